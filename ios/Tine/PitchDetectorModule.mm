@@ -1,26 +1,90 @@
 #import "PitchDetectorModule.h"
 
 #import <AVFoundation/AVFoundation.h>
+#import <QuartzCore/QuartzCore.h>
 #import <React/RCTBridge.h>
 #import <React/RCTConvert.h>
 #import <React/RCTLog.h>
 
 #include <atomic>
+#include <chrono>
+#include <cstring>
 #include <memory>
+#include <string>
 #include <vector>
 
-#include "../../native/cpp/FloatRingBuffer.hpp"
-#include "../../native/cpp/YinPitchDetector.hpp"
-
-using tine::dsp::FloatRingBuffer;
+#include "../../native/cpp/DialAnimator.hpp"
+#include "../../native/cpp/EngineThread.hpp"
+#include "../../native/cpp/InstrumentPresets.hpp"
+#include "../../native/cpp/KernelAutotuner.hpp"
+#include "../../native/cpp/LatencyPlanner.hpp"
+#include "../../native/cpp/Metrics.hpp"
+#include "../../native/cpp/PitchEngine.hpp"
+#include "../../native/cpp/RtLog.hpp"
+#include "../../native/cpp/SessionAnalytics.hpp"
+#include "../../native/cpp/SpscQueue.hpp"
+#include "../../native/cpp/ThreadConfig.hpp"
+#include "../../native/cpp/ToneGenerator.hpp"
+
+using tine::dsp::DialAnimator;
+using tine::dsp::DialState;
+using tine::dsp::EngineMode;
+using tine::dsp::EngineThread;
+using tine::dsp::CompiledPreset;
+using tine::dsp::InstrumentPreset;
+using tine::dsp::KernelWisdom;
+using tine::dsp::LatencyPlan;
+using tine::dsp::LagRefinement;
+using tine::dsp::LatencyPlanRequest;
+using tine::dsp::MetricKind;
+using tine::dsp::MetricsSnapshot;
+using tine::dsp::PitchEngine;
+using tine::dsp::PitchEngineConfig;
 using tine::dsp::PitchResult;
-using tine::dsp::YinPitchDetector;
+using tine::dsp::RtLog;
+using tine::dsp::RtLogEvent;
+using tine::dsp::RtLogLevel;
+using tine::dsp::RtLogRecord;
+using tine::dsp::IntonationSummary;
+using tine::dsp::SessionAnalytics;
+using tine::dsp::SessionAnalyticsConfig;
+using tine::dsp::SessionAnalyticsSnapshot;
+using tine::dsp::SpscQueue;
+using tine::dsp::ThreadConfigRequest;
+using tine::dsp::ThreadPolicy;
+using tine::dsp::ToneGenerator;
+using tine::dsp::ToneParameters;
+using tine::dsp::ToneWaveform;
 
 static const char *const kEventName = "onPitchData";
+static const char *const kLogEventName = "onNativeLog";
+static const char *const kDialEventName = "onDialFrame";
 static const double kPreferredSampleRate = 48000.0;
-static const double kPreferredIOBufferFrames = 256.0;
-static const NSUInteger kDefaultBufferSize = 2048;
+static const double kDefaultTargetLatencyMs = 80.0;
+static const double kDefaultMinFrequency = 40.0;
 static const double kDefaultThreshold = 0.12;
+// Added latency the energy policy batches hops within unless maxBatchLatencyMs says otherwise.
+static const double kDefaultEnergyBatchLatencyMs = 150.0;
+// Fraction of each engine period the analysis thread asks the kernel to reserve.
+static const double kEngineComputationFraction = 0.25;
+// Per-device kernel timings, kept in Caches so the OS may purge them; they are re-measured.
+static NSString *const kKernelWisdomFileName = @"tine-kernel-wisdom.txt";
+// Records the real-time threads can log between drains before dropping.
+static const std::size_t kLogCapacity = 512;
+static const double kLogDrainIntervalSeconds = 0.25;
+// Results the analysing thread can hand over between engine-thread drains.
+static const std::size_t kResultQueueCapacity = 256;
+
+// A PitchResult with its note name inline, so the capture thread can queue it
+// without allocating.
+struct QueuedResult {
+  bool isValid;
+  double frequency;
+  double midi;
+  double cents;
+  double probability;
+  char noteName[4];
+};
 
 @interface PitchDetectorModule ()
 
@@ -29,16 +93,47 @@ static const double kDefaultThreshold = 0.12;
 @end
 
 @implementation PitchDetectorModule {
-  dispatch_queue_t _processingQueue;
+  EngineThread _engineThread;
+  NSString *_threadConfigDescription;
   std::atomic<bool> _running;
-  std::unique_ptr<FloatRingBuffer> _ringBuffer;
-  std::unique_ptr<YinPitchDetector> _detector;
-  std::vector<float> _scratchBuffer;
+  std::unique_ptr<PitchEngine> _pitchEngine;
+  std::unique_ptr<SpscQueue<QueuedResult>> _results;
+  // Signalled by inline results so the engine thread emits them without waiting for its next tick.
+  dispatch_semaphore_t _resultReady;
+  std::unique_ptr<RtLog> _rtLog;
+  dispatch_queue_t _logQueue;
+  dispatch_source_t _logDrainTimer;
+  uint64_t _reportedLogDrops;
+  EngineMode _requestedMode;
+  BOOL _adaptiveWindow;
+  LagRefinement _lagRefinement;
+  BOOL _autotuneKernels;
+  BOOL _energyPolicy;
+  BOOL _nativeDial;
+  std::unique_ptr<DialAnimator> _dialAnimator;
+  BOOL _referenceToneNotch;
+  // Reference tone settings survive stop/start; the generator lives with the engine.
+  ToneParameters _toneParameters;
+  std::atomic<bool> _duckToneWhileVoiced;
+  std::unique_ptr<ToneGenerator> _toneGenerator;
+  BOOL _sessionAnalyticsEnabled;
+  double _inTuneCents;
+  // Kept after stop() so the finished session can still be read.
+  std::unique_ptr<SessionAnalytics> _sessionAnalytics;
+  AVAudioSourceNode *_toneNode;
+  CADisplayLink *_dialLink;
+  CFTimeInterval _lastDialTimestamp;
+  BOOL _dialRestSent;
+  std::vector<std::size_t> _kernelWindowSizes;
+  std::atomic<bool> _autotuning;
+  std::unique_ptr<InstrumentPreset> _presetDefinition;
+  std::unique_ptr<CompiledPreset> _preset;
+  LatencyPlanRequest _planRequest;
+  LatencyPlan _plan;
   double _sampleRate;
   NSUInteger _bufferSize;
   double _threshold;
   std::atomic<bool> _tapInstalled;
-  dispatch_source_t _drainTimer;
 }
 
 RCT_EXPORT_MODULE(PitchDetector);
@@ -51,13 +146,24 @@ RCT_EXPORT_MODULE(PitchDetector);
   if (self = [super init]) {
     _running.store(false);
     _tapInstalled.store(false);
-    _processingQueue = dispatch_queue_create("com.tine.pitchdetector", DISPATCH_QUEUE_SERIAL);
+    _autotuning.store(false);
+    _duckToneWhileVoiced.store(false);
+    _rtLog = std::make_unique<RtLog>(kLogCapacity);
+    _dialAnimator = std::make_unique<DialAnimator>();
+    _reportedLogDrops = 0;
+    _resultReady = dispatch_semaphore_create(0);
+    _logQueue = dispatch_queue_create(
+        "com.tine.pitchdetector.log",
+        dispatch_queue_attr_make_with_qos_class(DISPATCH_QUEUE_SERIAL, QOS_CLASS_UTILITY, 0));
   }
   return self;
 }
 
 - (NSArray<NSString *> *)supportedEvents {
-  return @[ [NSString stringWithUTF8String:kEventName] ];
+  return @[
+    [NSString stringWithUTF8String:kEventName], [NSString stringWithUTF8String:kLogEventName],
+    [NSString stringWithUTF8String:kDialEventName]
+  ];
 }
 
 - (void)invalidate {
@@ -72,11 +178,7 @@ RCT_REMAP_METHOD(start,
                  resolver:(RCTPromiseResolveBlock)resolve
                  rejecter:(RCTPromiseRejectBlock)reject) {
   if (_running.load()) {
-    resolve(@{
-      @"sampleRate" : @(_sampleRate),
-      @"bufferSize" : @(_bufferSize),
-      @"threshold" : @(_threshold),
-    });
+    resolve([self startResult]);
     return;
   }
 
@@ -88,14 +190,73 @@ RCT_REMAP_METHOD(start,
     NSNumber *bufferSizeValue = options[@"bufferSize"];
     NSNumber *thresholdValue = options[@"threshold"];
     NSNumber *sampleRateValue = options[@"sampleRate"];
-
-    self->_bufferSize = bufferSizeValue != nil ? MAX(256, bufferSizeValue.unsignedIntegerValue)
-                                               : kDefaultBufferSize;
-    self->_threshold = thresholdValue != nil ? thresholdValue.doubleValue : kDefaultThreshold;
+    NSNumber *targetLatencyValue = options[@"targetLatencyMs"];
+    NSNumber *minFrequencyValue = options[@"minFrequency"];
+    NSString *analysisModeValue = [RCTConvert NSString:options[@"analysisMode"]];
+    NSNumber *adaptiveWindowValue = options[@"adaptiveWindow"];
+    NSString *lagRefinementValue = [RCTConvert NSString:options[@"lagRefinement"]];
+    NSString *presetValue = [RCTConvert NSString:options[@"preset"]];
+    NSNumber *autotuneKernelsValue = options[@"autotuneKernels"];
+    NSNumber *nativeDialValue = options[@"nativeDial"];
+    NSString *schedulingPolicyValue = [RCTConvert NSString:options[@"schedulingPolicy"]];
+    NSNumber *maxBatchLatencyValue = options[@"maxBatchLatencyMs"];
+    NSNumber *referenceToneNotchValue = options[@"referenceToneNotch"];
+    NSNumber *sessionAnalyticsValue = options[@"sessionAnalytics"];
+    NSNumber *inTuneCentsValue = options[@"inTuneCents"];
+
+    // A preset only supplies defaults; every explicit option below still wins.
+    const InstrumentPreset *preset =
+        presetValue.length > 0 ? tine::dsp::builtInPreset(presetValue.UTF8String) : nullptr;
+    if (presetValue.length > 0 && preset == nullptr) {
+      RCTLogWarn(@"[PitchDetector] Unknown preset '%@'; using default settings", presetValue);
+    }
+    self->_presetDefinition = preset ? std::make_unique<InstrumentPreset>(*preset) : nullptr;
+    self->_preset.reset();
+
+    self->_threshold = thresholdValue != nil ? thresholdValue.doubleValue
+                                             : (preset ? preset->threshold : kDefaultThreshold);
+    self->_adaptiveWindow = adaptiveWindowValue != nil ? adaptiveWindowValue.boolValue
+                                                       : (preset ? preset->adaptiveWindow : YES);
+    self->_lagRefinement = [lagRefinementValue isEqualToString:@"sinc"]    ? LagRefinement::Sinc
+                           : [lagRefinementValue isEqualToString:@"cubic"] ? LagRefinement::Cubic
+                                                                           : LagRefinement::Parabolic;
+    self->_autotuneKernels = autotuneKernelsValue.boolValue;
+    self->_energyPolicy = [schedulingPolicyValue isEqualToString:@"energy"];
+    self->_nativeDial = nativeDialValue.boolValue;
+    // Off unless asked for: the notch also removes a player tuning in unison with the tone.
+    self->_referenceToneNotch = referenceToneNotchValue.boolValue;
+    self->_sessionAnalyticsEnabled = sessionAnalyticsValue.boolValue;
+    self->_inTuneCents = inTuneCentsValue != nil && inTuneCentsValue.doubleValue > 0
+                             ? inTuneCentsValue.doubleValue
+                             : SessionAnalyticsConfig{}.inTuneCents;
+    self->_requestedMode =
+        [analysisModeValue isEqualToString:@"inline"] ? EngineMode::Inline : EngineMode::Worker;
     if (sampleRateValue != nil && sampleRateValue.doubleValue > 0) {
       preferredSampleRate = MIN(MAX(sampleRateValue.doubleValue, 8000.0), 48000.0);
     }
 
+    LatencyPlanRequest planRequest;
+    planRequest.targetLatencySeconds = kDefaultTargetLatencyMs / 1000.0;
+    planRequest.minFrequencyHz = kDefaultMinFrequency;
+    if (preset) {
+      tine::dsp::compilePreset(*preset, preferredSampleRate).applyTo(planRequest);
+    }
+    if (targetLatencyValue != nil && targetLatencyValue.doubleValue > 0) {
+      planRequest.targetLatencySeconds = targetLatencyValue.doubleValue / 1000.0;
+    }
+    if (minFrequencyValue != nil && minFrequencyValue.doubleValue > 0) {
+      planRequest.minFrequencyHz = minFrequencyValue.doubleValue;
+    }
+    // An explicit window still wins; the planner then only derives the rest.
+    planRequest.windowFrames = bufferSizeValue != nil ? MAX(256, bufferSizeValue.unsignedIntegerValue) : 0;
+    planRequest.mode = self->_requestedMode;
+    if (self->_energyPolicy) {
+      const double batchMs = maxBatchLatencyValue != nil ? MAX(0.0, maxBatchLatencyValue.doubleValue)
+                                                         : kDefaultEnergyBatchLatencyMs;
+      planRequest.maxBatchLatencySeconds = batchMs / 1000.0;
+    }
+    self->_planRequest = planRequest;
+
     if (![session setCategory:AVAudioSessionCategoryPlayAndRecord
                  withOptions:AVAudioSessionCategoryOptionAllowBluetooth |
                              AVAudioSessionCategoryOptionDefaultToSpeaker
@@ -114,7 +275,8 @@ RCT_REMAP_METHOD(start,
     }
 
     NSTimeInterval preferredDuration =
-        (kPreferredIOBufferFrames / (preferredSampleRate > 0 ? preferredSampleRate : kPreferredSampleRate));
+        (double)tine::dsp::preferredIoPeriodFrames(preferredSampleRate, planRequest.targetLatencySeconds) /
+        preferredSampleRate;
     if (![session setPreferredIOBufferDuration:preferredDuration error:&error]) {
       RCTLogWarn(@"[PitchDetector] Unable to set preferred IO buffer duration: %@", error);
     }
@@ -129,6 +291,7 @@ RCT_REMAP_METHOD(start,
       self->_sampleRate = kPreferredSampleRate;
     }
 
+    [self planPipelineWithIOBufferDuration:session.IOBufferDuration fallback:preferredDuration];
     [self configureEngineWithReject:reject resolve:resolve];
   });
 }
@@ -146,14 +309,89 @@ RCT_REMAP_METHOD(start,
       [[AVAudioFormat alloc] initStandardFormatWithSampleRate:_sampleRate channels:1];
   self.streamFormat = format;
 
-  _ringBuffer = std::make_unique<FloatRingBuffer>(_bufferSize * 4);
-  _detector = std::make_unique<YinPitchDetector>(_sampleRate, _bufferSize, _threshold);
-  _scratchBuffer.assign(_bufferSize, 0.0f);
+  PitchEngineConfig engineConfig = _plan.engineConfig(_threshold);
+  if (_preset) {
+    _preset->applyTo(engineConfig);
+  }
+  engineConfig.adaptiveWindow = _adaptiveWindow;
+  engineConfig.lagRefinement = _lagRefinement;
+  engineConfig.log = _rtLog.get();
+  if (_nativeDial) {
+    // No results flow yet, so the animator can be rewound from this thread.
+    _dialAnimator->reset();
+    engineConfig.animator = _dialAnimator.get();
+  }
+  // Built before the render thread exists; from here on only parameters change.
+  _toneGenerator = std::make_unique<ToneGenerator>(_sampleRate);
+  _toneGenerator->setParameters(_toneParameters);
+  if (_referenceToneNotch) {
+    engineConfig.referenceTone = _toneGenerator.get();
+  }
+  if (_sessionAnalyticsEnabled) {
+    SessionAnalyticsConfig analyticsConfig;
+    analyticsConfig.sampleRate = _sampleRate;
+    analyticsConfig.hopSize = engineConfig.hopSize;
+    analyticsConfig.inTuneCents = _inTuneCents;
+    if (_presetDefinition) {
+      analyticsConfig.stringMidi = _presetDefinition->targetMidi;
+    }
+    _sessionAnalytics = std::make_unique<SessionAnalytics>(analyticsConfig);
+    engineConfig.analytics = _sessionAnalytics.get();
+  } else {
+    _sessionAnalytics.reset();
+  }
+  KernelWisdom wisdom;
+  if (KernelWisdom::load([self kernelWisdomPath], tine::dsp::currentCpuModel(), wisdom)) {
+    engineConfig.kernelWisdom = wisdom;
+  }
+  _pitchEngine = std::make_unique<PitchEngine>(engineConfig);
+  _kernelWindowSizes = _pitchEngine->windowLadder();
+  _results = std::make_unique<SpscQueue<QueuedResult>>(kResultQueueCapacity);
 
   __weak typeof(self) weakSelf = self;
+  ToneGenerator *tone = _toneGenerator.get();
+  SpscQueue<QueuedResult> *results = _results.get();
+  PitchEngine *engine = _pitchEngine.get();
+  dispatch_semaphore_t resultReady = _resultReady;
+  // Runs on the tap thread in inline mode and on the engine thread otherwise;
+  // only one of them produces at a time. Events are built and sent from the
+  // engine thread, so the tap thread never allocates here; inline results
+  // signal it, which is safe from the tap thread, so they go out at once.
+  _pitchEngine->setResultHandler([weakSelf, tone, results, engine, resultReady](const PitchResult &result) {
+    __strong typeof(weakSelf) strongSelf = weakSelf;
+    if (strongSelf && strongSelf->_duckToneWhileVoiced.load(std::memory_order_relaxed)) {
+      tone->setDucked(result.isValid);
+    }
+    QueuedResult queued{result.isValid, result.frequency, result.midi, result.cents, result.probability, {}};
+    std::strncpy(queued.noteName, result.noteName.c_str(), sizeof(queued.noteName) - 1);
+    if (results->push(queued) && engine->inlineActive()) {
+      dispatch_semaphore_signal(resultReady);
+    }
+  });
+
+  // Render thread: table lookups only. The engine is stopped before the
+  // generator is released, so the raw pointer never dangles.
+  _toneNode = [[AVAudioSourceNode alloc]
+      initWithFormat:format
+         renderBlock:^OSStatus(BOOL *isSilence, const AudioTimeStamp *timestamp, AVAudioFrameCount frameCount,
+                               AudioBufferList *outputData) {
+           for (UInt32 i = 0; i < outputData->mNumberBuffers; ++i) {
+             float *samples = static_cast<float *>(outputData->mBuffers[i].mData);
+             if (i == 0) {
+               tone->render(samples, frameCount);
+             } else {
+               memcpy(samples, outputData->mBuffers[0].mData, frameCount * sizeof(float));
+             }
+           }
+           *isSilence = tone->audibleFrequency() <= 0.0;
+           return noErr;
+         }];
+  [self.engine attachNode:_toneNode];
+  [self.engine connect:_toneNode to:self.engine.mainMixerNode format:format];
+
   [inputNode removeTapOnBus:0];
   [inputNode installTapOnBus:0
-                  bufferSize:512
+                  bufferSize:(AVAudioFrameCount)_plan.tapFrames
                       format:format
                        block:^(AVAudioPCMBuffer *buffer, AVAudioTime *when) {
                          [weakSelf handleAudioBuffer:buffer];
@@ -168,40 +406,115 @@ RCT_REMAP_METHOD(start,
   }
 
   _tapInstalled.store(true);
-  [self startDrainTimer];
+  [self startEngineThread];
+  [self startLogDrain];
+  if (_nativeDial) {
+    [self startDialLink];
+  }
   _running.store(true);
 
-  resolve(@{
+  resolve([self startResult]);
+}
+
+- (void)planPipelineWithIOBufferDuration:(NSTimeInterval)ioDuration fallback:(NSTimeInterval)fallback {
+  // Plan against the IO period the session actually granted, not the one requested.
+  const NSTimeInterval granted = ioDuration > 0 ? ioDuration : fallback;
+  _planRequest.sampleRate = _sampleRate;
+  _planRequest.ioPeriodFrames = (std::size_t)MAX(1.0, round(granted * _sampleRate));
+  _plan = tine::dsp::planLatency(_planRequest);
+  _bufferSize = _plan.windowFrames;
+  // Filters and the lag floor depend on the rate the session actually granted.
+  if (_presetDefinition) {
+    _preset = std::make_unique<CompiledPreset>(tine::dsp::compilePreset(*_presetDefinition, _sampleRate));
+  }
+
+  if (!_plan.meetsLatencyTarget || !_plan.meetsCpuBudget) {
+    RCTLogWarn(@"[PitchDetector] Latency target %.0f ms not fully met: %s",
+               _planRequest.targetLatencySeconds * 1000.0, _plan.describe().c_str());
+  }
+}
+
+- (NSDictionary *)presetInfo {
+  if (!_preset) {
+    return nil;
+  }
+  const InstrumentPreset &preset = _preset->preset;
+  NSMutableArray<NSNumber *> *targets = [NSMutableArray arrayWithCapacity:_preset->targetFrequencies.size()];
+  for (double frequency : _preset->targetFrequencies) {
+    [targets addObject:@(frequency)];
+  }
+  return @{
+    @"name" : [NSString stringWithUTF8String:preset.name.c_str()],
+    @"minFrequency" : @(preset.minFrequencyHz),
+    @"maxFrequency" : @(preset.maxFrequencyHz),
+    @"targetFrequencies" : targets,
+  };
+}
+
+- (NSDictionary *)startResult {
+  NSMutableDictionary *result = [@{
     @"sampleRate" : @(_sampleRate),
     @"bufferSize" : @(_bufferSize),
     @"threshold" : @(_threshold),
-  });
+    @"threadConfig" : _threadConfigDescription ?: @"",
+    @"analysisMode" : [self analysisModeName],
+    @"latencyPlan" : @{
+      @"ioPeriodFrames" : @(_plan.ioPeriodFrames),
+      @"tapFrames" : @(_plan.tapFrames),
+      @"hopFrames" : @(_plan.hopFrames),
+      @"windowFrames" : @(_plan.windowFrames),
+      @"ringCapacity" : @(_plan.ringCapacity),
+      @"minDetectableHz" : @(_plan.minDetectableHz),
+      @"expectedLatencyMs" : @(_plan.expectedLatencySeconds * 1000.0),
+      @"worstCaseLatencyMs" : @(_plan.worstCaseLatencySeconds * 1000.0),
+      @"cpuLoad" : @(_plan.cpuLoad),
+      @"meetsLatencyTarget" : @(_plan.meetsLatencyTarget),
+      @"batchHops" : @(_plan.batchHops),
+      @"wakeupsPerSecond" : @(_plan.wakeupsPerSecond),
+    },
+    @"schedulingPolicy" : _energyPolicy ? @"energy" : @"latency",
+  } mutableCopy];
+  NSDictionary *presetInfo = [self presetInfo];
+  if (presetInfo) {
+    result[@"preset"] = presetInfo;
+  }
+  return result;
 }
 
-- (void)startDrainTimer {
-  if (_drainTimer != nil) {
-    dispatch_source_cancel(_drainTimer);
-    _drainTimer = nil;
-  }
+- (NSString *)analysisModeName {
+  return (_pitchEngine && _pitchEngine->inlineActive()) ? @"inline" : @"worker";
+}
 
-  const double intervalSeconds = (double)_bufferSize / _sampleRate;
-  const uint64_t intervalNanos = (uint64_t)(intervalSeconds * NSEC_PER_SEC);
+- (void)startEngineThread {
+  _engineThread.stop();
 
-  dispatch_source_t timer = dispatch_source_create(DISPATCH_SOURCE_TYPE_TIMER, 0, 0, _processingQueue);
-  dispatch_source_set_timer(timer, dispatch_time(DISPATCH_TIME_NOW, intervalNanos), intervalNanos,
-                            intervalNanos / 4);
+  const double intervalSeconds = _plan.drainPeriodSeconds;
+
+  ThreadConfigRequest request;
+  // A time-constraint thread is promised prompt, high-priority wakeups; the energy
+  // policy has already given up latency, so it runs as an ordinary thread.
+  request.policy = _energyPolicy ? ThreadPolicy::Default : ThreadPolicy::TimeConstraint;
+  request.periodSeconds = intervalSeconds;
+  request.computationSeconds = intervalSeconds * MIN(1.0, MAX(kEngineComputationFraction, _plan.cpuLoad));
+  request.constraintSeconds = intervalSeconds;
+  request.flushDenormals = true;
 
   __weak typeof(self) weakSelf = self;
-  dispatch_source_set_event_handler(timer, ^{
-    [weakSelf drainAndProcess];
+  _engineThread.start(request, std::chrono::nanoseconds((int64_t)(intervalSeconds * NSEC_PER_SEC)), [weakSelf]() {
+    @autoreleasepool {
+      [weakSelf drainAndProcess];
+    }
   });
 
-  _drainTimer = timer;
-  dispatch_resume(timer);
+  _threadConfigDescription =
+      [NSString stringWithUTF8String:_engineThread.appliedConfig().describe().c_str()];
+  if (_engineThread.appliedConfig().error != 0) {
+    RCTLogWarn(@"[PitchDetector] Engine thread configuration partially refused: %@", _threadConfigDescription);
+  }
 }
 
 - (void)handleAudioBuffer:(AVAudioPCMBuffer *)buffer {
-  if (!_ringBuffer) {
+  if (!_pitchEngine) {
     return;
   }
 
@@ -215,34 +528,180 @@ RCT_REMAP_METHOD(start,
     return;
   }
 
-  const std::size_t written = _ringBuffer->write(channel, frameLength);
-  if (written < frameLength) {
-    static std::atomic<bool> logOnce{false};
-    bool alreadyLogged = logOnce.exchange(true);
-    if (!alreadyLogged) {
-      RCTLogWarn(@"[PitchDetector] Ring buffer overrun (dropped %u frames)", frameLength - written);
-    }
-  }
+  // The ring overwrites its oldest frames under load; losses are reported from the
+  // engine thread rather than logged here on the capture thread.
+  _pitchEngine->pushAudio(channel, frameLength);
 }
 
 - (void)drainAndProcess {
-  if (!_ringBuffer || !_detector || !_running.load()) {
+  if (!_pitchEngine || !_running.load()) {
     return;
   }
 
-  const std::size_t framesRead = _ringBuffer->read(_scratchBuffer.data(), _bufferSize);
-  if (framesRead < _bufferSize) {
+  _pitchEngine->processPending();
+  [self emitQueuedResults];
+  if (!_pitchEngine->inlineActive()) {
     return;
   }
 
-  PitchResult result = _detector->processBuffer(_scratchBuffer.data(), _bufferSize);
-  [self emitResult:result];
+  // Inline results are analyzed on the tap thread: wait for them until the next
+  // tick is due so each is emitted as it is queued rather than a tick later. The
+  // tick still runs processPending() in case the engine falls back to the worker.
+  const dispatch_time_t nextTick =
+      dispatch_time(DISPATCH_TIME_NOW, (int64_t)(_plan.drainPeriodSeconds * NSEC_PER_SEC));
+  while (_running.load() && dispatch_semaphore_wait(_resultReady, nextTick) == 0) {
+    [self emitQueuedResults];
+  }
+}
+
+- (void)emitQueuedResults {
+  QueuedResult result;
+  while (_results->pop(result)) {
+    [self emitResult:result];
+  }
+}
+
+// The dial springs advance here, on the main thread, once per display refresh;
+// only frames where the dial actually moves cross the bridge.
+- (void)startDialLink {
+  [self stopDialLink];
+  _lastDialTimestamp = 0;
+  _dialRestSent = NO;
+  _dialLink = [CADisplayLink displayLinkWithTarget:self selector:@selector(advanceDial:)];
+  [_dialLink addToRunLoop:[NSRunLoop mainRunLoop] forMode:NSRunLoopCommonModes];
 }
 
-- (void)emitResult:(const PitchResult &)result {
+- (void)stopDialLink {
+  // The link retains the module; invalidating it breaks the cycle.
+  [_dialLink invalidate];
+  _dialLink = nil;
+}
+
+- (void)advanceDial:(CADisplayLink *)link {
+  const CFTimeInterval elapsed = _lastDialTimestamp > 0 ? link.timestamp - _lastDialTimestamp : link.duration;
+  _lastDialTimestamp = link.timestamp;
+  const DialState state = _dialAnimator->advance(elapsed);
+  if (state.settled) {
+    if (_dialRestSent) {
+      return;
+    }
+    _dialRestSent = YES;
+  } else {
+    _dialRestSent = NO;
+  }
+
+  [self sendEventWithName:[NSString stringWithUTF8String:kDialEventName]
+                     body:@{
+                       @"needleDegrees" : @(state.needleDegrees),
+                       @"ringDegrees" : @(state.ringDegrees),
+                       @"cents" : @(state.cents),
+                       @"midi" : @(state.midi),
+                       @"voiced" : @(state.voiced != 0),
+                       @"settled" : @(state.settled != 0),
+                       @"timestamp" : @(link.timestamp * 1000.0),
+                     }];
+}
+
+- (void)startLogDrain {
+  [self stopLogDrain];
+  _logDrainTimer = dispatch_source_create(DISPATCH_SOURCE_TYPE_TIMER, 0, 0, _logQueue);
+  const uint64_t interval = (uint64_t)(kLogDrainIntervalSeconds * NSEC_PER_SEC);
+  dispatch_source_set_timer(_logDrainTimer, dispatch_time(DISPATCH_TIME_NOW, interval), interval, interval / 4);
+  __weak typeof(self) weakSelf = self;
+  dispatch_source_set_event_handler(_logDrainTimer, ^{
+    [weakSelf drainNativeLog];
+  });
+  dispatch_resume(_logDrainTimer);
+}
+
+- (void)stopLogDrain {
+  if (_logDrainTimer) {
+    dispatch_source_cancel(_logDrainTimer);
+    _logDrainTimer = nil;
+  }
+  // The queue is serial, so this runs after any in-flight timer pass and keeps
+  // the ring single-consumer while flushing what the last session logged.
+  dispatch_sync(_logQueue, ^{
+    [self drainNativeLog];
+  });
+}
+
+// Runs on _logQueue only; the real-time threads never format or lock.
+- (void)drainNativeLog {
+  RtLog *log = _rtLog.get();
+  if (!log) {
+    return;
+  }
+
+  // Overruns and drops come one per late hop or refused push; one line each per
+  // drain pass is enough, with the frame counts summed.
+  RtLogRecord overruns{};
+  RtLogRecord drops{};
+  std::size_t overrunRecords = 0;
+  std::size_t dropRecords = 0;
+  log->drain([&](const RtLogRecord &record) {
+    if (record.event == RtLogEvent::CaptureOverrun) {
+      overruns.timestampNanos = record.timestampNanos;
+      overruns.args[0] += record.args[0];
+      overruns.args[1] = record.args[1];
+      ++overrunRecords;
+      return;
+    }
+    if (record.event == RtLogEvent::CaptureDropped) {
+      drops.timestampNanos = record.timestampNanos;
+      drops.args[0] += record.args[0];
+      ++dropRecords;
+      return;
+    }
+    [self forwardLogRecord:record];
+  });
+  if (overrunRecords > 0) {
+    overruns.event = RtLogEvent::CaptureOverrun;
+    [self forwardLogRecord:overruns];
+  }
+  if (dropRecords > 0) {
+    drops.event = RtLogEvent::CaptureDropped;
+    [self forwardLogRecord:drops];
+  }
+
+  const uint64_t dropped = log->dropped();
+  if (dropped != _reportedLogDrops) {
+    RCTLogWarn(@"[PitchDetector] Native log ring full: %llu records dropped",
+               (unsigned long long)(dropped - _reportedLogDrops));
+    _reportedLogDrops = dropped;
+  }
+}
+
+- (void)forwardLogRecord:(const RtLogRecord &)record {
+  NSString *message = [NSString stringWithUTF8String:RtLog::format(record).c_str()];
+  const RtLogLevel level = RtLog::level(record.event);
+  if (level == RtLogLevel::Info) {
+    RCTLogInfo(@"[PitchDetector] %@", message);
+  } else {
+    RCTLogWarn(@"[PitchDetector] %@", message);
+  }
+
+  // Records carry a steady-clock stamp; map it to wall time for the JS logger.
+  const auto nowNanos = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                            std::chrono::steady_clock::now().time_since_epoch())
+                            .count();
+  const double ageSeconds = (double)((int64_t)nowNanos - (int64_t)record.timestampNanos) / 1e9;
+  NSDictionary *payload = @{
+    @"level" : level == RtLogLevel::Info ? @"info" : (level == RtLogLevel::Warn ? @"warn" : @"error"),
+    @"tag" : @"PitchDetector",
+    @"event" : [NSString stringWithUTF8String:RtLog::eventName(record.event)],
+    @"message" : message,
+    @"timestamp" : @(([[NSDate date] timeIntervalSince1970] - MAX(0.0, ageSeconds)) * 1000.0),
+  };
+  dispatch_async(dispatch_get_main_queue(), ^{
+    [self sendEventWithName:[NSString stringWithUTF8String:kLogEventName] body:payload];
+  });
+}
+
+- (void)emitResult:(const QueuedResult &)result {
   NSString *noteName = nil;
-  if (!result.noteName.empty()) {
-    noteName = [NSString stringWithUTF8String:result.noteName.c_str()];
+  if (result.noteName[0] != '\0') {
+    noteName = [NSString stringWithUTF8String:result.noteName];
   }
 
   NSDictionary *payload = @{
@@ -261,11 +720,9 @@ RCT_REMAP_METHOD(start,
 
 - (void)stopInternal {
   _running.store(false);
-
-  if (_drainTimer != nil) {
-    dispatch_source_cancel(_drainTimer);
-    _drainTimer = nil;
-  }
+  // Release an engine thread waiting for inline results so the join is prompt.
+  dispatch_semaphore_signal(_resultReady);
+  _engineThread.stop();
 
   if (_tapInstalled.load()) {
     AVAudioInputNode *inputNode = self.engine.inputNode;
@@ -281,9 +738,59 @@ RCT_REMAP_METHOD(start,
 
   [self teardownAudioSession];
 
-  _ringBuffer.reset();
-  _detector.reset();
-  _scratchBuffer.clear();
+  [self stopDialLink];
+  _pitchEngine.reset();
+  _results.reset();
+  if (_toneNode) {
+    [self.engine detachNode:_toneNode];
+    _toneNode = nil;
+  }
+  _toneGenerator.reset();
+  [self stopLogDrain];
+  [self scheduleKernelAutotune];
+}
+
+- (std::string)kernelWisdomPath {
+  NSString *caches = NSSearchPathForDirectoriesInDomains(NSCachesDirectory, NSUserDomainMask, YES).firstObject;
+  return std::string([[caches ?: NSTemporaryDirectory() stringByAppendingPathComponent:kKernelWisdomFileName]
+      fileSystemRepresentation]);
+}
+
+- (void)scheduleKernelAutotune {
+  if (!_autotuneKernels || _kernelWindowSizes.empty() || _autotuning.exchange(true)) {
+    return;
+  }
+
+  // Capture has just stopped, so the timings neither disturb nor are disturbed by
+  // the audio threads. Results apply from the next start().
+  const std::vector<std::size_t> windowSizes = _kernelWindowSizes;
+  const std::string path = [self kernelWisdomPath];
+  __weak typeof(self) weakSelf = self;
+  dispatch_async(dispatch_get_global_queue(QOS_CLASS_BACKGROUND, 0), ^{
+    const std::string cpuModel = tine::dsp::currentCpuModel();
+    KernelWisdom wisdom(cpuModel);
+    KernelWisdom::load(path, cpuModel, wisdom);
+
+    std::vector<std::size_t> missing;
+    for (std::size_t window : windowSizes) {
+      if (!wisdom.find(window)) {
+        missing.push_back(window);
+      }
+    }
+    if (!missing.empty()) {
+      for (const auto &entry : tine::dsp::autotuneDifferenceKernels(missing).entries()) {
+        wisdom.set(entry);
+      }
+      if (!wisdom.save(path)) {
+        RCTLogWarn(@"[PitchDetector] Unable to save kernel timings to %s", path.c_str());
+      }
+    }
+
+    __strong typeof(weakSelf) strongSelf = weakSelf;
+    if (strongSelf) {
+      strongSelf->_autotuning.store(false);
+    }
+  });
 }
 
 - (void)teardownAudioSession {
@@ -316,9 +823,163 @@ RCT_REMAP_METHOD(stop,
 
 RCT_EXPORT_METHOD(setThreshold:(double)threshold) {
   _threshold = threshold;
-  if (_detector) {
-    _detector->setThreshold(threshold);
+  if (_pitchEngine) {
+    _pitchEngine->setThreshold(threshold);
+  }
+}
+
+// Main queue, like start(), so the accumulator is never replaced mid-snapshot.
+RCT_REMAP_METHOD(getSessionAnalytics,
+                 getSessionAnalyticsWithResolver:(RCTPromiseResolveBlock)resolve
+                 rejecter:(RCTPromiseRejectBlock)reject) {
+  dispatch_async(dispatch_get_main_queue(), ^{
+    if (!self->_sessionAnalytics) {
+      resolve([NSNull null]);
+      return;
+    }
+    resolve([self analyticsDictionary:self->_sessionAnalytics->snapshot()]);
+  });
+}
+
+- (NSDictionary *)intonationDictionary:(const IntonationSummary &)summary {
+  NSMutableArray *histogram = [NSMutableArray arrayWithCapacity:IntonationSummary::HISTOGRAM_BINS];
+  for (double seconds : summary.centsHistogram) {
+    [histogram addObject:@(seconds)];
+  }
+  return @{
+    @"voicedSeconds" : @(summary.voicedSeconds),
+    @"inTuneSeconds" : @(summary.inTuneSeconds),
+    @"inTuneFraction" : @(summary.inTuneFraction()),
+    @"meanCents" : @(summary.meanCents),
+    @"stdDevCents" : @(summary.stdDevCents),
+    @"centsHistogram" : histogram,
+    @"vibratoSeconds" : @(summary.vibratoSeconds),
+    @"vibratoRateHz" : @(summary.vibratoRateHz),
+    @"vibratoDepthCents" : @(summary.vibratoDepthCents),
+  };
+}
+
+- (NSDictionary *)analyticsDictionary:(const SessionAnalyticsSnapshot &)snapshot {
+  NSMutableArray *notes = [NSMutableArray arrayWithCapacity:snapshot.notes.size()];
+  for (const auto &note : snapshot.notes) {
+    NSMutableDictionary *entry = [[self intonationDictionary:note.summary] mutableCopy];
+    entry[@"midi"] = @(note.midi);
+    [notes addObject:entry];
   }
+  NSMutableArray *strings = [NSMutableArray arrayWithCapacity:snapshot.strings.size()];
+  for (const auto &string : snapshot.strings) {
+    NSMutableDictionary *entry = [[self intonationDictionary:string.summary] mutableCopy];
+    entry[@"midi"] = @(string.midi);
+    [strings addObject:entry];
+  }
+  NSMutableArray *drift = [NSMutableArray arrayWithCapacity:snapshot.drift.size()];
+  for (const auto &point : snapshot.drift) {
+    [drift addObject:@{
+      @"startSeconds" : @(point.startSeconds),
+      @"voicedSeconds" : @(point.voicedSeconds),
+      @"meanCents" : @(point.meanCents),
+    }];
+  }
+
+  return @{
+    @"sessionSeconds" : @(snapshot.sessionSeconds),
+    @"inTuneCents" : @(_sessionAnalytics->config().inTuneCents),
+    @"overall" : [self intonationDictionary:snapshot.overall],
+    @"notes" : notes,
+    @"strings" : strings,
+    @"driftBinSeconds" : @(snapshot.driftBinSeconds),
+    @"drift" : drift,
+    @"driftCentsPerMinute" : @(snapshot.driftCentsPerMinute),
+  };
+}
+
+// Parameters are published from the main queue only: the generator's single writer.
+RCT_EXPORT_METHOD(setReferenceTone:(NSDictionary *)options) {
+  dispatch_async(dispatch_get_main_queue(), ^{
+    ToneParameters next = self->_toneParameters;
+    NSNumber *frequencyValue = options[@"frequency"];
+    if (options == nil || frequencyValue == nil || !(frequencyValue.doubleValue > 0)) {
+      next.gate = false;
+    } else {
+      const ToneParameters defaults;
+      NSString *waveformValue = [RCTConvert NSString:options[@"waveform"]];
+      NSNumber *gainValue = options[@"gain"];
+      NSNumber *glideValue = options[@"glideMs"];
+      NSNumber *attackValue = options[@"attackMs"];
+      NSNumber *releaseValue = options[@"releaseMs"];
+      NSNumber *duckGainValue = options[@"duckGain"];
+
+      next.frequency = frequencyValue.doubleValue;
+      next.gain = gainValue != nil ? MIN(MAX(gainValue.doubleValue, 0.0), 1.0) : defaults.gain;
+      next.glideSeconds = glideValue != nil ? MAX(0.0, glideValue.doubleValue) / 1000.0 : defaults.glideSeconds;
+      next.attackSeconds = attackValue != nil ? MAX(0.0, attackValue.doubleValue) / 1000.0 : defaults.attackSeconds;
+      next.releaseSeconds =
+          releaseValue != nil ? MAX(0.0, releaseValue.doubleValue) / 1000.0 : defaults.releaseSeconds;
+      next.duckGain = duckGainValue != nil ? MIN(MAX(duckGainValue.doubleValue, 0.0), 1.0) : defaults.duckGain;
+      next.waveform = [waveformValue isEqualToString:@"triangle"]   ? ToneWaveform::Triangle
+                      : [waveformValue isEqualToString:@"sawtooth"] ? ToneWaveform::Sawtooth
+                      : [waveformValue isEqualToString:@"square"]   ? ToneWaveform::Square
+                                                                    : ToneWaveform::Sine;
+      next.gate = true;
+    }
+    const BOOL duck = next.gate && [RCTConvert BOOL:options[@"duckWhileVoiced"]];
+    self->_duckToneWhileVoiced.store(duck, std::memory_order_relaxed);
+    self->_toneParameters = next;
+    if (self->_toneGenerator) {
+      if (!duck) {
+        self->_toneGenerator->setDucked(false);
+      }
+      self->_toneGenerator->setParameters(next);
+    }
+  });
+}
+
+// Serialized with start/stop on the main queue so the engine cannot be torn down
+// mid-snapshot. The snapshot itself only reads relaxed atomics.
+RCT_REMAP_METHOD(getStats,
+                 getStatsWithResolver:(RCTPromiseResolveBlock)resolve
+                 rejecter:(RCTPromiseRejectBlock)reject) {
+  dispatch_async(dispatch_get_main_queue(), ^{
+    if (!self->_pitchEngine) {
+      resolve([NSNull null]);
+      return;
+    }
+    resolve([self statsDictionary:self->_pitchEngine->metrics().snapshot()]);
+  });
+}
+
+- (NSDictionary *)statsDictionary:(const MetricsSnapshot &)snapshot {
+  NSMutableDictionary *counters = [NSMutableDictionary dictionary];
+  NSMutableDictionary *gauges = [NSMutableDictionary dictionary];
+  for (const auto &value : snapshot.values) {
+    NSMutableDictionary *target = value.kind == MetricKind::Counter ? counters : gauges;
+    target[[NSString stringWithUTF8String:value.name.c_str()]] = @(value.value);
+  }
+
+  NSMutableDictionary *histograms = [NSMutableDictionary dictionary];
+  for (const auto &histogram : snapshot.histograms) {
+    const double scale = histogram.scale;
+    NSMutableDictionary *quantiles = [NSMutableDictionary dictionary];
+    for (const auto &[q, v] : histogram.summary.quantiles) {
+      quantiles[[NSString stringWithFormat:@"%g", q]] = @((double)v * scale);
+    }
+    histograms[[NSString stringWithUTF8String:histogram.name.c_str()]] = @{
+      @"count" : @(histogram.summary.count),
+      @"sum" : @((double)histogram.summary.sum * scale),
+      @"min" : @((double)histogram.summary.min * scale),
+      @"max" : @((double)histogram.summary.max * scale),
+      @"quantiles" : quantiles,
+    };
+  }
+
+  return @{
+    @"counters" : counters,
+    @"gauges" : gauges,
+    @"histograms" : histograms,
+    @"sampleRate" : @(_sampleRate),
+    @"wakeupsPerSecond" : @(_engineThread.wakeupsPerSecond()),
+    @"timestamp" : @([[NSDate date] timeIntervalSince1970] * 1000.0),
+  };
 }
 
 @end
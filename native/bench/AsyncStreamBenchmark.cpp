@@ -0,0 +1,106 @@
+// Compares the coroutine stream analyzer against one OS thread per stream.
+//
+// Build (from the repository root):
+//   c++ -std=c++20 -O2 -pthread -Inative/cpp native/bench/AsyncStreamBenchmark.cpp
+//       native/cpp/AsyncScheduler.cpp native/cpp/AsyncStream.cpp native/cpp/ThreadPool.cpp native/cpp/ThreadConfig.cpp
+//       native/cpp/StreamScheduler.cpp native/cpp/Metrics.cpp native/cpp/YinPitchDetector.cpp
+//       native/cpp/DifferenceKernel.cpp -o async_stream_bench
+//   ./async_stream_bench [streams] [seconds]
+
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+#include <vector>
+
+#include "AsyncScheduler.hpp"
+#include "AsyncStream.hpp"
+#include "AsyncTask.hpp"
+#include "YinPitchDetector.hpp"
+
+using namespace tine::dsp;
+
+namespace {
+
+constexpr double kSampleRate = 48000.0;
+constexpr std::size_t kWindow = 2048;
+constexpr std::size_t kHop = 1024;
+
+std::vector<float> makeTone(double frequency, std::size_t frames) {
+    std::vector<float> samples(frames);
+    for (std::size_t i = 0; i < frames; ++i) {
+        samples[i] = static_cast<float>(0.5 * std::sin(2.0 * M_PI * frequency * static_cast<double>(i) / kSampleRate));
+    }
+    return samples;
+}
+
+double secondsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+double runThreadPerStream(const std::vector<std::vector<float>>& streams, std::atomic<std::size_t>& windows) {
+    const auto start = std::chrono::steady_clock::now();
+    std::vector<std::thread> threads;
+    threads.reserve(streams.size());
+    for (const auto& samples : streams) {
+        threads.emplace_back([&samples, &windows] {
+            YinPitchDetector detector(kSampleRate, kWindow, 0.1);
+            for (std::size_t offset = 0; offset + kWindow <= samples.size(); offset += kHop) {
+                detector.processBuffer(samples.data() + offset, kWindow);
+                windows.fetch_add(1, std::memory_order_relaxed);
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    return secondsSince(start);
+}
+
+Task<void> analyzeOne(AsyncContext& context, const std::vector<float>& samples, std::atomic<std::size_t>& windows) {
+    MemoryStreamSource source(samples.data(), samples.size());
+    StreamAnalysisConfig config{kSampleRate, kWindow, kHop, 0.1};
+    const StreamSummary summary = co_await analyzeStream(context, source, config, nullptr);
+    windows.fetch_add(summary.windowsAnalyzed, std::memory_order_relaxed);
+}
+
+double runCoroutines(const std::vector<std::vector<float>>& streams, std::atomic<std::size_t>& windows) {
+    const auto start = std::chrono::steady_clock::now();
+    AsyncScheduler scheduler;
+    AsyncContext context{scheduler, nullptr};
+    WaitGroup group;
+    for (const auto& samples : streams) {
+        spawn(scheduler, analyzeOne(context, samples, windows), &group);
+    }
+    group.wait();
+    return secondsSince(start);
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    const std::size_t streamCount = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 512;
+    const double seconds = argc > 2 ? std::strtod(argv[2], nullptr) : 2.0;
+    const auto frames = static_cast<std::size_t>(seconds * kSampleRate);
+
+    std::vector<std::vector<float>> streams;
+    streams.reserve(streamCount);
+    for (std::size_t i = 0; i < streamCount; ++i) {
+        streams.push_back(makeTone(82.41 * std::pow(2.0, static_cast<double>(i % 36) / 12.0), frames));
+    }
+
+    std::atomic<std::size_t> threadWindows{0};
+    std::atomic<std::size_t> asyncWindows{0};
+    const double threadSeconds = runThreadPerStream(streams, threadWindows);
+    const double asyncSeconds = runCoroutines(streams, asyncWindows);
+
+    std::printf("streams=%zu audio=%.1fs window=%zu hop=%zu workers=%u\n", streamCount, seconds, kWindow, kHop,
+                std::thread::hardware_concurrency());
+    std::printf("thread-per-stream: %8.3f s  %10.0f windows/s\n", threadSeconds,
+                static_cast<double>(threadWindows.load()) / threadSeconds);
+    std::printf("coroutines:        %8.3f s  %10.0f windows/s\n", asyncSeconds,
+                static_cast<double>(asyncWindows.load()) / asyncSeconds);
+    return 0;
+}
@@ -0,0 +1,75 @@
+// Compares YinPitchDetector::processFrames() against one processBuffer() call per
+// window for dense (hop well below window) offline pitch tracks.
+//
+// Build (from the repository root):
+//   c++ -std=c++20 -O2 -Inative/cpp native/bench/BatchedYinBenchmark.cpp
+//       native/cpp/YinPitchDetector.cpp native/cpp/DifferenceKernel.cpp -o batched_yin_bench
+//   ./batched_yin_bench [seconds] [window]
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+#include "YinPitchDetector.hpp"
+
+using namespace tine::dsp;
+
+namespace {
+
+constexpr double kSampleRate = 48000.0;
+
+std::vector<float> makeGlide(std::size_t frames) {
+    std::vector<float> samples(frames);
+    double phase = 0.0;
+    for (std::size_t i = 0; i < frames; ++i) {
+        const double frequency = 110.0 + 330.0 * static_cast<double>(i) / static_cast<double>(frames);
+        phase += 2.0 * M_PI * frequency / kSampleRate;
+        samples[i] = static_cast<float>(0.5 * std::sin(phase));
+    }
+    return samples;
+}
+
+double secondsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    const double seconds = argc > 1 ? std::atof(argv[1]) : 4.0;
+    const std::size_t window = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 2048;
+    const std::vector<float> samples = makeGlide(static_cast<std::size_t>(seconds * kSampleRate));
+    if (samples.size() < window) {
+        std::fprintf(stderr, "input shorter than one window\n");
+        return 1;
+    }
+
+    std::printf("window=%zu audio=%.1fs\n", window, seconds);
+    for (std::size_t hop = window / 32; hop <= window; hop *= 2) {
+        const std::size_t frames = (samples.size() - window) / hop + 1;
+        std::vector<PitchResult> single(frames);
+        std::vector<PitchResult> batched(frames);
+
+        YinPitchDetector a(kSampleRate, window);
+        auto start = std::chrono::steady_clock::now();
+        for (std::size_t k = 0; k < frames; ++k) {
+            single[k] = a.processBuffer(samples.data() + k * hop, window);
+        }
+        const double singleSeconds = secondsSince(start);
+
+        YinPitchDetector b(kSampleRate, window);
+        start = std::chrono::steady_clock::now();
+        b.processFrames(samples.data(), samples.size(), hop, batched.data(), frames);
+        const double batchedSeconds = secondsSince(start);
+
+        double worstHz = 0.0;
+        for (std::size_t k = 0; k < frames; ++k) {
+            worstHz = std::fmax(worstHz, std::fabs(single[k].frequency - batched[k].frequency));
+        }
+        std::printf("hop=%5zu frames=%6zu  processBuffer %7.1f ms  processFrames %7.1f ms  %5.1fx  max|df|=%.1e Hz\n",
+                    hop, frames, singleSeconds * 1e3, batchedSeconds * 1e3, singleSeconds / batchedSeconds, worstHz);
+    }
+    return 0;
+}
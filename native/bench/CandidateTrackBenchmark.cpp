@@ -0,0 +1,114 @@
+// Re-deriving an offline pitch track at several thresholds: full re-analysis
+// against decoding a CandidateTrack recorded once. Also checks the decoded
+// results match the detector's and that the sidecar survives a round trip.
+//
+// Build (from the repository root):
+//   c++ -std=c++20 -O2 -pthread -Inative/cpp native/bench/CandidateTrackBenchmark.cpp
+//       native/cpp/CandidateTrack.cpp native/cpp/AsyncStream.cpp native/cpp/AsyncScheduler.cpp
+//       native/cpp/ThreadPool.cpp native/cpp/ThreadConfig.cpp native/cpp/YinPitchDetector.cpp
+//       native/cpp/DifferenceKernel.cpp native/cpp/KernelAutotuner.cpp native/cpp/StreamScheduler.cpp
+//       native/cpp/Metrics.cpp -o candidate_track_bench
+//   ./candidate_track_bench [seconds] [window] [hop]
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+#include "CandidateTrack.hpp"
+
+using namespace tine::dsp;
+
+namespace {
+
+constexpr double kSampleRate = 48000.0;
+constexpr double kThresholds[] = {0.05, 0.1, 0.15, 0.2, 0.3, 0.5};
+
+// Half-second notes with three harmonics over a noise floor, every fourth one a rest.
+std::vector<float> makePhrase(std::size_t frames) {
+    std::mt19937 rng(7);
+    std::normal_distribution<double> noise(0.0, 0.02);
+    std::uniform_int_distribution<int> note(40, 84);
+    std::vector<float> samples(frames);
+    const auto noteFrames = static_cast<std::size_t>(0.5 * kSampleRate);
+    double phase = 0.0;
+    double frequency = 0.0;
+    for (std::size_t i = 0; i < frames; ++i) {
+        if (i % noteFrames == 0) {
+            const bool rest = (i / noteFrames) % 4 == 3;
+            frequency = rest ? 0.0 : 440.0 * std::pow(2.0, (note(rng) - 69) / 12.0);
+        }
+        phase += 2.0 * M_PI * frequency / kSampleRate;
+        const double tone = std::sin(phase) + 0.5 * std::sin(2.0 * phase) + 0.25 * std::sin(3.0 * phase);
+        samples[i] = static_cast<float>(0.3 * tone + noise(rng));
+    }
+    return samples;
+}
+
+double secondsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+bool sameResult(const PitchResult& a, const PitchResult& b) {
+    return a.isValid == b.isValid && a.frequency == b.frequency && a.probability == b.probability &&
+           a.noteName == b.noteName;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    const double seconds = argc > 1 ? std::atof(argv[1]) : 30.0;
+    const std::size_t window = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 2048;
+    const std::size_t hop = argc > 3 ? std::strtoul(argv[3], nullptr, 10) : 256;
+    const std::vector<float> samples = makePhrase(static_cast<std::size_t>(seconds * kSampleRate));
+    if (samples.size() < window || hop == 0) {
+        std::fprintf(stderr, "input shorter than one window\n");
+        return 1;
+    }
+    const std::size_t frames = (samples.size() - window) / hop + 1;
+    std::vector<PitchResult> results(frames);
+
+    CandidateTrack track;
+    track.info.sampleRate = kSampleRate;
+    track.info.windowSize = static_cast<std::uint32_t>(window);
+    track.info.hopSize = static_cast<std::uint32_t>(hop);
+    {
+        YinPitchDetector recorder(kSampleRate, window);
+        recorder.setCandidateLog(&track.log);
+        const auto start = std::chrono::steady_clock::now();
+        recorder.processFrames(samples.data(), samples.size(), hop, results.data(), frames);
+        std::printf("record: %.3f s for %zu frames\n", secondsSince(start), frames);
+    }
+
+    const std::string bytes = track.serialize();
+    CandidateTrack loaded;
+    if (!CandidateTrack::parse(bytes, loaded)) {
+        std::fprintf(stderr, "sidecar failed to parse\n");
+        return 1;
+    }
+    std::printf("sidecar: %zu bytes, %.1f candidates and %.1f bytes per frame\n", bytes.size(),
+                static_cast<double>(loaded.log.candidates.size()) / static_cast<double>(frames),
+                static_cast<double>(bytes.size()) / static_cast<double>(frames));
+
+    std::printf("%9s %12s %12s %9s %10s\n", "threshold", "reanalyze_s", "decode_s", "speedup", "mismatches");
+    for (double threshold : kThresholds) {
+        YinPitchDetector detector(kSampleRate, window, threshold);
+        auto start = std::chrono::steady_clock::now();
+        detector.processFrames(samples.data(), samples.size(), hop, results.data(), frames);
+        const double reanalyzeSeconds = secondsSince(start);
+
+        start = std::chrono::steady_clock::now();
+        const std::vector<PitchResult> decoded = loaded.decode(threshold);
+        const double decodeSeconds = secondsSince(start);
+
+        std::size_t mismatches = decoded.size() == frames ? 0 : frames;
+        for (std::size_t k = 0; k < frames && k < decoded.size(); ++k) {
+            mismatches += sameResult(results[k], decoded[k]) ? 0 : 1;
+        }
+        std::printf("%9.2f %12.4f %12.5f %8.0fx %10zu\n", threshold, reanalyzeSeconds, decodeSeconds,
+                    reanalyzeSeconds / decodeSeconds, mismatches);
+    }
+    return 0;
+}
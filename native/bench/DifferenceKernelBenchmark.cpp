@@ -0,0 +1,64 @@
+// Times each YIN difference kernel across window sizes to show where the
+// crossovers fall on this machine, then prints the wisdom file the autotuner
+// would persist for the same sizes.
+//
+// Build (from the repository root):
+//   c++ -std=c++20 -O2 -pthread -Inative/cpp native/bench/DifferenceKernelBenchmark.cpp
+//       native/cpp/DifferenceKernel.cpp native/cpp/KernelAutotuner.cpp -o difference_kernel_bench
+//   ./difference_kernel_bench [calls]
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+#include "DifferenceKernel.hpp"
+#include "KernelAutotuner.hpp"
+
+using namespace tine::dsp;
+
+namespace {
+
+constexpr std::size_t kWindows[] = {128, 256, 512, 1024, 2048, 4096, 8192};
+
+double secondsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    const int calls = argc > 1 ? std::max(1, std::atoi(argv[1])) : 50;
+    const std::size_t largest = kWindows[sizeof(kWindows) / sizeof(kWindows[0]) - 1];
+
+    std::vector<float> samples(largest);
+    for (std::size_t i = 0; i < samples.size(); ++i) {
+        samples[i] = static_cast<float>(0.5 * std::sin(2.0 * M_PI * 147.0 * static_cast<double>(i) / 48000.0));
+    }
+    std::vector<double> out(largest / 2 + 1);
+
+    DifferenceKernel kernel;
+    kernel.reserve(largest, DifferenceKernel::minimumFftSize(largest, largest / 2));
+
+    std::printf("%8s %12s %12s %12s   (us per call)\n", "window", "direct", "blocked", "fft");
+    std::vector<std::size_t> windows;
+    for (std::size_t window : kWindows) {
+        windows.push_back(window);
+        std::printf("%8zu", window);
+        for (DifferenceKernelKind kind :
+             {DifferenceKernelKind::Direct, DifferenceKernelKind::Blocked, DifferenceKernelKind::Fft}) {
+            kernel.compute({kind, 0}, samples.data(), window, window / 2, out.data());
+            const auto start = std::chrono::steady_clock::now();
+            for (int i = 0; i < calls; ++i) {
+                kernel.compute({kind, 0}, samples.data(), window, window / 2, out.data());
+            }
+            std::printf(" %12.1f", secondsSince(start) * 1e6 / calls);
+        }
+        std::printf("\n");
+    }
+
+    std::printf("\n%s", autotuneDifferenceKernels(windows).serialize().c_str());
+    return 0;
+}
@@ -0,0 +1,124 @@
+// Pitch error of each YinPitchDetector lag refinement against window size, on
+// harmonic tones with noise across the range the window can detect.
+//
+// Build (from the repository root):
+//   c++ -std=c++20 -O2 -Inative/cpp native/bench/LagRefinementBenchmark.cpp
+//       native/cpp/YinPitchDetector.cpp native/cpp/DifferenceKernel.cpp
+//       native/cpp/KernelAutotuner.cpp -o lag_refinement_bench
+//   ./lag_refinement_bench [trials] [snrDb]
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+#include "YinPitchDetector.hpp"
+
+using namespace tine::dsp;
+
+namespace {
+
+constexpr double kSampleRate = 48000.0;
+constexpr double kMaxFrequency = 2000.0;
+// Errors beyond this are octave or harmonic confusions, counted apart from accuracy.
+constexpr double kGrossErrorCents = 50.0;
+
+struct Case {
+    double frequency;
+    std::vector<float> samples;
+};
+
+// Five harmonics at 1/h amplitude with random phases, plus white noise.
+std::vector<Case> makeCases(std::size_t window, std::size_t trials, double snrDb, std::mt19937& rng) {
+    // Lowest pitch whose period leaves the detector a few lags of headroom.
+    const double minFrequency = kSampleRate / (0.45 * static_cast<double>(window));
+    std::uniform_real_distribution<double> logFrequency(std::log(minFrequency), std::log(kMaxFrequency));
+    std::uniform_real_distribution<double> phase(0.0, 2.0 * M_PI);
+    std::normal_distribution<double> noise(0.0, 1.0);
+
+    std::vector<Case> cases(trials);
+    for (Case& c : cases) {
+        c.frequency = std::exp(logFrequency(rng));
+        double phases[5];
+        for (double& p : phases) {
+            p = phase(rng);
+        }
+        double power = 0.0;
+        for (int h = 1; h <= 5; ++h) {
+            power += 0.5 / (h * h);
+        }
+        const double noiseScale = std::sqrt(power / std::pow(10.0, snrDb / 10.0));
+        c.samples.resize(window);
+        for (std::size_t i = 0; i < window; ++i) {
+            double value = 0.0;
+            for (int h = 1; h <= 5; ++h) {
+                value += std::sin(2.0 * M_PI * h * c.frequency * static_cast<double>(i) / kSampleRate + phases[h - 1]) / h;
+            }
+            c.samples[i] = static_cast<float>(0.3 * (value + noiseScale * noise(rng)));
+        }
+    }
+    return cases;
+}
+
+const char* name(LagRefinement refinement) {
+    switch (refinement) {
+        case LagRefinement::Parabolic:
+            return "parabolic";
+        case LagRefinement::Cubic:
+            return "cubic";
+        case LagRefinement::Sinc:
+            return "sinc";
+    }
+    return "?";
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    const std::size_t trials = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 2000;
+    const double snrDb = argc > 2 ? std::atof(argv[2]) : 30.0;
+    const LagRefinement refinements[] = {LagRefinement::Parabolic, LagRefinement::Cubic, LagRefinement::Sinc};
+
+    std::printf("trials=%zu snr=%.0f dB, pitch log-uniform up to %.0f Hz\n", trials, snrDb, kMaxFrequency);
+    std::printf("%6s %-10s %10s %10s %10s %8s %10s\n", "window", "refine", "mean|c|", "p95|c|", "max|c|", "gross",
+                "us/frame");
+    for (std::size_t window = 512; window <= 4096; window *= 2) {
+        std::mt19937 rng(static_cast<unsigned>(window));
+        const std::vector<Case> cases = makeCases(window, trials, snrDb, rng);
+        for (LagRefinement refinement : refinements) {
+            YinPitchDetector detector(kSampleRate, window, 0.15);
+            detector.setLagRefinement(refinement);
+
+            std::vector<double> errors;
+            errors.reserve(cases.size());
+            std::size_t gross = 0;
+            const auto start = std::chrono::steady_clock::now();
+            for (const Case& c : cases) {
+                const PitchResult result = detector.processBuffer(c.samples.data(), window);
+                const double cents = result.frequency > 0.0 ? std::fabs(1200.0 * std::log2(result.frequency / c.frequency))
+                                                            : INFINITY;
+                if (cents > kGrossErrorCents) {
+                    ++gross;
+                } else {
+                    errors.push_back(cents);
+                }
+            }
+            const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+            std::sort(errors.begin(), errors.end());
+            double mean = 0.0;
+            for (double e : errors) {
+                mean += e;
+            }
+            mean = errors.empty() ? 0.0 : mean / static_cast<double>(errors.size());
+            const double p95 = errors.empty() ? 0.0 : errors[static_cast<std::size_t>(0.95 * (errors.size() - 1))];
+            const double worst = errors.empty() ? 0.0 : errors.back();
+            std::printf("%6zu %-10s %10.4f %10.4f %10.4f %8zu %10.2f\n", window, name(refinement), mean, p95, worst,
+                        gross, seconds * 1e6 / static_cast<double>(cases.size()));
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,172 @@
+// Streaming alignment of a simulated singer to a reference melody. The singer
+// drifts between 0.75x and 1.25x tempo, holds each note a little off pitch with
+// vibrato, opens notes with unvoiced consonants and now and then jumps an
+// octave. Reports time per result and how close committed positions and scores
+// are to the known truth, for several band radii and commit lags, and once with
+// a capture dropout longer than the band.
+//
+// Build (from the repository root); GCC needs -O3 to vectorize the column
+// loops, Clang already does at -O2:
+//   c++ -std=c++20 -O3 -Inative/cpp native/bench/MelodyAlignerBenchmark.cpp
+//       native/cpp/MelodyAligner.cpp -o melody_aligner_bench
+//   ./melody_aligner_bench [notes]
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+#include "MelodyAligner.hpp"
+
+using namespace tine::dsp;
+
+namespace {
+
+constexpr double kSampleRate = 48000.0;
+constexpr std::size_t kHop = 512;
+constexpr double kHopSeconds = static_cast<double>(kHop) / kSampleRate;
+
+struct Truth {
+    double referenceSeconds{0.0};
+    std::uint32_t noteIndex{0};
+    /** NaN when the frame is not a voiced frame on a note. */
+    double deviationCents{NAN};
+};
+
+std::vector<MelodyNote> makeMelody(std::size_t count, std::mt19937& rng) {
+    std::uniform_int_distribution<int> interval(-4, 4);
+    std::uniform_int_distribution<int> beats(1, 4);
+    std::uniform_real_distribution<double> unit(0.0, 1.0);
+    std::vector<MelodyNote> melody;
+    int midi = 62;
+    for (std::size_t i = 0; i < count; ++i) {
+        if (i > 0 && unit(rng) < 0.08) {
+            melody.push_back(MelodyNote{-1.0, 0.25 * beats(rng)});
+        }
+        midi = std::clamp(midi + interval(rng), 55, 76);
+        melody.push_back(MelodyNote{static_cast<double>(midi), 0.25 * beats(rng)});
+    }
+    return melody;
+}
+
+// One result per hop until the singer reaches the end of the melody.
+void sing(const std::vector<MelodyNote>& melody, std::mt19937& rng, std::vector<PitchResult>& results,
+          std::vector<Truth>& truth) {
+    std::vector<double> starts;
+    double total = 0.0;
+    for (const MelodyNote& note : melody) {
+        starts.push_back(total);
+        total += note.seconds;
+    }
+    std::normal_distribution<double> noteOffset(0.0, 15.0);
+    std::normal_distribution<double> jitter(0.0, 3.0);
+    std::uniform_real_distribution<double> unit(0.0, 1.0);
+    std::vector<double> offsets(melody.size());
+    std::vector<double> octaves(melody.size());
+    for (std::size_t i = 0; i < melody.size(); ++i) {
+        offsets[i] = noteOffset(rng);
+        octaves[i] = unit(rng) < 0.03 ? 1200.0 : 0.0;
+    }
+
+    double position = 0.0;
+    double time = 0.0;
+    std::size_t note = 0;
+    while (position < total) {
+        while (note + 1 < melody.size() && starts[note + 1] <= position) {
+            ++note;
+        }
+        Truth frame;
+        frame.referenceSeconds = position;
+        frame.noteIndex = static_cast<std::uint32_t>(note);
+        PitchResult result;
+        const bool consonant = position - starts[note] < 0.06 && note % 3 == 0;
+        if (melody[note].midi >= 0.0 && !consonant) {
+            const double deviation =
+                offsets[note] + 20.0 * std::sin(2.0 * M_PI * 5.5 * time) + jitter(rng);
+            const double sung = 100.0 * melody[note].midi + deviation + octaves[note];
+            result.isValid = true;
+            result.frequency = 440.0 * std::pow(2.0, (sung - 6900.0) / 1200.0);
+            frame.deviationCents = deviation;
+        }
+        results.push_back(result);
+        truth.push_back(frame);
+        time += kHopSeconds;
+        position += kHopSeconds * (1.0 + 0.25 * std::sin(2.0 * M_PI * time / 20.0));
+    }
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    const std::size_t notes = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 400;
+    std::mt19937 rng(11);
+    const std::vector<MelodyNote> melody = makeMelody(notes, rng);
+    std::vector<PitchResult> results;
+    std::vector<Truth> truth;
+    sing(melody, rng, results, truth);
+
+    double trueAbsCents = 0.0;
+    std::size_t trueScored = 0;
+    for (const Truth& frame : truth) {
+        if (!std::isnan(frame.deviationCents)) {
+            trueAbsCents += std::fabs(frame.deviationCents);
+            ++trueScored;
+        }
+    }
+    std::printf("%zu notes, %zu results (%.0f s); true mean |deviation| %.2f cents\n", melody.size(), results.size(),
+                static_cast<double>(results.size()) * kHopSeconds, trueAbsCents / static_cast<double>(trueScored));
+    std::printf("%8s %6s %10s %12s %14s %12s %16s\n", "radius_s", "lag_s", "dropout_s", "ns/result", "mean_err_ms",
+                "note_match", "mean_|dev|_cents");
+
+    struct Run {
+        double radius;
+        double lag;
+        double dropout;
+    };
+    for (const Run& run : {Run{1.0, 0.5, 0.0}, Run{2.0, 0.0, 0.0}, Run{2.0, 0.25, 0.0}, Run{2.0, 0.5, 0.0},
+                           Run{4.0, 0.5, 0.0}, Run{2.0, 0.5, 10.0}}) {
+        const double radius = run.radius;
+        const double lag = run.lag;
+        // Results lost mid-song, as when the app is backgrounded.
+        const std::size_t dropFrom = results.size() / 2;
+        const auto dropTo = dropFrom + static_cast<std::size_t>(run.dropout / kHopSeconds);
+        MelodyAlignerConfig config;
+        config.sampleRate = kSampleRate;
+        config.hopSize = kHop;
+        config.melody = melody;
+        config.bandRadiusSeconds = radius;
+        config.lagSeconds = lag;
+        config.queueCapacity = results.size() + 1;
+        MelodyAligner aligner(config);
+
+        const auto start = std::chrono::steady_clock::now();
+        for (std::size_t i = 0; i < results.size(); ++i) {
+            if (i < dropFrom || i >= dropTo) {
+                aligner.process(results[i], static_cast<std::uint64_t>(i) * kHop);
+            }
+        }
+        aligner.finish();
+        const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        double error = 0.0;
+        std::size_t matched = 0;
+        std::size_t aligned = 0;
+        AlignedFrame frame;
+        while (aligner.pop(frame)) {
+            const Truth& expected = truth[frame.sampleTime / kHop];
+            error += std::fabs(frame.referenceSeconds - expected.referenceSeconds);
+            matched += frame.noteIndex == expected.noteIndex ? 1 : 0;
+            ++aligned;
+        }
+        const AlignmentScore score = aligner.score();
+        std::printf("%8.1f %6.2f %10.1f %12.0f %14.1f %11.1f%% %16.2f\n", radius, lag, run.dropout,
+                    1e9 * seconds / static_cast<double>(results.size()),
+                    aligned > 0 ? 1e3 * error / static_cast<double>(aligned) : 0.0,
+                    aligned > 0 ? 100.0 * static_cast<double>(matched) / static_cast<double>(aligned) : 0.0,
+                    score.meanAbsCents());
+    }
+    return 0;
+}
@@ -0,0 +1,159 @@
+// Batch analysis of a set of uploads with and without a PitchTrackCache. The set
+// mixes unique takes, exact duplicates and takes that repeat another's opening,
+// and is analyzed twice, the second time at another threshold. Reports wall
+// time, hit rate and whether cached results match uncached ones.
+//
+// Build (from the repository root):
+//   c++ -std=c++20 -O2 -pthread -Inative/cpp native/bench/PitchTrackCacheBenchmark.cpp
+//       native/cpp/PitchTrackCache.cpp native/cpp/CandidateTrack.cpp native/cpp/AsyncStream.cpp
+//       native/cpp/AsyncScheduler.cpp native/cpp/ThreadPool.cpp native/cpp/ThreadConfig.cpp
+//       native/cpp/YinPitchDetector.cpp native/cpp/DifferenceKernel.cpp native/cpp/KernelAutotuner.cpp
+//       native/cpp/StreamScheduler.cpp native/cpp/Metrics.cpp -o pitch_track_cache_bench
+//   ./pitch_track_cache_bench [cacheDirectory] [uploads] [seconds]
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+#include "AsyncScheduler.hpp"
+#include "PitchTrackCache.hpp"
+
+using namespace tine::dsp;
+
+namespace {
+
+constexpr double kSampleRate = 48000.0;
+
+std::vector<float> makeTake(unsigned seed, std::size_t frames) {
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<double> pitch(80.0, 900.0);
+    std::normal_distribution<double> noise(0.0, 0.01);
+    std::vector<float> samples(frames);
+    double phase = 0.0;
+    double frequency = pitch(rng);
+    for (std::size_t i = 0; i < frames; ++i) {
+        if (i % 12000 == 0) {
+            frequency = pitch(rng);
+        }
+        phase += 2.0 * M_PI * frequency / kSampleRate;
+        samples[i] = static_cast<float>(0.4 * std::sin(phase) + 0.1 * std::sin(2.0 * phase) + noise(rng));
+    }
+    return samples;
+}
+
+// Every third upload duplicates an earlier one; every third keeps an earlier
+// one's first half and continues differently.
+std::vector<std::vector<float>> makeUploads(std::size_t count, std::size_t frames) {
+    std::vector<std::vector<float>> uploads;
+    for (std::size_t i = 0; i < count; ++i) {
+        if (i >= 3 && i % 3 == 1) {
+            uploads.push_back(uploads[i - 3]);
+        } else if (i >= 3 && i % 3 == 2) {
+            std::vector<float> take = makeTake(static_cast<unsigned>(1000 + i), frames);
+            std::copy(uploads[i - 2].begin(), uploads[i - 2].begin() + frames / 2, take.begin());
+            uploads.push_back(std::move(take));
+        } else {
+            uploads.push_back(makeTake(static_cast<unsigned>(i), frames));
+        }
+    }
+    return uploads;
+}
+
+Task<void> analyzeOne(AsyncContext& context,
+                      const std::vector<float>& samples,
+                      StreamAnalysisConfig config,
+                      PitchTrackCache* cache,
+                      std::vector<PitchResult>& results) {
+    MemoryStreamSource source(samples.data(), samples.size());
+    auto sink = [&results](std::size_t, const PitchResult& result) { results.push_back(result); };
+    if (cache) {
+        co_await analyzeStreamCached(context, source, config, *cache, sink);
+    } else {
+        co_await analyzeStream(context, source, config, sink);
+    }
+}
+
+double run(const std::vector<std::vector<float>>& uploads,
+           const StreamAnalysisConfig& config,
+           PitchTrackCache* cache,
+           std::vector<std::vector<PitchResult>>& results) {
+    AsyncScheduler scheduler;
+    AsyncContext context{scheduler, nullptr};
+    results.assign(uploads.size(), {});
+    const auto start = std::chrono::steady_clock::now();
+    // One upload at a time, so duplicates find their original already stored.
+    for (std::size_t i = 0; i < uploads.size(); ++i) {
+        WaitGroup group;
+        spawn(scheduler, analyzeOne(context, uploads[i], config, cache, results[i]), &group);
+        group.wait();
+    }
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+// processFrames() groups windows differently with and without the cache, so
+// frequencies may differ in the last bits; count validity flips and drifts above 1e-6 cent.
+std::size_t mismatches(const std::vector<std::vector<PitchResult>>& a, const std::vector<std::vector<PitchResult>>& b) {
+    std::size_t count = 0;
+    for (std::size_t i = 0; i < a.size(); ++i) {
+        if (a[i].size() != b[i].size()) {
+            count += std::max(a[i].size(), b[i].size());
+            continue;
+        }
+        for (std::size_t k = 0; k < a[i].size(); ++k) {
+            const PitchResult& x = a[i][k];
+            const PitchResult& y = b[i][k];
+            const double cents = x.frequency > 0.0 && y.frequency > 0.0
+                                     ? std::fabs(1200.0 * std::log2(x.frequency / y.frequency))
+                                     : (x.frequency == y.frequency ? 0.0 : INFINITY);
+            count += x.isValid == y.isValid && cents <= 1e-6 ? 0 : 1;
+        }
+    }
+    return count;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    const std::string directory = argc > 1 ? argv[1] : "pitch_track_cache";
+    const std::size_t count = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 12;
+    const double seconds = argc > 3 ? std::atof(argv[3]) : 10.0;
+    const std::vector<std::vector<float>> uploads =
+        makeUploads(count, static_cast<std::size_t>(seconds * kSampleRate));
+
+    StreamAnalysisConfig config;
+    config.sampleRate = kSampleRate;
+    config.windowSize = 2048;
+    config.hopSize = 256;
+
+    PitchTrackCacheConfig cacheConfig;
+    cacheConfig.directory = directory;
+    cacheConfig.chunkWindows = 128;
+    PitchTrackCache cache(cacheConfig);
+    cache.clear();
+
+    std::printf("%zu uploads of %.0fs, window %zu hop %zu, chunk %zu windows\n", count, seconds, config.windowSize,
+                config.hopSize, cacheConfig.chunkWindows);
+    std::printf("%-26s %9s %9s %10s\n", "pass", "seconds", "hit_rate", "mismatches");
+    for (double threshold : {0.1, 0.2}) {
+        config.threshold = threshold;
+        std::vector<std::vector<PitchResult>> plain;
+        std::vector<std::vector<PitchResult>> cached;
+        const double plainSeconds = run(uploads, config, nullptr, plain);
+        const PitchTrackCacheStats before = cache.stats();
+        const double cachedSeconds = run(uploads, config, &cache, cached);
+        const PitchTrackCacheStats after = cache.stats();
+        const auto hits = static_cast<double>(after.hits - before.hits);
+        const auto lookups = hits + static_cast<double>(after.misses - before.misses);
+
+        std::printf("threshold %.1f uncached      %9.3f %9s %10s\n", threshold, plainSeconds, "-", "-");
+        std::printf("threshold %.1f cached        %9.3f %8.0f%% %10zu\n", threshold, cachedSeconds,
+                    lookups > 0 ? 100.0 * hits / lookups : 0.0, mismatches(plain, cached));
+    }
+    const PitchTrackCacheStats stats = cache.stats();
+    std::printf("store: %llu entries, %.1f MiB, %llu evictions\n", static_cast<unsigned long long>(stats.entries),
+                static_cast<double>(stats.bytes) / (1 << 20), static_cast<unsigned long long>(stats.evictions));
+    return 0;
+}
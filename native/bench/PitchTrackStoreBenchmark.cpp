@@ -0,0 +1,140 @@
+// Range aggregation over a long session: a PitchTrackStore filled with about
+// three hours of results answers random range queries by scanning the frames
+// and through its index, in memory and from a saved, mapped file. Reports time
+// per query and whether the index agrees with the scan.
+//
+// Build (from the repository root):
+//   c++ -std=c++20 -O2 -Inative/cpp native/bench/PitchTrackStoreBenchmark.cpp
+//       native/cpp/PitchTrackStore.cpp -o pitch_track_store_bench
+//   ./pitch_track_store_bench [trackFile] [hours] [queries]
+//
+// Without trackFile the track (about 13 MB at three hours) goes to the system
+// temporary directory and is removed afterwards.
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "PitchTrackStore.hpp"
+
+using namespace tine::dsp;
+
+namespace {
+
+constexpr double kSampleRate = 48000.0;
+constexpr std::size_t kHop = 512;
+
+TrackAggregate scan(const PitchTrackView& view, std::size_t begin, std::size_t end) {
+    TrackAggregate total;
+    for (std::size_t i = begin; i < std::min(end, view.frameCount); ++i) {
+        total.add(view.frames[i]);
+    }
+    return total;
+}
+
+bool agrees(const TrackAggregate& a, const TrackAggregate& b) {
+    const auto close = [](double x, double y) { return std::fabs(x - y) <= 1e-6 * std::max(1.0, std::fabs(x)); };
+    return a.frames == b.frames && a.validFrames == b.validFrames && close(a.sumCents, b.sumCents) &&
+           close(a.sumSquaredCents, b.sumSquaredCents) && a.minCents == b.minCents && a.maxCents == b.maxCents &&
+           a.minFrequency == b.minFrequency && a.maxFrequency == b.maxFrequency;
+}
+
+template <typename Query>
+double perQueryMicros(const std::vector<std::pair<std::size_t, std::size_t>>& ranges, Query&& query, double& sink) {
+    const auto start = std::chrono::steady_clock::now();
+    for (const auto& [begin, end] : ranges) {
+        sink += query(begin, end).meanCents();
+    }
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return 1e6 * seconds / static_cast<double>(ranges.size());
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    const bool temporary = argc <= 1;
+    const std::string path =
+        temporary ? (std::filesystem::temp_directory_path() / "tine_pitch_track_bench.bin").string() : argv[1];
+    const double hours = argc > 2 ? std::atof(argv[2]) : 3.0;
+    const std::size_t queries = argc > 3 ? std::strtoul(argv[3], nullptr, 10) : 2000;
+    const auto frames = static_cast<std::size_t>(hours * 3600.0 * kSampleRate / kHop);
+
+    PitchTrackStoreConfig config;
+    config.sampleRate = kSampleRate;
+    config.hopSize = kHop;
+    config.capacityFrames = frames;
+    PitchTrackStore store(config);
+
+    // Phrases of a held note with drift, separated by silence and the odd dropped hop.
+    std::mt19937 rng(7);
+    std::uniform_real_distribution<double> note(45.0, 80.0);
+    std::normal_distribution<double> drift(0.0, 8.0);
+    std::uint64_t sampleTime = 0;
+    double midi = note(rng);
+    const auto fillStart = std::chrono::steady_clock::now();
+    for (std::size_t i = 0; store.view().frameCount < frames; ++i) {
+        if (i % 400 == 0) {
+            midi = note(rng);
+        }
+        PitchResult result;
+        result.isValid = i % 400 < 320;
+        result.cents = drift(rng);
+        result.frequency = 440.0 * std::pow(2.0, (midi - 69.0 + result.cents / 100.0) / 12.0);
+        store.append(result, sampleTime);
+        sampleTime += i % 997 == 0 ? 2 * kHop : kHop;
+    }
+    const double fillSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - fillStart).count();
+    if (!store.save(path)) {
+        std::fprintf(stderr, "cannot write %s\n", path.c_str());
+        return 1;
+    }
+    MappedPitchTrack mapped;
+    if (!mapped.open(path)) {
+        std::fprintf(stderr, "cannot map %s\n", path.c_str());
+        return 1;
+    }
+
+    const PitchTrackView view = store.view();
+    std::printf("%zu frames (%.2f h), append %.1f ns/frame\n", view.frameCount, view.durationSeconds() / 3600.0,
+                1e9 * fillSeconds / static_cast<double>(view.frameCount));
+
+    std::uniform_int_distribution<std::size_t> position(0, view.frameCount);
+    std::vector<std::pair<std::size_t, std::size_t>> ranges(queries);
+    for (auto& [begin, end] : ranges) {
+        begin = position(rng);
+        end = position(rng);
+        if (begin > end) {
+            std::swap(begin, end);
+        }
+    }
+
+    std::size_t disagreements = 0;
+    for (const auto& [begin, end] : ranges) {
+        const TrackAggregate expected = scan(view, begin, end);
+        disagreements += agrees(expected, view.queryFrames(begin, end)) ? 0 : 1;
+        disagreements += agrees(expected, mapped.view().queryFrames(begin, end)) ? 0 : 1;
+    }
+
+    double sink = 0.0;
+    const double scanMicros =
+        perQueryMicros(ranges, [&](std::size_t b, std::size_t e) { return scan(view, b, e); }, sink);
+    const double indexMicros =
+        perQueryMicros(ranges, [&](std::size_t b, std::size_t e) { return view.queryFrames(b, e); }, sink);
+    const double mappedMicros =
+        perQueryMicros(ranges, [&](std::size_t b, std::size_t e) { return mapped.view().queryFrames(b, e); }, sink);
+
+    std::printf("%-10s %14s\n", "method", "us/query");
+    std::printf("%-10s %14.2f\n", "scan", scanMicros);
+    std::printf("%-10s %14.3f\n", "index", indexMicros);
+    std::printf("%-10s %14.3f\n", "mapped", mappedMicros);
+    std::printf("disagreements: %zu of %zu (checksum %.3f)\n", disagreements, 2 * ranges.size(), sink);
+    if (temporary) {
+        std::filesystem::remove(path);
+    }
+    return 0;
+}
@@ -0,0 +1,230 @@
+// Mixed live and batch load on a small worker pool, with and without a
+// StreamScheduler. Live streams are fed in real time through AsyncRingBuffers;
+// batch streams analyze in-memory files with large batched steps. Reports
+// live result latency (hop written to result delivered) and batch throughput,
+// then how admission control answers a growing number of live streams.
+//
+// Build (from the repository root):
+//   c++ -std=c++20 -O2 -pthread -Inative/cpp native/bench/StreamSchedulerBenchmark.cpp
+//       native/cpp/StreamScheduler.cpp native/cpp/Metrics.cpp native/cpp/AsyncStream.cpp
+//       native/cpp/AsyncScheduler.cpp native/cpp/ThreadPool.cpp native/cpp/ThreadConfig.cpp
+//       native/cpp/YinPitchDetector.cpp native/cpp/DifferenceKernel.cpp native/cpp/KernelAutotuner.cpp
+//       -o stream_scheduler_bench
+//   ./stream_scheduler_bench [workers] [liveStreams] [batchStreams] [seconds]
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "AsyncScheduler.hpp"
+#include "AsyncStream.hpp"
+#include "StreamScheduler.hpp"
+
+using namespace tine::dsp;
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+constexpr double kSampleRate = 48000.0;
+constexpr std::size_t kLiveWindow = 2048;
+constexpr std::size_t kLiveHop = 512;
+constexpr double kBatchSeconds = 10.0;
+
+std::vector<float> makeTone(double frequency, std::size_t frames) {
+    std::vector<float> samples(frames);
+    for (std::size_t i = 0; i < frames; ++i) {
+        const double phase = 2.0 * M_PI * frequency * static_cast<double>(i) / kSampleRate;
+        samples[i] = static_cast<float>(0.4 * std::sin(phase) + 0.1 * std::sin(2.0 * phase));
+    }
+    return samples;
+}
+
+struct LiveStream {
+    std::unique_ptr<AsyncRingBuffer> ring;
+    /** Write time of each hop, indexed by hop. */
+    std::vector<Clock::time_point> written;
+    std::unique_ptr<ScheduledStream> slot;
+};
+
+struct RunResult {
+    MetricHistogram::Summary latency;
+    double batchAudioSecondsPerSecond{0.0};
+    /** Measured live compute seconds per audio second (scheduled runs only). */
+    double liveCost{0.0};
+};
+
+Task<void> runLive(AsyncContext& context, LiveStream& live, StreamAnalysisConfig config, MetricHistogram& latency) {
+    auto sink = [&live, &latency](std::size_t startFrame, const PitchResult&) {
+        const std::size_t hop = (startFrame + kLiveWindow) / kLiveHop - 1;
+        const auto elapsed = Clock::now() - live.written[hop];
+        const auto nanoseconds = std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count();
+        latency.record(static_cast<std::uint64_t>(nanoseconds));
+    };
+    co_await analyzeRing(context, *live.ring, config, sink);
+}
+
+// A file that never ends before the live streams do: loops its samples until stopped.
+class LoopingSource final : public AudioStreamSource {
+public:
+    LoopingSource(const std::vector<float>& samples, const std::atomic<bool>& running) noexcept
+        : m_samples(samples), m_running(running) {}
+
+    StreamStatus read(float* dst, std::size_t frames, std::size_t& framesRead) override {
+        framesRead = 0;
+        if (!m_running.load(std::memory_order_relaxed)) {
+            return StreamStatus::EndOfStream;
+        }
+        while (framesRead < frames) {
+            const std::size_t chunk = std::min(frames - framesRead, m_samples.size() - m_position);
+            std::copy_n(m_samples.data() + m_position, chunk, dst + framesRead);
+            framesRead += chunk;
+            m_position = (m_position + chunk) % m_samples.size();
+        }
+        return StreamStatus::Ok;
+    }
+
+private:
+    const std::vector<float>& m_samples;
+    const std::atomic<bool>& m_running;
+    std::size_t m_position{0};
+};
+
+Task<void> runBatch(AsyncContext& context,
+                    const std::vector<float>& samples,
+                    StreamAnalysisConfig config,
+                    std::atomic<std::size_t>& frames,
+                    const std::atomic<bool>& running) {
+    LoopingSource source(samples, running);
+    auto sink = [&frames, &config](std::size_t, const PitchResult&) {
+        frames.fetch_add(config.hopSize, std::memory_order_relaxed);
+    };
+    co_await analyzeStream(context, source, config, sink);
+}
+
+RunResult run(std::size_t workers, std::size_t liveCount, std::size_t batchCount, double seconds, bool scheduled) {
+    ThreadPoolConfig poolConfig;
+    poolConfig.normalWorkers = workers;
+    ThreadPool pool(poolConfig);
+    AsyncScheduler scheduler(pool);
+    AsyncContext context{scheduler, nullptr};
+    StreamScheduler streams(scheduler);
+
+    const std::vector<float> batchAudio = makeTone(220.0, static_cast<std::size_t>(kBatchSeconds * kSampleRate));
+    const std::vector<float> liveAudio = makeTone(330.0, kLiveHop);
+    const auto hops = static_cast<std::size_t>(seconds * kSampleRate / kLiveHop);
+
+    MetricHistogram latency;
+    std::atomic<std::size_t> batchFrames{0};
+    std::atomic<bool> running{true};
+    WaitGroup liveGroup;
+    WaitGroup batchGroup;
+
+    std::vector<LiveStream> live(liveCount);
+    for (LiveStream& stream : live) {
+        stream.ring = std::make_unique<AsyncRingBuffer>(scheduler, 1 << 16);
+        stream.written.resize(hops);
+        StreamAnalysisConfig config;
+        config.sampleRate = kSampleRate;
+        config.windowSize = kLiveWindow;
+        config.hopSize = kLiveHop;
+        if (scheduled) {
+            stream.slot = streams.admit(StreamClass::Live).stream;
+            config.stream = stream.slot.get();
+        }
+        spawn(scheduler, runLive(context, stream, config, latency), &liveGroup);
+    }
+
+    std::vector<std::unique_ptr<ScheduledStream>> batchSlots;
+    for (std::size_t i = 0; i < batchCount; ++i) {
+        StreamAnalysisConfig config;
+        config.sampleRate = kSampleRate;
+        config.windowSize = 4096;
+        config.hopSize = 256;
+        config.batchFrames = 64;
+        if (scheduled) {
+            batchSlots.push_back(streams.admit(StreamClass::Batch).stream);
+            config.stream = batchSlots.back().get();
+        }
+        spawn(scheduler, runBatch(context, batchAudio, config, batchFrames, running), &batchGroup);
+    }
+
+    // One feeder paces every live stream at the capture rate.
+    const auto start = Clock::now();
+    const auto hopDuration = std::chrono::duration<double>(static_cast<double>(kLiveHop) / kSampleRate);
+    for (std::size_t hop = 0; hop < hops; ++hop) {
+        std::this_thread::sleep_until(start + std::chrono::duration_cast<Clock::duration>(hopDuration * hop));
+        for (LiveStream& stream : live) {
+            stream.written[hop] = Clock::now();
+            stream.ring->write(liveAudio.data(), kLiveHop);
+        }
+    }
+    for (LiveStream& stream : live) {
+        stream.ring->close();
+    }
+    liveGroup.wait();
+    const double elapsed = std::chrono::duration<double>(Clock::now() - start).count();
+    const std::size_t analyzed = batchFrames.load();
+    running.store(false);
+    batchGroup.wait();
+
+    RunResult result;
+    result.latency = latency.summarize({0.5, 0.99});
+    result.batchAudioSecondsPerSecond = static_cast<double>(analyzed) / kSampleRate / elapsed;
+    result.liveCost = streams.stats().live.cost;
+    return result;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    const std::size_t workers = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 4;
+    const std::size_t liveCount = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 8;
+    const std::size_t batchCount = argc > 3 ? std::strtoul(argv[3], nullptr, 10) : 16;
+    const double seconds = argc > 4 ? std::atof(argv[4]) : 5.0;
+
+    std::printf("%zu workers, %zu live streams (hop %zu), %zu batch streams, %.0f s\n", workers, liveCount, kLiveHop,
+                batchCount, seconds);
+    std::printf("%-12s %10s %10s %10s %18s\n", "mode", "live_p50", "live_p99", "live_max", "batch_audio_s/s");
+    double liveCost = 0.0;
+    for (bool scheduled : {false, true}) {
+        const RunResult result = run(workers, liveCount, batchCount, seconds, scheduled);
+        std::printf("%-12s %8.2fms %8.2fms %8.2fms %18.1f\n", scheduled ? "scheduled" : "yield-only",
+                    1e-6 * static_cast<double>(result.latency.quantiles[0].second),
+                    1e-6 * static_cast<double>(result.latency.quantiles[1].second),
+                    1e-6 * static_cast<double>(result.latency.max), result.batchAudioSecondsPerSecond);
+        liveCost = result.liveCost;
+    }
+
+    // Admission: starting from the live cost measured above, ask for more and more live streams.
+    ThreadPoolConfig poolConfig;
+    poolConfig.normalWorkers = workers;
+    ThreadPool pool(poolConfig);
+    AsyncScheduler scheduler(pool);
+    StreamSchedulerConfig config;
+    config.initialCost = liveCost;
+    StreamScheduler streams(scheduler, config);
+    std::vector<std::unique_ptr<ScheduledStream>> admitted;
+    std::size_t accepted = 0;
+    std::size_t degraded = 0;
+    std::size_t rejected = 0;
+    for (std::size_t i = 0; i < 200; ++i) {
+        StreamAdmission admission = streams.admit(StreamClass::Live);
+        accepted += admission.verdict == AdmissionVerdict::Accepted ? 1 : 0;
+        degraded += admission.verdict == AdmissionVerdict::Degraded ? 1 : 0;
+        rejected += admission.verdict == AdmissionVerdict::Rejected ? 1 : 0;
+        if (admission.stream) {
+            admitted.push_back(std::move(admission.stream));
+        }
+    }
+    const StreamSchedulerStats stats = streams.stats();
+    std::printf("admission at %.4f cost/audio-s on %zu workers: %zu accepted, %zu degraded, %zu rejected, load %.2f\n",
+                config.initialCost, stats.concurrency, accepted, degraded, rejected, stats.liveLoad);
+    return 0;
+}
@@ -0,0 +1,95 @@
+// Measures ThreadPool per-task overhead, submitted from outside the pool and
+// fanned out from a worker, to size tasks that stay profitable.
+//
+// Build (from the repository root):
+//   c++ -std=c++20 -O2 -pthread -Inative/cpp native/bench/ThreadPoolBenchmark.cpp
+//       native/cpp/ThreadPool.cpp native/cpp/ThreadConfig.cpp -o thread_pool_bench
+//   ./thread_pool_bench [tasks]
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+#include <vector>
+
+#include "ThreadPool.hpp"
+
+using namespace tine::dsp;
+
+namespace {
+
+struct CountingTask : PoolTask {
+    std::atomic<std::size_t>* counter{nullptr};
+};
+
+void countInvoke(PoolTask* self) {
+    static_cast<CountingTask*>(self)->counter->fetch_add(1, std::memory_order_relaxed);
+}
+
+double nanosPerTask(std::chrono::steady_clock::time_point start, std::size_t tasks) {
+    const auto elapsed = std::chrono::steady_clock::now() - start;
+    return std::chrono::duration<double, std::nano>(elapsed).count() / static_cast<double>(tasks);
+}
+
+void waitFor(const std::atomic<std::size_t>& counter, std::size_t target) {
+    while (counter.load(std::memory_order_acquire) < target) {
+        std::this_thread::yield();
+    }
+}
+
+double externalSubmit(ThreadPool& pool, std::vector<CountingTask>& tasks) {
+    std::atomic<std::size_t> counter{0};
+    for (CountingTask& task : tasks) {
+        task.counter = &counter;
+        task.invoke = countInvoke;
+    }
+    const auto start = std::chrono::steady_clock::now();
+    for (CountingTask& task : tasks) {
+        pool.submit(&task);
+    }
+    waitFor(counter, tasks.size());
+    return nanosPerTask(start, tasks.size());
+}
+
+struct FanOutTask : PoolTask {
+    ThreadPool* pool{nullptr};
+    std::vector<CountingTask>* children{nullptr};
+};
+
+double workerSubmit(ThreadPool& pool, std::vector<CountingTask>& tasks) {
+    std::atomic<std::size_t> counter{0};
+    for (CountingTask& task : tasks) {
+        task.counter = &counter;
+        task.invoke = countInvoke;
+    }
+
+    FanOutTask root;
+    root.pool = &pool;
+    root.children = &tasks;
+    root.invoke = [](PoolTask* self) {
+        auto* fan = static_cast<FanOutTask*>(self);
+        for (CountingTask& child : *fan->children) {
+            fan->pool->submit(&child);
+        }
+    };
+
+    const auto start = std::chrono::steady_clock::now();
+    pool.submit(&root);
+    waitFor(counter, tasks.size());
+    return nanosPerTask(start, tasks.size());
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    const std::size_t taskCount = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 200000;
+
+    ThreadPool& pool = ThreadPool::shared();
+    std::vector<CountingTask> tasks(taskCount);
+
+    std::printf("workers=%zu tasks=%zu\n", pool.workerCount(TaskPriority::Normal), taskCount);
+    std::printf("external submit: %8.1f ns/task\n", externalSubmit(pool, tasks));
+    std::printf("worker submit:   %8.1f ns/task\n", workerSubmit(pool, tasks));
+    return 0;
+}
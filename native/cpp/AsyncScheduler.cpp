@@ -0,0 +1,16 @@
+#include "AsyncScheduler.hpp"
+
+namespace tine::dsp {
+
+void AsyncScheduler::schedule(std::coroutine_handle<> handle) {
+    if (!handle) {
+        return;
+    }
+    // A rejected handle means the pool is shutting down; running it inline lets the
+    // coroutine observe its closed inputs and finish instead of leaking its frame.
+    if (!m_pool.submit(handle, m_priority)) {
+        handle.resume();
+    }
+}
+
+}  // namespace tine::dsp
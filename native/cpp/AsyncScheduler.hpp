@@ -0,0 +1,72 @@
+#ifndef TINE_NATIVE_ASYNC_ASYNCSCHEDULER_HPP
+#define TINE_NATIVE_ASYNC_ASYNCSCHEDULER_HPP
+
+#include <coroutine>
+#include <cstddef>
+
+#include "ThreadPool.hpp"
+
+namespace tine::dsp {
+
+/**
+ * Resumes coroutine handles on the shared work-stealing ThreadPool.
+ *
+ * Handles scheduled from a pool worker go to that worker's deque (LIFO for cache
+ * locality); idle workers steal from the opposite end. The scheduler owns no
+ * threads, so any number of them can coexist without oversubscribing cores.
+ */
+class AsyncScheduler {
+public:
+    explicit AsyncScheduler(ThreadPool& pool = ThreadPool::shared(),
+                            TaskPriority priority = TaskPriority::Normal) noexcept
+        : m_pool(pool), m_priority(priority) {}
+
+    AsyncScheduler(const AsyncScheduler&) = delete;
+    AsyncScheduler& operator=(const AsyncScheduler&) = delete;
+
+    /**
+     * Queue @p handle for resumption on one of the pool workers. For wake-ups from
+     * outside the coroutine (producers, the reactor); awaiters use trySchedule().
+     */
+    void schedule(std::coroutine_handle<> handle);
+
+    /**
+     * Queue @p handle unless the pool is shutting down.
+     * @return false if the pool refused it; the caller still owns the handle.
+     */
+    [[nodiscard]] bool trySchedule(std::coroutine_handle<> handle) { return m_pool.submit(handle, m_priority); }
+
+    /**
+     * Queue @p handle behind everything already waiting for the pool, even from a
+     * worker (see ThreadPool::post()).
+     * @return false if the pool refused it; the caller still owns the handle.
+     */
+    [[nodiscard]] bool post(std::coroutine_handle<> handle) { return m_pool.post(handle, m_priority); }
+
+    /**
+     * Awaitable that reschedules the awaiting coroutine onto the pool. Used to hop
+     * onto a worker from a foreign thread and to yield between analysis steps.
+     */
+    [[nodiscard]] auto yield() noexcept {
+        struct Awaiter {
+            AsyncScheduler& scheduler;
+            bool await_ready() const noexcept { return false; }
+            // Refused during shutdown: carry on in this thread rather than resuming
+            // from inside await_suspend, which would nest one frame per step.
+            bool await_suspend(std::coroutine_handle<> handle) { return scheduler.trySchedule(handle); }
+            void await_resume() const noexcept {}
+        };
+        return Awaiter{*this};
+    }
+
+    [[nodiscard]] ThreadPool& pool() const noexcept { return m_pool; }
+    [[nodiscard]] std::size_t workerCount() const noexcept { return m_pool.workerCount(m_priority); }
+
+private:
+    ThreadPool& m_pool;
+    TaskPriority m_priority;
+};
+
+}  // namespace tine::dsp
+
+#endif  // TINE_NATIVE_ASYNC_ASYNCSCHEDULER_HPP
@@ -0,0 +1,439 @@
+#include "AsyncStream.hpp"
+
+#include "StreamScheduler.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <cmath>
+#include <cstring>
+#include <utility>
+
+#include <fcntl.h>
+#include <poll.h>
+#include <unistd.h>
+
+namespace tine::dsp {
+
+IoReactor::IoReactor(AsyncScheduler& scheduler) : m_scheduler(scheduler) {
+    if (::pipe(m_wakePipe) == 0) {
+        ::fcntl(m_wakePipe[0], F_SETFL, ::fcntl(m_wakePipe[0], F_GETFL) | O_NONBLOCK);
+        ::fcntl(m_wakePipe[1], F_SETFL, ::fcntl(m_wakePipe[1], F_GETFL) | O_NONBLOCK);
+        m_thread = std::thread([this] { run(); });
+    } else {
+        m_wakePipe[0] = m_wakePipe[1] = -1;
+        m_stopping.store(true);
+    }
+}
+
+IoReactor::~IoReactor() {
+    shutdown();
+    if (m_wakePipe[0] >= 0) {
+        ::close(m_wakePipe[0]);
+        ::close(m_wakePipe[1]);
+    }
+}
+
+void IoReactor::shutdown() {
+    if (m_stopping.exchange(true)) {
+        return;
+    }
+    wake();
+    if (m_thread.joinable()) {
+        m_thread.join();
+    }
+
+    // Parked coroutines retry their read through the scheduler instead of hanging.
+    std::vector<Waiter> leftovers;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        leftovers.swap(m_waiters);
+    }
+    for (const Waiter& waiter : leftovers) {
+        m_scheduler.schedule(waiter.handle);
+    }
+}
+
+bool IoReactor::park(int descriptor, std::coroutine_handle<> handle) {
+    {
+        // Checked under the lock: shutdown() sets the flag before it takes the
+        // leftovers, so a waiter is either handed back there or refused here.
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_stopping.load(std::memory_order_acquire)) {
+            return false;
+        }
+        m_waiters.push_back({descriptor, handle});
+    }
+    wake();
+    return true;
+}
+
+void IoReactor::wake() {
+    if (m_wakePipe[1] < 0) {
+        return;
+    }
+    const unsigned char byte = 1;
+    [[maybe_unused]] const ssize_t ignored = ::write(m_wakePipe[1], &byte, 1);
+}
+
+void IoReactor::run() {
+    std::vector<pollfd> descriptors;
+    std::vector<Waiter> snapshot;
+
+    while (!m_stopping.load(std::memory_order_acquire)) {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            snapshot = m_waiters;
+        }
+
+        descriptors.clear();
+        descriptors.push_back({m_wakePipe[0], POLLIN, 0});
+        for (const Waiter& waiter : snapshot) {
+            descriptors.push_back({waiter.descriptor, POLLIN, 0});
+        }
+
+        const int ready = ::poll(descriptors.data(), static_cast<nfds_t>(descriptors.size()), -1);
+        if (ready < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            break;
+        }
+
+        if (descriptors[0].revents != 0) {
+            unsigned char sink[64];
+            while (::read(m_wakePipe[0], sink, sizeof(sink)) > 0) {
+            }
+        }
+
+        for (std::size_t i = 1; i < descriptors.size(); ++i) {
+            if (descriptors[i].revents == 0) {
+                continue;
+            }
+            const Waiter& fired = snapshot[i - 1];
+            bool found = false;
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                for (auto it = m_waiters.begin(); it != m_waiters.end(); ++it) {
+                    if (it->handle == fired.handle) {
+                        m_waiters.erase(it);
+                        found = true;
+                        break;
+                    }
+                }
+            }
+            if (found) {
+                m_scheduler.schedule(fired.handle);
+            }
+        }
+    }
+}
+
+FdStreamSource::~FdStreamSource() {
+    if (m_ownsDescriptor && m_descriptor >= 0) {
+        ::close(m_descriptor);
+    }
+}
+
+StreamStatus FdStreamSource::read(float* dst, std::size_t frames, std::size_t& framesRead) {
+    framesRead = 0;
+    if (!dst || frames == 0) {
+        return StreamStatus::Ok;
+    }
+
+    auto* bytes = reinterpret_cast<unsigned char*>(dst);
+    const std::size_t carried = m_partialBytes;
+    std::memcpy(bytes, m_partial, carried);
+
+    ssize_t received = 0;
+    do {
+        received = ::read(m_descriptor, bytes + carried, frames * sizeof(float) - carried);
+    } while (received < 0 && errno == EINTR);
+
+    if (received < 0) {
+        return (errno == EAGAIN || errno == EWOULDBLOCK) ? StreamStatus::WouldBlock : StreamStatus::Error;
+    }
+    if (received == 0) {
+        m_partialBytes = 0;
+        return StreamStatus::EndOfStream;
+    }
+
+    const std::size_t total = carried + static_cast<std::size_t>(received);
+    framesRead = total / sizeof(float);
+    m_partialBytes = total % sizeof(float);
+    std::memcpy(m_partial, bytes + framesRead * sizeof(float), m_partialBytes);
+
+    return framesRead > 0 ? StreamStatus::Ok : StreamStatus::WouldBlock;
+}
+
+StreamStatus MemoryStreamSource::read(float* dst, std::size_t frames, std::size_t& framesRead) {
+    framesRead = 0;
+    if (m_position >= m_frames) {
+        return StreamStatus::EndOfStream;
+    }
+    const std::size_t remaining = m_frames - m_position;
+    framesRead = frames < remaining ? frames : remaining;
+    std::memcpy(dst, m_samples + m_position, framesRead * sizeof(float));
+    m_position += framesRead;
+    return StreamStatus::Ok;
+}
+
+std::size_t AsyncRingBuffer::write(const float* data, std::size_t frames) {
+    const std::size_t written = m_ring.write(data, frames);
+    if (written > 0) {
+        wakeIfReady();
+    }
+    return written;
+}
+
+void AsyncRingBuffer::close() {
+    m_closed.store(true, std::memory_order_release);
+    wakeIfReady();
+}
+
+bool AsyncRingBuffer::park(std::size_t frames, std::coroutine_handle<> handle) {
+    m_wantedFrames.store(frames, std::memory_order_relaxed);
+    m_waiter.store(handle.address(), std::memory_order_seq_cst);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+
+    // Re-check after publishing: the producer may have written in between. If we
+    // can reclaim the handle, continue inline; otherwise the producer owns it.
+    if (ready(frames)) {
+        void* expected = handle.address();
+        if (m_waiter.compare_exchange_strong(expected, nullptr, std::memory_order_acq_rel)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void AsyncRingBuffer::wakeIfReady() {
+    // Pairs with the fence in park(): either the consumer sees our frames or we see its handle.
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (m_waiter.load(std::memory_order_seq_cst) == nullptr) {
+        return;
+    }
+    if (!ready(m_wantedFrames.load(std::memory_order_relaxed))) {
+        return;
+    }
+    void* address = m_waiter.exchange(nullptr, std::memory_order_acq_rel);
+    if (address) {
+        m_scheduler.schedule(std::coroutine_handle<>::from_address(address));
+    }
+}
+
+namespace {
+
+Task<std::size_t> readFramesWithStatus(AsyncContext& context,
+                                       AudioStreamSource& source,
+                                       float* dst,
+                                       std::size_t frames,
+                                       StreamStatus& lastStatus) {
+    std::size_t total = 0;
+    lastStatus = StreamStatus::Ok;
+
+    while (total < frames) {
+        std::size_t got = 0;
+        const StreamStatus status = source.read(dst + total, frames - total, got);
+        total += got;
+
+        if (status == StreamStatus::Ok) {
+            continue;
+        }
+        if (status == StreamStatus::WouldBlock) {
+            if (got > 0) {
+                continue;
+            }
+            const int descriptor = source.descriptor();
+            if (context.reactor && descriptor >= 0) {
+                co_await context.reactor->readable(descriptor);
+            } else {
+                co_await context.scheduler.yield();
+            }
+            continue;
+        }
+
+        lastStatus = status;
+        break;
+    }
+
+    co_return total;
+}
+
+bool validConfig(const StreamAnalysisConfig& config) {
+    return config.sampleRate > 0.0 && config.windowSize >= 4 && config.hopSize > 0 &&
+           config.hopSize <= config.windowSize;
+}
+
+void slideWindow(std::vector<float>& window, std::size_t hop) {
+    std::memmove(window.data(), window.data() + hop, (window.size() - hop) * sizeof(float));
+}
+
+double audioSecondsOf(const StreamAnalysisConfig& config, std::size_t windows) {
+    return static_cast<double>(windows * config.hopSize) / config.sampleRate;
+}
+
+}  // namespace
+
+std::size_t scheduledHopSize(const StreamAnalysisConfig& config) noexcept {
+    if (!config.stream) {
+        return config.hopSize;
+    }
+    const double scaled = std::round(static_cast<double>(config.hopSize) * config.stream->hopScale());
+    return std::max<std::size_t>(config.hopSize, static_cast<std::size_t>(scaled));
+}
+
+Task<std::size_t> readFrames(AsyncContext& context, AudioStreamSource& source, float* dst, std::size_t frames) {
+    StreamStatus status = StreamStatus::Ok;
+    co_return co_await readFramesWithStatus(context, source, dst, frames, status);
+}
+
+Task<StreamSummary> analyzeStream(AsyncContext& context,
+                                  AudioStreamSource& source,
+                                  StreamAnalysisConfig config,
+                                  StreamResultSink sink) {
+    StreamSummary summary;
+    if (!validConfig(config)) {
+        summary.failed = true;
+        co_return summary;
+    }
+
+    // A degraded stream runs at the longer hop it was admitted under.
+    config.hopSize = scheduledHopSize(config);
+
+    YinPitchDetector detector(config.sampleRate, config.windowSize, config.threshold);
+    detector.setLagRefinement(config.lagRefinement);
+    detector.setCandidateLog(config.candidates);
+    // The span holds batchFrames overlapping windows; they are analyzed together so
+    // lags and partial sums shared between overlapping windows are computed once.
+    const std::size_t batch = std::max<std::size_t>(1, config.batchFrames);
+    std::vector<float> span(config.windowSize + (batch - 1) * config.hopSize, 0.0f);
+    std::vector<PitchResult> results(batch);
+    StreamStatus status = StreamStatus::Ok;
+
+    std::size_t filled = 0;
+    std::size_t skip = 0;
+    std::size_t windowStart = 0;
+    bool ended = false;
+
+    for (;;) {
+        // A hop longer than the window leaves a gap before the next window's audio.
+        while (!ended && skip > 0) {
+            const std::size_t want = std::min(skip, span.size());
+            const std::size_t got = co_await readFramesWithStatus(context, source, span.data(), want, status);
+            summary.framesRead += got;
+            skip -= got;
+            ended = got < want;
+        }
+        if (!ended && filled < span.size()) {
+            const std::size_t want = span.size() - filled;
+            const std::size_t got =
+                co_await readFramesWithStatus(context, source, span.data() + filled, want, status);
+            summary.framesRead += got;
+            filled += got;
+            ended = got < want;
+        }
+        if (filled < config.windowSize) {
+            break;
+        }
+
+        std::size_t produced = 0;
+        {
+            ScheduledStep step(context.scheduler, config.stream);
+            co_await step.begin();
+
+            const std::size_t windows = (filled - config.windowSize) / config.hopSize + 1;
+            produced = detector.processFrames(span.data(), filled, config.hopSize, results.data(), windows);
+            step.charge(audioSecondsOf(config, produced));
+            for (std::size_t k = 0; k < produced; ++k) {
+                ++summary.windowsAnalyzed;
+                if (results[k].isValid) {
+                    ++summary.validWindows;
+                }
+                if (sink) {
+                    sink(windowStart, results[k]);
+                }
+                windowStart += config.hopSize;
+            }
+        }
+
+        const std::size_t advanced = produced * config.hopSize;
+        const std::size_t consumed = std::min(advanced, filled);
+        skip = advanced - consumed;
+        std::memmove(span.data(), span.data() + consumed, (filled - consumed) * sizeof(float));
+        filled -= consumed;
+    }
+
+    summary.failed = status == StreamStatus::Error;
+    co_return summary;
+}
+
+Task<StreamSummary> analyzeRing(AsyncContext& context,
+                                AsyncRingBuffer& ring,
+                                StreamAnalysisConfig config,
+                                StreamResultSink sink) {
+    StreamSummary summary;
+    if (!validConfig(config)) {
+        summary.failed = true;
+        co_return summary;
+    }
+
+    config.hopSize = scheduledHopSize(config);
+
+    YinPitchDetector detector(config.sampleRate, config.windowSize, config.threshold);
+    detector.setLagRefinement(config.lagRefinement);
+    detector.setCandidateLog(config.candidates);
+    std::vector<float> window(config.windowSize, 0.0f);
+    std::size_t windowStart = 0;
+    std::size_t need = config.windowSize;
+    std::size_t skip = 0;
+    float* target = window.data();
+
+    for (;;) {
+        // Frames between windows when the hop is longer than the window; the
+        // window is refilled whole afterwards, so it doubles as the scratch.
+        while (skip > 0) {
+            const std::size_t want = std::min(skip, config.windowSize);
+            co_await ring.waitForFrames(want);
+            const std::size_t got = ring.read(window.data(), want);
+            if (got == 0) {
+                co_return summary;
+            }
+            summary.framesRead += got;
+            skip -= got;
+        }
+        co_await ring.waitForFrames(need);
+        if (ring.available() < need) {
+            break;
+        }
+        summary.framesRead += ring.read(target, need);
+        {
+            ScheduledStep step(context.scheduler, config.stream);
+            co_await step.begin();
+
+            const PitchResult result = detector.processBuffer(window.data(), config.windowSize);
+            step.charge(audioSecondsOf(config, 1));
+            ++summary.windowsAnalyzed;
+            if (result.isValid) {
+                ++summary.validWindows;
+            }
+            if (sink) {
+                sink(windowStart, result);
+            }
+        }
+
+        if (config.hopSize < config.windowSize) {
+            slideWindow(window, config.hopSize);
+            need = config.hopSize;
+            target = window.data() + config.windowSize - config.hopSize;
+        } else {
+            skip = config.hopSize - config.windowSize;
+            need = config.windowSize;
+            target = window.data();
+        }
+        windowStart += config.hopSize;
+    }
+
+    co_return summary;
+}
+
+}  // namespace tine::dsp
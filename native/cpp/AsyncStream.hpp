@@ -0,0 +1,258 @@
+#ifndef TINE_NATIVE_ASYNC_ASYNCSTREAM_HPP
+#define TINE_NATIVE_ASYNC_ASYNCSTREAM_HPP
+
+#include <atomic>
+#include <coroutine>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "AsyncScheduler.hpp"
+#include "AsyncTask.hpp"
+#include "FloatRingBuffer.hpp"
+#include "YinPitchDetector.hpp"
+
+namespace tine::dsp {
+
+class ScheduledStream;
+
+/**
+ * Readiness reactor for non-blocking descriptors (POSIX poll(2)). Coroutines
+ * park on a descriptor and are handed back to the scheduler once it is readable.
+ */
+class IoReactor {
+public:
+    explicit IoReactor(AsyncScheduler& scheduler);
+    ~IoReactor();
+
+    IoReactor(const IoReactor&) = delete;
+    IoReactor& operator=(const IoReactor&) = delete;
+
+    /**
+     * Awaitable that suspends until @p descriptor is readable (or hung up).
+     */
+    [[nodiscard]] auto readable(int descriptor) noexcept {
+        struct Awaiter {
+            IoReactor& reactor;
+            int descriptor;
+            bool await_ready() const noexcept { return false; }
+            bool await_suspend(std::coroutine_handle<> handle) { return reactor.park(descriptor, handle); }
+            void await_resume() const noexcept {}
+        };
+        return Awaiter{*this, descriptor};
+    }
+
+    void shutdown();
+
+private:
+    struct Waiter {
+        int descriptor;
+        std::coroutine_handle<> handle;
+    };
+
+    /** @return false when shut down: the caller retries its read instead of parking. */
+    bool park(int descriptor, std::coroutine_handle<> handle);
+    void wake();
+    void run();
+
+    AsyncScheduler& m_scheduler;
+    std::mutex m_mutex;
+    std::vector<Waiter> m_waiters;
+    int m_wakePipe[2]{-1, -1};
+    std::atomic<bool> m_stopping{false};
+    std::thread m_thread;
+};
+
+enum class StreamStatus {
+    Ok,
+    WouldBlock,
+    EndOfStream,
+    Error,
+};
+
+/**
+ * Source of mono float frames for the async analyzer.
+ */
+class AudioStreamSource {
+public:
+    virtual ~AudioStreamSource() = default;
+
+    /**
+     * Copy up to @p frames samples into @p dst without blocking.
+     */
+    virtual StreamStatus read(float* dst, std::size_t frames, std::size_t& framesRead) = 0;
+
+    /**
+     * @return Descriptor to poll when read() reports WouldBlock, or -1 to yield instead.
+     */
+    [[nodiscard]] virtual int descriptor() const noexcept { return -1; }
+};
+
+/**
+ * Reads native-endian float32 frames from a file or socket descriptor. Sockets
+ * should be opened with O_NONBLOCK so reads surface as WouldBlock.
+ */
+class FdStreamSource final : public AudioStreamSource {
+public:
+    explicit FdStreamSource(int descriptor, bool ownsDescriptor = false) noexcept
+        : m_descriptor(descriptor), m_ownsDescriptor(ownsDescriptor) {}
+    ~FdStreamSource() override;
+
+    FdStreamSource(const FdStreamSource&) = delete;
+    FdStreamSource& operator=(const FdStreamSource&) = delete;
+
+    StreamStatus read(float* dst, std::size_t frames, std::size_t& framesRead) override;
+    [[nodiscard]] int descriptor() const noexcept override { return m_descriptor; }
+
+private:
+    int m_descriptor;
+    bool m_ownsDescriptor;
+    unsigned char m_partial[sizeof(float)]{};
+    std::size_t m_partialBytes{0};
+};
+
+/**
+ * Serves frames from caller-owned memory. Useful for decoded files and benchmarks.
+ */
+class MemoryStreamSource final : public AudioStreamSource {
+public:
+    MemoryStreamSource(const float* samples, std::size_t frames) noexcept
+        : m_samples(samples), m_frames(frames) {}
+
+    StreamStatus read(float* dst, std::size_t frames, std::size_t& framesRead) override;
+
+private:
+    const float* m_samples;
+    std::size_t m_frames;
+    std::size_t m_position{0};
+};
+
+/**
+ * FloatRingBuffer whose single consumer can co_await a minimum fill level. The
+ * producer never blocks; it only hands the parked consumer back to the scheduler.
+ */
+class AsyncRingBuffer {
+public:
+    AsyncRingBuffer(AsyncScheduler& scheduler, std::size_t capacityFrames)
+        : m_scheduler(scheduler), m_ring(capacityFrames) {}
+
+    std::size_t write(const float* data, std::size_t frames);
+    std::size_t read(float* dst, std::size_t frames) { return m_ring.read(dst, frames); }
+
+    /**
+     * Marks the stream finished; a parked consumer is resumed with whatever remains.
+     */
+    void close();
+
+    [[nodiscard]] bool closed() const noexcept { return m_closed.load(std::memory_order_acquire); }
+    [[nodiscard]] std::size_t available() const { return m_ring.available(); }
+
+    /**
+     * Awaitable that completes once @p frames are readable or the ring is closed.
+     */
+    [[nodiscard]] auto waitForFrames(std::size_t frames) noexcept {
+        struct Awaiter {
+            AsyncRingBuffer& ring;
+            std::size_t frames;
+            bool await_ready() const { return ring.ready(frames); }
+            bool await_suspend(std::coroutine_handle<> handle) { return ring.park(frames, handle); }
+            void await_resume() const noexcept {}
+        };
+        return Awaiter{*this, frames};
+    }
+
+private:
+    bool ready(std::size_t frames) const { return closed() || m_ring.available() >= frames; }
+    bool park(std::size_t frames, std::coroutine_handle<> handle);
+    void wakeIfReady();
+
+    AsyncScheduler& m_scheduler;
+    FloatRingBuffer m_ring;
+    std::atomic<std::size_t> m_wantedFrames{0};
+    std::atomic<void*> m_waiter{nullptr};
+    std::atomic<bool> m_closed{false};
+};
+
+/**
+ * Shared infrastructure for a population of async streams.
+ */
+struct AsyncContext {
+    AsyncScheduler& scheduler;
+    IoReactor* reactor{nullptr};
+};
+
+struct StreamAnalysisConfig {
+    double sampleRate{48000.0};
+    std::size_t windowSize{2048};
+    std::size_t hopSize{2048};
+    double threshold{0.1};
+    /**
+     * Windows analyzeStream() reads and analyzes per YinPitchDetector::processFrames()
+     * call. Values above 1 pay off when hopSize is well below windowSize.
+     */
+    std::size_t batchFrames{16};
+    LagRefinement lagRefinement{LagRefinement::Parabolic};
+    /**
+     * Also append each window's threshold-independent candidates here (see
+     * CandidateTrack). Not owned; must outlive the analysis.
+     */
+    CandidateLog* candidates{nullptr};
+    /**
+     * When set, each detection step waits for this stream's turn in its
+     * StreamScheduler instead of yielding, and is charged the audio it analyzed.
+     * The analysis runs at the hop the stream was admitted under (see
+     * scheduledHopSize()). Not owned; must outlive the analysis.
+     */
+    ScheduledStream* stream{nullptr};
+};
+
+/**
+ * hopSize times the hopScale @p config's stream was admitted under, or hopSize
+ * when there is no stream. May exceed windowSize: the audio between windows is
+ * then read and skipped.
+ */
+[[nodiscard]] std::size_t scheduledHopSize(const StreamAnalysisConfig& config) noexcept;
+
+struct StreamSummary {
+    std::size_t framesRead{0};
+    std::size_t windowsAnalyzed{0};
+    std::size_t validWindows{0};
+    /** Windows among windowsAnalyzed served from a PitchTrackCache instead of the detector. */
+    std::size_t cachedWindows{0};
+    bool failed{false};
+};
+
+/**
+ * Receives each analysis result with the index of the first sample of its window.
+ */
+using StreamResultSink = std::function<void(std::size_t startFrame, const PitchResult& result)>;
+
+/**
+ * Awaitable read step: fills @p dst with @p frames samples unless the stream ends
+ * first, parking on the reactor (or yielding) whenever the source would block.
+ * @return Frames read; short only at end of stream or on error.
+ */
+Task<std::size_t> readFrames(AsyncContext& context, AudioStreamSource& source, float* dst, std::size_t frames);
+
+/**
+ * Analyze @p source hop by hop. Each read, detection and sink call is a separate
+ * step, so many streams interleave fairly on a few workers.
+ */
+Task<StreamSummary> analyzeStream(AsyncContext& context,
+                                  AudioStreamSource& source,
+                                  StreamAnalysisConfig config,
+                                  StreamResultSink sink);
+
+/**
+ * Same as analyzeStream() but consumes a live ring filled by a capture thread.
+ */
+Task<StreamSummary> analyzeRing(AsyncContext& context,
+                                AsyncRingBuffer& ring,
+                                StreamAnalysisConfig config,
+                                StreamResultSink sink);
+
+}  // namespace tine::dsp
+
+#endif  // TINE_NATIVE_ASYNC_ASYNCSTREAM_HPP
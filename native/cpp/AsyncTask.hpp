@@ -0,0 +1,239 @@
+#ifndef TINE_NATIVE_ASYNC_ASYNCTASK_HPP
+#define TINE_NATIVE_ASYNC_ASYNCTASK_HPP
+
+#include <condition_variable>
+#include <coroutine>
+#include <cstddef>
+#include <exception>
+#include <mutex>
+#include <optional>
+#include <utility>
+
+#include "AsyncScheduler.hpp"
+
+namespace tine::dsp {
+
+template <typename T>
+class Task;
+
+namespace detail {
+
+struct TaskFinalAwaiter {
+    bool await_ready() const noexcept { return false; }
+
+    template <typename Promise>
+    std::coroutine_handle<> await_suspend(std::coroutine_handle<Promise> handle) noexcept {
+        auto next = handle.promise().continuation;
+        return next ? next : std::noop_coroutine();
+    }
+
+    void await_resume() const noexcept {}
+};
+
+struct TaskPromiseBase {
+    std::coroutine_handle<> continuation;
+    std::exception_ptr error;
+
+    std::suspend_always initial_suspend() const noexcept { return {}; }
+    TaskFinalAwaiter final_suspend() const noexcept { return {}; }
+
+    void unhandled_exception() noexcept { error = std::current_exception(); }
+};
+
+template <typename T>
+struct TaskPromise : TaskPromiseBase {
+    std::optional<T> value;
+
+    Task<T> get_return_object() noexcept;
+
+    template <typename U>
+    void return_value(U&& result) {
+        value.emplace(std::forward<U>(result));
+    }
+
+    T take() {
+        if (error) {
+            std::rethrow_exception(error);
+        }
+        return std::move(*value);
+    }
+};
+
+template <>
+struct TaskPromise<void> : TaskPromiseBase {
+    Task<void> get_return_object() noexcept;
+
+    void return_void() const noexcept {}
+
+    void take() const {
+        if (error) {
+            std::rethrow_exception(error);
+        }
+    }
+};
+
+}  // namespace detail
+
+/**
+ * Lazily started coroutine returning @p T. Awaiting a task starts it and resumes
+ * the awaiter by symmetric transfer once it completes, so chains of steps never
+ * grow the native stack.
+ */
+template <typename T = void>
+class [[nodiscard]] Task {
+public:
+    using promise_type = detail::TaskPromise<T>;
+
+    Task() noexcept = default;
+    explicit Task(std::coroutine_handle<promise_type> handle) noexcept : m_handle(handle) {}
+
+    Task(Task&& other) noexcept : m_handle(std::exchange(other.m_handle, {})) {}
+
+    Task& operator=(Task&& other) noexcept {
+        if (this != &other) {
+            destroy();
+            m_handle = std::exchange(other.m_handle, {});
+        }
+        return *this;
+    }
+
+    Task(const Task&) = delete;
+    Task& operator=(const Task&) = delete;
+
+    ~Task() { destroy(); }
+
+    auto operator co_await() && noexcept {
+        struct Awaiter {
+            std::coroutine_handle<promise_type> handle;
+            bool await_ready() const noexcept { return !handle || handle.done(); }
+            std::coroutine_handle<> await_suspend(std::coroutine_handle<> awaiting) noexcept {
+                handle.promise().continuation = awaiting;
+                return handle;
+            }
+            T await_resume() { return handle.promise().take(); }
+        };
+        return Awaiter{m_handle};
+    }
+
+private:
+    void destroy() noexcept {
+        if (m_handle) {
+            m_handle.destroy();
+            m_handle = {};
+        }
+    }
+
+    std::coroutine_handle<promise_type> m_handle;
+};
+
+namespace detail {
+
+template <typename T>
+Task<T> TaskPromise<T>::get_return_object() noexcept {
+    return Task<T>{std::coroutine_handle<TaskPromise<T>>::from_promise(*this)};
+}
+
+inline Task<void> TaskPromise<void>::get_return_object() noexcept {
+    return Task<void>{std::coroutine_handle<TaskPromise<void>>::from_promise(*this)};
+}
+
+}  // namespace detail
+
+/**
+ * Counts outstanding detached tasks and lets a non-coroutine thread block until
+ * all of them have finished. A task that throws still counts as finished; the
+ * group records it as failed.
+ */
+class WaitGroup {
+public:
+    void add(std::size_t count = 1) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_outstanding += count;
+    }
+
+    /** @param error What the task threw, or null if it completed. */
+    void done(std::exception_ptr error = nullptr) {
+        // Decrement and notify under the lock: once the count reads zero a waiter
+        // may return and destroy the group, so nothing may touch it afterwards.
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (error) {
+            ++m_failed;
+            if (!m_firstError) {
+                m_firstError = std::move(error);
+            }
+        }
+        if (--m_outstanding == 0) {
+            m_condition.notify_all();
+        }
+    }
+
+    void wait() {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_condition.wait(lock, [this] { return m_outstanding == 0; });
+    }
+
+    /** Tasks that ended by throwing. */
+    [[nodiscard]] std::size_t failed() const {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_failed;
+    }
+
+    /** The first exception a task threw, for the caller to rethrow or log; null if none did. */
+    [[nodiscard]] std::exception_ptr firstError() const {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_firstError;
+    }
+
+private:
+    std::size_t m_outstanding{0};
+    std::size_t m_failed{0};
+    std::exception_ptr m_firstError;
+    mutable std::mutex m_mutex;
+    std::condition_variable m_condition;
+};
+
+namespace detail {
+
+struct DetachedTask {
+    struct promise_type {
+        DetachedTask get_return_object() const noexcept { return {}; }
+        std::suspend_never initial_suspend() const noexcept { return {}; }
+        std::suspend_never final_suspend() const noexcept { return {}; }
+        void return_void() const noexcept {}
+        // runDetached() catches what its task throws; nothing else in it can.
+        void unhandled_exception() const noexcept { std::terminate(); }
+    };
+};
+
+inline DetachedTask runDetached(AsyncScheduler& scheduler, Task<void> task, WaitGroup* group) {
+    co_await scheduler.yield();
+    // A throwing source or sink fails its own stream only; the other streams
+    // sharing the scheduler keep running.
+    std::exception_ptr error;
+    try {
+        co_await std::move(task);
+    } catch (...) {
+        error = std::current_exception();
+    }
+    if (group) {
+        group->done(std::move(error));
+    }
+}
+
+}  // namespace detail
+
+/**
+ * Start @p task on @p scheduler without awaiting it. When @p group is provided it
+ * is incremented now and signalled when the task completes or throws; without
+ * a group an exception is dropped with the task.
+ */
+inline void spawn(AsyncScheduler& scheduler, Task<void> task, WaitGroup* group = nullptr) {
+    if (group) {
+        group->add();
+    }
+    detail::runDetached(scheduler, std::move(task), group);
+}
+
+}  // namespace tine::dsp
+
+#endif  // TINE_NATIVE_ASYNC_ASYNCTASK_HPP
@@ -0,0 +1,100 @@
+#ifndef TINE_NATIVE_DSP_BIQUAD_HPP
+#define TINE_NATIVE_DSP_BIQUAD_HPP
+
+#include <cmath>
+#include <cstddef>
+
+namespace tine::dsp {
+
+/**
+ * Normalised (a0 = 1) second-order section coefficients.
+ */
+struct BiquadCoefficients {
+    double b0{1.0};
+    double b1{0.0};
+    double b2{0.0};
+    double a1{0.0};
+    double a2{0.0};
+
+    /** Butterworth (Q = 1/sqrt 2) high-pass; RBJ cookbook. */
+    static BiquadCoefficients highPass(double sampleRate, double cutoffHz, double q = M_SQRT1_2) {
+        const Prototype p(sampleRate, cutoffHz, q);
+        return p.normalise((1.0 + p.cosw) / 2.0, -(1.0 + p.cosw), (1.0 + p.cosw) / 2.0);
+    }
+
+    /** Butterworth (Q = 1/sqrt 2) low-pass; RBJ cookbook. */
+    static BiquadCoefficients lowPass(double sampleRate, double cutoffHz, double q = M_SQRT1_2) {
+        const Prototype p(sampleRate, cutoffHz, q);
+        return p.normalise((1.0 - p.cosw) / 2.0, 1.0 - p.cosw, (1.0 - p.cosw) / 2.0);
+    }
+
+    /** Band-reject centred on @p centreHz; RBJ cookbook. */
+    static BiquadCoefficients notch(double sampleRate, double centreHz, double q) {
+        const Prototype p(sampleRate, centreHz, q);
+        return p.normalise(1.0, -2.0 * p.cosw, 1.0);
+    }
+
+private:
+    struct Prototype {
+        double cosw;
+        double alpha;
+
+        Prototype(double sampleRate, double frequency, double q) {
+            const double nyquistSafe = std::fmin(frequency, sampleRate * 0.49);
+            const double w = 2.0 * M_PI * nyquistSafe / sampleRate;
+            cosw = std::cos(w);
+            alpha = std::sin(w) / (2.0 * (q > 0.0 ? q : M_SQRT1_2));
+        }
+
+        [[nodiscard]] BiquadCoefficients normalise(double b0, double b1, double b2) const {
+            const double a0 = 1.0 + alpha;
+            BiquadCoefficients c;
+            c.b0 = b0 / a0;
+            c.b1 = b1 / a0;
+            c.b2 = b2 / a0;
+            c.a1 = -2.0 * cosw / a0;
+            c.a2 = (1.0 - alpha) / a0;
+            return c;
+        }
+    };
+};
+
+/**
+ * Transposed direct form II section. Allocation free; one instance per stream.
+ */
+class Biquad {
+public:
+    Biquad() = default;
+    explicit Biquad(const BiquadCoefficients& coefficients) : m_c(coefficients) {}
+
+    void setCoefficients(const BiquadCoefficients& coefficients) noexcept { m_c = coefficients; }
+
+    void reset() noexcept {
+        m_z1 = 0.0;
+        m_z2 = 0.0;
+    }
+
+    float process(float sample) noexcept {
+        const double x = sample;
+        const double y = m_c.b0 * x + m_z1;
+        m_z1 = m_c.b1 * x - m_c.a1 * y + m_z2;
+        m_z2 = m_c.b2 * x - m_c.a2 * y;
+        return static_cast<float>(y);
+    }
+
+    /** Filter @p frames samples in place. */
+    void process(float* samples, std::size_t frames) noexcept {
+        for (std::size_t i = 0; i < frames; ++i) {
+            samples[i] = process(samples[i]);
+        }
+    }
+
+private:
+    BiquadCoefficients m_c;
+    double m_z1{0.0};
+    double m_z2{0.0};
+};
+
+}  // namespace tine::dsp
+
+#endif  // TINE_NATIVE_DSP_BIQUAD_HPP
@@ -0,0 +1,181 @@
+#include "BroadcastRingBuffer.hpp"
+
+namespace tine::dsp {
+
+namespace {
+
+std::size_t nextPowerOfTwo(std::size_t value) {
+    std::size_t v = 1;
+    while (v < value) {
+        v <<= 1;
+    }
+    return v;
+}
+
+}  // namespace
+
+BroadcastRingBuffer::BroadcastRingBuffer(std::size_t capacityFrames, std::size_t maxConsumers)
+    : m_capacity(nextPowerOfTwo(capacityFrames == 0 ? 1 : capacityFrames)),
+      m_mask(m_capacity - 1),
+      m_buffer(std::make_unique<std::atomic<float>[]>(m_capacity)),
+      m_cursors(new Cursor[maxConsumers == 0 ? 1 : maxConsumers]),
+      m_maxConsumers(maxConsumers == 0 ? 1 : maxConsumers) {}
+
+BroadcastRingBuffer::ConsumerId BroadcastRingBuffer::addConsumer(ConsumerMode mode, std::size_t resyncFrames) {
+    for (std::size_t i = 0; i < m_maxConsumers; ++i) {
+        Cursor& cursor = m_cursors[i];
+        std::uint8_t expected = kSlotFree;
+        if (!cursor.state.compare_exchange_strong(expected, kSlotClaimed, std::memory_order_acq_rel)) {
+            continue;
+        }
+
+        cursor.resyncFrames = resyncFrames == 0 || resyncFrames > m_capacity ? m_capacity / 2 : resyncFrames;
+        cursor.lost.store(0, std::memory_order_relaxed);
+        cursor.overruns.store(0, std::memory_order_relaxed);
+        cursor.read.store(m_writeIndex.load(std::memory_order_acquire), std::memory_order_relaxed);
+        // Publishing the mode makes the cursor visible to the producer's free-space scan.
+        cursor.state.store(mode == ConsumerMode::Blocking ? kSlotBlocking : kSlotLagging, std::memory_order_release);
+        m_consumerCount.fetch_add(1, std::memory_order_relaxed);
+        return static_cast<ConsumerId>(i);
+    }
+    return kInvalidConsumer;
+}
+
+void BroadcastRingBuffer::removeConsumer(ConsumerId id) {
+    if (!valid(id)) {
+        return;
+    }
+    m_cursors[static_cast<std::size_t>(id)].state.store(kSlotFree, std::memory_order_release);
+    m_consumerCount.fetch_sub(1, std::memory_order_relaxed);
+}
+
+bool BroadcastRingBuffer::valid(ConsumerId id) const noexcept {
+    if (id < 0 || static_cast<std::size_t>(id) >= m_maxConsumers) {
+        return false;
+    }
+    const std::uint8_t state = m_cursors[static_cast<std::size_t>(id)].state.load(std::memory_order_acquire);
+    return state == kSlotBlocking || state == kSlotLagging;
+}
+
+std::size_t BroadcastRingBuffer::slowestBlockingCursor(std::size_t writeIndex) const {
+    std::size_t slowest = writeIndex;
+    for (std::size_t i = 0; i < m_maxConsumers; ++i) {
+        const Cursor& cursor = m_cursors[i];
+        if (cursor.state.load(std::memory_order_acquire) != kSlotBlocking) {
+            continue;
+        }
+        const std::size_t read = cursor.read.load(std::memory_order_acquire);
+        // A cursor registered from a write position that has since been lapped is
+        // resynchronised by its own next read; it must not stall the producer.
+        if (writeIndex - read <= m_capacity && writeIndex - read > writeIndex - slowest) {
+            slowest = read;
+        }
+    }
+    return slowest;
+}
+
+std::size_t BroadcastRingBuffer::write(const float* data, std::size_t frames) {
+    if (!data || frames == 0) {
+        return 0;
+    }
+
+    const std::size_t localWrite = m_writeIndex.load(std::memory_order_relaxed);
+    const std::size_t free = m_capacity - (localWrite - slowestBlockingCursor(localWrite));
+    const std::size_t toWrite = frames > free ? free : frames;
+    if (toWrite == 0) {
+        return 0;
+    }
+
+    // Only Lagging consumers can be overwritten, and only they need the claim:
+    // they compare it after copying to detect slots replaced mid-read.
+    const std::size_t end = localWrite + toWrite;
+    m_writeClaim.store(end, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    for (std::size_t i = 0; i < toWrite; ++i) {
+        m_buffer[(localWrite + i) & m_mask].store(data[i], std::memory_order_relaxed);
+    }
+
+    m_writeIndex.store(end, std::memory_order_release);
+    return toWrite;
+}
+
+std::size_t BroadcastRingBuffer::read(ConsumerId id, float* dst, std::size_t frames, std::size_t* lost) {
+    if (lost) {
+        *lost = 0;
+    }
+    if (!dst || frames == 0 || !valid(id)) {
+        return 0;
+    }
+
+    Cursor& cursor = m_cursors[static_cast<std::size_t>(id)];
+    std::size_t localRead = cursor.read.load(std::memory_order_relaxed);
+    const std::size_t localWrite = m_writeIndex.load(std::memory_order_acquire);
+    std::size_t skipped = 0;
+
+    if (localWrite - localRead > m_capacity) {
+        const std::size_t target = localWrite - cursor.resyncFrames;
+        skipped += target - localRead;
+        localRead = target;
+    }
+
+    const std::size_t available = localWrite - localRead;
+    std::size_t count = frames > available ? available : frames;
+    for (std::size_t i = 0; i < count; ++i) {
+        dst[i] = m_buffer[(localRead + i) & m_mask].load(std::memory_order_relaxed);
+    }
+
+    std::atomic_thread_fence(std::memory_order_acquire);
+    const std::size_t claim = m_writeClaim.load(std::memory_order_relaxed);
+    if (claim - localRead > m_capacity) {
+        std::size_t stale = claim - localRead - m_capacity;
+        stale = stale > count ? count : stale;
+        for (std::size_t i = stale; i < count; ++i) {
+            dst[i - stale] = dst[i];
+        }
+        count -= stale;
+        localRead += stale;
+        skipped += stale;
+    }
+
+    cursor.read.store(localRead + count, std::memory_order_release);
+    if (skipped > 0) {
+        cursor.lost.fetch_add(skipped, std::memory_order_relaxed);
+        cursor.overruns.fetch_add(1, std::memory_order_relaxed);
+    }
+    if (lost) {
+        *lost = skipped;
+    }
+    return count;
+}
+
+std::size_t BroadcastRingBuffer::skip(ConsumerId id, std::size_t frames) {
+    if (!valid(id)) {
+        return 0;
+    }
+    Cursor& cursor = m_cursors[static_cast<std::size_t>(id)];
+    const std::size_t localRead = cursor.read.load(std::memory_order_relaxed);
+    const std::size_t available = m_writeIndex.load(std::memory_order_acquire) - localRead;
+    const std::size_t count = frames > available ? available : frames;
+    cursor.read.store(localRead + count, std::memory_order_release);
+    return count;
+}
+
+std::size_t BroadcastRingBuffer::available(ConsumerId id) const {
+    if (!valid(id)) {
+        return 0;
+    }
+    const std::size_t behind = m_writeIndex.load(std::memory_order_acquire) -
+                               m_cursors[static_cast<std::size_t>(id)].read.load(std::memory_order_relaxed);
+    return behind > m_capacity ? m_capacity : behind;
+}
+
+std::uint64_t BroadcastRingBuffer::lostFrames(ConsumerId id) const {
+    return valid(id) ? m_cursors[static_cast<std::size_t>(id)].lost.load(std::memory_order_relaxed) : 0;
+}
+
+std::uint64_t BroadcastRingBuffer::overruns(ConsumerId id) const {
+    return valid(id) ? m_cursors[static_cast<std::size_t>(id)].overruns.load(std::memory_order_relaxed) : 0;
+}
+
+}  // namespace tine::dsp
@@ -0,0 +1,132 @@
+#ifndef TINE_NATIVE_UTIL_BROADCAST_RING_BUFFER_HPP
+#define TINE_NATIVE_UTIL_BROADCAST_RING_BUFFER_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+namespace tine::dsp {
+
+/**
+ * What happens to a capture path's main consumer when it falls a full ring behind.
+ */
+enum class OverflowPolicy {
+    /** The consumer is Blocking: the producer writes only what fits and the newest frames are dropped. */
+    DropNewest,
+    /**
+     * The consumer is Lagging: the producer always writes and the oldest unread
+     * frames are overwritten; the consumer counts the loss and skips ahead.
+     */
+    OverwriteOldest,
+};
+
+enum class ConsumerMode {
+    /** Holds the producer back: the ring never overwrites frames this consumer has not read. */
+    Blocking,
+    /** Never holds the producer back; overwritten frames are skipped and counted. */
+    Lagging,
+};
+
+/**
+ * Single-producer/multi-consumer ring for audio frames. The producer writes each
+ * frame once; every registered consumer reads it through its own cursor.
+ *
+ * Free space is bounded by the slowest Blocking consumer; frames that do not fit
+ * are dropped. Lagging consumers may be lapped. They detect it from the write
+ * sequence, count the loss and resynchronise near the producer.
+ *
+ * Threading: write() from one producer thread; read()/skip()/available() for a
+ * given consumer from one thread at a time; addConsumer()/removeConsumer() from
+ * any non-real-time thread.
+ */
+class BroadcastRingBuffer {
+public:
+    using ConsumerId = int;
+    static constexpr ConsumerId kInvalidConsumer = -1;
+
+    explicit BroadcastRingBuffer(std::size_t capacityFrames, std::size_t maxConsumers = 8);
+
+    BroadcastRingBuffer(const BroadcastRingBuffer&) = delete;
+    BroadcastRingBuffer& operator=(const BroadcastRingBuffer&) = delete;
+
+    /**
+     * Register a consumer positioned at the current write position.
+     * @param resyncFrames Lagging only: distance behind the producer to resume at
+     *        after being lapped. 0 keeps half the ring.
+     * @return The consumer id, or kInvalidConsumer when every slot is taken.
+     */
+    ConsumerId addConsumer(ConsumerMode mode, std::size_t resyncFrames = 0);
+
+    /**
+     * Release @p id. The consumer must not be used concurrently or afterwards.
+     */
+    void removeConsumer(ConsumerId id);
+
+    /**
+     * Write up to @p frames samples. Returns the number written; fewer than
+     * @p frames only when a Blocking consumer is behind or @p frames exceeds
+     * the capacity.
+     */
+    std::size_t write(const float* data, std::size_t frames);
+
+    /**
+     * Read up to @p frames samples for @p id. Returns frames copied.
+     * @param lost Receives frames skipped before the returned data because they
+     *        were overwritten. Always zero for a Blocking consumer in steady state.
+     */
+    std::size_t read(ConsumerId id, float* dst, std::size_t frames, std::size_t* lost = nullptr);
+
+    /**
+     * Advance @p id without copying, e.g. when its owner consumed the frames
+     * elsewhere. Returns frames skipped.
+     */
+    std::size_t skip(ConsumerId id, std::size_t frames);
+
+    /**
+     * @return Frames readable by @p id (capped at capacity once lapped).
+     */
+    [[nodiscard]] std::size_t available(ConsumerId id) const;
+
+    [[nodiscard]] std::uint64_t lostFrames(ConsumerId id) const;
+    [[nodiscard]] std::uint64_t overruns(ConsumerId id) const;
+
+    [[nodiscard]] std::size_t capacity() const noexcept { return m_capacity; }
+    [[nodiscard]] std::size_t consumerCount() const noexcept {
+        return m_consumerCount.load(std::memory_order_relaxed);
+    }
+
+private:
+    enum : std::uint8_t { kSlotFree = 0, kSlotClaimed, kSlotBlocking, kSlotLagging };
+
+    // One cache line per consumer so a reader advancing its cursor never
+    // invalidates the line the producer or another reader is polling.
+    struct alignas(64) Cursor {
+        std::atomic<std::size_t> read{0};
+        std::atomic<std::uint8_t> state{kSlotFree};
+        std::size_t resyncFrames{0};
+        std::atomic<std::uint64_t> lost{0};
+        std::atomic<std::uint64_t> overruns{0};
+    };
+
+    [[nodiscard]] bool valid(ConsumerId id) const noexcept;
+    [[nodiscard]] std::size_t slowestBlockingCursor(std::size_t writeIndex) const;
+
+    const std::size_t m_capacity;
+    const std::size_t m_mask;
+    // Relaxed atomics, not plain floats: a Lagging reader may copy a slot while
+    // the producer overwrites it. The claim check discards such samples, but the
+    // access itself must still be race-free. Relaxed loads and stores compile to
+    // ordinary moves on the targets we ship.
+    std::unique_ptr<std::atomic<float>[]> m_buffer;
+    std::unique_ptr<Cursor[]> m_cursors;
+    const std::size_t m_maxConsumers;
+    std::atomic<std::size_t> m_consumerCount{0};
+
+    alignas(64) std::atomic<std::size_t> m_writeIndex{0};
+    std::atomic<std::size_t> m_writeClaim{0};
+};
+
+}  // namespace tine::dsp
+
+#endif  // TINE_NATIVE_UTIL_BROADCAST_RING_BUFFER_HPP
@@ -0,0 +1,182 @@
+#include "CandidateTrack.hpp"
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <utility>
+
+namespace tine::dsp {
+
+namespace {
+
+constexpr char TRACK_MAGIC[8] = {'T', 'I', 'N', 'E', 'C', 'A', 'N', 'D'};
+constexpr std::size_t HEADER_BYTES = sizeof(TRACK_MAGIC) + 4 + 8 + 4 + 4 + 4 + 8 + 8;
+constexpr std::size_t CANDIDATE_BYTES = 4 + 8 + 8;
+
+template <typename T>
+void put(std::string& out, T value) {
+    char bytes[sizeof(T)];
+    std::memcpy(bytes, &value, sizeof(T));
+    out.append(bytes, sizeof(T));
+}
+
+// Sequential reader over a byte view; every get() fails once the view runs out.
+class Reader {
+public:
+    explicit Reader(std::string_view bytes) : m_bytes(bytes) {}
+
+    template <typename T>
+    bool get(T& value) {
+        if (m_bytes.size() - m_offset < sizeof(T)) {
+            return false;
+        }
+        std::memcpy(&value, m_bytes.data() + m_offset, sizeof(T));
+        m_offset += sizeof(T);
+        return true;
+    }
+
+    [[nodiscard]] std::size_t remaining() const noexcept { return m_bytes.size() - m_offset; }
+
+private:
+    std::string_view m_bytes;
+    std::size_t m_offset{0};
+};
+
+}  // namespace
+
+const LagCandidate* CandidateTrack::candidates(std::size_t frame, std::size_t& count) const noexcept {
+    if (frame >= log.frameCount()) {
+        count = 0;
+        return nullptr;
+    }
+    const std::size_t begin = log.frameBegin(frame);
+    count = log.frameEnds[frame] - begin;
+    return log.candidates.data() + begin;
+}
+
+PitchResult CandidateTrack::decodeFrame(std::size_t frame, double threshold) const {
+    std::size_t count = 0;
+    const LagCandidate* first = candidates(frame, count);
+    return YinPitchDetector::decodeCandidates(first, count, threshold, info.sampleRate);
+}
+
+std::vector<PitchResult> CandidateTrack::decode(double threshold) const {
+    std::vector<PitchResult> results;
+    results.reserve(frameCount());
+    for (std::size_t frame = 0; frame < frameCount(); ++frame) {
+        results.push_back(decodeFrame(frame, threshold));
+    }
+    return results;
+}
+
+std::string CandidateTrack::serialize() const {
+    std::string out;
+    out.reserve(HEADER_BYTES + log.frameEnds.size() * 4 + log.candidates.size() * CANDIDATE_BYTES);
+    out.append(TRACK_MAGIC, sizeof(TRACK_MAGIC));
+    put<std::uint32_t>(out, kVersion);
+    put<double>(out, info.sampleRate);
+    put<std::uint32_t>(out, info.windowSize);
+    put<std::uint32_t>(out, info.hopSize);
+    put<std::uint32_t>(out, static_cast<std::uint32_t>(info.refinement));
+    put<std::uint64_t>(out, log.frameEnds.size());
+    put<std::uint64_t>(out, log.candidates.size());
+    for (std::uint32_t end : log.frameEnds) {
+        put<std::uint32_t>(out, end);
+    }
+    for (const LagCandidate& candidate : log.candidates) {
+        put<std::uint32_t>(out, candidate.lag);
+        put<double>(out, candidate.cmnd);
+        put<double>(out, candidate.period);
+    }
+    return out;
+}
+
+bool CandidateTrack::parse(std::string_view bytes, CandidateTrack& track) {
+    if (bytes.size() < HEADER_BYTES || std::memcmp(bytes.data(), TRACK_MAGIC, sizeof(TRACK_MAGIC)) != 0) {
+        return false;
+    }
+    Reader in(bytes.substr(sizeof(TRACK_MAGIC)));
+
+    CandidateTrack parsed;
+    std::uint32_t version = 0;
+    std::uint32_t refinement = 0;
+    std::uint64_t frames = 0;
+    std::uint64_t candidates = 0;
+    if (!in.get(version) || version != kVersion || !in.get(parsed.info.sampleRate) ||
+        !in.get(parsed.info.windowSize) || !in.get(parsed.info.hopSize) || !in.get(refinement) ||
+        !in.get(frames) || !in.get(candidates)) {
+        return false;
+    }
+    // Counts are checked against the bytes present before they size anything.
+    if (refinement > static_cast<std::uint32_t>(LagRefinement::Sinc) || frames > in.remaining() / 4 ||
+        candidates > in.remaining() / CANDIDATE_BYTES ||
+        in.remaining() != frames * 4 + candidates * CANDIDATE_BYTES) {
+        return false;
+    }
+    parsed.info.refinement = static_cast<LagRefinement>(refinement);
+
+    parsed.log.frameEnds.resize(frames);
+    std::uint32_t previous = 0;
+    for (std::uint32_t& end : parsed.log.frameEnds) {
+        if (!in.get(end) || end < previous || end > candidates) {
+            return false;
+        }
+        previous = end;
+    }
+    if (previous != candidates) {
+        return false;
+    }
+
+    parsed.log.candidates.resize(candidates);
+    for (LagCandidate& candidate : parsed.log.candidates) {
+        if (!in.get(candidate.lag) || !in.get(candidate.cmnd) || !in.get(candidate.period)) {
+            return false;
+        }
+    }
+
+    track = std::move(parsed);
+    return true;
+}
+
+bool CandidateTrack::load(const std::string& path, CandidateTrack& track) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file) {
+        return false;
+    }
+    std::ostringstream contents;
+    contents << file.rdbuf();
+    return parse(contents.str(), track);
+}
+
+bool CandidateTrack::save(const std::string& path) const {
+    const std::string temporary = path + ".tmp";
+    {
+        std::ofstream file(temporary, std::ios::binary | std::ios::trunc);
+        if (!file) {
+            return false;
+        }
+        const std::string bytes = serialize();
+        file.write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+        if (!file.flush()) {
+            return false;
+        }
+    }
+    return std::rename(temporary.c_str(), path.c_str()) == 0;
+}
+
+Task<StreamSummary> analyzeStreamCandidates(AsyncContext& context,
+                                            AudioStreamSource& source,
+                                            StreamAnalysisConfig config,
+                                            CandidateTrack& track,
+                                            StreamResultSink sink) {
+    track.info.sampleRate = config.sampleRate;
+    track.info.windowSize = static_cast<std::uint32_t>(config.windowSize);
+    track.info.hopSize = static_cast<std::uint32_t>(config.hopSize);
+    track.info.refinement = config.lagRefinement;
+    track.log.clear();
+    config.candidates = &track.log;
+    co_return co_await analyzeStream(context, source, config, std::move(sink));
+}
+
+}  // namespace tine::dsp
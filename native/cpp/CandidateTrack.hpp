@@ -0,0 +1,84 @@
+#ifndef TINE_NATIVE_DSP_CANDIDATETRACK_HPP
+#define TINE_NATIVE_DSP_CANDIDATETRACK_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "AsyncStream.hpp"
+#include "YinPitchDetector.hpp"
+
+namespace tine::dsp {
+
+/** Analysis settings a candidate track was recorded with; decoding needs no others. */
+struct CandidateTrackInfo {
+    double sampleRate{48000.0};
+    std::uint32_t windowSize{2048};
+    std::uint32_t hopSize{2048};
+    LagRefinement refinement{LagRefinement::Parabolic};
+};
+
+/**
+ * Threshold-independent record of an analysis: the LagCandidate list of every
+ * frame. decode() re-derives the results for any threshold from the candidates
+ * alone, identical to re-running the detector with that threshold, at the cost
+ * of a few comparisons per frame instead of a difference function.
+ *
+ * Persisted as a binary sidecar, native byte order:
+ *
+ *     "TINECAND" u32 version
+ *     f64 sampleRate, u32 windowSize, u32 hopSize, u32 refinement
+ *     u64 frames, u64 candidates
+ *     u32 frameEnds[frames]
+ *     { u32 lag, f64 cmnd, f64 period }[candidates]
+ */
+class CandidateTrack {
+public:
+    /** Bump whenever the layout or the meaning of a candidate changes. */
+    static constexpr std::uint32_t kVersion = 1;
+
+    CandidateTrackInfo info;
+    CandidateLog log;
+
+    [[nodiscard]] std::size_t frameCount() const noexcept { return log.frameCount(); }
+
+    /** First sample of frame @p frame's window. */
+    [[nodiscard]] std::size_t frameStart(std::size_t frame) const noexcept { return frame * info.hopSize; }
+
+    [[nodiscard]] const LagCandidate* candidates(std::size_t frame, std::size_t& count) const noexcept;
+
+    [[nodiscard]] PitchResult decodeFrame(std::size_t frame, double threshold) const;
+
+    /** Every frame's result at @p threshold, in frame order. */
+    [[nodiscard]] std::vector<PitchResult> decode(double threshold) const;
+
+    [[nodiscard]] std::string serialize() const;
+
+    /**
+     * Parse serialize() output. Returns false (leaving @p track untouched) for a
+     * truncated or inconsistent file or a different version.
+     */
+    static bool parse(std::string_view bytes, CandidateTrack& track);
+
+    static bool load(const std::string& path, CandidateTrack& track);
+
+    /** Write atomically (temporary file + rename). */
+    [[nodiscard]] bool save(const std::string& path) const;
+};
+
+/**
+ * Offline mode of analyzeStream(): analyze @p source as usual and also record
+ * every window's candidates into @p track (replacing its contents). @p track must
+ * outlive the task.
+ */
+Task<StreamSummary> analyzeStreamCandidates(AsyncContext& context,
+                                            AudioStreamSource& source,
+                                            StreamAnalysisConfig config,
+                                            CandidateTrack& track,
+                                            StreamResultSink sink = {});
+
+}  // namespace tine::dsp
+
+#endif  // TINE_NATIVE_DSP_CANDIDATETRACK_HPP
@@ -0,0 +1,115 @@
+#include "DialAnimator.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace tine::dsp {
+
+namespace {
+
+// Longer gaps (app backgrounded, debugger) snap straight to rest instead of
+// integrating one huge step.
+constexpr double MAX_STEP_SECONDS = 0.25;
+
+struct Spring {
+    double position;
+    double velocity;
+};
+
+// Exact critically damped response toward @p target after @p t seconds:
+// x(t) = (x0 + (v0 + w x0) t) e^-wt, so any frame interval is stable.
+Spring stepCriticallyDamped(Spring spring, double target, double omega, double t) {
+    const double x0 = spring.position - target;
+    const double v0 = spring.velocity;
+    const double decay = std::exp(-omega * t);
+    const double c = v0 + omega * x0;
+    return {target + (x0 + c * t) * decay, (v0 - omega * c * t) * decay};
+}
+
+// Nearest angle to @p reference that is congruent to @p degrees modulo 360.
+double nearestTurn(double degrees, double reference) {
+    return reference + std::remainder(degrees - reference, 360.0);
+}
+
+}  // namespace
+
+DialAnimator::DialAnimator(const DialAnimatorConfig& config) : m_config(config) {
+    if (!(m_config.angularFrequency > 0.0)) {
+        m_config.angularFrequency = DialAnimatorConfig{}.angularFrequency;
+    }
+    if (!(m_config.maxNeedleCents > 0.0)) {
+        m_config.maxNeedleCents = DialAnimatorConfig{}.maxNeedleCents;
+    }
+}
+
+void DialAnimator::pushResult(const PitchResult& result) noexcept {
+    Target target = m_target.load();
+    if (!result.isValid || !(result.frequency > 0.0) || !std::isfinite(result.midi)) {
+        // Unvoiced: the needle relaxes to centre and the ring stays on the last note.
+        target.needleDegrees = 0.0;
+        target.voiced = 0;
+        m_target.store(target);
+        return;
+    }
+
+    const double cents = std::clamp(result.cents, -m_config.maxNeedleCents, m_config.maxNeedleCents);
+    target.needleDegrees = cents / m_config.maxNeedleCents * m_config.needleFullScaleDegrees;
+    target.ringDegrees = std::fmod(-std::fmod(result.midi, 12.0) * m_config.ringDegreesPerSemitone + 720.0, 360.0);
+    target.cents = result.cents;
+    target.midi = result.midi;
+    target.voiced = 1;
+    target.hasRing = 1;
+    m_target.store(target);
+}
+
+DialState DialAnimator::advance(double seconds) noexcept {
+    const Target target = m_target.load();
+    const double omega = m_config.angularFrequency;
+    DialState next = m_current;
+
+    const double ringTarget = target.hasRing ? nearestTurn(target.ringDegrees, m_current.ringDegrees)
+                                             : m_current.ringDegrees;
+    if (!(seconds > 0.0)) {
+        seconds = 0.0;
+    }
+    if (seconds > MAX_STEP_SECONDS) {
+        next.needleDegrees = target.needleDegrees;
+        next.needleVelocity = 0.0;
+        next.ringDegrees = ringTarget;
+        next.ringVelocity = 0.0;
+    } else {
+        const Spring needle =
+            stepCriticallyDamped({m_current.needleDegrees, m_current.needleVelocity}, target.needleDegrees, omega,
+                                 seconds);
+        const Spring ring =
+            stepCriticallyDamped({m_current.ringDegrees, m_current.ringVelocity}, ringTarget, omega, seconds);
+        next.needleDegrees = needle.position;
+        next.needleVelocity = needle.velocity;
+        next.ringDegrees = ring.position;
+        next.ringVelocity = ring.velocity;
+    }
+
+    next.cents = target.cents;
+    next.midi = target.midi;
+    next.voiced = target.voiced;
+    const double tolerance = m_config.settleDegrees;
+    next.settled = std::fabs(next.needleDegrees - target.needleDegrees) < tolerance &&
+                           std::fabs(next.needleVelocity) < tolerance &&
+                           std::fabs(next.ringDegrees - ringTarget) < tolerance &&
+                           std::fabs(next.ringVelocity) < tolerance
+                       ? 1
+                       : 0;
+    ++next.frame;
+
+    m_current = next;
+    m_state.store(next);
+    return next;
+}
+
+void DialAnimator::reset() noexcept {
+    m_target.store(Target{});
+    m_current = DialState{};
+    m_state.store(m_current);
+}
+
+}  // namespace tine::dsp
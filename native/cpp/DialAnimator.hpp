@@ -0,0 +1,94 @@
+#ifndef TINE_NATIVE_DSP_DIALANIMATOR_HPP
+#define TINE_NATIVE_DSP_DIALANIMATOR_HPP
+
+#include <cstdint>
+
+#include "SeqLock.hpp"
+#include "YinPitchDetector.hpp"
+
+namespace tine::dsp {
+
+/**
+ * Mapping from pitch to dial geometry; defaults match the tuner screen.
+ */
+struct DialAnimatorConfig {
+    /** Natural frequency of the critically damped springs (rad/s). */
+    double angularFrequency{12.0};
+    /** Needle deflection at maxNeedleCents (degrees); MAX_DISPLAY_DEG in src/utils/music.ts. */
+    double needleFullScaleDegrees{150.0};
+    double maxNeedleCents{50.0};
+    /** Note-ring rotation per semitone (degrees); the ring turns the other way. */
+    double ringDegreesPerSemitone{30.0};
+    /** Below this offset (degrees) and speed (degrees/s) the dial is reported settled. */
+    double settleDegrees{0.01};
+};
+
+/**
+ * One display frame of dial state, in degrees.
+ */
+struct DialState {
+    double needleDegrees{0.0};
+    double needleVelocity{0.0};
+    /** Continuous (unwrapped) ring rotation, so it never spins the long way round. */
+    double ringDegrees{0.0};
+    double ringVelocity{0.0};
+    /** Cents and MIDI note of the result the springs are heading for. */
+    double cents{0.0};
+    double midi{0.0};
+    std::uint32_t voiced{0};
+    /** Both springs have come to rest; a renderer may skip the frame. */
+    std::uint32_t settled{1};
+    std::uint64_t frame{0};
+};
+
+/**
+ * Native needle/note-ring integrator fed directly by detector results.
+ *
+ * pushResult() runs on whichever thread produced the result (capture or engine)
+ * and only publishes new targets. advance() runs once per display frame on the
+ * UI thread: it steps two critically damped springs by the real frame interval
+ * using the closed-form solution, so a late frame lands where a punctual one
+ * would have. state() may be read from any thread. All three are wait-free for
+ * the writer and never allocate.
+ */
+class DialAnimator {
+public:
+    explicit DialAnimator(const DialAnimatorConfig& config = {});
+
+    DialAnimator(const DialAnimator&) = delete;
+    DialAnimator& operator=(const DialAnimator&) = delete;
+
+    /** Retarget from a detector result. Single producer at a time. */
+    void pushResult(const PitchResult& result) noexcept;
+
+    /** Step the springs by @p seconds and publish the frame. Display thread only. */
+    DialState advance(double seconds) noexcept;
+
+    [[nodiscard]] DialState state() const noexcept { return m_state.load(); }
+
+    /** Return both springs and targets to rest at the centre. Only while no results are pushed. */
+    void reset() noexcept;
+
+    [[nodiscard]] const DialAnimatorConfig& config() const noexcept { return m_config; }
+
+private:
+    struct Target {
+        double needleDegrees{0.0};
+        /** Ring angle in [0, 360); advance() picks the nearest continuous turn. */
+        double ringDegrees{0.0};
+        double cents{0.0};
+        double midi{0.0};
+        std::uint32_t voiced{0};
+        std::uint32_t hasRing{0};
+    };
+
+    DialAnimatorConfig m_config;
+    SeqLock<Target> m_target;
+    SeqLock<DialState> m_state;
+    /** Display-thread copy of the published state. */
+    DialState m_current;
+};
+
+}  // namespace tine::dsp
+
+#endif  // TINE_NATIVE_DSP_DIALANIMATOR_HPP
@@ -0,0 +1,209 @@
+#include "DifferenceKernel.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+namespace tine::dsp {
+
+namespace {
+
+constexpr std::size_t BLOCK_LAGS = 4;
+
+std::size_t nextPowerOfTwo(std::size_t value) {
+    std::size_t v = 1;
+    while (v < value) {
+        v <<= 1;
+    }
+    return v;
+}
+
+}  // namespace
+
+const char* kernelName(DifferenceKernelKind kind) noexcept {
+    switch (kind) {
+        case DifferenceKernelKind::Direct:
+            return "direct";
+        case DifferenceKernelKind::Blocked:
+            return "blocked";
+        case DifferenceKernelKind::Fft:
+            return "fft";
+    }
+    return "direct";
+}
+
+bool parseKernelName(std::string_view name, DifferenceKernelKind& kind) noexcept {
+    for (DifferenceKernelKind candidate :
+         {DifferenceKernelKind::Direct, DifferenceKernelKind::Blocked, DifferenceKernelKind::Fft}) {
+        if (name == kernelName(candidate)) {
+            kind = candidate;
+            return true;
+        }
+    }
+    return false;
+}
+
+void DifferenceKernel::reserve(std::size_t windowCapacity, std::size_t maxFftSize) {
+    m_energy.assign(windowCapacity + 1, 0.0);
+    m_maxFftSize = maxFftSize == 0 ? 0 : nextPowerOfTwo(maxFftSize);
+    m_real.assign(m_maxFftSize, 0.0);
+    m_imag.assign(m_maxFftSize, 0.0);
+    m_cos.resize(m_maxFftSize / 2);
+    m_sin.resize(m_maxFftSize / 2);
+    for (std::size_t k = 0; k < m_maxFftSize / 2; ++k) {
+        const double angle = -2.0 * M_PI * static_cast<double>(k) / static_cast<double>(m_maxFftSize);
+        m_cos[k] = std::cos(angle);
+        m_sin[k] = std::sin(angle);
+    }
+}
+
+std::size_t DifferenceKernel::minimumFftSize(std::size_t window, std::size_t maxLag) noexcept {
+    return nextPowerOfTwo(window + maxLag);
+}
+
+DifferenceKernelKind DifferenceKernel::compute(const DifferenceKernelChoice& choice, const float* samples,
+                                               std::size_t window, std::size_t maxLag, double* out) noexcept {
+    switch (choice.kind) {
+        case DifferenceKernelKind::Blocked:
+            computeBlocked(samples, window, maxLag, out);
+            return DifferenceKernelKind::Blocked;
+        case DifferenceKernelKind::Fft: {
+            const std::size_t needed = minimumFftSize(window, maxLag);
+            const std::size_t size = std::max(needed, choice.fftSize == 0 ? needed : nextPowerOfTwo(choice.fftSize));
+            if (size <= m_maxFftSize && window < m_energy.size()) {
+                computeFft(samples, window, maxLag, size, out);
+                return DifferenceKernelKind::Fft;
+            }
+            break;
+        }
+        case DifferenceKernelKind::Direct:
+            break;
+    }
+    computeDirect(samples, window, maxLag, out);
+    return DifferenceKernelKind::Direct;
+}
+
+void DifferenceKernel::computeDirect(const float* samples, std::size_t window, std::size_t maxLag,
+                                     double* out) noexcept {
+    out[0] = 0.0;
+    for (std::size_t tau = 1; tau <= maxLag; ++tau) {
+        double sum = 0.0;
+        for (std::size_t i = 0; i < window - tau; ++i) {
+            const double delta = static_cast<double>(samples[i]) - static_cast<double>(samples[i + tau]);
+            sum += delta * delta;
+        }
+        out[tau] = sum;
+    }
+}
+
+void DifferenceKernel::computeBlocked(const float* samples, std::size_t window, std::size_t maxLag,
+                                      double* out) noexcept {
+    out[0] = 0.0;
+    std::size_t tau = 1;
+    for (; tau + BLOCK_LAGS - 1 <= maxLag; tau += BLOCK_LAGS) {
+        // Every lag in the block is defined over [0, window - tau - j); share the
+        // common prefix, then finish each lag's few remaining terms on its own.
+        const std::size_t common = window - (tau + BLOCK_LAGS - 1);
+        double s0 = 0.0;
+        double s1 = 0.0;
+        double s2 = 0.0;
+        double s3 = 0.0;
+        for (std::size_t i = 0; i < common; ++i) {
+            const double x = samples[i];
+            const float* y = samples + i + tau;
+            const double d0 = x - static_cast<double>(y[0]);
+            const double d1 = x - static_cast<double>(y[1]);
+            const double d2 = x - static_cast<double>(y[2]);
+            const double d3 = x - static_cast<double>(y[3]);
+            s0 += d0 * d0;
+            s1 += d1 * d1;
+            s2 += d2 * d2;
+            s3 += d3 * d3;
+        }
+        double sums[BLOCK_LAGS] = {s0, s1, s2, s3};
+        for (std::size_t j = 0; j < BLOCK_LAGS; ++j) {
+            for (std::size_t i = common; i < window - tau - j; ++i) {
+                const double delta = static_cast<double>(samples[i]) - static_cast<double>(samples[i + tau + j]);
+                sums[j] += delta * delta;
+            }
+            out[tau + j] = sums[j];
+        }
+    }
+    for (; tau <= maxLag; ++tau) {
+        double sum = 0.0;
+        for (std::size_t i = 0; i < window - tau; ++i) {
+            const double delta = static_cast<double>(samples[i]) - static_cast<double>(samples[i + tau]);
+            sum += delta * delta;
+        }
+        out[tau] = sum;
+    }
+}
+
+void DifferenceKernel::computeFft(const float* samples, std::size_t window, std::size_t maxLag, std::size_t fftSize,
+                                  double* out) noexcept {
+    // d(tau) = sum x[i]^2 + sum x[i + tau]^2 - 2 r(tau) over i in [0, window - tau).
+    m_energy[0] = 0.0;
+    for (std::size_t i = 0; i < window; ++i) {
+        const double x = samples[i];
+        m_energy[i + 1] = m_energy[i] + x * x;
+    }
+
+    for (std::size_t i = 0; i < fftSize; ++i) {
+        m_real[i] = i < window ? static_cast<double>(samples[i]) : 0.0;
+        m_imag[i] = 0.0;
+    }
+    transform(fftSize, false);
+    for (std::size_t i = 0; i < fftSize; ++i) {
+        m_real[i] = m_real[i] * m_real[i] + m_imag[i] * m_imag[i];
+        m_imag[i] = 0.0;
+    }
+    transform(fftSize, true);
+
+    const double scale = 1.0 / static_cast<double>(fftSize);
+    out[0] = 0.0;
+    for (std::size_t tau = 1; tau <= maxLag; ++tau) {
+        const double head = m_energy[window - tau];
+        const double tail = m_energy[window] - m_energy[tau];
+        // Cancellation can leave a tiny negative where the signal repeats exactly.
+        out[tau] = std::max(0.0, head + tail - 2.0 * m_real[tau] * scale);
+    }
+}
+
+void DifferenceKernel::transform(std::size_t size, bool inverse) noexcept {
+    double* re = m_real.data();
+    double* im = m_imag.data();
+
+    for (std::size_t i = 1, j = 0; i < size; ++i) {
+        std::size_t bit = size >> 1;
+        for (; j & bit; bit >>= 1) {
+            j ^= bit;
+        }
+        j ^= bit;
+        if (i < j) {
+            std::swap(re[i], re[j]);
+            std::swap(im[i], im[j]);
+        }
+    }
+
+    const double sign = inverse ? -1.0 : 1.0;
+    for (std::size_t length = 2; length <= size; length <<= 1) {
+        const std::size_t half = length / 2;
+        const std::size_t stride = m_maxFftSize / length;
+        for (std::size_t start = 0; start < size; start += length) {
+            for (std::size_t k = 0; k < half; ++k) {
+                const double wr = m_cos[k * stride];
+                const double wi = sign * m_sin[k * stride];
+                const std::size_t a = start + k;
+                const std::size_t b = a + half;
+                const double tr = re[b] * wr - im[b] * wi;
+                const double ti = re[b] * wi + im[b] * wr;
+                re[b] = re[a] - tr;
+                im[b] = im[a] - ti;
+                re[a] += tr;
+                im[a] += ti;
+            }
+        }
+    }
+}
+
+}  // namespace tine::dsp
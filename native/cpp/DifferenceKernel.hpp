@@ -0,0 +1,81 @@
+#ifndef TINE_NATIVE_DSP_DIFFERENCEKERNEL_HPP
+#define TINE_NATIVE_DSP_DIFFERENCEKERNEL_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+namespace tine::dsp {
+
+enum class DifferenceKernelKind : std::uint8_t {
+    /** One lag at a time; the reference implementation. */
+    Direct,
+    /** Four lags per pass sharing each sample load and running independent sums. */
+    Blocked,
+    /** Energy prefix sums plus an FFT autocorrelation; O(N log N) in the window. */
+    Fft,
+};
+
+/**
+ * A kernel and, for Fft, the transform length. fftSize 0 means the smallest
+ * power of two that avoids circular wrap-around for the window.
+ */
+struct DifferenceKernelChoice {
+    DifferenceKernelKind kind{DifferenceKernelKind::Direct};
+    std::size_t fftSize{0};
+};
+
+[[nodiscard]] const char* kernelName(DifferenceKernelKind kind) noexcept;
+
+/**
+ * @return false when @p name is not a kernel name; @p kind is left unchanged.
+ */
+bool parseKernelName(std::string_view name, DifferenceKernelKind& kind) noexcept;
+
+/**
+ * Computes the YIN difference function d(tau) for tau in [0, maxLag] with a
+ * selectable kernel. All kernels produce the same values up to floating-point
+ * summation order.
+ *
+ * reserve() allocates the FFT scratch; compute() never allocates and is safe on
+ * the audio thread.
+ */
+class DifferenceKernel {
+public:
+    /**
+     * Size scratch for windows up to @p windowCapacity and transforms up to
+     * @p maxFftSize (rounded up to a power of two; 0 skips the FFT scratch).
+     */
+    void reserve(std::size_t windowCapacity, std::size_t maxFftSize);
+
+    /**
+     * Fill @p out[0..maxLag] for @p window samples. Falls back to Direct when the
+     * choice cannot run here (FFT scratch not reserved or too small).
+     * @return The kernel that actually ran.
+     */
+    DifferenceKernelKind compute(const DifferenceKernelChoice& choice, const float* samples, std::size_t window,
+                                 std::size_t maxLag, double* out) noexcept;
+
+    /** Smallest transform that keeps lags up to @p maxLag free of wrap-around. */
+    [[nodiscard]] static std::size_t minimumFftSize(std::size_t window, std::size_t maxLag) noexcept;
+
+private:
+    static void computeDirect(const float* samples, std::size_t window, std::size_t maxLag, double* out) noexcept;
+    static void computeBlocked(const float* samples, std::size_t window, std::size_t maxLag, double* out) noexcept;
+    void computeFft(const float* samples, std::size_t window, std::size_t maxLag, std::size_t fftSize,
+                    double* out) noexcept;
+    void transform(std::size_t size, bool inverse) noexcept;
+
+    std::size_t m_maxFftSize{0};
+    std::vector<double> m_real;
+    std::vector<double> m_imag;
+    // cos/sin of -2*pi*k/m_maxFftSize; shorter transforms stride through them.
+    std::vector<double> m_cos;
+    std::vector<double> m_sin;
+    std::vector<double> m_energy;
+};
+
+}  // namespace tine::dsp
+
+#endif  // TINE_NATIVE_DSP_DIFFERENCEKERNEL_HPP
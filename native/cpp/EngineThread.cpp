@@ -0,0 +1,92 @@
+#include "EngineThread.hpp"
+
+#include <utility>
+
+namespace tine::dsp {
+
+EngineThread::~EngineThread() {
+    stop();
+}
+
+bool EngineThread::start(const ThreadConfigRequest& request, std::chrono::nanoseconds period, Tick tick) {
+    if (m_running.load(std::memory_order_acquire) || period.count() <= 0 || !tick) {
+        return false;
+    }
+
+    m_tick = std::move(tick);
+    m_periodNanos.store(period.count(), std::memory_order_relaxed);
+    m_wakeups.store(0, std::memory_order_relaxed);
+    m_startNanos.store(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                           std::chrono::steady_clock::now().time_since_epoch())
+                           .count(),
+                       std::memory_order_relaxed);
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_configured = false;
+        m_stopRequested = false;
+    }
+
+    m_running.store(true, std::memory_order_release);
+    m_thread = std::thread([this, request] { run(request); });
+
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_condition.wait(lock, [this] { return m_configured; });
+    return true;
+}
+
+void EngineThread::stop() {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stopRequested = true;
+    }
+    m_condition.notify_all();
+
+    if (m_thread.joinable()) {
+        m_thread.join();
+    }
+    m_running.store(false, std::memory_order_release);
+    m_tick = nullptr;
+}
+
+double EngineThread::wakeupsPerSecond() const noexcept {
+    if (!running()) {
+        return 0.0;
+    }
+    const std::int64_t now =
+        std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch())
+            .count();
+    const double elapsed = static_cast<double>(now - m_startNanos.load(std::memory_order_relaxed)) * 1e-9;
+    return elapsed > 0.0 ? static_cast<double>(wakeups()) / elapsed : 0.0;
+}
+
+void EngineThread::run(ThreadConfigRequest request) {
+    const AppliedThreadConfig applied = configureCurrentThread(request);
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_applied = applied;
+        m_configured = true;
+    }
+    m_condition.notify_all();
+
+    auto deadline = std::chrono::steady_clock::now();
+    for (;;) {
+        deadline += std::chrono::nanoseconds(m_periodNanos.load(std::memory_order_relaxed));
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            if (m_condition.wait_until(lock, deadline, [this] { return m_stopRequested; })) {
+                break;
+            }
+        }
+
+        // After a stall, resynchronise rather than firing a burst of catch-up ticks.
+        const auto now = std::chrono::steady_clock::now();
+        if (now - deadline > std::chrono::nanoseconds(m_periodNanos.load(std::memory_order_relaxed))) {
+            deadline = now;
+        }
+
+        m_wakeups.fetch_add(1, std::memory_order_relaxed);
+        m_tick();
+    }
+}
+
+}  // namespace tine::dsp
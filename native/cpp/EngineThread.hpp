@@ -0,0 +1,94 @@
+#ifndef TINE_NATIVE_UTIL_ENGINETHREAD_HPP
+#define TINE_NATIVE_UTIL_ENGINETHREAD_HPP
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+#include "ThreadConfig.hpp"
+
+namespace tine::dsp {
+
+/**
+ * Dedicated periodic worker that drains the capture ring and runs analysis.
+ *
+ * Replaces platform timers (dispatch sources on iOS, nothing on Linux) with one
+ * thread whose scheduling class, affinity and FP state are configured through
+ * configureCurrentThread(). Ticks are scheduled against absolute deadlines so the
+ * period does not drift with processing time.
+ */
+class EngineThread {
+public:
+    using Tick = std::function<void()>;
+
+    EngineThread() = default;
+    ~EngineThread();
+
+    EngineThread(const EngineThread&) = delete;
+    EngineThread& operator=(const EngineThread&) = delete;
+
+    /**
+     * Start ticking @p tick every @p period. Blocks until the thread has applied
+     * @p request so appliedConfig() is valid on return.
+     * @return False when already running or @p period is not positive.
+     */
+    bool start(const ThreadConfigRequest& request, std::chrono::nanoseconds period, Tick tick);
+
+    /**
+     * Stop ticking and join. Safe to call when not running.
+     */
+    void stop();
+
+    /**
+     * Change the tick period; takes effect from the next deadline.
+     */
+    void setPeriod(std::chrono::nanoseconds period) noexcept {
+        if (period.count() > 0) {
+            m_periodNanos.store(period.count(), std::memory_order_relaxed);
+        }
+    }
+
+    [[nodiscard]] std::chrono::nanoseconds period() const noexcept {
+        return std::chrono::nanoseconds(m_periodNanos.load(std::memory_order_relaxed));
+    }
+
+    [[nodiscard]] bool running() const noexcept { return m_running.load(std::memory_order_acquire); }
+
+    /**
+     * Settings that actually took effect on the engine thread.
+     */
+    [[nodiscard]] const AppliedThreadConfig& appliedConfig() const noexcept { return m_applied; }
+
+    /**
+     * Number of times the thread has woken to run @p tick since start().
+     */
+    [[nodiscard]] std::uint64_t wakeups() const noexcept { return m_wakeups.load(std::memory_order_relaxed); }
+
+    /**
+     * Average wakeup rate since start(); the figure batching is meant to lower.
+     */
+    [[nodiscard]] double wakeupsPerSecond() const noexcept;
+
+private:
+    void run(ThreadConfigRequest request);
+
+    std::thread m_thread;
+    Tick m_tick;
+    AppliedThreadConfig m_applied;
+    std::atomic<std::int64_t> m_periodNanos{0};
+    std::atomic<std::uint64_t> m_wakeups{0};
+    std::atomic<std::int64_t> m_startNanos{0};
+    std::atomic<bool> m_running{false};
+    bool m_configured{false};
+    bool m_stopRequested{false};
+    std::mutex m_mutex;
+    std::condition_variable m_condition;
+};
+
+}  // namespace tine::dsp
+
+#endif  // TINE_NATIVE_UTIL_ENGINETHREAD_HPP
@@ -0,0 +1,111 @@
+#include "InstrumentPresets.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace tine::dsp {
+
+namespace {
+
+// One equal-tempered semitone; band edges get this much slack so a slightly
+// sharp top note or flat bottom string stays inside the lag range.
+constexpr double SEMITONE = 1.0594630943592953;
+
+InstrumentPreset makePreset(const char* name, double minHz, double maxHz, double latency, double threshold,
+                            double highPassHz, double lowPassHz, std::vector<int> targets) {
+    InstrumentPreset preset;
+    preset.name = name;
+    preset.minFrequencyHz = minHz;
+    preset.maxFrequencyHz = maxHz;
+    preset.targetLatencySeconds = latency;
+    preset.threshold = threshold;
+    preset.highPassHz = highPassHz;
+    preset.lowPassHz = lowPassHz;
+    preset.targetMidi = std::move(targets);
+    return preset;
+}
+
+std::vector<InstrumentPreset> makeBuiltIns() {
+    std::vector<InstrumentPreset> presets;
+
+    // Standard tuning E2 A2 D3 G3 B3 E4; the floor leaves room for drop D.
+    presets.push_back(makePreset("guitar", 70.0, 1400.0, 0.06, 0.12, 50.0, 4000.0, {40, 45, 50, 55, 59, 64}));
+
+    // Four-string E1 A1 D2 G2 down to a five-string low B0. Long windows are
+    // unavoidable, so the latency goal is relaxed rather than missed.
+    presets.push_back(makePreset("bass", 29.0, 420.0, 0.12, 0.15, 20.0, 1200.0, {28, 33, 38, 43}));
+
+    // Violin family: G3 D4 A4 E5 / C3 G3 D4 A4 / C2 G2 D3 A3.
+    presets.push_back(makePreset("violin", 185.0, 3000.0, 0.04, 0.10, 120.0, 0.0, {55, 62, 69, 76}));
+    presets.push_back(makePreset("viola", 125.0, 1600.0, 0.05, 0.10, 80.0, 0.0, {48, 55, 62, 69}));
+    presets.push_back(makePreset("cello", 62.0, 1000.0, 0.07, 0.12, 40.0, 3000.0, {36, 43, 50, 57}));
+
+    // Re-entrant G4 C4 E4 A4: a narrow, high band and the cheapest configuration.
+    presets.push_back(makePreset("ukulele", 245.0, 1200.0, 0.035, 0.10, 150.0, 4000.0, {67, 60, 64, 69}));
+
+    presets.push_back(makePreset("voice", 75.0, 1100.0, 0.06, 0.15, 60.0, 3000.0, {}));
+
+    // A0 to C8.
+    presets.push_back(makePreset("piano", 27.0, 4200.0, 0.12, 0.12, 20.0, 0.0, {}));
+
+    presets.push_back(makePreset("chromatic", 30.0, 2000.0, 0.08, 0.12, 25.0, 0.0, {}));
+    return presets;
+}
+
+}  // namespace
+
+void CompiledPreset::applyTo(LatencyPlanRequest& request) const {
+    request.sampleRate = sampleRate;
+    request.minFrequencyHz = preset.minFrequencyHz / SEMITONE;
+    request.targetLatencySeconds = preset.targetLatencySeconds;
+    // Left at 0 so the planner derives the window from the band; an explicit
+    // window the caller sets afterwards still wins.
+    request.windowFrames = 0;
+}
+
+void CompiledPreset::applyTo(PitchEngineConfig& config) const {
+    config.preFilters = preFilters;
+    config.minLag = minLag;
+    config.adaptiveWindow = preset.adaptiveWindow;
+}
+
+CompiledPreset compilePreset(const InstrumentPreset& preset, double sampleRate, double a4Hz) {
+    CompiledPreset compiled;
+    compiled.preset = preset;
+    compiled.sampleRate = sampleRate > 0.0 ? sampleRate : 48000.0;
+
+    const double rate = compiled.sampleRate;
+    const double lowest = std::max(1.0, preset.minFrequencyHz / SEMITONE);
+    const double highest = std::max(lowest, preset.maxFrequencyHz * SEMITONE);
+    compiled.minLag = std::max<std::size_t>(2, static_cast<std::size_t>(std::floor(rate / highest)));
+
+    if (preset.highPassHz > 0.0) {
+        compiled.preFilters.push_back(BiquadCoefficients::highPass(rate, preset.highPassHz));
+    }
+    // A low-pass at or above Nyquist would do nothing but cost cycles.
+    if (preset.lowPassHz > 0.0 && preset.lowPassHz < rate * 0.45) {
+        compiled.preFilters.push_back(BiquadCoefficients::lowPass(rate, preset.lowPassHz));
+    }
+
+    compiled.targetFrequencies.reserve(preset.targetMidi.size());
+    for (int midi : preset.targetMidi) {
+        compiled.targetFrequencies.push_back(a4Hz * std::pow(2.0, (midi - 69) / 12.0));
+    }
+    return compiled;
+}
+
+const std::vector<InstrumentPreset>& builtInPresets() {
+    static const std::vector<InstrumentPreset> presets = makeBuiltIns();
+    return presets;
+}
+
+const InstrumentPreset* builtInPreset(std::string_view name) {
+    for (const InstrumentPreset& preset : builtInPresets()) {
+        if (preset.name == name) {
+            return &preset;
+        }
+    }
+    return nullptr;
+}
+
+}  // namespace tine::dsp
@@ -0,0 +1,77 @@
+#ifndef TINE_NATIVE_DSP_INSTRUMENTPRESETS_HPP
+#define TINE_NATIVE_DSP_INSTRUMENTPRESETS_HPP
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "Biquad.hpp"
+#include "LatencyPlanner.hpp"
+#include "PitchEngine.hpp"
+
+namespace tine::dsp {
+
+/**
+ * Instrument-specific analysis settings, independent of sample rate.
+ */
+struct InstrumentPreset {
+    std::string name;
+    /** Fundamental range the instrument can produce (Hz). */
+    double minFrequencyHz{30.0};
+    double maxFrequencyHz{2000.0};
+    double targetLatencySeconds{0.08};
+    double threshold{0.12};
+    /** Pre-filter corners (Hz); 0 disables the stage. */
+    double highPassHz{0.0};
+    double lowPassHz{0.0};
+    bool adaptiveWindow{true};
+    /** Reference notes (open strings) as MIDI numbers; empty means chromatic. */
+    std::vector<int> targetMidi;
+};
+
+/**
+ * A preset with every sample-rate-dependent table derived once.
+ */
+struct CompiledPreset {
+    InstrumentPreset preset;
+    double sampleRate{0.0};
+    /**
+     * Shortest lag searched: the period of the band's top with a semitone of
+     * slack. The longest follows from the window the planner derives from the
+     * band's bottom, given the same slack in applyTo().
+     */
+    std::size_t minLag{0};
+    std::vector<BiquadCoefficients> preFilters;
+    std::vector<double> targetFrequencies;
+
+    /** Band and latency goal for the planner. */
+    void applyTo(LatencyPlanRequest& request) const;
+
+    /**
+     * Pre-filters, lag floor and window adaptation for the engine. The threshold
+     * is left to the caller so an explicit user choice can win over the preset's.
+     */
+    void applyTo(PitchEngineConfig& config) const;
+};
+
+/**
+ * Built-in presets: guitar, bass, violin, viola, cello, ukulele, voice, piano and
+ * chromatic. Built once and never modified, so references stay valid.
+ */
+const std::vector<InstrumentPreset>& builtInPresets();
+
+/**
+ * Uncompiled built-in definition, for callers that need preset defaults before
+ * the device sample rate is known. nullptr for an unknown name.
+ */
+const InstrumentPreset* builtInPreset(std::string_view name);
+
+/**
+ * Derive @p preset's tables for @p sampleRate (A4 = @p a4Hz for reference notes).
+ */
+CompiledPreset compilePreset(const InstrumentPreset& preset, double sampleRate, double a4Hz = 440.0);
+
+}  // namespace tine::dsp
+
+#endif  // TINE_NATIVE_DSP_INSTRUMENTPRESETS_HPP
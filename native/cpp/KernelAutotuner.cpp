@@ -0,0 +1,286 @@
+#include "KernelAutotuner.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <thread>
+
+#if defined(__APPLE__)
+#include <sys/sysctl.h>
+#endif
+
+namespace tine::dsp {
+
+namespace {
+
+constexpr const char* WISDOM_MAGIC = "tine-kernel-wisdom";
+constexpr std::size_t MIN_TIMED_CALLS = 3;
+// Accepted deviation from Direct, relative to the largest difference value.
+constexpr double MAX_RELATIVE_ERROR = 1e-6;
+
+#if defined(__APPLE__)
+std::string sysctlString(const char* name) {
+    std::size_t size = 0;
+    if (sysctlbyname(name, nullptr, &size, nullptr, 0) != 0 || size == 0) {
+        return {};
+    }
+    std::string value(size, '\0');
+    if (sysctlbyname(name, value.data(), &size, nullptr, 0) != 0) {
+        return {};
+    }
+    value.resize(std::strlen(value.c_str()));
+    return value;
+}
+#else
+std::string cpuinfoField(const char* field) {
+    std::ifstream cpuinfo("/proc/cpuinfo");
+    std::string line;
+    const std::size_t length = std::strlen(field);
+    while (std::getline(cpuinfo, line)) {
+        if (line.compare(0, length, field) != 0) {
+            continue;
+        }
+        const std::size_t colon = line.find(':');
+        if (colon == std::string::npos) {
+            continue;
+        }
+        const std::size_t start = line.find_first_not_of(" \t", colon + 1);
+        return start == std::string::npos ? std::string{} : line.substr(start);
+    }
+    return {};
+}
+#endif
+
+std::string joinNonEmpty(const std::string& a, const std::string& b) {
+    if (a.empty()) {
+        return b;
+    }
+    return b.empty() ? a : a + " " + b;
+}
+
+std::vector<float> makeTestSignal(std::size_t frames) {
+    // Harmonic tone plus low-level noise: realistic magnitudes, no denormals.
+    std::vector<float> signal(frames);
+    std::uint32_t state = 0x9e3779b9u;
+    for (std::size_t i = 0; i < frames; ++i) {
+        state = state * 1664525u + 1013904223u;
+        const double noise = (static_cast<double>(state >> 8) / 16777216.0 - 0.5) * 0.02;
+        const double t = static_cast<double>(i) / 48000.0;
+        signal[i] = static_cast<float>(0.5 * std::sin(2.0 * M_PI * 196.0 * t) +
+                                       0.25 * std::sin(2.0 * M_PI * 392.0 * t) + noise);
+    }
+    return signal;
+}
+
+double medianSecondsPerCall(DifferenceKernel& kernel, const DifferenceKernelChoice& choice, const float* signal,
+                            std::size_t window, std::size_t maxLag, double* out, double budgetSeconds) {
+    using Clock = std::chrono::steady_clock;
+
+    kernel.compute(choice, signal, window, maxLag, out);  // warm caches and branch predictors
+    std::vector<double> samples;
+    const auto deadline = Clock::now() + std::chrono::duration<double>(budgetSeconds);
+    while (samples.size() < MIN_TIMED_CALLS || Clock::now() < deadline) {
+        const auto start = Clock::now();
+        kernel.compute(choice, signal, window, maxLag, out);
+        samples.push_back(std::chrono::duration<double>(Clock::now() - start).count());
+    }
+    // The median shrugs off the odd preemption better than the mean.
+    std::nth_element(samples.begin(), samples.begin() + static_cast<std::ptrdiff_t>(samples.size() / 2),
+                     samples.end());
+    return samples[samples.size() / 2];
+}
+
+}  // namespace
+
+const KernelWisdomEntry* KernelWisdom::find(std::size_t windowSize) const noexcept {
+    for (const KernelWisdomEntry& entry : m_entries) {
+        if (entry.windowSize == windowSize) {
+            return &entry;
+        }
+    }
+    return nullptr;
+}
+
+void KernelWisdom::set(const KernelWisdomEntry& entry) {
+    for (KernelWisdomEntry& existing : m_entries) {
+        if (existing.windowSize == entry.windowSize) {
+            existing = entry;
+            return;
+        }
+    }
+    m_entries.push_back(entry);
+    std::sort(m_entries.begin(), m_entries.end(),
+              [](const KernelWisdomEntry& a, const KernelWisdomEntry& b) { return a.windowSize < b.windowSize; });
+}
+
+std::string KernelWisdom::serialize() const {
+    std::ostringstream out;
+    out << WISDOM_MAGIC << ' ' << kVersion << '\n';
+    out << "cpu " << m_cpuModel << '\n';
+    for (const KernelWisdomEntry& entry : m_entries) {
+        out << entry.windowSize << ' ' << kernelName(entry.choice.kind) << ' ' << entry.choice.fftSize << ' '
+            << entry.secondsPerCall << '\n';
+    }
+    return out.str();
+}
+
+bool KernelWisdom::parse(std::string_view text, KernelWisdom& wisdom) {
+    std::istringstream in{std::string(text)};
+    std::string magic;
+    int version = 0;
+    if (!(in >> magic >> version) || magic != WISDOM_MAGIC || version != kVersion) {
+        return false;
+    }
+
+    std::string key;
+    KernelWisdom parsed;
+    if (!(in >> key) || key != "cpu") {
+        return false;
+    }
+    std::getline(in, parsed.m_cpuModel);
+    const std::size_t start = parsed.m_cpuModel.find_first_not_of(' ');
+    parsed.m_cpuModel = start == std::string::npos ? std::string{} : parsed.m_cpuModel.substr(start);
+
+    // One entry per line, so a line cut short by a partial write is an error
+    // rather than the end of the list.
+    std::string line;
+    while (std::getline(in, line)) {
+        if (line.find_first_not_of(" \t\r") == std::string::npos) {
+            continue;
+        }
+        std::istringstream fields(line);
+        std::size_t window = 0;
+        std::string name;
+        std::size_t fftSize = 0;
+        double seconds = 0.0;
+        KernelWisdomEntry entry;
+        if (!(fields >> window >> name >> fftSize >> seconds) || !(fields >> std::ws).eof() || window == 0 ||
+            !parseKernelName(name, entry.choice.kind)) {
+            return false;
+        }
+        entry.windowSize = window;
+        entry.choice.fftSize = fftSize;
+        entry.secondsPerCall = seconds;
+        parsed.set(entry);
+    }
+
+    wisdom = std::move(parsed);
+    return true;
+}
+
+bool KernelWisdom::load(const std::string& path, const std::string& cpuModel, KernelWisdom& wisdom) {
+    std::ifstream file(path);
+    if (!file) {
+        return false;
+    }
+    std::ostringstream contents;
+    contents << file.rdbuf();
+
+    KernelWisdom parsed;
+    if (!parse(contents.str(), parsed) || parsed.m_cpuModel != cpuModel) {
+        return false;
+    }
+    wisdom = std::move(parsed);
+    return true;
+}
+
+bool KernelWisdom::save(const std::string& path) const {
+    const std::string temporary = path + ".tmp";
+    {
+        std::ofstream file(temporary, std::ios::trunc);
+        if (!file) {
+            return false;
+        }
+        file << serialize();
+        if (!file.flush()) {
+            return false;
+        }
+    }
+    return std::rename(temporary.c_str(), path.c_str()) == 0;
+}
+
+std::string currentCpuModel() {
+#if defined(__APPLE__)
+    std::string model = joinNonEmpty(sysctlString("hw.machine"), sysctlString("machdep.cpu.brand_string"));
+#else
+    std::string model = cpuinfoField("model name");
+    if (model.empty()) {
+        model = cpuinfoField("Hardware");
+    }
+    if (model.empty()) {
+        model = joinNonEmpty(cpuinfoField("CPU implementer"), cpuinfoField("CPU part"));
+    }
+#endif
+    if (model.empty()) {
+        model = "unknown";
+    }
+    std::replace(model.begin(), model.end(), '\n', ' ');
+    return model + " x" + std::to_string(std::thread::hardware_concurrency());
+}
+
+KernelWisdom autotuneDifferenceKernels(const std::vector<std::size_t>& windowSizes,
+                                       const KernelAutotuneOptions& options) {
+    KernelWisdom wisdom(currentCpuModel());
+    if (windowSizes.empty()) {
+        return wisdom;
+    }
+
+    const std::size_t largest = *std::max_element(windowSizes.begin(), windowSizes.end());
+    const std::size_t largestFft = DifferenceKernel::minimumFftSize(largest, largest / 2) * (options.tryLargerFft ? 2 : 1);
+    DifferenceKernel kernel;
+    kernel.reserve(largest, largestFft);
+
+    const std::vector<float> signal = makeTestSignal(largest);
+    std::vector<double> reference(largest / 2 + 1);
+    std::vector<double> candidate(largest / 2 + 1);
+
+    for (std::size_t window : windowSizes) {
+        const std::size_t maxLag = window / 2;
+        if (maxLag < 2) {
+            continue;
+        }
+        kernel.compute({}, signal.data(), window, maxLag, reference.data());
+        const double peak = *std::max_element(reference.begin(), reference.begin() + static_cast<std::ptrdiff_t>(maxLag + 1));
+
+        std::vector<DifferenceKernelChoice> candidates = {
+            {DifferenceKernelKind::Direct, 0},
+            {DifferenceKernelKind::Blocked, 0},
+            {DifferenceKernelKind::Fft, DifferenceKernel::minimumFftSize(window, maxLag)},
+        };
+        if (options.tryLargerFft) {
+            candidates.push_back({DifferenceKernelKind::Fft, DifferenceKernel::minimumFftSize(window, maxLag) * 2});
+        }
+
+        KernelWisdomEntry best;
+        best.windowSize = window;
+        best.secondsPerCall = 0.0;
+        for (const DifferenceKernelChoice& choice : candidates) {
+            if (kernel.compute(choice, signal.data(), window, maxLag, candidate.data()) != choice.kind) {
+                continue;
+            }
+            bool matches = true;
+            for (std::size_t tau = 0; tau <= maxLag && matches; ++tau) {
+                matches = std::fabs(candidate[tau] - reference[tau]) <= MAX_RELATIVE_ERROR * peak + 1e-12;
+            }
+            if (!matches) {
+                continue;
+            }
+
+            const double seconds = medianSecondsPerCall(kernel, choice, signal.data(), window, maxLag,
+                                                        candidate.data(), options.secondsPerCandidate);
+            if (best.secondsPerCall == 0.0 || seconds < best.secondsPerCall) {
+                best.choice = choice;
+                best.secondsPerCall = seconds;
+            }
+        }
+        wisdom.set(best);
+    }
+    return wisdom;
+}
+
+}  // namespace tine::dsp
@@ -0,0 +1,99 @@
+#ifndef TINE_NATIVE_DSP_KERNELAUTOTUNER_HPP
+#define TINE_NATIVE_DSP_KERNELAUTOTUNER_HPP
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "DifferenceKernel.hpp"
+
+namespace tine::dsp {
+
+struct KernelWisdomEntry {
+    std::size_t windowSize{0};
+    DifferenceKernelChoice choice;
+    /** Measured cost of the winning kernel, for diagnostics. */
+    double secondsPerCall{0.0};
+};
+
+/**
+ * Measured-fastest difference kernel per window size for one device.
+ *
+ * Persisted as a small text file:
+ *
+ *     tine-kernel-wisdom <version>
+ *     cpu <model>
+ *     <window> <kernel> <fftSize> <secondsPerCall>
+ *
+ * A file with another version or CPU model is ignored, so an OS update that
+ * changes the reported model or a new kernel set simply triggers a re-tune.
+ */
+class KernelWisdom {
+public:
+    /** Bump when kernels change enough to invalidate earlier measurements. */
+    static constexpr int kVersion = 1;
+
+    KernelWisdom() = default;
+    explicit KernelWisdom(std::string cpuModel) : m_cpuModel(std::move(cpuModel)) {}
+
+    [[nodiscard]] const std::string& cpuModel() const noexcept { return m_cpuModel; }
+    [[nodiscard]] const std::vector<KernelWisdomEntry>& entries() const noexcept { return m_entries; }
+    [[nodiscard]] bool empty() const noexcept { return m_entries.empty(); }
+
+    /**
+     * @return The entry for exactly @p windowSize, or nullptr.
+     */
+    [[nodiscard]] const KernelWisdomEntry* find(std::size_t windowSize) const noexcept;
+
+    /** Insert or replace the entry for entry.windowSize. */
+    void set(const KernelWisdomEntry& entry);
+
+    [[nodiscard]] std::string serialize() const;
+
+    /**
+     * Parse serialize() output. Returns false (leaving @p wisdom untouched) for a
+     * malformed file, including one whose last entry was cut short, or a
+     * different version.
+     */
+    static bool parse(std::string_view text, KernelWisdom& wisdom);
+
+    /**
+     * Load @p path if it exists, parses, and was measured on @p cpuModel.
+     */
+    static bool load(const std::string& path, const std::string& cpuModel, KernelWisdom& wisdom);
+
+    /** Write atomically (temporary file + rename). */
+    [[nodiscard]] bool save(const std::string& path) const;
+
+private:
+    std::string m_cpuModel;
+    std::vector<KernelWisdomEntry> m_entries;
+};
+
+/**
+ * Identifier for the wisdom key: hardware model (e.g. "iPhone15,2") or CPU brand
+ * string plus the logical core count.
+ */
+[[nodiscard]] std::string currentCpuModel();
+
+struct KernelAutotuneOptions {
+    /** Wall-clock spent timing each candidate for each window. */
+    double secondsPerCandidate{0.02};
+    /** Also try the FFT at twice the minimum transform length. */
+    bool tryLargerFft{true};
+};
+
+/**
+ * Time every kernel (and FFT length) for each of @p windowSizes with lag range
+ * window / 2 and return the fastest per window. Candidates whose output differs
+ * from Direct beyond rounding are rejected. Blocking and CPU-heavy: run it on a
+ * low-priority thread while nothing latency-sensitive is active.
+ */
+KernelWisdom autotuneDifferenceKernels(const std::vector<std::size_t>& windowSizes,
+                                       const KernelAutotuneOptions& options = {});
+
+}  // namespace tine::dsp
+
+#endif  // TINE_NATIVE_DSP_KERNELAUTOTUNER_HPP
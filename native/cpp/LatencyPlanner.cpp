@@ -0,0 +1,195 @@
+#include "LatencyPlanner.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+
+namespace tine::dsp {
+
+namespace {
+
+constexpr std::size_t MIN_IO_PERIOD_FRAMES = 64;
+constexpr std::size_t MAX_IO_PERIOD_FRAMES = 1024;
+// Share of the latency target the device IO period may take.
+constexpr double IO_PERIOD_TARGET_SHARE = 0.125;
+// Windows are rounded to this many frames so the lag loops stay vector friendly.
+constexpr std::size_t WINDOW_GRANULE = 32;
+// Drains the ring can fall behind by (scheduling jitter) without overrunning.
+constexpr std::size_t RING_DRAIN_SLACK = 2;
+
+struct Candidate {
+    std::size_t tap{0};
+    std::size_t hop{0};
+    double expected{0.0};
+    double worstCase{0.0};
+    double cpuLoad{0.0};
+    /** Load that must fit the budget: per hop for the worker, per callback inline. */
+    double peakLoad{0.0};
+};
+
+std::size_t roundUp(std::size_t value, std::size_t granule) {
+    return ((value + granule - 1) / granule) * granule;
+}
+
+std::size_t roundUpPowerOfTwo(std::size_t value) {
+    std::size_t v = 1;
+    while (v < value) {
+        v <<= 1;
+    }
+    return v;
+}
+
+double differenceTerms(std::size_t window) {
+    // YIN difference: lags 1..window/2, each summing (window - lag) squared deltas.
+    const double w = static_cast<double>(window);
+    const double lags = static_cast<double>(window / 2);
+    return lags * w - lags * (lags + 1.0) / 2.0;
+}
+
+Candidate evaluate(const LatencyPlanRequest& request, std::size_t io, std::size_t window, std::size_t tap,
+                   std::size_t hop, double analysisSeconds) {
+    const double rate = request.sampleRate;
+    const double ioSeconds = static_cast<double>(io) / rate;
+    const double tapWait = static_cast<double>(tap - io) / rate;
+    const double hopWait = static_cast<double>(hop - tap) / rate;
+    const double halfWindow = static_cast<double>(window) / (2.0 * rate);
+    // Worker results wait for the engine thread's next drain; inline results are
+    // analyzed in the callback and the host is woken as each one is queued.
+    const double drainWait = request.mode == EngineMode::Inline ? 0.0 : static_cast<double>(hop) / rate;
+
+    Candidate candidate;
+    candidate.tap = tap;
+    candidate.hop = hop;
+    candidate.expected = ioSeconds + (tapWait + hopWait + drainWait) / 2.0 + halfWindow + analysisSeconds;
+    candidate.worstCase = ioSeconds + tapWait + hopWait + drainWait + halfWindow + analysisSeconds;
+    candidate.cpuLoad = analysisSeconds / (static_cast<double>(hop) / rate);
+    // Inline analysis has to finish inside the callback that completed the hop.
+    candidate.peakLoad =
+        request.mode == EngineMode::Inline ? analysisSeconds / (static_cast<double>(tap) / rate) : candidate.cpuLoad;
+    return candidate;
+}
+
+}  // namespace
+
+std::size_t windowFramesForFrequency(double sampleRate, double minFrequencyHz) {
+    if (sampleRate <= 0.0 || minFrequencyHz <= 0.0) {
+        return 2048;
+    }
+    // Parabolic refinement needs one lag past the period, and the search stops at window / 2.
+    const auto period = static_cast<std::size_t>(std::ceil(sampleRate / minFrequencyHz));
+    return roundUp(2 * (period + 2), WINDOW_GRANULE);
+}
+
+std::size_t preferredIoPeriodFrames(double sampleRate, double targetLatencySeconds) {
+    const double share = std::max(0.0, sampleRate * targetLatencySeconds * IO_PERIOD_TARGET_SHARE);
+    std::size_t frames = MIN_IO_PERIOD_FRAMES;
+    while (frames * 2 <= share && frames * 2 <= MAX_IO_PERIOD_FRAMES) {
+        frames *= 2;
+    }
+    return frames;
+}
+
+LatencyPlan planLatency(const LatencyPlanRequest& request) {
+    LatencyPlanRequest req = request;
+    if (req.sampleRate <= 0.0) {
+        req.sampleRate = 48000.0;
+    }
+    if (req.maxCpuLoad <= 0.0) {
+        req.maxCpuLoad = 1.0;
+    }
+
+    const std::size_t window = std::max<std::size_t>(
+        req.windowFrames > 0 ? req.windowFrames : windowFramesForFrequency(req.sampleRate, req.minFrequencyHz), 8);
+    const std::size_t io = std::clamp<std::size_t>(req.ioPeriodFrames, 1, window);
+    const double analysisSeconds =
+        req.analysisSeconds > 0.0 ? req.analysisSeconds : differenceTerms(window) * req.secondsPerDifferenceTerm;
+
+    bool haveBest = false;
+    Candidate best;
+    int bestRank = -1;
+
+    for (std::size_t tap = io; tap <= window; tap += io) {
+        for (std::size_t hop = tap; hop <= window; hop += tap) {
+            const Candidate c = evaluate(req, io, window, tap, hop, analysisSeconds);
+            const bool fitsCpu = c.peakLoad <= req.maxCpuLoad;
+            const bool fitsLatency = c.expected <= req.targetLatencySeconds;
+            const int rank = (fitsCpu ? 2 : 0) + (fitsLatency ? 1 : 0);
+
+            bool better = !haveBest || rank > bestRank;
+            if (haveBest && rank == bestRank) {
+                if (rank == 3) {
+                    // Everything fits: spend the slack on fewer analyses, then on latency.
+                    better = c.hop > best.hop || (c.hop == best.hop && c.expected < best.expected);
+                } else if (rank == 2) {
+                    better = c.expected < best.expected;
+                } else {
+                    // CPU budget unreachable: keep the cheapest pipeline.
+                    better = c.peakLoad < best.peakLoad || (c.peakLoad == best.peakLoad && c.expected < best.expected);
+                }
+            }
+
+            if (better) {
+                best = c;
+                bestRank = rank;
+                haveBest = true;
+            }
+        }
+    }
+
+    // Coalesce drains: waking every batchHops hops adds up to (batchHops - 1) hops
+    // of queueing. Inline analysis runs in the capture callback and has nothing to batch.
+    const double hopSeconds = static_cast<double>(best.hop) / req.sampleRate;
+    std::size_t batchHops = 1;
+    if (req.mode == EngineMode::Worker && req.maxBatchLatencySeconds > 0.0) {
+        batchHops += static_cast<std::size_t>(std::floor(req.maxBatchLatencySeconds / hopSeconds));
+    }
+    const double batchLatency = static_cast<double>(batchHops - 1) * hopSeconds;
+
+    LatencyPlan plan;
+    plan.sampleRate = req.sampleRate;
+    plan.mode = req.mode;
+    plan.ioPeriodFrames = io;
+    plan.tapFrames = best.tap;
+    plan.hopFrames = best.hop;
+    plan.windowFrames = window;
+    plan.ringCapacity = roundUpPowerOfTwo((RING_DRAIN_SLACK + batchHops) * best.hop + best.tap);
+    plan.drainPeriodSeconds = static_cast<double>(batchHops) * hopSeconds;
+    plan.batchHops = batchHops;
+    plan.wakeupsPerSecond = 1.0 / plan.drainPeriodSeconds;
+    plan.batchLatencySeconds = batchLatency;
+    plan.minDetectableHz = req.sampleRate / static_cast<double>(window / 2 - 1);
+    plan.analysisSeconds = analysisSeconds;
+    plan.expectedLatencySeconds = best.expected + batchLatency / 2.0;
+    plan.worstCaseLatencySeconds = best.worstCase + batchLatency;
+    plan.cpuLoad = best.cpuLoad;
+    plan.meetsLatencyTarget = best.expected <= req.targetLatencySeconds;
+    plan.cpuBudget = req.maxCpuLoad;
+    plan.meetsCpuBudget = best.peakLoad <= req.maxCpuLoad;
+    return plan;
+}
+
+PitchEngineConfig LatencyPlan::engineConfig(double threshold) const {
+    PitchEngineConfig config;
+    config.sampleRate = sampleRate;
+    config.windowSize = windowFrames;
+    config.hopSize = hopFrames;
+    config.ringCapacity = ringCapacity;
+    config.threshold = threshold;
+    config.mode = mode;
+    config.captureBlockFrames = tapFrames;
+    config.inlineBudgetFraction = cpuBudget;
+    return config;
+}
+
+std::string LatencyPlan::describe() const {
+    char line[224];
+    std::snprintf(line, sizeof(line),
+                  "io=%zu tap=%zu hop=%zu window=%zu ring=%zu batch=%zu wake=%.1f/s latency=%.1fms worst=%.1fms "
+                  "cpu=%.0f%% fmin=%.1fHz",
+                  ioPeriodFrames, tapFrames, hopFrames, windowFrames, ringCapacity, batchHops, wakeupsPerSecond,
+                  expectedLatencySeconds * 1000.0, worstCaseLatencySeconds * 1000.0, cpuLoad * 100.0,
+                  minDetectableHz);
+    return line;
+}
+
+}  // namespace tine::dsp
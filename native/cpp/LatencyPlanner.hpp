@@ -0,0 +1,113 @@
+#ifndef TINE_NATIVE_DSP_LATENCYPLANNER_HPP
+#define TINE_NATIVE_DSP_LATENCYPLANNER_HPP
+
+#include <cstddef>
+#include <string>
+
+#include "PitchEngine.hpp"
+
+namespace tine::dsp {
+
+/**
+ * Latency objective and device facts the planner derives a capture pipeline from.
+ */
+struct LatencyPlanRequest {
+    double sampleRate{48000.0};
+    /** Expected onset-to-result latency the pipeline should stay under (seconds). */
+    double targetLatencySeconds{0.08};
+    /** Lowest fundamental that must stay detectable; sets the window length. */
+    double minFrequencyHz{40.0};
+    /** Hardware IO period actually granted by the device (frames). */
+    std::size_t ioPeriodFrames{256};
+    /** Fixed analysis window (frames), or 0 to derive it from minFrequencyHz. */
+    std::size_t windowFrames{0};
+    EngineMode mode{EngineMode::Worker};
+    /**
+     * Share of one core the detector may use: averaged over a hop for the worker,
+     * within a single capture callback for inline analysis.
+     */
+    double maxCpuLoad{0.5};
+    /** Cost model: seconds per difference-function term (window * maxLag terms per analysis). */
+    double secondsPerDifferenceTerm{1.0e-9};
+    /** Measured seconds per analysis; overrides the cost model when positive. */
+    double analysisSeconds{0.0};
+    /**
+     * Energy policy: extra latency (seconds) the worker may add by letting hops
+     * queue and analyzing them in one wakeup. 0 wakes once per hop. Comes on top
+     * of targetLatencySeconds; results are identical, only delivered in bursts.
+     */
+    double maxBatchLatencySeconds{0.0};
+};
+
+/**
+ * Consistent tap / hop / window / ring sizes plus the latency and load they imply.
+ *
+ * Latency model (onset of a new note to its result leaving the engine):
+ * one IO period, the tap block and hop accumulation beyond it, half a window
+ * for the new note to dominate the YIN difference function, the engine-thread
+ * drain wake-up (worker mode only: inline results wake the host as they are
+ * queued), and one analysis. Expected values take the mean wait for each stage;
+ * worst-case values the full wait.
+ */
+struct LatencyPlan {
+    double sampleRate{0.0};
+    EngineMode mode{EngineMode::Worker};
+    std::size_t ioPeriodFrames{0};
+    std::size_t tapFrames{0};
+    std::size_t hopFrames{0};
+    std::size_t windowFrames{0};
+    std::size_t ringCapacity{0};
+    /** Engine-thread drain period (seconds); batchHops hops long. */
+    double drainPeriodSeconds{0.0};
+    /** Hops analyzed per engine-thread wakeup; 1 unless maxBatchLatencySeconds allows more. */
+    std::size_t batchHops{1};
+    /** Engine-thread wakeups per second the plan implies. */
+    double wakeupsPerSecond{0.0};
+    /** Worst-case latency added by batching (seconds); included in the latency figures. */
+    double batchLatencySeconds{0.0};
+    /** Lowest fundamental the chosen window can resolve (Hz). */
+    double minDetectableHz{0.0};
+    double analysisSeconds{0.0};
+    double expectedLatencySeconds{0.0};
+    double worstCaseLatencySeconds{0.0};
+    /** Average fraction of one core spent in the detector. */
+    double cpuLoad{0.0};
+    /** Requested maxCpuLoad; also the inline per-callback budget. */
+    double cpuBudget{0.0};
+    /** Judged before batching, whose latency was granted separately. */
+    bool meetsLatencyTarget{false};
+    bool meetsCpuBudget{false};
+
+    /**
+     * Engine configuration realising this plan.
+     */
+    [[nodiscard]] PitchEngineConfig engineConfig(double threshold) const;
+
+    /** Compact single-line description for logs and telemetry. */
+    [[nodiscard]] std::string describe() const;
+};
+
+/**
+ * Derive the pipeline for @p request. Tap blocks are whole IO periods and hops
+ * whole tap blocks so every stage boundary lines up; among the candidates that
+ * meet both the latency target and the CPU budget the cheapest (longest hop)
+ * wins, then the one with the lowest latency. When nothing meets both, the CPU
+ * budget is kept and latency is minimised; the plan's meets* flags report what
+ * was achieved.
+ */
+LatencyPlan planLatency(const LatencyPlanRequest& request);
+
+/**
+ * IO period (frames) to ask the device for: a power of two using at most an
+ * eighth of the latency target, clamped to [64, 1024].
+ */
+std::size_t preferredIoPeriodFrames(double sampleRate, double targetLatencySeconds);
+
+/**
+ * Shortest window (frames) whose lag range covers one period of @p minFrequencyHz.
+ */
+std::size_t windowFramesForFrequency(double sampleRate, double minFrequencyHz);
+
+}  // namespace tine::dsp
+
+#endif  // TINE_NATIVE_DSP_LATENCYPLANNER_HPP
@@ -0,0 +1,328 @@
+#include "MelodyAligner.hpp"
+
+#include <algorithm>
+#include <limits>
+
+namespace tine::dsp {
+
+namespace {
+
+constexpr float UNREACHABLE = std::numeric_limits<float>::infinity();
+constexpr float OCTAVE_CENTS = 1200.0F;
+// Keeps (d + bias) positive for any MIDI-range difference, so truncation is
+// floor and the fold needs no rounding call the vectorizer cannot lower.
+constexpr float FOLD_OCTAVES = 16.0F;
+constexpr float FOLD_BIAS = (FOLD_OCTAVES + 0.5F) * OCTAVE_CENTS;
+constexpr std::ptrdiff_t MIN_RADIUS_ROWS = 2;
+
+float liveCentsOf(double frequency) {
+    return static_cast<float>(1200.0 * std::log2(frequency / 440.0) + 6900.0);
+}
+
+bool isVoiced(const PitchResult& result) {
+    return result.isValid && result.frequency > 0.0 && std::isfinite(result.frequency);
+}
+
+}  // namespace
+
+MelodyAligner::MelodyAligner(const MelodyAlignerConfig& config)
+    : m_config(config),
+      m_queue(std::max<std::size_t>(config.queueCapacity, 1)),
+      m_inputs(std::max<std::size_t>(config.inputCapacity, 1)) {
+    m_config.hopSize = std::max<std::size_t>(m_config.hopSize, 1);
+    const double rowsPerSecond = m_config.sampleRate / static_cast<double>(m_config.hopSize);
+
+    for (std::size_t note = 0; note < m_config.melody.size(); ++note) {
+        const MelodyNote& entry = m_config.melody[note];
+        const auto rows = static_cast<std::size_t>(std::max(1.0, std::round(entry.seconds * rowsPerSecond)));
+        const bool rest = !(entry.midi >= 0.0);
+        m_refCents.insert(m_refCents.end(), rows, rest ? 0.0F : static_cast<float>(100.0 * entry.midi));
+        m_refRest.insert(m_refRest.end(), rows, rest ? 1.0F : 0.0F);
+        m_refNote.insert(m_refNote.end(), rows, static_cast<std::uint32_t>(note));
+    }
+    m_rows = m_refCents.size();
+
+    m_radius = std::max(MIN_RADIUS_ROWS,
+                        static_cast<std::ptrdiff_t>(std::round(m_config.bandRadiusSeconds * rowsPerSecond)));
+    m_width = static_cast<std::size_t>(2 * m_radius + 1);
+    m_lag = static_cast<std::size_t>(std::max(0.0, std::round(m_config.lagSeconds * rowsPerSecond)));
+    m_ringSize = m_lag + 1;
+
+    m_previous.resize(m_width);
+    m_current.resize(m_width);
+    m_shifted.resize(m_width + 1);
+    m_cost.resize(m_width);
+    m_steps.resize(m_ringSize * m_width);
+    m_columns.resize(m_ringSize);
+    m_traced.resize(m_ringSize);
+    reset();
+}
+
+void MelodyAligner::reset() noexcept {
+    LiveResult stale;
+    while (m_inputs.pop(stale)) {
+    }
+    // A virtual column before the first: the path enters row 0 diagonally from row -1.
+    m_previous[0] = 0.0F;
+    m_previousLo = -1;
+    m_previousCount = 1;
+    m_center = 0;
+    m_bestRow = 0;
+    m_columnCount = 0;
+    m_committed = 0;
+    m_committedRow = 0;
+    m_firstSampleTime = 0;
+    m_running = AlignmentScore{};
+    m_started = false;
+    m_finished = false;
+    m_score.store(m_running);
+}
+
+bool MelodyAligner::submit(const PitchResult& result, std::uint64_t sampleTime) noexcept {
+    const bool voiced = isVoiced(result);
+    return m_inputs.push(LiveResult{sampleTime, voiced ? liveCentsOf(result.frequency) : 0.0F, voiced});
+}
+
+std::size_t MelodyAligner::drain() noexcept {
+    std::size_t aligned = 0;
+    LiveResult live;
+    while (m_inputs.pop(live)) {
+        align(live);
+        ++aligned;
+    }
+    return aligned;
+}
+
+void MelodyAligner::process(const PitchResult& result, std::uint64_t sampleTime) noexcept {
+    const bool voiced = isVoiced(result);
+    align(LiveResult{sampleTime, voiced ? liveCentsOf(result.frequency) : 0.0F, voiced});
+}
+
+void MelodyAligner::align(const LiveResult& live) noexcept {
+    if (m_finished || m_rows == 0) {
+        return;
+    }
+
+    if (!m_started) {
+        // Silence before the first note is not part of the performance.
+        if (!live.voiced) {
+            return;
+        }
+        m_started = true;
+        m_firstSampleTime = live.sampleTime;
+    } else if (live.sampleTime > m_firstSampleTime) {
+        const std::uint64_t hop = m_config.hopSize;
+        const std::uint64_t slot = (live.sampleTime - m_firstSampleTime + hop / 2) / hop;
+        // Past the band radius the filler columns carry no evidence, and aligning
+        // them one by one would make a long dropout cost the band width per hop.
+        if (slot > m_columnCount + static_cast<std::uint64_t>(m_radius)) {
+            resync(slot - m_columnCount);
+        }
+        while (m_columnCount < slot && !m_finished) {
+            advance(false, 0.0F, m_firstSampleTime + m_columnCount * hop);
+        }
+    }
+    if (!m_finished) {
+        advance(live.voiced, live.liveCents, live.sampleTime);
+    }
+}
+
+void MelodyAligner::advance(bool voiced, float liveCents, std::uint64_t sampleTime) noexcept {
+    const auto rows = static_cast<std::ptrdiff_t>(m_rows);
+    const std::ptrdiff_t lo = std::max<std::ptrdiff_t>(0, m_center - m_radius);
+    const std::ptrdiff_t hi = std::min(rows, m_center + m_radius + 1);
+    if (lo >= hi) {
+        finish();
+        return;
+    }
+    const auto count = static_cast<std::size_t>(hi - lo);
+    const std::size_t slot = m_columnCount % m_ringSize;
+    std::uint8_t* steps = m_steps.data() + slot * m_width;
+    float* cost = m_cost.data();
+    float* current = m_current.data();
+    float* shifted = m_shifted.data();
+    const float* refCents = m_refCents.data() + lo;
+    const float* refRest = m_refRest.data() + lo;
+
+    // Local costs: saturating pitch distance, or the fixed unvoiced / rest costs.
+    const auto restCost = static_cast<float>(m_config.restCost);
+    if (!voiced) {
+        const auto unvoicedCost = static_cast<float>(m_config.unvoicedCost);
+        for (std::size_t k = 0; k < count; ++k) {
+            cost[k] = unvoicedCost * (1.0F - refRest[k]);
+        }
+    } else {
+        const auto saturation = static_cast<float>(m_config.saturationCents);
+        const float inverseSaturation = 1.0F / saturation;
+        if (m_config.foldOctaves) {
+            for (std::size_t k = 0; k < count; ++k) {
+                const float d = liveCents - refCents[k];
+                const auto octaves = static_cast<float>(static_cast<int>((d + FOLD_BIAS) / OCTAVE_CENTS)) - FOLD_OCTAVES;
+                const float folded = d - OCTAVE_CENTS * octaves;
+                const float a = std::min(std::fabs(folded), saturation) * inverseSaturation;
+                cost[k] = a + refRest[k] * (restCost - a);
+            }
+        } else {
+            for (std::size_t k = 0; k < count; ++k) {
+                const float a = std::min(std::fabs(liveCents - refCents[k]), saturation) * inverseSaturation;
+                cost[k] = a + refRest[k] * (restCost - a);
+            }
+        }
+    }
+
+    // shifted[k] is the previous column's cost at row lo + k - 1; rows it did not
+    // cover are unreachable.
+    std::fill(shifted, shifted + count + 1, UNREACHABLE);
+    const std::ptrdiff_t first = std::max<std::ptrdiff_t>(0, m_previousLo - (lo - 1));
+    const std::ptrdiff_t last = std::min(static_cast<std::ptrdiff_t>(count + 1),
+                                         m_previousLo + static_cast<std::ptrdiff_t>(m_previousCount) - (lo - 1));
+    if (first < last) {
+        std::copy(m_previous.data() + (lo - 1 + first - m_previousLo),
+                  m_previous.data() + (lo - 1 + last - m_previousLo), shifted + first);
+    }
+
+    // Diagonal and horizontal steps depend only on the previous column.
+    const auto penalty = static_cast<float>(m_config.stepPenalty);
+    for (std::size_t k = 0; k < count; ++k) {
+        const float diagonal = shifted[k];
+        const float horizontal = shifted[k + 1] + penalty;
+        current[k] = cost[k] + std::min(diagonal, horizontal);
+        steps[k] = horizontal < diagonal ? Horizontal : Diagonal;
+    }
+    // Vertical steps chain within the column.
+    for (std::size_t k = 1; k < count; ++k) {
+        const float vertical = current[k - 1] + cost[k] + penalty;
+        if (vertical < current[k]) {
+            current[k] = vertical;
+            steps[k] = Vertical;
+        }
+    }
+
+    std::size_t best = 0;
+    for (std::size_t k = 1; k < count; ++k) {
+        best = current[k] < current[best] ? k : best;
+    }
+    const float minimum = current[best];
+    if (!(minimum < UNREACHABLE)) {
+        finish();
+        return;
+    }
+    // Only differences matter; rebasing keeps float sums small over long songs.
+    for (std::size_t k = 0; k < count; ++k) {
+        current[k] -= minimum;
+    }
+
+    m_columns[slot] = Column{lo, count, sampleTime, liveCents, voiced};
+    m_previous.swap(m_current);
+    m_previousLo = lo;
+    m_previousCount = count;
+    m_bestRow = lo + static_cast<std::ptrdiff_t>(best);
+
+    // Follow the path: lean the band by a row when it drifts into the outer half.
+    const std::ptrdiff_t drift = m_bestRow - m_center;
+    m_center += 1 + (drift > m_radius / 2 ? 1 : 0) - (drift < -m_radius / 2 ? 1 : 0);
+
+    const std::uint64_t column = m_columnCount++;
+    m_running.leadingReferenceSeconds = rowSeconds(m_bestRow);
+    if (column >= m_committed + m_lag) {
+        traceBack(column, m_bestRow, column - m_lag);
+        commit(column - m_lag, m_traced[0]);
+    }
+    m_score.store(m_running);
+}
+
+void MelodyAligner::traceBack(std::uint64_t column, std::ptrdiff_t row, std::uint64_t until) noexcept {
+    m_traced[column - until] = row;
+    while (column > until) {
+        const std::size_t slot = column % m_ringSize;
+        const std::uint8_t step = m_steps[slot * m_width + static_cast<std::size_t>(row - m_columns[slot].lo)];
+        if (step != Horizontal) {
+            --row;
+        }
+        if (step != Vertical) {
+            --column;
+            m_traced[column - until] = row;
+        }
+    }
+}
+
+void MelodyAligner::commit(std::uint64_t column, std::ptrdiff_t row) noexcept {
+    const Column& live = m_columns[column % m_ringSize];
+    // A later traceback may leave the committed prefix: while a note is held
+    // longer than written, the provisional path runs ahead along the diagonal
+    // and the next trace ends lower. Committed positions never move back.
+    row = std::max(row, m_committedRow);
+    m_committedRow = row;
+    const auto index = static_cast<std::size_t>(row);
+
+    AlignedFrame frame;
+    frame.sampleTime = live.sampleTime;
+    frame.referenceSeconds = rowSeconds(row);
+    frame.noteIndex = m_refNote[index];
+    frame.voiced = live.voiced;
+    frame.onRest = m_refRest[index] > 0.5F;
+    if (frame.voiced && !frame.onRest) {
+        double deviation = static_cast<double>(live.liveCents) - static_cast<double>(m_refCents[index]);
+        if (m_config.foldOctaves) {
+            deviation -= 1200.0 * std::round(deviation / 1200.0);
+        }
+        frame.deviationCents = deviation;
+        ++m_running.scoredFrames;
+        m_running.inTuneFrames += std::fabs(deviation) <= m_config.inTuneCents ? 1 : 0;
+        m_running.sumCents += deviation;
+        m_running.sumAbsCents += std::fabs(deviation);
+    }
+    ++m_running.alignedFrames;
+    m_running.referenceSeconds = frame.referenceSeconds;
+    m_running.noteIndex = frame.noteIndex;
+    m_queue.push(frame);
+    m_committed = column + 1;
+}
+
+void MelodyAligner::commitPending() noexcept {
+    if (m_columnCount > m_committed) {
+        const std::uint64_t last = m_columnCount - 1;
+        traceBack(last, m_bestRow, m_committed);
+        const std::uint64_t from = m_committed;
+        for (std::uint64_t column = from; column <= last; ++column) {
+            commit(column, m_traced[column - from]);
+        }
+    }
+}
+
+void MelodyAligner::resync(std::uint64_t columns) noexcept {
+    commitPending();
+    // Unvoiced filler would have moved the band one row per column.
+    m_center += static_cast<std::ptrdiff_t>(columns);
+    m_columnCount += columns;
+    m_committed = m_columnCount;
+
+    const std::ptrdiff_t lo = std::max<std::ptrdiff_t>(0, m_center - m_radius);
+    const std::ptrdiff_t hi = std::min(static_cast<std::ptrdiff_t>(m_rows), m_center + m_radius + 1);
+    if (lo >= hi) {
+        finish();
+        return;
+    }
+    // A free virtual column under the whole band: the next column may start the
+    // path on any row, as the first column starts it on row 0.
+    m_previousLo = lo - 1;
+    m_previousCount = static_cast<std::size_t>(hi - lo);
+    std::fill(m_previous.begin(), m_previous.begin() + static_cast<std::ptrdiff_t>(m_previousCount), 0.0F);
+    m_score.store(m_running);
+}
+
+void MelodyAligner::finish() noexcept {
+    if (m_finished) {
+        return;
+    }
+    m_finished = true;
+    commitPending();
+    m_running.finished = true;
+    m_score.store(m_running);
+}
+
+double MelodyAligner::rowSeconds(std::ptrdiff_t row) const noexcept {
+    return static_cast<double>(row) * static_cast<double>(m_config.hopSize) / m_config.sampleRate;
+}
+
+}  // namespace tine::dsp
@@ -0,0 +1,234 @@
+#ifndef TINE_NATIVE_DSP_MELODYALIGNER_HPP
+#define TINE_NATIVE_DSP_MELODYALIGNER_HPP
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "SeqLock.hpp"
+#include "SpscQueue.hpp"
+#include "YinPitchDetector.hpp"
+
+namespace tine::dsp {
+
+/** One note of the target melody. */
+struct MelodyNote {
+    /** MIDI note, fractional allowed; negative for a rest. */
+    double midi{69.0};
+    double seconds{0.5};
+};
+
+struct MelodyAlignerConfig {
+    double sampleRate{48000.0};
+    /** Frames of new audio per result; the reference is laid out on the same grid. */
+    std::size_t hopSize{512};
+    std::vector<MelodyNote> melody;
+    /**
+     * Sakoe-Chiba band half-width: how far (in reference time) the singer may be
+     * ahead of or behind the band centre. Cost per result is linear in it.
+     */
+    double bandRadiusSeconds{2.0};
+    /** Delay before a result's alignment is committed and scored. */
+    double lagSeconds{0.5};
+    /** Pitch distance at which the local cost saturates; larger errors cost the same. */
+    double saturationCents{200.0};
+    /** Compare pitch classes, so singing an octave off still aligns and scores. */
+    bool foldOctaves{true};
+    /** Local cost of an unvoiced result against a note (breaths, consonants). */
+    double unvoicedCost{0.3};
+    /** Local cost of a voiced result against a rest. */
+    double restCost{0.6};
+    /** Added to steps that hold either sequence still, so the path prefers the diagonal. */
+    double stepPenalty{0.05};
+    /** |deviation| at or below which a scored result counts as in tune. */
+    double inTuneCents{25.0};
+    /** Committed frames the queue holds before new ones are dropped. */
+    std::size_t queueCapacity{1024};
+    /**
+     * Results submit() holds for the aligning thread. A dropped result leaves a
+     * gap that is aligned as unvoiced, like a skipped hop.
+     */
+    std::size_t inputCapacity{256};
+};
+
+/** One result with its committed position in the melody. */
+struct AlignedFrame {
+    /** Stream frame of the newest sample behind the result. */
+    std::uint64_t sampleTime{0};
+    double referenceSeconds{0.0};
+    /** Index into the melody. */
+    std::uint32_t noteIndex{0};
+    bool voiced{false};
+    bool onRest{false};
+    /** Sung pitch minus the target (folded to +/-600 with foldOctaves); NaN unless voiced on a note. */
+    double deviationCents{NAN};
+};
+
+/** Running intonation score over committed frames. */
+struct AlignmentScore {
+    std::uint64_t alignedFrames{0};
+    /** Voiced frames aligned to a note (not a rest). */
+    std::uint64_t scoredFrames{0};
+    std::uint64_t inTuneFrames{0};
+    double sumCents{0.0};
+    double sumAbsCents{0.0};
+    /** Committed position, lagSeconds behind the singer. */
+    double referenceSeconds{0.0};
+    /** Best position after the newest result: immediate but may still be revised. */
+    double leadingReferenceSeconds{0.0};
+    std::uint32_t noteIndex{0};
+    bool finished{false};
+
+    [[nodiscard]] double meanCents() const noexcept {
+        return scoredFrames > 0 ? sumCents / static_cast<double>(scoredFrames) : 0.0;
+    }
+    [[nodiscard]] double meanAbsCents() const noexcept {
+        return scoredFrames > 0 ? sumAbsCents / static_cast<double>(scoredFrames) : 0.0;
+    }
+    [[nodiscard]] double inTuneFraction() const noexcept {
+        return scoredFrames > 0 ? static_cast<double>(inTuneFrames) / static_cast<double>(scoredFrames) : 0.0;
+    }
+};
+
+/**
+ * Streaming dynamic-time-warping alignment of the live result stream to a
+ * reference melody, for scoring practice while the user sings.
+ *
+ * Each result adds one DTW column restricted to a Sakoe-Chiba band around the
+ * expected position. The band centre advances one reference frame per result
+ * and leans by one more or one less when the best path drifts into the outer
+ * half of the band, so the singer may hold still or run at up to double speed
+ * without leaving it. The column update is split so that the local costs and the
+ * diagonal/horizontal minima are straight-line loops over float arrays that
+ * the compiler vectorizes (Clang from -O2, GCC from -O3); only the vertical
+ * recurrence runs as a scalar scan.
+ *
+ * Memory is fixed at construction: two cost columns and a ring of step
+ * directions for lagSeconds of columns. After every result the path is traced
+ * back from the best cell of the newest column and the column lagSeconds old
+ * is committed: pushed to an SPSC queue and added to the score. Committed
+ * positions never move back, even when a later trace would place the column
+ * earlier. Alignment starts at the first voiced result and ends once the band
+ * has passed the end of the melody or finish() is called. A gap in the stream longer than the band
+ * radius commits what is pending and restarts the path anywhere in the band
+ * around the expected position, instead of aligning every missing hop.
+ *
+ * The detector thread only calls submit(), which copies the result into an
+ * SPSC queue, so the column update never runs inside the capture budget. One
+ * aligning thread calls drain() (or process() directly), finish(), reset() and
+ * pop(); none of them allocate. Any thread may read score().
+ */
+class MelodyAligner {
+public:
+    explicit MelodyAligner(const MelodyAlignerConfig& config);
+
+    MelodyAligner(const MelodyAligner&) = delete;
+    MelodyAligner& operator=(const MelodyAligner&) = delete;
+
+    /**
+     * Detector thread: queue one result for the aligning thread. Wait-free.
+     * @param sampleTime Stream frame index of the newest sample behind it.
+     * @return false (and counts it) when the input queue is full.
+     */
+    bool submit(const PitchResult& result, std::uint64_t sampleTime) noexcept;
+
+    /** Aligning thread: align every submitted result. @return Results aligned. */
+    std::size_t drain() noexcept;
+
+    /**
+     * Aligning thread: add one result directly, bypassing the input queue.
+     * @param sampleTime Stream frame index of the newest sample behind it; skipped
+     *        hops are aligned as unvoiced results.
+     */
+    void process(const PitchResult& result, std::uint64_t sampleTime) noexcept;
+
+    /** Aligning thread: commit the frames still inside the lag and stop. */
+    void finish() noexcept;
+
+    /** Aligning thread: start over at the beginning of the melody, discarding queued input. */
+    void reset() noexcept;
+
+    /** Consumer thread. @return false when no frame is waiting. */
+    bool pop(AlignedFrame& frame) noexcept { return m_queue.pop(frame); }
+
+    [[nodiscard]] std::uint64_t droppedFrames() const noexcept { return m_queue.dropped(); }
+
+    /** Results submit() refused because the aligning thread fell behind. */
+    [[nodiscard]] std::uint64_t droppedResults() const noexcept { return m_inputs.dropped(); }
+
+    /** Any thread. */
+    [[nodiscard]] AlignmentScore score() const noexcept { return m_score.load(); }
+
+    /** Reference frames (results) the melody spans. */
+    [[nodiscard]] std::size_t referenceFrames() const noexcept { return m_rows; }
+
+    [[nodiscard]] const MelodyAlignerConfig& config() const noexcept { return m_config; }
+
+private:
+    enum Step : std::uint8_t { Diagonal, Horizontal, Vertical };
+
+    struct LiveResult {
+        std::uint64_t sampleTime{0};
+        float liveCents{0.0F};
+        bool voiced{false};
+    };
+
+    struct Column {
+        std::ptrdiff_t lo{0};
+        std::size_t count{0};
+        std::uint64_t sampleTime{0};
+        float liveCents{0.0F};
+        bool voiced{false};
+    };
+
+    void align(const LiveResult& live) noexcept;
+    void advance(bool voiced, float liveCents, std::uint64_t sampleTime) noexcept;
+    /** Commit every pending column, then skip @p columns and let the path re-enter anywhere in the band. */
+    void resync(std::uint64_t columns) noexcept;
+    void commitPending() noexcept;
+    /** Trace from (@p column, @p row) back to @p until, recording the first row met in each column. */
+    void traceBack(std::uint64_t column, std::ptrdiff_t row, std::uint64_t until) noexcept;
+    void commit(std::uint64_t column, std::ptrdiff_t row) noexcept;
+    [[nodiscard]] double rowSeconds(std::ptrdiff_t row) const noexcept;
+
+    MelodyAlignerConfig m_config;
+    SpscQueue<AlignedFrame> m_queue;
+    SpscQueue<LiveResult> m_inputs;
+    SeqLock<AlignmentScore> m_score;
+
+    // Reference laid out one row per hop.
+    std::size_t m_rows{0};
+    std::vector<float> m_refCents;
+    std::vector<float> m_refRest;
+    std::vector<std::uint32_t> m_refNote;
+
+    std::ptrdiff_t m_radius{0};
+    std::size_t m_width{0};
+    std::size_t m_lag{0};
+    std::size_t m_ringSize{0};
+
+    // Aligning-thread state.
+    std::vector<float> m_previous;
+    std::vector<float> m_current;
+    std::vector<float> m_shifted;
+    std::vector<float> m_cost;
+    std::vector<std::uint8_t> m_steps;
+    std::vector<Column> m_columns;
+    std::vector<std::ptrdiff_t> m_traced;
+    std::ptrdiff_t m_previousLo{-1};
+    std::size_t m_previousCount{0};
+    std::ptrdiff_t m_center{0};
+    std::ptrdiff_t m_bestRow{0};
+    std::uint64_t m_columnCount{0};
+    std::uint64_t m_committed{0};
+    std::ptrdiff_t m_committedRow{0};
+    std::uint64_t m_firstSampleTime{0};
+    AlignmentScore m_running;
+    bool m_started{false};
+    bool m_finished{false};
+};
+
+}  // namespace tine::dsp
+
+#endif  // TINE_NATIVE_DSP_MELODYALIGNER_HPP
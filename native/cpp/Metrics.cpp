@@ -0,0 +1,226 @@
+#include "Metrics.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <cstdio>
+
+namespace tine::dsp {
+
+namespace {
+
+void appendHeader(std::string& out, const std::string& name, const std::string& help, const char* type) {
+    out += "# HELP ";
+    out += name;
+    out += ' ';
+    out += help;
+    out += "\n# TYPE ";
+    out += name;
+    out += ' ';
+    out += type;
+    out += '\n';
+}
+
+void appendSample(std::string& out, const std::string& name, const char* labels, double value) {
+    char text[64];
+    // Counts stay exact; measured values only need a few significant digits.
+    if (value == std::floor(value) && std::fabs(value) < 9007199254740992.0) {
+        std::snprintf(text, sizeof(text), " %.0f\n", value);
+    } else {
+        std::snprintf(text, sizeof(text), " %.9g\n", value);
+    }
+    out += name;
+    out += labels;
+    out += text;
+}
+
+}  // namespace
+
+MetricHistogram::MetricHistogram() : m_buckets(new std::atomic<std::uint64_t>[BUCKET_COUNT]) {
+    for (std::size_t i = 0; i < BUCKET_COUNT; ++i) {
+        m_buckets[i].store(0, std::memory_order_relaxed);
+    }
+}
+
+std::size_t MetricHistogram::bucketIndex(std::uint64_t value) noexcept {
+    value = std::min(value, MAX_VALUE);
+    if (value < 2 * SUB_BUCKETS) {
+        return static_cast<std::size_t>(value);
+    }
+    // Octave [2^msb, 2^(msb+1)) keeps its top SUB_BUCKET_BITS + 1 bits.
+    const unsigned msb = static_cast<unsigned>(std::bit_width(value)) - 1;
+    const unsigned shift = msb - SUB_BUCKET_BITS;
+    return static_cast<std::size_t>((shift + 1) * SUB_BUCKETS + ((value >> shift) - SUB_BUCKETS));
+}
+
+std::uint64_t MetricHistogram::bucketUpperBound(std::size_t index) noexcept {
+    if (index < 2 * SUB_BUCKETS) {
+        return index;
+    }
+    const std::uint64_t shift = index / SUB_BUCKETS - 1;
+    const std::uint64_t mantissa = index % SUB_BUCKETS + SUB_BUCKETS;
+    return ((mantissa + 1) << shift) - 1;
+}
+
+void MetricHistogram::record(std::uint64_t value) noexcept {
+    m_buckets[bucketIndex(value)].fetch_add(1, std::memory_order_relaxed);
+    m_sum.fetch_add(value, std::memory_order_relaxed);
+
+    std::uint64_t current = m_max.load(std::memory_order_relaxed);
+    while (value > current && !m_max.compare_exchange_weak(current, value, std::memory_order_relaxed)) {
+    }
+    current = m_min.load(std::memory_order_relaxed);
+    while (value < current && !m_min.compare_exchange_weak(current, value, std::memory_order_relaxed)) {
+    }
+}
+
+void MetricHistogram::merge(const MetricHistogram& other) noexcept {
+    for (std::size_t i = 0; i < BUCKET_COUNT; ++i) {
+        if (const std::uint64_t count = other.m_buckets[i].load(std::memory_order_relaxed)) {
+            m_buckets[i].fetch_add(count, std::memory_order_relaxed);
+        }
+    }
+    m_sum.fetch_add(other.m_sum.load(std::memory_order_relaxed), std::memory_order_relaxed);
+
+    const std::uint64_t otherMax = other.m_max.load(std::memory_order_relaxed);
+    std::uint64_t current = m_max.load(std::memory_order_relaxed);
+    while (otherMax > current && !m_max.compare_exchange_weak(current, otherMax, std::memory_order_relaxed)) {
+    }
+    const std::uint64_t otherMin = other.m_min.load(std::memory_order_relaxed);
+    current = m_min.load(std::memory_order_relaxed);
+    while (otherMin < current && !m_min.compare_exchange_weak(current, otherMin, std::memory_order_relaxed)) {
+    }
+}
+
+void MetricHistogram::reset() noexcept {
+    for (std::size_t i = 0; i < BUCKET_COUNT; ++i) {
+        m_buckets[i].store(0, std::memory_order_relaxed);
+    }
+    m_sum.store(0, std::memory_order_relaxed);
+    m_min.store(~std::uint64_t{0}, std::memory_order_relaxed);
+    m_max.store(0, std::memory_order_relaxed);
+}
+
+MetricHistogram::Summary MetricHistogram::summarize(const std::vector<double>& quantiles) const {
+    std::vector<std::uint64_t> counts(BUCKET_COUNT);
+    Summary summary;
+    for (std::size_t i = 0; i < BUCKET_COUNT; ++i) {
+        counts[i] = m_buckets[i].load(std::memory_order_relaxed);
+        summary.count += counts[i];
+    }
+    summary.sum = m_sum.load(std::memory_order_relaxed);
+    summary.max = m_max.load(std::memory_order_relaxed);
+    summary.min = summary.count > 0 ? std::min(m_min.load(std::memory_order_relaxed), summary.max) : 0;
+
+    for (double q : quantiles) {
+        std::uint64_t value = 0;
+        if (summary.count > 0) {
+            // Rank of the quantile sample, 1-based, so q = 1 is the last sample.
+            const auto rank = static_cast<std::uint64_t>(
+                std::max(1.0, std::ceil(std::clamp(q, 0.0, 1.0) * static_cast<double>(summary.count))));
+            std::uint64_t seen = 0;
+            for (std::size_t i = 0; i < BUCKET_COUNT; ++i) {
+                seen += counts[i];
+                if (seen >= rank) {
+                    // Never report past the exact extremes.
+                    value = std::clamp(bucketUpperBound(i), summary.min, summary.max);
+                    break;
+                }
+            }
+        }
+        summary.quantiles.emplace_back(q, value);
+    }
+    return summary;
+}
+
+std::string MetricsSnapshot::toText() const {
+    std::string out;
+    for (const Value& value : values) {
+        appendHeader(out, value.name, value.help, value.kind == MetricKind::Counter ? "counter" : "gauge");
+        appendSample(out, value.name, "", value.value);
+    }
+    for (const Histogram& histogram : histograms) {
+        appendHeader(out, histogram.name, histogram.help, "summary");
+        for (const auto& [q, v] : histogram.summary.quantiles) {
+            char labels[32];
+            std::snprintf(labels, sizeof(labels), "{quantile=\"%g\"}", q);
+            appendSample(out, histogram.name, labels, static_cast<double>(v) * histogram.scale);
+        }
+        appendSample(out, histogram.name + "_sum", "", static_cast<double>(histogram.summary.sum) * histogram.scale);
+        appendSample(out, histogram.name + "_count", "", static_cast<double>(histogram.summary.count));
+    }
+    return out;
+}
+
+const std::vector<double>& MetricsRegistry::defaultQuantiles() {
+    static const std::vector<double> quantiles{0.5, 0.9, 0.99, 0.999};
+    return quantiles;
+}
+
+MetricsRegistry::Entry* MetricsRegistry::find(const std::string& name, MetricKind kind) {
+    for (Entry& entry : m_entries) {
+        if (entry.name == name && entry.kind == kind) {
+            return &entry;
+        }
+    }
+    return nullptr;
+}
+
+MetricsRegistry::Entry& MetricsRegistry::add(const std::string& name, const std::string& help, MetricKind kind,
+                                              double scale) {
+    Entry& entry = m_entries.emplace_back();
+    entry.name = name;
+    entry.help = help;
+    entry.kind = kind;
+    entry.scale = scale;
+    return entry;
+}
+
+MetricCounter& MetricsRegistry::counter(const std::string& name, const std::string& help) {
+    if (Entry* entry = find(name, MetricKind::Counter)) {
+        return *entry->counter;
+    }
+    Entry& entry = add(name, help, MetricKind::Counter, 1.0);
+    entry.counter = std::make_unique<MetricCounter>();
+    return *entry.counter;
+}
+
+MetricGauge& MetricsRegistry::gauge(const std::string& name, const std::string& help) {
+    if (Entry* entry = find(name, MetricKind::Gauge)) {
+        return *entry->gauge;
+    }
+    Entry& entry = add(name, help, MetricKind::Gauge, 1.0);
+    entry.gauge = std::make_unique<MetricGauge>();
+    return *entry.gauge;
+}
+
+MetricHistogram& MetricsRegistry::histogram(const std::string& name, const std::string& help, double scale) {
+    if (Entry* entry = find(name, MetricKind::Histogram)) {
+        return *entry->histogram;
+    }
+    Entry& entry = add(name, help, MetricKind::Histogram, scale);
+    entry.histogram = std::make_unique<MetricHistogram>();
+    return *entry.histogram;
+}
+
+MetricsSnapshot MetricsRegistry::snapshot() const {
+    MetricsSnapshot snapshot;
+    for (const Entry& entry : m_entries) {
+        switch (entry.kind) {
+            case MetricKind::Counter:
+                snapshot.values.push_back(
+                    {entry.name, entry.help, entry.kind, static_cast<double>(entry.counter->value())});
+                break;
+            case MetricKind::Gauge:
+                snapshot.values.push_back({entry.name, entry.help, entry.kind, entry.gauge->value()});
+                break;
+            case MetricKind::Histogram:
+                snapshot.histograms.push_back(
+                    {entry.name, entry.help, entry.scale, entry.histogram->summarize(defaultQuantiles())});
+                break;
+        }
+    }
+    return snapshot;
+}
+
+}  // namespace tine::dsp
@@ -0,0 +1,180 @@
+#ifndef TINE_NATIVE_UTIL_METRICS_HPP
+#define TINE_NATIVE_UTIL_METRICS_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace tine::dsp {
+
+/**
+ * Monotonic event or frame count. add() is a single relaxed fetch_add.
+ */
+class MetricCounter {
+public:
+    void add(std::uint64_t amount = 1) noexcept { m_value.fetch_add(amount, std::memory_order_relaxed); }
+
+    [[nodiscard]] std::uint64_t value() const noexcept { return m_value.load(std::memory_order_relaxed); }
+
+private:
+    std::atomic<std::uint64_t> m_value{0};
+};
+
+/**
+ * Last-written value, or with raise() a high-water mark.
+ */
+class MetricGauge {
+public:
+    void set(double value) noexcept { m_value.store(value, std::memory_order_relaxed); }
+
+    /** Keep the larger of the current and @p value. */
+    void raise(double value) noexcept {
+        double current = m_value.load(std::memory_order_relaxed);
+        while (value > current && !m_value.compare_exchange_weak(current, value, std::memory_order_relaxed)) {
+        }
+    }
+
+    [[nodiscard]] double value() const noexcept { return m_value.load(std::memory_order_relaxed); }
+
+private:
+    std::atomic<double> m_value{0.0};
+};
+
+/**
+ * HDR-style log-linear histogram of non-negative integers (e.g. nanoseconds).
+ *
+ * Values below 2 * SUB_BUCKETS land in exact buckets; above that each power of
+ * two is split into SUB_BUCKETS linear buckets, so any recorded value is known
+ * to within 1/SUB_BUCKETS (about 1.6 %). record() is lock-free: relaxed
+ * fetch_adds plus a CAS for the extremes. Values past MAX_VALUE saturate into
+ * the top bucket; max() stays exact.
+ */
+class MetricHistogram {
+public:
+    static constexpr unsigned SUB_BUCKET_BITS = 6;
+    static constexpr std::uint64_t SUB_BUCKETS = std::uint64_t{1} << SUB_BUCKET_BITS;
+    static constexpr unsigned MAX_VALUE_BITS = 40;
+    static constexpr std::uint64_t MAX_VALUE = (std::uint64_t{1} << MAX_VALUE_BITS) - 1;
+    static constexpr std::size_t BUCKET_COUNT = (MAX_VALUE_BITS - SUB_BUCKET_BITS + 1) * SUB_BUCKETS;
+
+    struct Summary {
+        std::uint64_t count{0};
+        std::uint64_t sum{0};
+        std::uint64_t min{0};
+        std::uint64_t max{0};
+        /** (quantile, value) pairs; value is the upper edge of the quantile's bucket. */
+        std::vector<std::pair<double, std::uint64_t>> quantiles;
+    };
+
+    MetricHistogram();
+
+    MetricHistogram(const MetricHistogram&) = delete;
+    MetricHistogram& operator=(const MetricHistogram&) = delete;
+
+    void record(std::uint64_t value) noexcept;
+
+    /**
+     * Add every sample recorded in @p other, e.g. to aggregate per-stream
+     * histograms. Lock-free; either side may still be recording.
+     */
+    void merge(const MetricHistogram& other) noexcept;
+
+    /** Forget every sample. Only while nothing is recording. */
+    void reset() noexcept;
+
+    /**
+     * Consistent enough for monitoring: buckets are read one by one while writers
+     * may still be recording, so the count comes from the buckets themselves.
+     */
+    [[nodiscard]] Summary summarize(const std::vector<double>& quantiles) const;
+
+    [[nodiscard]] static std::size_t bucketIndex(std::uint64_t value) noexcept;
+    /** Largest value that maps to @p index. */
+    [[nodiscard]] static std::uint64_t bucketUpperBound(std::size_t index) noexcept;
+
+private:
+    std::unique_ptr<std::atomic<std::uint64_t>[]> m_buckets;
+    std::atomic<std::uint64_t> m_sum{0};
+    std::atomic<std::uint64_t> m_min{~std::uint64_t{0}};
+    std::atomic<std::uint64_t> m_max{0};
+};
+
+enum class MetricKind : std::uint8_t { Counter, Gauge, Histogram };
+
+/**
+ * Point-in-time copy of every registered metric, safe to format or ship off the
+ * real-time threads.
+ */
+struct MetricsSnapshot {
+    struct Value {
+        std::string name;
+        std::string help;
+        MetricKind kind{MetricKind::Counter};
+        double value{0.0};
+    };
+
+    struct Histogram {
+        std::string name;
+        std::string help;
+        /** Multiplier from recorded integers to the exported unit (1e-9 for ns -> s). */
+        double scale{1.0};
+        MetricHistogram::Summary summary;
+    };
+
+    std::vector<Value> values;
+    std::vector<Histogram> histograms;
+
+    /**
+     * Prometheus text exposition (version 0.0.4); histograms are written as
+     * summaries with quantile labels, in the exported unit.
+     */
+    [[nodiscard]] std::string toText() const;
+};
+
+/**
+ * Owns a fixed set of named metrics. Register everything up front (registration
+ * allocates); the returned references stay valid for the registry's lifetime and
+ * are then updated from any thread without locks. snapshot() may run
+ * concurrently with updates.
+ */
+class MetricsRegistry {
+public:
+    /** Quantiles reported for every histogram. */
+    static const std::vector<double>& defaultQuantiles();
+
+    MetricsRegistry() = default;
+
+    MetricsRegistry(const MetricsRegistry&) = delete;
+    MetricsRegistry& operator=(const MetricsRegistry&) = delete;
+
+    /** Registering an existing name returns the existing metric. */
+    MetricCounter& counter(const std::string& name, const std::string& help);
+    MetricGauge& gauge(const std::string& name, const std::string& help);
+    MetricHistogram& histogram(const std::string& name, const std::string& help, double scale = 1.0);
+
+    [[nodiscard]] MetricsSnapshot snapshot() const;
+
+private:
+    struct Entry {
+        std::string name;
+        std::string help;
+        MetricKind kind{MetricKind::Counter};
+        double scale{1.0};
+        std::unique_ptr<MetricCounter> counter;
+        std::unique_ptr<MetricGauge> gauge;
+        std::unique_ptr<MetricHistogram> histogram;
+    };
+
+    Entry* find(const std::string& name, MetricKind kind);
+    Entry& add(const std::string& name, const std::string& help, MetricKind kind, double scale);
+
+    std::vector<Entry> m_entries;
+};
+
+}  // namespace tine::dsp
+
+#endif  // TINE_NATIVE_UTIL_METRICS_HPP
@@ -0,0 +1,269 @@
+#include "MidiGenerator.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+
+#include <unistd.h>
+
+namespace tine::dsp {
+
+namespace {
+
+constexpr int BEND_CENTRE = 8192;
+constexpr int BEND_MAX = 16383;
+// 120 bpm: the tempo the file declares, so ticks map to seconds exactly.
+constexpr std::uint32_t MICROSECONDS_PER_QUARTER = 500000;
+
+void appendBigEndian(std::vector<std::uint8_t>& out, std::uint32_t value, int bytes) {
+    for (int shift = (bytes - 1) * 8; shift >= 0; shift -= 8) {
+        out.push_back(static_cast<std::uint8_t>(value >> shift));
+    }
+}
+
+void appendVariableLength(std::vector<std::uint8_t>& out, std::uint32_t value) {
+    std::uint8_t groups[5];
+    int count = 0;
+    do {
+        groups[count++] = static_cast<std::uint8_t>(value & 0x7F);
+        value >>= 7;
+    } while (value > 0);
+    while (count > 1) {
+        out.push_back(static_cast<std::uint8_t>(groups[--count] | 0x80));
+    }
+    out.push_back(groups[0]);
+}
+
+}  // namespace
+
+std::size_t MidiEvent::toBytes(std::uint8_t out[3]) const noexcept {
+    const std::uint8_t ch = channel & 0x0F;
+    switch (type) {
+        case MidiEventType::NoteOn:
+            out[0] = static_cast<std::uint8_t>(0x90 | ch);
+            out[1] = note & 0x7F;
+            out[2] = velocity & 0x7F;
+            break;
+        case MidiEventType::NoteOff:
+            out[0] = static_cast<std::uint8_t>(0x80 | ch);
+            out[1] = note & 0x7F;
+            out[2] = velocity & 0x7F;
+            break;
+        case MidiEventType::PitchBend:
+            out[0] = static_cast<std::uint8_t>(0xE0 | ch);
+            out[1] = static_cast<std::uint8_t>(bend & 0x7F);
+            out[2] = static_cast<std::uint8_t>((bend >> 7) & 0x7F);
+            break;
+    }
+    return 3;
+}
+
+MidiGenerator::MidiGenerator(const MidiGeneratorConfig& config)
+    : m_config(config), m_queue(std::max<std::size_t>(config.queueCapacity, 16)) {
+    m_config.channel &= 0x0F;
+    m_config.retriggerHops = std::clamp<std::size_t>(m_config.retriggerHops, 1, 2);
+    m_config.offProbability = std::min(m_config.offProbability, m_config.onProbability);
+    if (!(m_config.bendRangeSemitones > 0.0)) {
+        m_config.bendRangeSemitones = MidiGeneratorConfig{}.bendRangeSemitones;
+    }
+}
+
+void MidiGenerator::process(const PitchResult& result, std::uint64_t sampleTime, double levelDb) noexcept {
+    const bool voiced = result.isValid && result.frequency > 0.0 && std::isfinite(result.midi) &&
+                        result.midi >= 0.0 && result.midi <= 127.0;
+    const bool onset = std::isfinite(levelDb) && std::isfinite(m_lastLevelDb) &&
+                       levelDb - m_lastLevelDb >= m_config.onsetRiseDb;
+    m_lastLevelDb = levelDb;
+
+    if (m_note < 0) {
+        if (voiced && result.probability >= m_config.onProbability) {
+            noteOn(static_cast<int>(std::lround(result.midi)), result.midi, sampleTime,
+                   velocityFor(result.probability, levelDb));
+        }
+        return;
+    }
+
+    if (!voiced || result.probability < m_config.offProbability) {
+        noteOff(sampleTime);
+        return;
+    }
+
+    const int nearest = static_cast<int>(std::lround(result.midi));
+    const double deviationCents = (result.midi - static_cast<double>(m_note)) * 100.0;
+    if (nearest != m_note && std::fabs(deviationCents) >= m_config.retriggerCents) {
+        // Lock: one stray hop bends; the same new note twice running replaces it.
+        m_pendingHops = nearest == m_pendingNote ? m_pendingHops + 1 : 1;
+        m_pendingNote = nearest;
+        if (m_pendingHops >= m_config.retriggerHops) {
+            noteOff(sampleTime);
+            noteOn(nearest, result.midi, sampleTime, velocityFor(result.probability, levelDb));
+        } else {
+            bendTo(result.midi, sampleTime, false);
+        }
+        return;
+    }
+
+    m_pendingNote = -1;
+    m_pendingHops = 0;
+    if (onset && result.probability >= m_config.onProbability) {
+        noteOff(sampleTime);
+        noteOn(nearest, result.midi, sampleTime, velocityFor(result.probability, levelDb));
+        return;
+    }
+    bendTo(result.midi, sampleTime, false);
+}
+
+void MidiGenerator::allNotesOff(std::uint64_t sampleTime) noexcept {
+    if (m_note >= 0) {
+        noteOff(sampleTime);
+    }
+    m_lastLevelDb = NAN;
+}
+
+void MidiGenerator::emit(MidiEventType type, std::uint64_t sampleTime, std::uint8_t note, std::uint8_t velocity,
+                         std::uint16_t bend) noexcept {
+    MidiEvent event;
+    event.sampleTime = sampleTime;
+    event.type = type;
+    event.channel = m_config.channel;
+    event.note = note;
+    event.velocity = velocity;
+    event.bend = bend;
+    m_queue.push(event);
+}
+
+void MidiGenerator::noteOn(int note, double midi, std::uint64_t sampleTime, std::uint8_t velocity) noexcept {
+    m_note = std::clamp(note, 0, 127);
+    m_pendingNote = -1;
+    m_pendingHops = 0;
+    // Same timestamp, bend first: the note starts in tune.
+    bendTo(midi, sampleTime, true);
+    emit(MidiEventType::NoteOn, sampleTime, static_cast<std::uint8_t>(m_note), velocity);
+}
+
+void MidiGenerator::noteOff(std::uint64_t sampleTime) noexcept {
+    emit(MidiEventType::NoteOff, sampleTime, static_cast<std::uint8_t>(m_note), 0);
+    m_note = -1;
+    m_pendingNote = -1;
+    m_pendingHops = 0;
+}
+
+void MidiGenerator::bendTo(double midi, std::uint64_t sampleTime, bool force) noexcept {
+    const double semitones = midi - static_cast<double>(m_note);
+    const int bend = std::clamp(
+        BEND_CENTRE + static_cast<int>(std::lround(semitones / m_config.bendRangeSemitones * BEND_CENTRE)), 0,
+        BEND_MAX);
+    const double unitsPerCent = BEND_CENTRE / (m_config.bendRangeSemitones * 100.0);
+    if (!force && std::abs(bend - m_sentBend) < m_config.bendResolutionCents * unitsPerCent) {
+        return;
+    }
+    m_sentBend = bend;
+    emit(MidiEventType::PitchBend, sampleTime, 0, 0, static_cast<std::uint16_t>(bend));
+}
+
+std::uint8_t MidiGenerator::velocityFor(double probability, double levelDb) const noexcept {
+    double position;
+    if (std::isfinite(levelDb) && m_config.velocityCeilingDb > m_config.velocityFloorDb) {
+        position = (levelDb - m_config.velocityFloorDb) / (m_config.velocityCeilingDb - m_config.velocityFloorDb);
+    } else {
+        // No level: a clean, confident onset plays mezzo-forte and up.
+        const double span = 1.0 - m_config.onProbability;
+        position = 0.5 + 0.5 * (span > 0.0 ? (probability - m_config.onProbability) / span : 1.0);
+    }
+    return static_cast<std::uint8_t>(std::clamp(1.0 + std::clamp(position, 0.0, 1.0) * 126.0, 1.0, 127.0));
+}
+
+std::vector<std::uint8_t> encodeStandardMidiFile(const std::vector<MidiEvent>& events, double sampleRate,
+                                                 std::uint16_t ticksPerQuarter) {
+    if (!(sampleRate > 0.0)) {
+        sampleRate = 48000.0;
+    }
+    if (ticksPerQuarter == 0 || ticksPerQuarter > 0x7FFF) {
+        ticksPerQuarter = 960;
+    }
+    const double ticksPerSecond = ticksPerQuarter * 1.0e6 / MICROSECONDS_PER_QUARTER;
+
+    std::vector<std::uint8_t> track;
+    appendVariableLength(track, 0);
+    const std::uint8_t tempo[] = {0xFF, 0x51, 0x03};
+    track.insert(track.end(), tempo, tempo + 3);
+    appendBigEndian(track, MICROSECONDS_PER_QUARTER, 3);
+
+    const std::uint64_t origin = events.empty() ? 0 : events.front().sampleTime;
+    std::uint64_t previousTick = 0;
+    for (const MidiEvent& event : events) {
+        // Ticks from absolute time, so rounding never accumulates across deltas.
+        const std::uint64_t sampleOffset = event.sampleTime > origin ? event.sampleTime - origin : 0;
+        const auto tick = static_cast<std::uint64_t>(
+            std::llround(static_cast<double>(sampleOffset) / sampleRate * ticksPerSecond));
+        const std::uint64_t delta = tick > previousTick ? tick - previousTick : 0;
+        previousTick = std::max(previousTick, tick);
+        appendVariableLength(track, static_cast<std::uint32_t>(std::min<std::uint64_t>(delta, 0x0FFFFFFF)));
+
+        std::uint8_t bytes[3];
+        const std::size_t length = event.toBytes(bytes);
+        track.insert(track.end(), bytes, bytes + length);
+    }
+    appendVariableLength(track, 0);
+    const std::uint8_t endOfTrack[] = {0xFF, 0x2F, 0x00};
+    track.insert(track.end(), endOfTrack, endOfTrack + 3);
+
+    std::vector<std::uint8_t> file = {'M', 'T', 'h', 'd'};
+    appendBigEndian(file, 6, 4);
+    appendBigEndian(file, 0, 2);  // format 0
+    appendBigEndian(file, 1, 2);  // one track
+    appendBigEndian(file, ticksPerQuarter, 2);
+    const std::uint8_t trackId[] = {'M', 'T', 'r', 'k'};
+    file.insert(file.end(), trackId, trackId + 4);
+    appendBigEndian(file, static_cast<std::uint32_t>(track.size()), 4);
+    file.insert(file.end(), track.begin(), track.end());
+    return file;
+}
+
+bool writeStandardMidiFile(const std::string& path, const std::vector<MidiEvent>& events, double sampleRate,
+                           std::uint16_t ticksPerQuarter) {
+    const std::vector<std::uint8_t> bytes = encodeStandardMidiFile(events, sampleRate, ticksPerQuarter);
+    std::FILE* file = std::fopen(path.c_str(), "wb");
+    if (!file) {
+        return false;
+    }
+    const bool written = std::fwrite(bytes.data(), 1, bytes.size(), file) == bytes.size();
+    return std::fclose(file) == 0 && written;
+}
+
+bool FdMidiByteSink::send(const std::uint8_t* bytes, std::size_t length, std::uint64_t /*sampleTime*/) {
+    while (length > 0) {
+        const ssize_t written = ::write(m_fd, bytes, length);
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return false;
+        }
+        bytes += written;
+        length -= static_cast<std::size_t>(written);
+    }
+    return true;
+}
+
+std::size_t drainMidiEvents(MidiGenerator& generator, MidiByteSink& sink, std::vector<MidiEvent>* record,
+                            std::size_t* failed) {
+    std::size_t count = 0;
+    MidiEvent event;
+    while (generator.pop(event)) {
+        std::uint8_t bytes[3];
+        // Keep draining past a failed send so the queue never backs up into the
+        // audio threads and the record stays complete.
+        if (sink.send(bytes, event.toBytes(bytes), event.sampleTime)) {
+            ++count;
+        } else if (failed) {
+            ++*failed;
+        }
+        if (record) {
+            record->push_back(event);
+        }
+    }
+    return count;
+}
+
+}  // namespace tine::dsp
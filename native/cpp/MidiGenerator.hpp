@@ -0,0 +1,170 @@
+#ifndef TINE_NATIVE_DSP_MIDIGENERATOR_HPP
+#define TINE_NATIVE_DSP_MIDIGENERATOR_HPP
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "SpscQueue.hpp"
+#include "YinPitchDetector.hpp"
+
+namespace tine::dsp {
+
+enum class MidiEventType : std::uint8_t { NoteOn, NoteOff, PitchBend };
+
+/**
+ * One channel-voice message stamped with the stream frame it was decided at.
+ */
+struct MidiEvent {
+    /** Capture frame index (from stream start) of the newest sample behind the decision. */
+    std::uint64_t sampleTime{0};
+    MidiEventType type{MidiEventType::NoteOn};
+    std::uint8_t channel{0};
+    std::uint8_t note{0};
+    std::uint8_t velocity{0};
+    /** 14-bit bend, 8192 = centre. PitchBend only. */
+    std::uint16_t bend{8192};
+
+    /**
+     * Encode as a MIDI 1.0 message into @p out.
+     * @return Bytes written (always 3).
+     */
+    std::size_t toBytes(std::uint8_t out[3]) const noexcept;
+};
+
+struct MidiGeneratorConfig {
+    double sampleRate{48000.0};
+    /** Channel 0-15 every event is sent on. */
+    std::uint8_t channel{0};
+    /** Probability a result needs to start a note; held notes survive down to offProbability. */
+    double onProbability{0.9};
+    double offProbability{0.75};
+    /**
+     * A held note is replaced only when the pitch stays this far from it for
+     * retriggerHops consecutive results; nearer excursions are bent instead.
+     */
+    double retriggerCents{70.0};
+    /** Capped at 2 so a note change adds at most one hop. */
+    std::size_t retriggerHops{2};
+    /** Hop level rise (dB) that re-articulates a held note, e.g. a re-picked string. */
+    double onsetRiseDb{9.0};
+    /** Receiver's pitch-bend range (semitones each way). */
+    double bendRangeSemitones{2.0};
+    /** Smallest bend change worth sending (cents). */
+    double bendResolutionCents{1.0};
+    /** Hop level (dBFS) mapped to velocity 1 and 127; without a level, probability is used. */
+    double velocityFloorDb{-60.0};
+    double velocityCeilingDb{-6.0};
+    /** Events the queue holds before new ones are dropped. */
+    std::size_t queueCapacity{1024};
+};
+
+/**
+ * Turns the per-hop result stream into note-on/off and 14-bit pitch-bend events.
+ *
+ * Decisions are made on the result that provides the evidence, so a note-on or
+ * note-off leaves on the same hop and a note change at most one hop later
+ * (retriggerHops = 2). Events go to a lock-free SPSC queue: process() runs on
+ * whichever thread produces results and never allocates; one other thread
+ * drains with pop().
+ */
+class MidiGenerator {
+public:
+    explicit MidiGenerator(const MidiGeneratorConfig& config = {});
+
+    MidiGenerator(const MidiGenerator&) = delete;
+    MidiGenerator& operator=(const MidiGenerator&) = delete;
+
+    /**
+     * Producer thread: feed one analysis result.
+     * @param sampleTime Stream frame index of the newest sample in the analyzed window.
+     * @param levelDb Hop RMS level in dBFS; NaN when unknown (no onset detection,
+     *        velocity from probability).
+     */
+    void process(const PitchResult& result, std::uint64_t sampleTime, double levelDb = NAN) noexcept;
+
+    /** Producer thread: release any held note (stream stopped or reset). */
+    void allNotesOff(std::uint64_t sampleTime) noexcept;
+
+    /** Consumer thread. @return false when no event is waiting. */
+    bool pop(MidiEvent& event) noexcept { return m_queue.pop(event); }
+
+    /** Events lost because the consumer fell behind. */
+    [[nodiscard]] std::uint64_t droppedEvents() const noexcept { return m_queue.dropped(); }
+
+    /** Held note, or -1. Producer thread only. */
+    [[nodiscard]] int heldNote() const noexcept { return m_note; }
+
+    [[nodiscard]] const MidiGeneratorConfig& config() const noexcept { return m_config; }
+
+private:
+    void emit(MidiEventType type, std::uint64_t sampleTime, std::uint8_t note, std::uint8_t velocity,
+              std::uint16_t bend = 8192) noexcept;
+    void noteOn(int note, double midi, std::uint64_t sampleTime, std::uint8_t velocity) noexcept;
+    void noteOff(std::uint64_t sampleTime) noexcept;
+    void bendTo(double midi, std::uint64_t sampleTime, bool force) noexcept;
+    [[nodiscard]] std::uint8_t velocityFor(double probability, double levelDb) const noexcept;
+
+    MidiGeneratorConfig m_config;
+    SpscQueue<MidiEvent> m_queue;
+    int m_note{-1};
+    int m_pendingNote{-1};
+    std::size_t m_pendingHops{0};
+    int m_sentBend{8192};
+    double m_lastLevelDb{NAN};
+};
+
+/**
+ * Standard MIDI File (format 0, one track) from events in time order. Sample
+ * times become ticks at 120 bpm and @p ticksPerQuarter resolution, rebased so
+ * the first event falls on tick 0.
+ * @return Complete file contents.
+ */
+std::vector<std::uint8_t> encodeStandardMidiFile(const std::vector<MidiEvent>& events, double sampleRate,
+                                                 std::uint16_t ticksPerQuarter = 960);
+
+/**
+ * Write encodeStandardMidiFile() to @p path.
+ * @return false on any I/O error.
+ */
+bool writeStandardMidiFile(const std::string& path, const std::vector<MidiEvent>& events, double sampleRate,
+                           std::uint16_t ticksPerQuarter = 960);
+
+/**
+ * Destination for raw MIDI bytes, for local testing against a synth or a capture
+ * tool. Called from the draining thread, never from the audio threads.
+ */
+class MidiByteSink {
+public:
+    virtual ~MidiByteSink() = default;
+    virtual bool send(const std::uint8_t* bytes, std::size_t length, std::uint64_t sampleTime) = 0;
+};
+
+/**
+ * Writes bytes unframed to a file descriptor: a raw MIDI device node such as
+ * /dev/snd/midiC1D0, a FIFO, or a file. Does not own the descriptor.
+ */
+class FdMidiByteSink final : public MidiByteSink {
+public:
+    explicit FdMidiByteSink(int fd) : m_fd(fd) {}
+
+    bool send(const std::uint8_t* bytes, std::size_t length, std::uint64_t sampleTime) override;
+
+private:
+    int m_fd;
+};
+
+/**
+ * Consumer thread: pop every waiting event into @p sink, and into @p record
+ * when non-null (e.g. for a later writeStandardMidiFile()). Events the sink
+ * refuses are still recorded and added to @p failed when non-null.
+ * @return Events the sink accepted.
+ */
+std::size_t drainMidiEvents(MidiGenerator& generator, MidiByteSink& sink, std::vector<MidiEvent>* record = nullptr,
+                            std::size_t* failed = nullptr);
+
+}  // namespace tine::dsp
+
+#endif  // TINE_NATIVE_DSP_MIDIGENERATOR_HPP
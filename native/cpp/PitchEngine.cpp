@@ -0,0 +1,502 @@
+#include "PitchEngine.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+
+namespace tine::dsp {
+
+namespace {
+
+constexpr std::size_t CALIBRATION_RUNS = 3;
+// Lag range kept above the tracked period. Growing uses the tighter margin so a
+// falling note widens the window before it leaves the range; shrinking uses the
+// wider one so a note hovering near a boundary does not flip levels.
+constexpr double GROW_LAG_HEADROOM = 1.25;
+constexpr double SHRINK_LAG_HEADROOM = 2.0;
+
+// One step down the adaptive ladder; kept even like the detector's active size.
+std::size_t halveWindow(std::size_t window) {
+    return (window / 2) & ~static_cast<std::size_t>(1);
+}
+
+PitchEngineConfig sanitize(PitchEngineConfig config) {
+    if (config.windowSize < 4) {
+        config.windowSize = 4;
+    }
+    config.windowSize &= ~static_cast<std::size_t>(1);
+    config.hopSize = std::clamp<std::size_t>(config.hopSize, 1, config.windowSize);
+    if (config.captureBlockFrames == 0) {
+        config.captureBlockFrames = config.hopSize;
+    }
+    // The window lives outside the ring; it only has to absorb one capture block
+    // arriving while a full hop is still waiting to be drained.
+    config.ringCapacity = std::max(config.ringCapacity, config.hopSize + config.captureBlockFrames);
+    if (config.inlineStrikeLimit == 0) {
+        config.inlineStrikeLimit = 1;
+    }
+    config.minAdaptiveWindow = std::clamp<std::size_t>(config.minAdaptiveWindow, 4, config.windowSize);
+    return config;
+}
+
+}  // namespace
+
+PitchEngine::Meters::Meters(MetricsRegistry& registry)
+    : capturedFrames(registry.counter("tine_capture_frames_total", "Frames accepted from the capture callback.")),
+      droppedFrames(registry.counter("tine_capture_dropped_frames_total", "Frames refused because the ring was full.")),
+      analyzedFrames(registry.counter("tine_analyzed_frames_total", "Frames that entered the analysis window.")),
+      skippedFrames(
+          registry.counter("tine_skipped_frames_total", "Frames overwritten before the engine thread read them.")),
+      overruns(registry.counter("tine_overruns_total", "Times the engine thread was lapped by capture.")),
+      results(registry.counter("tine_results_total", "Pitch results emitted.")),
+      gateOpenFrames(registry.counter("tine_gate_open_frames_total", "Hop frames whose result was voiced.")),
+      gateClosedFrames(registry.counter("tine_gate_closed_frames_total", "Hop frames whose result was unvoiced.")),
+      inlineFallbacks(registry.counter("tine_inline_fallbacks_total", "Inline analysis moved to the worker.")),
+      windowResizes(registry.counter("tine_window_resizes_total", "Adaptive window size changes.")),
+      drainWakeups(registry.counter("tine_drain_wakeups_total", "processPending() calls on the engine thread.")),
+      ringFill(registry.gauge("tine_ring_fill_frames", "Frames waiting for the detector at the last drain.")),
+      ringHighWater(registry.gauge("tine_ring_fill_high_water_frames", "Most frames ever waiting for the detector.")),
+      activeWindow(registry.gauge("tine_active_window_frames", "Window currently analyzed.")),
+      inlineActive(registry.gauge("tine_inline_active", "1 while analysis runs on the capture thread.")),
+      analysisNanos(registry.histogram("tine_analysis_seconds", "Detector time per analyzed hop.", 1e-9)) {}
+
+PitchEngine::PitchEngine(const PitchEngineConfig& config)
+    : m_config(sanitize(config)),
+      m_ring(m_config.ringCapacity),
+      // After an overrun resume one hop behind the producer: the next read yields
+      // a whole hop of the newest audio.
+      m_detectorConsumer(m_ring.addConsumer(m_config.overflow == OverflowPolicy::OverwriteOldest
+                                                ? ConsumerMode::Lagging
+                                                : ConsumerMode::Blocking,
+                                            m_config.hopSize)),
+      m_detector(m_config.sampleRate, m_config.windowSize, m_config.threshold),
+      m_window(m_config.windowSize, 0.0f),
+      m_hop(m_config.hopSize, 0.0f),
+      m_activeWindow(m_config.windowSize),
+      m_appliedThreshold(m_config.threshold),
+      m_pendingThreshold(m_config.threshold),
+      m_activeWindowPublished(m_config.windowSize),
+      m_meters(m_metrics) {
+    // One analysis runs per completed hop; when hops are shorter than a capture
+    // callback several analyses share that callback's budget.
+    const std::size_t framesPerAnalysis = std::min(m_config.hopSize, m_config.captureBlockFrames);
+    m_inlineBudgetSeconds =
+        m_config.sampleRate > 0.0
+            ? m_config.inlineBudgetFraction * static_cast<double>(framesPerAnalysis) / m_config.sampleRate
+            : 0.0;
+
+    for (const BiquadCoefficients& coefficients : m_config.preFilters) {
+        m_preFilters.emplace_back(coefficients);
+    }
+    if (m_config.referenceTone) {
+        m_referenceNotches.resize(std::max<std::size_t>(m_config.referenceNotchHarmonics, 1));
+    }
+    if (m_config.minLag > 0) {
+        m_detector.setMinLag(m_config.minLag);
+    }
+    m_detector.setLagRefinement(m_config.lagRefinement);
+    // Before calibration, so the inline budget check times the kernel that will run.
+    if (!m_config.kernelWisdom.empty()) {
+        m_detector.setKernelWisdom(m_config.kernelWisdom);
+    }
+
+    if (m_config.mode == EngineMode::Inline) {
+        calibrateInline();
+    }
+    m_meters.activeWindow.set(static_cast<double>(m_activeWindow));
+    m_meters.inlineActive.set(inlineActive() ? 1.0 : 0.0);
+}
+
+std::size_t PitchEngine::pushAudio(const float* samples, std::size_t frames) {
+    if (!samples || frames == 0) {
+        return 0;
+    }
+
+    // Only this thread ever clears the flag, so a relaxed read is current.
+    if (!m_inlineActive.load(std::memory_order_relaxed)) {
+        const std::size_t accepted = m_ring.write(samples, frames);
+        m_meters.capturedFrames.add(accepted);
+        if (accepted < frames) {
+            m_meters.droppedFrames.add(frames - accepted);
+            m_detectorDroppedFrames.fetch_add(frames - accepted, std::memory_order_release);
+            log(RtLogEvent::CaptureDropped, static_cast<double>(frames - accepted));
+        }
+        return accepted;
+    }
+
+    // With no other consumers the inline detector is the only reader; skip the copy.
+    const bool broadcast = m_ring.consumerCount() > 1;
+    const std::size_t written = broadcast ? m_ring.write(samples, frames) : 0;
+
+    std::size_t consumed = 0;
+    const bool overBudget = inlinePush(samples, frames, consumed);
+
+    std::size_t accepted = written;
+    if (broadcast) {
+        // The detector's cursor belongs to this thread while inline; move it past
+        // what was analyzed here so a fallback resumes exactly at the next frame.
+        m_ring.skip(m_detectorConsumer, consumed);
+    } else {
+        accepted = consumed + (consumed < frames ? m_ring.write(samples + consumed, frames - consumed) : 0);
+    }
+
+    if (overBudget) {
+        fallBackToWorker();
+    }
+    m_meters.capturedFrames.add(accepted);
+    if (accepted < frames) {
+        m_meters.droppedFrames.add(frames - accepted);
+        log(RtLogEvent::CaptureDropped, static_cast<double>(frames - accepted));
+    }
+    // Frames the detector saw neither inline nor through the ring; nonzero only
+    // after a fallback into a full ring.
+    const std::size_t missed = frames - std::max(consumed, accepted);
+    if (missed > 0) {
+        m_detectorDroppedFrames.fetch_add(missed, std::memory_order_release);
+    }
+    return accepted;
+}
+
+std::size_t PitchEngine::processPending() {
+    if (m_inlineActive.load(std::memory_order_acquire)) {
+        return 0;
+    }
+
+    // Inline mode hands over on a hop boundary, so m_hopFill is zero the first
+    // time this thread sees it.
+    m_meters.drainWakeups.add();
+    const auto waiting = static_cast<double>(m_ring.available(m_detectorConsumer));
+    m_meters.ringFill.set(waiting);
+    m_meters.ringHighWater.raise(waiting);
+
+    std::size_t emitted = 0;
+    for (;;) {
+        std::size_t lost = 0;
+        float* dst = m_hop.data() + m_hopFill;
+        const std::size_t got = m_ring.read(m_detectorConsumer, dst, m_config.hopSize - m_hopFill, &lost);
+        if (lost > 0) {
+            m_meters.skippedFrames.add(lost);
+            m_meters.overruns.add();
+            log(RtLogEvent::CaptureOverrun, static_cast<double>(lost), static_cast<double>(overruns()));
+        }
+        m_streamFrame += lost;
+        if (lost > 0) {
+            // Neither the partial hop nor the window is contiguous with what
+            // follows; drop both and refill from the first frame after the gap.
+            if (m_hopFill > 0) {
+                std::memmove(m_hop.data(), dst, got * sizeof(float));
+                m_streamFrame += m_hopFill;
+                m_hopFill = 0;
+            }
+            std::fill(m_window.begin(), m_window.end(), 0.0f);
+            m_framesSeen = 0;
+        }
+        m_hopFill += got;
+        if (m_hopFill < m_config.hopSize) {
+            if (got == 0) {
+                skipDroppedFrames();
+                return emitted;
+            }
+            continue;
+        }
+        m_hopFill = 0;
+
+        appendHop(m_hop.data());
+        if (m_framesSeen < m_config.windowSize) {
+            continue;
+        }
+
+        PitchResult result;
+        analyzeWindow(result);
+        deliver(result);
+        ++emitted;
+    }
+    return emitted;
+}
+
+bool PitchEngine::inlinePush(const float* samples, std::size_t frames, std::size_t& consumed) {
+    using Clock = std::chrono::steady_clock;
+
+    while (consumed < frames) {
+        const std::size_t take = std::min(m_config.hopSize - m_hopFill, frames - consumed);
+        std::memcpy(m_hop.data() + m_hopFill, samples + consumed, take * sizeof(float));
+        m_hopFill += take;
+        consumed += take;
+
+        if (m_hopFill < m_config.hopSize) {
+            return false;
+        }
+        m_hopFill = 0;
+        // The guard times everything this callback does per hop: filters,
+        // notches and level, the analysis, and every consumer of the result.
+        const auto start = Clock::now();
+        appendHop(m_hop.data());
+        if (m_framesSeen < m_config.windowSize) {
+            continue;
+        }
+
+        PitchResult result;
+        analyzeWindow(result);
+        deliver(result);
+        const double elapsed = std::chrono::duration<double>(Clock::now() - start).count();
+
+        if (elapsed > m_inlineWorstSeconds.load(std::memory_order_relaxed)) {
+            m_inlineWorstSeconds.store(elapsed, std::memory_order_relaxed);
+        }
+        m_inlineStrikes = elapsed > m_inlineBudgetSeconds ? m_inlineStrikes + 1 : 0;
+        if (m_inlineStrikes >= m_config.inlineStrikeLimit) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void PitchEngine::deliver(const PitchResult& result) {
+    if (m_config.animator) {
+        m_config.animator->pushResult(result);
+    }
+    if (m_config.midi) {
+        m_config.midi->process(result, m_streamFrame, m_hopLevelDb);
+    }
+    if (m_config.analytics) {
+        m_config.analytics->process(result, m_streamFrame);
+    }
+    if (m_config.trackStore) {
+        m_config.trackStore->append(result, m_streamFrame);
+    }
+    if (m_config.aligner) {
+        m_config.aligner->submit(result, m_streamFrame);
+    }
+    if (m_resultHandler) {
+        m_resultHandler(result);
+    }
+}
+
+void PitchEngine::fallBackToWorker() {
+    // Called on a hop boundary, so nothing is buffered outside the window. The
+    // window and the detector's ring cursor transfer to the engine thread with the
+    // release below; the rest of this callback's samples are already in the ring.
+    m_inlineStrikes = 0;
+    m_meters.inlineFallbacks.add();
+    m_meters.inlineActive.set(0.0);
+    log(RtLogEvent::InlineFallback, m_inlineWorstSeconds.load(std::memory_order_relaxed), m_inlineBudgetSeconds);
+    m_inlineActive.store(false, std::memory_order_release);
+}
+
+void PitchEngine::log(RtLogEvent event, double a0, double a1, double a2) noexcept {
+    if (m_config.log) {
+        m_config.log->log(event, a0, a1, a2);
+    }
+}
+
+void PitchEngine::appendHop(float* hop) {
+    filterHop(hop);
+    shiftIntoWindow(hop);
+    m_framesSeen += m_config.hopSize;
+    m_streamFrame += m_config.hopSize;
+    m_meters.analyzedFrames.add(m_config.hopSize);
+}
+
+void PitchEngine::filterHop(float* hop) {
+    // Hops arrive in stream order on whichever thread owns the window, so the
+    // filter state carries across inline/worker handover.
+    for (Biquad& filter : m_preFilters) {
+        filter.process(hop, m_config.hopSize);
+    }
+    if (m_config.referenceTone) {
+        notchReferenceTone(hop);
+    }
+    if (m_config.midi) {
+        // Hop level drives MIDI onset detection and velocity.
+        double energy = 0.0;
+        for (std::size_t i = 0; i < m_config.hopSize; ++i) {
+            energy += static_cast<double>(hop[i]) * hop[i];
+        }
+        m_hopLevelDb = 10.0 * std::log10(energy / static_cast<double>(m_config.hopSize) + 1e-12);
+    }
+}
+
+void PitchEngine::shiftIntoWindow(const float* hop) {
+    const std::size_t keep = m_config.windowSize - m_config.hopSize;
+    std::memmove(m_window.data(), m_window.data() + m_config.hopSize, keep * sizeof(float));
+    std::memcpy(m_window.data() + keep, hop, m_config.hopSize * sizeof(float));
+}
+
+void PitchEngine::notchReferenceTone(float* hop) {
+    const double toneHz = m_config.referenceTone->audibleFrequency();
+    if (toneHz <= 0.0) {
+        if (m_referenceNotchHz > 0.0) {
+            for (Biquad& notch : m_referenceNotches) {
+                notch.reset();
+            }
+            m_referenceNotchHz = 0.0;
+        }
+        return;
+    }
+
+    const ToneWaveform waveform = m_config.referenceTone->parameters().waveform;
+    if (toneHz != m_referenceNotchHz || waveform != m_referenceWaveform) {
+        // Keeps the filter state, so a glide retunes each notch without a click.
+        const double ceiling = ToneGenerator::HARMONIC_CEILING * m_config.sampleRate;
+        m_referenceNotchCount = 0;
+        while (m_referenceNotchCount < m_referenceNotches.size() &&
+               static_cast<double>(m_referenceNotchCount + 1) * toneHz < ceiling) {
+            const double partialHz = static_cast<double>(m_referenceNotchCount + 1) * toneHz;
+            m_referenceNotches[m_referenceNotchCount].setCoefficients(
+                BiquadCoefficients::notch(m_config.sampleRate, partialHz, m_config.referenceNotchQ));
+            ++m_referenceNotchCount;
+        }
+        m_referenceNotchHz = toneHz;
+        m_referenceWaveform = waveform;
+    }
+    for (std::size_t i = 0; i < m_referenceNotchCount; ++i) {
+        if (ToneGenerator::containsHarmonic(waveform, i + 1)) {
+            m_referenceNotches[i].process(hop, m_config.hopSize);
+        }
+    }
+}
+
+void PitchEngine::skipDroppedFrames() {
+    // The ring refused these at the end of what it held, so once it is drained
+    // they sit between the partial hop and whatever the capture thread writes next.
+    const std::uint64_t dropped = m_detectorDroppedFrames.exchange(0, std::memory_order_acquire);
+    if (dropped == 0) {
+        return;
+    }
+    m_streamFrame += m_hopFill + dropped;
+    m_hopFill = 0;
+    std::fill(m_window.begin(), m_window.end(), 0.0f);
+    m_framesSeen = 0;
+}
+
+double PitchEngine::analyzeWindow(PitchResult& result) {
+    using Clock = std::chrono::steady_clock;
+
+    const auto start = Clock::now();
+    applyPendingThreshold();
+    // A shortened window takes the newest samples, so it also lowers latency.
+    const std::size_t offset = m_config.windowSize - m_activeWindow;
+    result = m_detector.processBuffer(m_window.data() + offset, m_activeWindow);
+    if (m_config.adaptiveWindow) {
+        adaptWindow(result);
+    }
+    const auto elapsed = Clock::now() - start;
+
+    m_meters.analysisNanos.record(
+        static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()));
+    m_meters.results.add();
+    (result.isValid ? m_meters.gateOpenFrames : m_meters.gateClosedFrames).add(m_config.hopSize);
+    return std::chrono::duration<double>(elapsed).count();
+}
+
+std::vector<std::size_t> PitchEngine::windowLadder() const {
+    std::vector<std::size_t> ladder{m_config.windowSize};
+    if (m_config.adaptiveWindow) {
+        for (std::size_t window = halveWindow(m_config.windowSize); window >= m_config.minAdaptiveWindow;
+             window = halveWindow(window)) {
+            ladder.push_back(window);
+        }
+    }
+    return ladder;
+}
+
+std::size_t PitchEngine::windowForFrequency(double frequency, double lagHeadroom) const {
+    // Smallest ladder step (full window halved repeatedly) whose lag range covers
+    // the period with headroom; the detector needs two lags past it to refine.
+    const double lags = m_config.sampleRate / frequency * lagHeadroom + 2.0;
+    std::size_t window = m_config.windowSize;
+    while (halveWindow(window) >= m_config.minAdaptiveWindow && static_cast<double>(halveWindow(window) / 2) >= lags) {
+        window = halveWindow(window);
+    }
+    return window;
+}
+
+void PitchEngine::adaptWindow(const PitchResult& result) {
+    // Without a dip under the threshold the detector only reports its best guess,
+    // which is what a note below the active lag range looks like.
+    const bool confident =
+        result.isValid && result.frequency > 0.0 && result.probability >= 1.0 - m_appliedThreshold;
+
+    std::size_t next = m_activeWindow;
+    if (!confident) {
+        // Lost track: the note may now be below the lag range. Look with everything.
+        next = m_config.windowSize;
+        m_shrinkVotes = 0;
+    } else if (windowForFrequency(result.frequency, GROW_LAG_HEADROOM) > m_activeWindow) {
+        next = windowForFrequency(result.frequency, GROW_LAG_HEADROOM);
+        m_shrinkVotes = 0;
+    } else if (windowForFrequency(result.frequency, SHRINK_LAG_HEADROOM) < m_activeWindow) {
+        if (++m_shrinkVotes >= m_config.adaptiveShrinkAfter) {
+            next = halveWindow(m_activeWindow);
+            m_shrinkVotes = 0;
+        }
+    } else {
+        m_shrinkVotes = 0;
+    }
+
+    if (next != m_activeWindow) {
+        log(RtLogEvent::WindowResized, static_cast<double>(m_activeWindow), static_cast<double>(next),
+            confident ? result.frequency : 0.0);
+        m_activeWindow = m_detector.setActiveSize(next);
+        m_activeWindowPublished.store(m_activeWindow, std::memory_order_relaxed);
+        m_meters.windowResizes.add();
+        m_meters.activeWindow.set(static_cast<double>(m_activeWindow));
+    }
+}
+
+void PitchEngine::applyPendingThreshold() {
+    const double pending = m_pendingThreshold.load(std::memory_order_relaxed);
+    if (pending != m_appliedThreshold) {
+        m_detector.setThreshold(pending);
+        m_appliedThreshold = pending;
+        log(RtLogEvent::ThresholdApplied, pending);
+    }
+}
+
+void PitchEngine::calibrateInline() {
+    using Clock = std::chrono::steady_clock;
+
+    // Broadband noise walks the whole lag range without an early threshold exit,
+    // which is the detector's slowest path.
+    std::uint32_t state = 0x9E3779B9u;
+    const auto fillNoise = [&state](std::vector<float>& samples) {
+        for (float& sample : samples) {
+            state = state * 1664525u + 1013904223u;
+            sample = static_cast<float>(state >> 8) / static_cast<float>(1u << 24) * 2.0f - 1.0f;
+        }
+    };
+    fillNoise(m_window);
+
+    // Time the hop path inlinePush() guards: filters, notches and level, the
+    // window shift and a full-window analysis. Consumers cannot be handed
+    // calibration results, so their share is left to the per-hop guard. The
+    // filters are put back afterwards so the stream starts from clean state.
+    const std::vector<Biquad> preFilters = m_preFilters;
+    const std::vector<Biquad> referenceNotches = m_referenceNotches;
+    const ToneWaveform referenceWaveform = m_referenceWaveform;
+
+    double worst = 0.0;
+    for (std::size_t run = 0; run < CALIBRATION_RUNS; ++run) {
+        fillNoise(m_hop);
+        const auto start = Clock::now();
+        filterHop(m_hop.data());
+        shiftIntoWindow(m_hop.data());
+        m_detector.processBuffer(m_window.data(), m_config.windowSize);
+        worst = std::max(worst, std::chrono::duration<double>(Clock::now() - start).count());
+    }
+
+    m_preFilters = preFilters;
+    m_referenceNotches = referenceNotches;
+    m_referenceNotchHz = 0.0;
+    m_referenceNotchCount = 0;
+    m_referenceWaveform = referenceWaveform;
+    m_hopLevelDb = 0.0;
+    std::fill(m_hop.begin(), m_hop.end(), 0.0f);
+    std::fill(m_window.begin(), m_window.end(), 0.0f);
+    m_inlineWorstSeconds.store(worst, std::memory_order_relaxed);
+    m_inlineActive.store(worst <= m_inlineBudgetSeconds, std::memory_order_release);
+}
+
+}  // namespace tine::dsp
@@ -0,0 +1,293 @@
+#ifndef TINE_NATIVE_DSP_PITCHENGINE_HPP
+#define TINE_NATIVE_DSP_PITCHENGINE_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <vector>
+
+#include "Biquad.hpp"
+#include "BroadcastRingBuffer.hpp"
+#include "DialAnimator.hpp"
+#include "KernelAutotuner.hpp"
+#include "MelodyAligner.hpp"
+#include "Metrics.hpp"
+#include "MidiGenerator.hpp"
+#include "PitchTrackStore.hpp"
+#include "RtLog.hpp"
+#include "SessionAnalytics.hpp"
+#include "ToneGenerator.hpp"
+#include "YinPitchDetector.hpp"
+
+namespace tine::dsp {
+
+enum class EngineMode {
+    /** Capture thread only writes the ring; the engine thread analyzes. */
+    Worker,
+    /** Capture thread analyzes each completed hop itself while it fits the budget. */
+    Inline,
+};
+
+struct PitchEngineConfig {
+    double sampleRate{48000.0};
+    std::size_t windowSize{2048};
+    std::size_t hopSize{2048};
+    std::size_t ringCapacity{8192};
+    /**
+     * OverwriteOldest keeps the capture path writing under load so results track
+     * the newest audio; losses are counted instead of growing latency.
+     */
+    OverflowPolicy overflow{OverflowPolicy::OverwriteOldest};
+    double threshold{0.1};
+    /**
+     * Sub-sample period estimate. Sinc keeps high pitches within a tenth of a
+     * cent on windows half the size Parabolic needs for the same accuracy.
+     */
+    LagRefinement lagRefinement{LagRefinement::Parabolic};
+    EngineMode mode{EngineMode::Worker};
+    /** Frames delivered per capture callback; sets the inline time budget. */
+    std::size_t captureBlockFrames{512};
+    /** Fraction of one capture callback period the inline detector may consume. */
+    double inlineBudgetFraction{0.5};
+    /** Consecutive over-budget hops tolerated before falling back to the worker. */
+    std::size_t inlineStrikeLimit{3};
+    /**
+     * Shrink the analyzed window and lag range to fit the tracked pitch. windowSize
+     * stays the allocation and the size used whenever the pitch is unknown.
+     */
+    bool adaptiveWindow{false};
+    /** Smallest window the adaptive ladder steps down to. */
+    std::size_t minAdaptiveWindow{256};
+    /** Consecutive results that must agree before the window shrinks a step. */
+    std::size_t adaptiveShrinkAfter{4};
+    /** Filters applied in order to each hop before it enters the analysis window. */
+    std::vector<BiquadCoefficients> preFilters;
+    /** Shortest lag (highest frequency) the detector may report; 0 for no floor. */
+    std::size_t minLag{0};
+    /** Measured-fastest difference kernels per window size; empty keeps the direct kernel. */
+    KernelWisdom kernelWisdom;
+    /**
+     * Diagnostics from the capture and engine threads (overruns, drops, fallback,
+     * window and threshold changes). Not owned; must outlive the engine.
+     */
+    RtLog* log{nullptr};
+    /** Receives every result before the handler to drive the native dial. Not owned. */
+    DialAnimator* animator{nullptr};
+    /**
+     * Receives every result with its stream frame and hop level to generate MIDI
+     * on the producing thread. Not owned.
+     */
+    MidiGenerator* midi{nullptr};
+    /** Accumulates per-session intonation statistics from every result. Not owned. */
+    SessionAnalytics* analytics{nullptr};
+    /** Stores every result on the session's indexed pitch track. Not owned. */
+    PitchTrackStore* trackStore{nullptr};
+    /**
+     * Receives every result through submit(); the host's aligning thread calls
+     * drain() to align it to a reference melody and score it. Not owned.
+     */
+    MelodyAligner* aligner{nullptr};
+    /**
+     * Reference tone playing through the speaker. While it sounds, each hop is
+     * notched at its current frequency and at every harmonic its waveform
+     * contains, so the detector follows the player rather than the speaker bleed.
+     * A player in unison with the tone is notched too; see referenceNotchQ.
+     * Not owned.
+     */
+    const ToneGenerator* referenceTone{nullptr};
+    /**
+     * Notch quality, the same at every harmonic so the width is constant in
+     * cents. High enough that a player a few tens of cents off the reference
+     * keeps most of their partials; within about 870 / Q cents of unison (43 at
+     * the default) the player is attenuated with the tone and may read as unvoiced.
+     */
+    double referenceNotchQ{20.0};
+    /**
+     * Most harmonics of the reference tone notched, fundamental included; those
+     * above ToneGenerator::HARMONIC_CEILING are never rendered and never notched.
+     * A bright waveform needs most of its harmonics removed before a player a
+     * tone away stops fusing with it into one lower period. Each notch costs one
+     * biquad pass over the hop.
+     */
+    std::size_t referenceNotchHarmonics{64};
+};
+
+/**
+ * Capture-to-result pipeline shared by the native hosts: hop-based sliding
+ * window, broadcast ring handoff to a worker, and an optional inline mode that
+ * runs the allocation-free detector directly on the capture thread.
+ *
+ * The detector is one consumer of captureRing(); meters, recorders and
+ * visualizers register their own cursors there and read the same frames
+ * without another copy on the capture thread.
+ *
+ * Threading: pushAudio() is called from the capture thread only; processPending()
+ * from the engine thread only. The result handler runs on whichever of the two
+ * produced the result.
+ */
+class PitchEngine {
+public:
+    using ResultHandler = std::function<void(const PitchResult& result)>;
+
+    explicit PitchEngine(const PitchEngineConfig& config);
+
+    PitchEngine(const PitchEngine&) = delete;
+    PitchEngine& operator=(const PitchEngine&) = delete;
+
+    /**
+     * Install the result callback. Call before audio starts flowing.
+     */
+    void setResultHandler(ResultHandler handler) { m_resultHandler = std::move(handler); }
+
+    /**
+     * Capture thread entry point.
+     * @return Frames accepted; fewer than @p frames means the ring overran
+     *         (DropNewest only).
+     */
+    std::size_t pushAudio(const float* samples, std::size_t frames);
+
+    /**
+     * Engine thread entry point: analyze every complete hop waiting in the ring.
+     * @return Number of results emitted. Always zero while inline mode is active.
+     */
+    std::size_t processPending();
+
+    /**
+     * Thread-safe; applied by whichever thread runs the next analysis.
+     */
+    void setThreshold(double threshold) noexcept { m_pendingThreshold.store(threshold, std::memory_order_relaxed); }
+
+    /**
+     * Capture frames the engine thread never analyzed because the ring was lapped.
+     */
+    [[nodiscard]] std::uint64_t lostFrames() const noexcept { return m_ring.lostFrames(m_detectorConsumer); }
+
+    [[nodiscard]] std::uint64_t overruns() const noexcept { return m_ring.overruns(m_detectorConsumer); }
+
+    /**
+     * Ring every captured frame is written to once. Additional consumers may be
+     * registered while audio is flowing.
+     */
+    [[nodiscard]] BroadcastRingBuffer& captureRing() noexcept { return m_ring; }
+
+    [[nodiscard]] bool inlineActive() const noexcept { return m_inlineActive.load(std::memory_order_acquire); }
+
+    /**
+     * Worst inline time per hop observed (seconds), from filtering through the
+     * result's consumers, including the calibration run.
+     */
+    [[nodiscard]] double inlineWorstCaseSeconds() const noexcept {
+        return m_inlineWorstSeconds.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * Time available to the inline detector per capture callback (seconds).
+     */
+    [[nodiscard]] double inlineBudgetSeconds() const noexcept { return m_inlineBudgetSeconds; }
+
+    [[nodiscard]] const PitchEngineConfig& config() const noexcept { return m_config; }
+
+    /**
+     * Window currently analyzed; below config().windowSize only with adaptiveWindow.
+     */
+    [[nodiscard]] std::size_t activeWindow() const noexcept {
+        return m_activeWindowPublished.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * Every window size the detector may analyze: the configured window and, with
+     * adaptiveWindow, each step of the halving ladder. These are the sizes worth
+     * autotuning kernels for.
+     */
+    [[nodiscard]] std::vector<std::size_t> windowLadder() const;
+
+    /**
+     * Pipeline health: captured, dropped, analyzed and skipped frames, overruns,
+     * ring fill and its high-water mark, gate (voiced/unvoiced) frames, drain
+     * wakeups and per-hop analysis time. Updated lock-free from both threads; snapshot from any thread.
+     */
+    [[nodiscard]] const MetricsRegistry& metrics() const noexcept { return m_metrics; }
+
+private:
+    struct Meters {
+        explicit Meters(MetricsRegistry& registry);
+
+        MetricCounter& capturedFrames;
+        MetricCounter& droppedFrames;
+        MetricCounter& analyzedFrames;
+        MetricCounter& skippedFrames;
+        MetricCounter& overruns;
+        MetricCounter& results;
+        MetricCounter& gateOpenFrames;
+        MetricCounter& gateClosedFrames;
+        MetricCounter& inlineFallbacks;
+        MetricCounter& windowResizes;
+        MetricCounter& drainWakeups;
+        MetricGauge& ringFill;
+        MetricGauge& ringHighWater;
+        MetricGauge& activeWindow;
+        MetricGauge& inlineActive;
+        MetricHistogram& analysisNanos;
+    };
+
+    /** @return Seconds spent, also recorded in the analysis-time histogram. */
+    double analyzeWindow(PitchResult& result);
+    /** Filter @p hop in place and shift it into the window. */
+    void appendHop(float* hop);
+    /** Pre-filters, reference-tone notches and the MIDI hop level. */
+    void filterHop(float* hop);
+    void shiftIntoWindow(const float* hop);
+    /** Engine thread, once the ring is drained: account for frames the ring refused. */
+    void skipDroppedFrames();
+    /** @return True when the budget guard tripped; the caller then falls back. */
+    bool inlinePush(const float* samples, std::size_t frames, std::size_t& consumed);
+    void deliver(const PitchResult& result);
+    void fallBackToWorker();
+    void calibrateInline();
+    void applyPendingThreshold();
+    void adaptWindow(const PitchResult& result);
+    void notchReferenceTone(float* hop);
+    void log(RtLogEvent event, double a0 = 0.0, double a1 = 0.0, double a2 = 0.0) noexcept;
+    [[nodiscard]] std::size_t windowForFrequency(double frequency, double lagHeadroom) const;
+
+    PitchEngineConfig m_config;
+    BroadcastRingBuffer m_ring;
+    BroadcastRingBuffer::ConsumerId m_detectorConsumer;
+    YinPitchDetector m_detector;
+    std::vector<float> m_window;
+    std::vector<float> m_hop;
+    std::vector<Biquad> m_preFilters;
+    /** One per harmonic number; a slot is skipped when the waveform lacks that harmonic. */
+    std::vector<Biquad> m_referenceNotches;
+    double m_referenceNotchHz{0.0};
+    ToneWaveform m_referenceWaveform{ToneWaveform::Sine};
+    /** Leading slots of m_referenceNotches below the tone's harmonic ceiling. */
+    std::size_t m_referenceNotchCount{0};
+    std::size_t m_hopFill{0};
+    std::size_t m_framesSeen{0};
+    /** Capture frames consumed from stream start, including skipped ones; the MIDI clock. */
+    std::uint64_t m_streamFrame{0};
+    double m_hopLevelDb{0.0};
+    double m_inlineBudgetSeconds{0.0};
+    std::size_t m_inlineStrikes{0};
+    std::size_t m_activeWindow;
+    std::size_t m_shrinkVotes{0};
+    double m_appliedThreshold;
+    ResultHandler m_resultHandler;
+
+    std::atomic<double> m_pendingThreshold;
+    std::atomic<double> m_inlineWorstSeconds{0.0};
+    std::atomic<bool> m_inlineActive{false};
+    std::atomic<std::size_t> m_activeWindowPublished;
+    /** Capture frames refused before reaching the detector; the engine thread adds them to m_streamFrame. */
+    std::atomic<std::uint64_t> m_detectorDroppedFrames{0};
+
+    MetricsRegistry m_metrics;
+    Meters m_meters;
+};
+
+}  // namespace tine::dsp
+
+#endif  // TINE_NATIVE_DSP_PITCHENGINE_HPP
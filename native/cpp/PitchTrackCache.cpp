@@ -0,0 +1,452 @@
+#include "PitchTrackCache.hpp"
+
+#include "StreamScheduler.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string_view>
+#include <utility>
+
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace tine::dsp {
+
+namespace {
+
+constexpr const char* ENTRY_SUFFIX = ".tpc";
+constexpr std::size_t ENTRY_SUFFIX_LENGTH = 4;
+constexpr std::size_t KEY_HEX_DIGITS = 32;
+// Folded into every key so a change to the chunk layout retires old entries.
+constexpr std::uint64_t KEY_FORMAT = 1;
+
+constexpr std::uint64_t PRIME_A = 0x9E3779B185EBCA87ULL;
+constexpr std::uint64_t PRIME_B = 0xC2B2AE3D27D4EB4FULL;
+constexpr std::uint64_t PRIME_C = 0x165667B19E3779F9ULL;
+
+std::uint64_t rotateLeft(std::uint64_t value, int bits) {
+    return (value << bits) | (value >> (64 - bits));
+}
+
+// MurmurHash3 finaliser: every input bit affects every output bit.
+std::uint64_t finalMix(std::uint64_t value) {
+    value ^= value >> 33;
+    value *= 0xFF51AFD7ED558CCDULL;
+    value ^= value >> 33;
+    value *= 0xC4CEB9FE1A85EC53ULL;
+    value ^= value >> 33;
+    return value;
+}
+
+// Two multiply-rotate lanes over 8-byte words, cross-mixed at the end.
+class ChunkHasher {
+public:
+    void add(const void* data, std::size_t bytes) {
+        const auto* in = static_cast<const unsigned char*>(data);
+        m_length += bytes;
+        while (bytes > 0) {
+            const std::size_t take = std::min(bytes, sizeof(m_pending) - m_pendingBytes);
+            std::memcpy(reinterpret_cast<unsigned char*>(&m_pending) + m_pendingBytes, in, take);
+            m_pendingBytes += take;
+            in += take;
+            bytes -= take;
+            if (m_pendingBytes == sizeof(m_pending)) {
+                mixWord(m_pending);
+                m_pending = 0;
+                m_pendingBytes = 0;
+            }
+        }
+    }
+
+    template <typename T>
+    void addValue(T value) {
+        add(&value, sizeof(value));
+    }
+
+    [[nodiscard]] TrackChunkKey finish() {
+        if (m_pendingBytes > 0) {
+            mixWord(m_pending);
+        }
+        std::uint64_t a = m_a ^ m_length;
+        std::uint64_t b = m_b ^ (m_length * PRIME_C);
+        a += b;
+        b += a;
+        return TrackChunkKey{finalMix(a), finalMix(b)};
+    }
+
+private:
+    void mixWord(std::uint64_t word) {
+        m_a = rotateLeft(m_a ^ (word * PRIME_B), 31) * PRIME_A;
+        m_b = (rotateLeft(m_b + (word * PRIME_A), 27) * PRIME_B) ^ m_a;
+    }
+
+    std::uint64_t m_a{PRIME_C};
+    std::uint64_t m_b{PRIME_A ^ PRIME_B};
+    std::uint64_t m_length{0};
+    std::uint64_t m_pending{0};
+    std::size_t m_pendingBytes{0};
+};
+
+bool parseHexKey(std::string_view text, TrackChunkKey& key) {
+    if (text.size() != KEY_HEX_DIGITS) {
+        return false;
+    }
+    std::uint64_t parts[2] = {0, 0};
+    for (std::size_t i = 0; i < KEY_HEX_DIGITS; ++i) {
+        const char c = text[i];
+        std::uint64_t digit = 0;
+        if (c >= '0' && c <= '9') {
+            digit = static_cast<std::uint64_t>(c - '0');
+        } else if (c >= 'a' && c <= 'f') {
+            digit = static_cast<std::uint64_t>(c - 'a' + 10);
+        } else {
+            return false;
+        }
+        parts[i / 16] = (parts[i / 16] << 4) | digit;
+    }
+    key.high = parts[0];
+    key.low = parts[1];
+    return true;
+}
+
+bool writeAtomically(const std::string& path, const std::string& bytes) {
+    // A unique name per writer: two threads storing the same key must not share
+    // (and truncate) one temporary before either renames it into place.
+    std::string temporary = path + ".tmp.XXXXXX";
+    const int descriptor = ::mkstemp(temporary.data());
+    if (descriptor < 0) {
+        return false;
+    }
+    std::FILE* file = ::fdopen(descriptor, "wb");
+    if (!file) {
+        ::close(descriptor);
+        ::unlink(temporary.c_str());
+        return false;
+    }
+    const bool written = std::fwrite(bytes.data(), 1, bytes.size(), file) == bytes.size();
+    if (std::fclose(file) != 0 || !written) {
+        ::unlink(temporary.c_str());
+        return false;
+    }
+    if (std::rename(temporary.c_str(), path.c_str()) != 0) {
+        ::unlink(temporary.c_str());
+        return false;
+    }
+    return true;
+}
+
+// Parse the entry at @p path from a read-only mapping of it.
+bool readMapped(const std::string& path, CandidateTrack& track) {
+    const int descriptor = ::open(path.c_str(), O_RDONLY);
+    if (descriptor < 0) {
+        return false;
+    }
+    struct stat info {};
+    bool parsed = false;
+    if (::fstat(descriptor, &info) == 0 && info.st_size > 0) {
+        const auto length = static_cast<std::size_t>(info.st_size);
+        void* mapped = ::mmap(nullptr, length, PROT_READ, MAP_PRIVATE, descriptor, 0);
+        if (mapped != MAP_FAILED) {
+            parsed = CandidateTrack::parse(std::string_view(static_cast<const char*>(mapped), length), track);
+            ::munmap(mapped, length);
+        }
+    }
+    ::close(descriptor);
+    return parsed;
+}
+
+}  // namespace
+
+std::string TrackChunkKey::hex() const {
+    char text[KEY_HEX_DIGITS + 1];
+    std::snprintf(text, sizeof(text), "%016llx%016llx", static_cast<unsigned long long>(high),
+                  static_cast<unsigned long long>(low));
+    return std::string(text, KEY_HEX_DIGITS);
+}
+
+TrackChunkKey hashTrackChunk(const float* samples, std::size_t frames, const CandidateTrackInfo& info) {
+    ChunkHasher hasher;
+    hasher.addValue(KEY_FORMAT);
+    hasher.addValue(CandidateTrack::kVersion);
+    hasher.addValue(info.sampleRate);
+    hasher.addValue(info.windowSize);
+    hasher.addValue(info.hopSize);
+    hasher.addValue(static_cast<std::uint32_t>(info.refinement));
+    hasher.addValue(static_cast<std::uint64_t>(frames));
+    if (samples && frames > 0) {
+        hasher.add(samples, frames * sizeof(float));
+    }
+    return hasher.finish();
+}
+
+PitchTrackCache::PitchTrackCache(PitchTrackCacheConfig config) : m_config(std::move(config)) {
+    if (m_config.chunkWindows == 0) {
+        m_config.chunkWindows = 1;
+    }
+    ::mkdir(m_config.directory.c_str(), 0755);
+    adoptExisting();
+}
+
+std::string PitchTrackCache::pathFor(const TrackChunkKey& key) const {
+    return m_config.directory + "/" + key.hex() + ENTRY_SUFFIX;
+}
+
+void PitchTrackCache::adoptExisting() {
+    struct Found {
+        TrackChunkKey key;
+        std::uint64_t bytes;
+        std::int64_t modified;
+    };
+    std::vector<Found> found;
+
+    DIR* directory = ::opendir(m_config.directory.c_str());
+    if (!directory) {
+        return;
+    }
+    while (const dirent* item = ::readdir(directory)) {
+        const std::string_view name(item->d_name);
+        if (name.size() != KEY_HEX_DIGITS + ENTRY_SUFFIX_LENGTH || !name.ends_with(ENTRY_SUFFIX)) {
+            continue;
+        }
+        Found entry{};
+        struct stat info {};
+        const std::string path = m_config.directory + "/" + std::string(name);
+        if (!parseHexKey(name.substr(0, KEY_HEX_DIGITS), entry.key) || ::stat(path.c_str(), &info) != 0) {
+            continue;
+        }
+        entry.bytes = static_cast<std::uint64_t>(info.st_size);
+        entry.modified = static_cast<std::int64_t>(info.st_mtime);
+        found.push_back(entry);
+    }
+    ::closedir(directory);
+
+    std::sort(found.begin(), found.end(), [](const Found& a, const Found& b) { return a.modified > b.modified; });
+    std::vector<TrackChunkKey> victims;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        for (const Found& entry : found) {
+            m_recency.push_back(entry.key);
+            m_entries[entry.key] = Entry{entry.bytes, std::prev(m_recency.end())};
+            m_stats.bytes += entry.bytes;
+        }
+        m_stats.entries = m_entries.size();
+        victims = takeVictims();
+    }
+    for (const TrackChunkKey& key : victims) {
+        ::unlink(pathFor(key).c_str());
+    }
+}
+
+bool PitchTrackCache::lookup(const TrackChunkKey& key, std::size_t frameCount, CandidateTrack& track) {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_entries.find(key) == m_entries.end()) {
+            ++m_stats.misses;
+            return false;
+        }
+    }
+
+    const std::string path = pathFor(key);
+    CandidateTrack loaded;
+    if (!readMapped(path, loaded) || loaded.frameCount() != frameCount) {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            forget(key);
+            ++m_stats.misses;
+        }
+        ::unlink(path.c_str());
+        return false;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        const auto found = m_entries.find(key);
+        if (found != m_entries.end()) {
+            m_recency.splice(m_recency.begin(), m_recency, found->second.recency);
+        }
+        ++m_stats.hits;
+    }
+    // Mirror the new recency on disk for the next process; failure only costs ordering.
+    ::utimensat(AT_FDCWD, path.c_str(), nullptr, 0);
+    track = std::move(loaded);
+    return true;
+}
+
+bool PitchTrackCache::store(const TrackChunkKey& key, const CandidateTrack& track) {
+    const std::string bytes = track.serialize();
+    if (!writeAtomically(pathFor(key), bytes)) {
+        return false;
+    }
+
+    std::vector<TrackChunkKey> victims;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        forget(key);
+        m_recency.push_front(key);
+        m_entries[key] = Entry{bytes.size(), m_recency.begin()};
+        m_stats.bytes += bytes.size();
+        m_stats.entries = m_entries.size();
+        ++m_stats.stores;
+        victims = takeVictims();
+    }
+    for (const TrackChunkKey& victim : victims) {
+        ::unlink(pathFor(victim).c_str());
+    }
+    return true;
+}
+
+PitchTrackCacheStats PitchTrackCache::stats() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_stats;
+}
+
+void PitchTrackCache::clear() {
+    std::vector<TrackChunkKey> keys;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        keys.assign(m_recency.begin(), m_recency.end());
+        m_entries.clear();
+        m_recency.clear();
+        m_stats.entries = 0;
+        m_stats.bytes = 0;
+    }
+    for (const TrackChunkKey& key : keys) {
+        ::unlink(pathFor(key).c_str());
+    }
+}
+
+void PitchTrackCache::forget(const TrackChunkKey& key) {
+    const auto found = m_entries.find(key);
+    if (found == m_entries.end()) {
+        return;
+    }
+    m_stats.bytes -= found->second.bytes;
+    m_recency.erase(found->second.recency);
+    m_entries.erase(found);
+    m_stats.entries = m_entries.size();
+}
+
+std::vector<TrackChunkKey> PitchTrackCache::takeVictims() {
+    std::vector<TrackChunkKey> victims;
+    // The newest entry stays even when it alone exceeds the budget.
+    while (m_stats.bytes > m_config.maxBytes && m_recency.size() > 1) {
+        const TrackChunkKey victim = m_recency.back();
+        forget(victim);
+        victims.push_back(victim);
+        ++m_stats.evictions;
+    }
+    return victims;
+}
+
+Task<StreamSummary> analyzeStreamCached(AsyncContext& context,
+                                        AudioStreamSource& source,
+                                        StreamAnalysisConfig config,
+                                        PitchTrackCache& cache,
+                                        StreamResultSink sink) {
+    StreamSummary summary;
+    if (config.sampleRate <= 0.0 || config.windowSize < 4 || config.hopSize == 0 ||
+        config.hopSize > config.windowSize) {
+        summary.failed = true;
+        co_return summary;
+    }
+    // A degraded stream runs, and is keyed, at the longer hop it was admitted under.
+    config.hopSize = scheduledHopSize(config);
+
+    CandidateTrackInfo info;
+    info.sampleRate = config.sampleRate;
+    info.windowSize = static_cast<std::uint32_t>(config.windowSize);
+    info.hopSize = static_cast<std::uint32_t>(config.hopSize);
+    info.refinement = config.lagRefinement;
+
+    YinPitchDetector detector(config.sampleRate, config.windowSize, config.threshold);
+    detector.setLagRefinement(config.lagRefinement);
+    const std::size_t chunkWindows = cache.config().chunkWindows;
+    std::vector<float> span(config.windowSize + (chunkWindows - 1) * config.hopSize, 0.0f);
+    std::vector<PitchResult> results(chunkWindows);
+    CandidateTrack chunk;
+    chunk.info = info;
+
+    std::size_t filled = 0;
+    std::size_t skip = 0;
+    std::size_t windowStart = 0;
+    bool ended = false;
+
+    for (;;) {
+        // A hop longer than the window leaves a gap before the next window's audio.
+        while (!ended && skip > 0) {
+            const std::size_t want = std::min(skip, span.size());
+            const std::size_t got = co_await readFrames(context, source, span.data(), want);
+            summary.framesRead += got;
+            skip -= got;
+            ended = got < want;
+        }
+        if (!ended && filled < span.size()) {
+            const std::size_t want = span.size() - filled;
+            const std::size_t got = co_await readFrames(context, source, span.data() + filled, want);
+            summary.framesRead += got;
+            filled += got;
+            ended = got < want;
+        }
+        if (filled < config.windowSize) {
+            break;
+        }
+
+        std::size_t produced = 0;
+        {
+            ScheduledStep step(context.scheduler, config.stream);
+            co_await step.begin();
+
+            // A full chunk spans the whole buffer; only the stream's last one is shorter.
+            const std::size_t windows = (filled - config.windowSize) / config.hopSize + 1;
+            const std::size_t chunkFrames = config.windowSize + (windows - 1) * config.hopSize;
+            const TrackChunkKey key = hashTrackChunk(span.data(), chunkFrames, info);
+
+            if (cache.lookup(key, windows, chunk)) {
+                for (std::size_t k = 0; k < windows; ++k) {
+                    results[k] = chunk.decodeFrame(k, config.threshold);
+                }
+                produced = windows;
+                summary.cachedWindows += windows;
+            } else {
+                chunk.info = info;
+                chunk.log.clear();
+                detector.setCandidateLog(&chunk.log);
+                produced = detector.processFrames(span.data(), chunkFrames, config.hopSize, results.data(), windows);
+                detector.setCandidateLog(nullptr);
+                if (produced == windows) {
+                    cache.store(key, chunk);
+                }
+            }
+            step.charge(static_cast<double>(produced * config.hopSize) / config.sampleRate);
+
+            for (std::size_t k = 0; k < produced; ++k) {
+                ++summary.windowsAnalyzed;
+                if (results[k].isValid) {
+                    ++summary.validWindows;
+                }
+                if (sink) {
+                    sink(windowStart, results[k]);
+                }
+                windowStart += config.hopSize;
+            }
+        }
+
+        const std::size_t advanced = produced * config.hopSize;
+        if (advanced == 0) {
+            break;
+        }
+        const std::size_t consumed = std::min(advanced, filled);
+        skip = advanced - consumed;
+        std::memmove(span.data(), span.data() + consumed, (filled - consumed) * sizeof(float));
+        filled -= consumed;
+    }
+
+    co_return summary;
+}
+
+}  // namespace tine::dsp
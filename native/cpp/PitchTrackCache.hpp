@@ -0,0 +1,132 @@
+#ifndef TINE_NATIVE_DSP_PITCHTRACKCACHE_HPP
+#define TINE_NATIVE_DSP_PITCHTRACKCACHE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "AsyncStream.hpp"
+#include "CandidateTrack.hpp"
+
+namespace tine::dsp {
+
+/**
+ * 128-bit content hash of one chunk of audio plus everything in the analysis
+ * configuration that changes its candidates. Not cryptographic: it tells
+ * duplicate uploads apart reliably but is no defence against forged collisions.
+ */
+struct TrackChunkKey {
+    std::uint64_t high{0};
+    std::uint64_t low{0};
+
+    bool operator==(const TrackChunkKey& other) const noexcept {
+        return high == other.high && low == other.low;
+    }
+
+    /** 32 lowercase hex digits; also the entry's file name stem. */
+    [[nodiscard]] std::string hex() const;
+};
+
+/**
+ * Key of @p frames samples analyzed with @p info. The threshold is not part of
+ * it: entries hold candidates, which decode at any threshold.
+ */
+[[nodiscard]] TrackChunkKey hashTrackChunk(const float* samples, std::size_t frames, const CandidateTrackInfo& info);
+
+struct PitchTrackCacheConfig {
+    /** Store directory; created if missing. Entries already there are adopted. */
+    std::string directory;
+    /** Total entry bytes kept on disk; least recently used entries go first. */
+    std::uint64_t maxBytes{256ULL << 20};
+    /** Windows per cached chunk. Smaller chunks find more partial overlaps but cost more files. */
+    std::size_t chunkWindows{256};
+};
+
+struct PitchTrackCacheStats {
+    std::uint64_t hits{0};
+    std::uint64_t misses{0};
+    std::uint64_t stores{0};
+    std::uint64_t evictions{0};
+    std::uint64_t entries{0};
+    std::uint64_t bytes{0};
+
+    [[nodiscard]] double hitRate() const noexcept {
+        const std::uint64_t lookups = hits + misses;
+        return lookups > 0 ? static_cast<double>(hits) / static_cast<double>(lookups) : 0.0;
+    }
+};
+
+/**
+ * Content-addressed, size-bounded store of analyzed audio chunks for the batch
+ * analyzer. Each entry is one CandidateTrack sidecar named by its key; lookups
+ * map the file read-only instead of reading it into a buffer. Recency is kept
+ * in memory and mirrored into file modification times, so LRU order survives a
+ * restart. Thread-safe; file I/O runs outside the lock.
+ */
+class PitchTrackCache {
+public:
+    explicit PitchTrackCache(PitchTrackCacheConfig config);
+
+    PitchTrackCache(const PitchTrackCache&) = delete;
+    PitchTrackCache& operator=(const PitchTrackCache&) = delete;
+
+    /**
+     * @return true and fill @p track on a hit. An entry that is corrupt or does
+     * not hold exactly @p frameCount windows is dropped and counts as a miss.
+     */
+    bool lookup(const TrackChunkKey& key, std::size_t frameCount, CandidateTrack& track);
+
+    /** Add or replace the entry for @p key, then evict down to maxBytes. */
+    bool store(const TrackChunkKey& key, const CandidateTrack& track);
+
+    [[nodiscard]] PitchTrackCacheStats stats() const;
+
+    /** Delete every entry. Counters other than entries and bytes are kept. */
+    void clear();
+
+    [[nodiscard]] const PitchTrackCacheConfig& config() const noexcept { return m_config; }
+
+private:
+    struct KeyHash {
+        std::size_t operator()(const TrackChunkKey& key) const noexcept { return static_cast<std::size_t>(key.low); }
+    };
+
+    struct Entry {
+        std::uint64_t bytes{0};
+        std::list<TrackChunkKey>::iterator recency;
+    };
+
+    [[nodiscard]] std::string pathFor(const TrackChunkKey& key) const;
+    void adoptExisting();
+    void forget(const TrackChunkKey& key);
+    /** Under the lock: unlink LRU entries from the index until within maxBytes; the caller deletes the files. */
+    [[nodiscard]] std::vector<TrackChunkKey> takeVictims();
+
+    PitchTrackCacheConfig m_config;
+    mutable std::mutex m_mutex;
+    std::unordered_map<TrackChunkKey, Entry, KeyHash> m_entries;
+    /** Most recently used first. */
+    std::list<TrackChunkKey> m_recency;
+    PitchTrackCacheStats m_stats;
+};
+
+/**
+ * analyzeStream() through @p cache: the stream is cut into chunks of
+ * chunkWindows windows; a chunk whose key is stored is decoded at
+ * config.threshold without running the detector, any other is analyzed and
+ * stored. Chunks start at whole multiples of the chunk length, so identical
+ * files and takes sharing a prefix hit; material at other offsets does not.
+ */
+Task<StreamSummary> analyzeStreamCached(AsyncContext& context,
+                                        AudioStreamSource& source,
+                                        StreamAnalysisConfig config,
+                                        PitchTrackCache& cache,
+                                        StreamResultSink sink);
+
+}  // namespace tine::dsp
+
+#endif  // TINE_NATIVE_DSP_PITCHTRACKCACHE_HPP
@@ -0,0 +1,339 @@
+#include "PitchTrackStore.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <type_traits>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace tine::dsp {
+
+namespace {
+
+// File layout (native byte order): header, frames padded to 8 bytes, then the
+// complete nodes of each level, level 0 first.
+constexpr char TRACK_MAGIC[8] = {'T', 'I', 'N', 'E', 'T', 'R', 'A', 'K'};
+constexpr std::uint32_t TRACK_VERSION = 1;
+
+struct FileHeader {
+    char magic[8];
+    std::uint32_t version;
+    std::uint32_t blockFrames;
+    double sampleRate;
+    std::uint64_t hopSize;
+    std::uint64_t firstSampleTime;
+    std::uint64_t frameCount;
+    std::uint64_t levelCount;
+};
+
+static_assert(std::is_trivially_copyable_v<TrackFrame> && sizeof(TrackFrame) == 12, "TrackFrame is persisted");
+static_assert(std::is_trivially_copyable_v<TrackAggregate> && sizeof(TrackAggregate) == 48,
+              "TrackAggregate is persisted");
+static_assert(sizeof(FileHeader) % alignof(TrackAggregate) == 0, "node sections must stay aligned");
+
+std::size_t alignUp(std::size_t bytes) {
+    return (bytes + alignof(TrackAggregate) - 1) & ~(alignof(TrackAggregate) - 1);
+}
+
+// Complete nodes per level for @p blocks complete blocks; returns the level count.
+std::size_t levelSizes(std::size_t blocks, std::size_t* sizes) {
+    std::size_t levels = 0;
+    for (std::size_t size = blocks; size > 0 && levels < PitchTrackView::MAX_LEVELS; size >>= 1) {
+        sizes[levels++] = size;
+    }
+    return levels;
+}
+
+bool writeAll(std::FILE* file, const void* data, std::size_t bytes) {
+    return bytes == 0 || std::fwrite(data, 1, bytes, file) == bytes;
+}
+
+}  // namespace
+
+void TrackAggregate::add(const TrackFrame& frame) noexcept {
+    ++frames;
+    if (frame.valid == 0) {
+        return;
+    }
+    ++validFrames;
+    const double cents = frame.cents;
+    sumCents += cents;
+    sumSquaredCents += cents * cents;
+    minCents = std::min(minCents, frame.cents);
+    maxCents = std::max(maxCents, frame.cents);
+    minFrequency = std::min(minFrequency, frame.frequency);
+    maxFrequency = std::max(maxFrequency, frame.frequency);
+}
+
+void TrackAggregate::merge(const TrackAggregate& other) noexcept {
+    frames += other.frames;
+    validFrames += other.validFrames;
+    sumCents += other.sumCents;
+    sumSquaredCents += other.sumSquaredCents;
+    minCents = std::min(minCents, other.minCents);
+    maxCents = std::max(maxCents, other.maxCents);
+    minFrequency = std::min(minFrequency, other.minFrequency);
+    maxFrequency = std::max(maxFrequency, other.maxFrequency);
+}
+
+double TrackAggregate::stdDevCents() const noexcept {
+    if (validFrames == 0) {
+        return 0.0;
+    }
+    const double mean = meanCents();
+    return std::sqrt(std::max(0.0, sumSquaredCents / static_cast<double>(validFrames) - mean * mean));
+}
+
+TrackAggregate PitchTrackView::queryFrames(std::size_t begin, std::size_t end) const noexcept {
+    TrackAggregate total;
+    end = std::min(end, frameCount);
+    if (!frames || begin >= end || blockFrames == 0) {
+        return total;
+    }
+
+    // Blocks wholly inside the range come from the index; the ragged ends are scanned.
+    std::size_t firstBlock = (begin + blockFrames - 1) / blockFrames;
+    std::size_t lastBlock = end / blockFrames;
+    if (firstBlock >= lastBlock) {
+        for (std::size_t i = begin; i < end; ++i) {
+            total.add(frames[i]);
+        }
+        return total;
+    }
+    for (std::size_t i = begin; i < firstBlock * blockFrames; ++i) {
+        total.add(frames[i]);
+    }
+    for (std::size_t i = lastBlock * blockFrames; i < end; ++i) {
+        total.add(frames[i]);
+    }
+
+    // Bottom-up segment tree walk: an odd left edge or right edge is a node that
+    // does not share a parent with the rest of the range.
+    for (std::size_t level = 0; firstBlock < lastBlock && level < levelCount; ++level) {
+        if (firstBlock & 1U) {
+            total.merge(levels[level][firstBlock++]);
+        }
+        if (lastBlock & 1U) {
+            total.merge(levels[level][--lastBlock]);
+        }
+        firstBlock >>= 1;
+        lastBlock >>= 1;
+    }
+    return total;
+}
+
+TrackAggregate PitchTrackView::query(double startSeconds, double endSeconds) const noexcept {
+    if (sampleRate <= 0.0 || hopSize == 0 || !(endSeconds > startSeconds)) {
+        return TrackAggregate{};
+    }
+    const double framesPerSecond = sampleRate / static_cast<double>(hopSize);
+    const auto toFrame = [&](double seconds) {
+        const double frame = std::ceil(std::max(0.0, seconds) * framesPerSecond);
+        return frame >= static_cast<double>(frameCount) ? frameCount : static_cast<std::size_t>(frame);
+    };
+    return queryFrames(toFrame(startSeconds), toFrame(endSeconds));
+}
+
+PitchTrackStore::PitchTrackStore(const PitchTrackStoreConfig& config) : m_config(config) {
+    m_config.capacityFrames = std::max<std::size_t>(m_config.capacityFrames, 1);
+    m_config.blockFrames = std::max<std::size_t>(m_config.blockFrames, 1);
+    m_config.hopSize = std::max<std::size_t>(m_config.hopSize, 1);
+
+    std::size_t sizes[PitchTrackView::MAX_LEVELS];
+    m_levelCount = levelSizes(m_config.capacityFrames / m_config.blockFrames, sizes);
+    std::size_t nodes = 0;
+    for (std::size_t level = 0; level < m_levelCount; ++level) {
+        m_levelOffsets[level] = nodes;
+        nodes += sizes[level];
+    }
+    m_frames = std::make_unique<TrackFrame[]>(m_config.capacityFrames);
+    m_nodes = std::make_unique<TrackAggregate[]>(std::max<std::size_t>(nodes, 1));
+}
+
+void PitchTrackStore::append(const PitchResult& result, std::uint64_t sampleTime) noexcept {
+    if (!m_started) {
+        m_started = true;
+        m_firstSampleTime.store(sampleTime, std::memory_order_relaxed);
+    }
+
+    // Place the result on the hop grid from the first one; a stream that went
+    // backwards (restarted) simply continues at the end.
+    const std::uint64_t first = m_firstSampleTime.load(std::memory_order_relaxed);
+    if (sampleTime >= first) {
+        const std::uint64_t hop = m_config.hopSize;
+        const std::uint64_t slot = (sampleTime - first + hop / 2) / hop;
+        const std::uint64_t limit = std::min<std::uint64_t>(slot, m_config.capacityFrames);
+        while (m_published.load(std::memory_order_relaxed) < limit) {
+            push(TrackFrame{});
+        }
+    }
+
+    TrackFrame frame;
+    const bool valid = result.isValid && result.frequency > 0.0 && std::isfinite(result.frequency) &&
+                       std::isfinite(result.cents);
+    if (valid) {
+        frame.frequency = static_cast<float>(result.frequency);
+        frame.cents = static_cast<float>(result.cents);
+        frame.valid = 1;
+    }
+    push(frame);
+}
+
+void PitchTrackStore::push(const TrackFrame& frame) noexcept {
+    const std::size_t index = m_published.load(std::memory_order_relaxed);
+    if (index >= m_config.capacityFrames) {
+        m_dropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    m_frames[index] = frame;
+    m_openBlock.add(frame);
+
+    if ((index + 1) % m_config.blockFrames == 0) {
+        // Leaf for the completed block, then every parent it completes.
+        std::size_t node = index / m_config.blockFrames;
+        m_nodes[m_levelOffsets[0] + node] = m_openBlock;
+        m_openBlock = TrackAggregate{};
+        for (std::size_t level = 0; (node & 1U) != 0 && level + 1 < m_levelCount; ++level) {
+            TrackAggregate parent = m_nodes[m_levelOffsets[level] + node - 1];
+            parent.merge(m_nodes[m_levelOffsets[level] + node]);
+            node >>= 1;
+            m_nodes[m_levelOffsets[level + 1] + node] = parent;
+        }
+    }
+    // Readers see the frame and every node it completed together.
+    m_published.store(index + 1, std::memory_order_release);
+}
+
+PitchTrackView PitchTrackStore::view() const noexcept {
+    PitchTrackView view;
+    view.sampleRate = m_config.sampleRate;
+    view.hopSize = m_config.hopSize;
+    view.blockFrames = m_config.blockFrames;
+    view.frameCount = m_published.load(std::memory_order_acquire);
+    view.frames = m_frames.get();
+    view.levelCount = m_levelCount;
+    for (std::size_t level = 0; level < m_levelCount; ++level) {
+        view.levels[level] = m_nodes.get() + m_levelOffsets[level];
+    }
+    return view;
+}
+
+bool PitchTrackStore::save(const std::string& path) const {
+    const PitchTrackView snapshot = view();
+    std::size_t sizes[PitchTrackView::MAX_LEVELS];
+    const std::size_t levels = levelSizes(snapshot.frameCount / snapshot.blockFrames, sizes);
+
+    FileHeader header{};
+    std::memcpy(header.magic, TRACK_MAGIC, sizeof(TRACK_MAGIC));
+    header.version = TRACK_VERSION;
+    header.blockFrames = static_cast<std::uint32_t>(snapshot.blockFrames);
+    header.sampleRate = snapshot.sampleRate;
+    header.hopSize = snapshot.hopSize;
+    header.firstSampleTime = firstSampleTime();
+    header.frameCount = snapshot.frameCount;
+    header.levelCount = levels;
+
+    const std::string temporary = path + ".tmp";
+    std::FILE* file = std::fopen(temporary.c_str(), "wb");
+    if (!file) {
+        return false;
+    }
+    const std::size_t frameBytes = snapshot.frameCount * sizeof(TrackFrame);
+    const char padding[alignof(TrackAggregate)] = {};
+    bool written = writeAll(file, &header, sizeof(header)) && writeAll(file, snapshot.frames, frameBytes) &&
+                   writeAll(file, padding, alignUp(frameBytes) - frameBytes);
+    for (std::size_t level = 0; written && level < levels; ++level) {
+        written = writeAll(file, snapshot.levels[level], sizes[level] * sizeof(TrackAggregate));
+    }
+    if (std::fclose(file) != 0 || !written) {
+        ::unlink(temporary.c_str());
+        return false;
+    }
+    return std::rename(temporary.c_str(), path.c_str()) == 0;
+}
+
+void PitchTrackStore::reset() noexcept {
+    m_published.store(0, std::memory_order_release);
+    m_openBlock = TrackAggregate{};
+    m_started = false;
+    m_firstSampleTime.store(0, std::memory_order_relaxed);
+    m_dropped.store(0, std::memory_order_relaxed);
+}
+
+MappedPitchTrack::~MappedPitchTrack() {
+    close();
+}
+
+bool MappedPitchTrack::open(const std::string& path) {
+    close();
+    const int descriptor = ::open(path.c_str(), O_RDONLY);
+    if (descriptor < 0) {
+        return false;
+    }
+    struct stat info {};
+    void* mapping = MAP_FAILED;
+    std::size_t length = 0;
+    if (::fstat(descriptor, &info) == 0 && static_cast<std::size_t>(info.st_size) >= sizeof(FileHeader)) {
+        length = static_cast<std::size_t>(info.st_size);
+        mapping = ::mmap(nullptr, length, PROT_READ, MAP_PRIVATE, descriptor, 0);
+    }
+    ::close(descriptor);
+    if (mapping == MAP_FAILED) {
+        return false;
+    }
+
+    FileHeader header{};
+    std::memcpy(&header, mapping, sizeof(header));
+    std::size_t sizes[PitchTrackView::MAX_LEVELS];
+    const bool plausible = std::memcmp(header.magic, TRACK_MAGIC, sizeof(TRACK_MAGIC)) == 0 &&
+                           header.version == TRACK_VERSION && header.blockFrames > 0 && header.hopSize > 0 &&
+                           header.sampleRate > 0.0 && header.frameCount <= length / sizeof(TrackFrame);
+    std::size_t levels = 0;
+    std::size_t expected = 0;
+    if (plausible) {
+        levels = levelSizes(header.frameCount / header.blockFrames, sizes);
+        expected = sizeof(FileHeader) + alignUp(header.frameCount * sizeof(TrackFrame));
+        for (std::size_t level = 0; level < levels; ++level) {
+            expected += sizes[level] * sizeof(TrackAggregate);
+        }
+    }
+    if (!plausible || levels != header.levelCount || expected != length) {
+        ::munmap(mapping, length);
+        return false;
+    }
+
+    const auto* base = static_cast<const unsigned char*>(mapping);
+    m_mapping = mapping;
+    m_length = length;
+    m_firstSampleTime = header.firstSampleTime;
+    m_view = PitchTrackView{};
+    m_view.sampleRate = header.sampleRate;
+    m_view.hopSize = header.hopSize;
+    m_view.blockFrames = header.blockFrames;
+    m_view.frameCount = header.frameCount;
+    m_view.frames = reinterpret_cast<const TrackFrame*>(base + sizeof(FileHeader));
+    m_view.levelCount = levels;
+    std::size_t offset = sizeof(FileHeader) + alignUp(header.frameCount * sizeof(TrackFrame));
+    for (std::size_t level = 0; level < levels; ++level) {
+        m_view.levels[level] = reinterpret_cast<const TrackAggregate*>(base + offset);
+        offset += sizes[level] * sizeof(TrackAggregate);
+    }
+    return true;
+}
+
+void MappedPitchTrack::close() noexcept {
+    if (m_mapping) {
+        ::munmap(m_mapping, m_length);
+    }
+    m_mapping = nullptr;
+    m_length = 0;
+    m_view = PitchTrackView{};
+    m_firstSampleTime = 0;
+}
+
+}  // namespace tine::dsp
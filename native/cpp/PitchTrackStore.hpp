@@ -0,0 +1,180 @@
+#ifndef TINE_NATIVE_DSP_PITCHTRACKSTORE_HPP
+#define TINE_NATIVE_DSP_PITCHTRACKSTORE_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <string>
+
+#include "YinPitchDetector.hpp"
+
+namespace tine::dsp {
+
+/** One stored result; fixed layout, persisted as is. */
+struct TrackFrame {
+    float frequency{0.0F};
+    /** Offset from the nearest note. */
+    float cents{0.0F};
+    std::uint32_t valid{0};
+};
+
+/**
+ * Statistics of a run of frames. Aggregates merge in any order, which is what
+ * lets the index answer a range from a few precomputed nodes.
+ */
+struct TrackAggregate {
+    std::uint64_t frames{0};
+    std::uint64_t validFrames{0};
+    double sumCents{0.0};
+    double sumSquaredCents{0.0};
+    /** Over valid frames only; +/-infinity while there are none. */
+    float minCents{std::numeric_limits<float>::infinity()};
+    float maxCents{-std::numeric_limits<float>::infinity()};
+    float minFrequency{std::numeric_limits<float>::infinity()};
+    float maxFrequency{-std::numeric_limits<float>::infinity()};
+
+    void add(const TrackFrame& frame) noexcept;
+    void merge(const TrackAggregate& other) noexcept;
+
+    [[nodiscard]] double validFraction() const noexcept {
+        return frames > 0 ? static_cast<double>(validFrames) / static_cast<double>(frames) : 0.0;
+    }
+    [[nodiscard]] double meanCents() const noexcept {
+        return validFrames > 0 ? sumCents / static_cast<double>(validFrames) : 0.0;
+    }
+    [[nodiscard]] double stdDevCents() const noexcept;
+};
+
+/**
+ * Read-only view of a track and its index, in memory or mapped from a file.
+ * Levels hold block aggregates: level 0 one node per complete block, level k
+ * one per 2^k blocks.
+ */
+struct PitchTrackView {
+    static constexpr std::size_t MAX_LEVELS = 48;
+
+    double sampleRate{48000.0};
+    std::size_t hopSize{512};
+    std::size_t blockFrames{64};
+    std::size_t frameCount{0};
+    const TrackFrame* frames{nullptr};
+    const TrackAggregate* levels[MAX_LEVELS]{};
+    std::size_t levelCount{0};
+
+    /** Aggregate of frames [begin, end), clamped to the track. O(blockFrames + log frames). */
+    [[nodiscard]] TrackAggregate queryFrames(std::size_t begin, std::size_t end) const noexcept;
+
+    /** Aggregate of the frames starting in [startSeconds, endSeconds) of track time. */
+    [[nodiscard]] TrackAggregate query(double startSeconds, double endSeconds) const noexcept;
+
+    [[nodiscard]] double durationSeconds() const noexcept {
+        return static_cast<double>(frameCount * hopSize) / sampleRate;
+    }
+};
+
+struct PitchTrackStoreConfig {
+    double sampleRate{48000.0};
+    /** Frames of new audio per result: the track's time step. */
+    std::size_t hopSize{512};
+    /** Preallocated track length; results beyond it are counted and dropped (about 3 h at 512 / 48 kHz). */
+    std::size_t capacityFrames{1 << 20};
+    /** Frames per leaf aggregate. Queries scan at most two partial blocks. */
+    std::size_t blockFrames{64};
+};
+
+/**
+ * Append-only pitch track with a range-aggregate index kept up to date as
+ * results arrive.
+ *
+ * The index is a segment tree stored bottom-up as a pyramid: each completed
+ * block adds a leaf and, whenever it completes a pair, the parent above it, so
+ * an append costs O(1) amortised and never rebalances. Everything is allocated
+ * up front: append() runs on the producing thread (capture or engine) without
+ * allocating, and view() may be taken from any thread at any time. save()
+ * writes the same layout, which MappedPitchTrack queries straight from the page
+ * cache.
+ */
+class PitchTrackStore {
+public:
+    explicit PitchTrackStore(const PitchTrackStoreConfig& config = {});
+
+    PitchTrackStore(const PitchTrackStore&) = delete;
+    PitchTrackStore& operator=(const PitchTrackStore&) = delete;
+
+    /**
+     * Producer thread: store one result.
+     * @param sampleTime Stream frame index of the newest sample behind it; skipped
+     *        hops are filled with invalid frames so the track stays on its time grid.
+     */
+    void append(const PitchResult& result, std::uint64_t sampleTime) noexcept;
+
+    /** Any thread: the frames published so far and their index. */
+    [[nodiscard]] PitchTrackView view() const noexcept;
+
+    [[nodiscard]] std::uint64_t droppedFrames() const noexcept {
+        return m_dropped.load(std::memory_order_relaxed);
+    }
+
+    /** Stream frame of the first stored result. */
+    [[nodiscard]] std::uint64_t firstSampleTime() const noexcept {
+        return m_firstSampleTime.load(std::memory_order_relaxed);
+    }
+
+    /** Write the published track and index atomically (temporary file + rename). Any thread. */
+    [[nodiscard]] bool save(const std::string& path) const;
+
+    /** Start an empty track. Only while nothing is appending. */
+    void reset() noexcept;
+
+    [[nodiscard]] const PitchTrackStoreConfig& config() const noexcept { return m_config; }
+
+private:
+    void push(const TrackFrame& frame) noexcept;
+
+    PitchTrackStoreConfig m_config;
+    std::unique_ptr<TrackFrame[]> m_frames;
+    std::unique_ptr<TrackAggregate[]> m_nodes;
+    std::size_t m_levelOffsets[PitchTrackView::MAX_LEVELS]{};
+    std::size_t m_levelCount{0};
+
+    // Producer-only state.
+    TrackAggregate m_openBlock;
+    bool m_started{false};
+
+    std::atomic<std::size_t> m_published{0};
+    std::atomic<std::uint64_t> m_firstSampleTime{0};
+    std::atomic<std::uint64_t> m_dropped{0};
+};
+
+/**
+ * A saved PitchTrackStore mapped read-only. Queries touch only the pages of the
+ * nodes and the two partial blocks they read.
+ */
+class MappedPitchTrack {
+public:
+    MappedPitchTrack() = default;
+    ~MappedPitchTrack();
+
+    MappedPitchTrack(const MappedPitchTrack&) = delete;
+    MappedPitchTrack& operator=(const MappedPitchTrack&) = delete;
+
+    /** @return false for a missing, truncated or foreign file. */
+    bool open(const std::string& path);
+    void close() noexcept;
+
+    [[nodiscard]] bool isOpen() const noexcept { return m_mapping != nullptr; }
+    [[nodiscard]] const PitchTrackView& view() const noexcept { return m_view; }
+    [[nodiscard]] std::uint64_t firstSampleTime() const noexcept { return m_firstSampleTime; }
+
+private:
+    void* m_mapping{nullptr};
+    std::size_t m_length{0};
+    PitchTrackView m_view;
+    std::uint64_t m_firstSampleTime{0};
+};
+
+}  // namespace tine::dsp
+
+#endif  // TINE_NATIVE_DSP_PITCHTRACKSTORE_HPP
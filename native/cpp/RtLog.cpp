@@ -0,0 +1,136 @@
+#include "RtLog.hpp"
+
+#include <chrono>
+#include <cstdio>
+
+namespace tine::dsp {
+
+namespace {
+
+std::size_t nextPowerOfTwo(std::size_t value) {
+    std::size_t v = 1;
+    while (v < value) {
+        v <<= 1;
+    }
+    return v;
+}
+
+}  // namespace
+
+RtLog::RtLog(std::size_t capacity)
+    : m_mask(nextPowerOfTwo(capacity < 2 ? 2 : capacity) - 1), m_cells(new Cell[m_mask + 1]) {
+    // Each cell's sequence says which enqueue position may fill it next.
+    for (std::size_t i = 0; i <= m_mask; ++i) {
+        m_cells[i].sequence.store(i, std::memory_order_relaxed);
+    }
+}
+
+bool RtLog::log(RtLogEvent event, double a0, double a1, double a2, double a3) noexcept {
+    std::size_t position = m_enqueue.load(std::memory_order_relaxed);
+    Cell* cell = nullptr;
+    for (;;) {
+        cell = &m_cells[position & m_mask];
+        const std::size_t sequence = cell->sequence.load(std::memory_order_acquire);
+        const auto lead = static_cast<std::ptrdiff_t>(sequence - position);
+        if (lead == 0) {
+            if (m_enqueue.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                break;
+            }
+        } else if (lead < 0) {
+            // The consumer has not freed this cell yet: full.
+            m_dropped.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        } else {
+            position = m_enqueue.load(std::memory_order_relaxed);
+        }
+    }
+
+    RtLogRecord& record = cell->record;
+    record.timestampNanos = static_cast<std::uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch())
+            .count());
+    record.event = event;
+    record.args[0] = a0;
+    record.args[1] = a1;
+    record.args[2] = a2;
+    record.args[3] = a3;
+    cell->sequence.store(position + 1, std::memory_order_release);
+    return true;
+}
+
+bool RtLog::pop(RtLogRecord& record) noexcept {
+    Cell& cell = m_cells[m_dequeue & m_mask];
+    if (cell.sequence.load(std::memory_order_acquire) != m_dequeue + 1) {
+        return false;
+    }
+    record = cell.record;
+    // Hand the cell to the producer one lap ahead.
+    cell.sequence.store(m_dequeue + m_mask + 1, std::memory_order_release);
+    ++m_dequeue;
+    return true;
+}
+
+const char* RtLog::eventName(RtLogEvent event) noexcept {
+    switch (event) {
+        case RtLogEvent::CaptureOverrun:
+            return "capture-overrun";
+        case RtLogEvent::CaptureDropped:
+            return "capture-dropped";
+        case RtLogEvent::InlineFallback:
+            return "inline-fallback";
+        case RtLogEvent::WindowResized:
+            return "window-resized";
+        case RtLogEvent::ThresholdApplied:
+            return "threshold-applied";
+    }
+    return "unknown";
+}
+
+RtLogLevel RtLog::level(RtLogEvent event) noexcept {
+    switch (event) {
+        case RtLogEvent::CaptureOverrun:
+        case RtLogEvent::CaptureDropped:
+        case RtLogEvent::InlineFallback:
+            return RtLogLevel::Warn;
+        case RtLogEvent::WindowResized:
+        case RtLogEvent::ThresholdApplied:
+            return RtLogLevel::Info;
+    }
+    return RtLogLevel::Info;
+}
+
+std::string RtLog::format(const RtLogRecord& record) {
+    char text[160];
+    const double* a = record.args;
+    switch (record.event) {
+        case RtLogEvent::CaptureOverrun:
+            std::snprintf(text, sizeof(text), "Analysis fell behind capture: skipped %.0f frames (%.0f overruns total)",
+                          a[0], a[1]);
+            break;
+        case RtLogEvent::CaptureDropped:
+            std::snprintf(text, sizeof(text), "Capture ring full: dropped %.0f new frames", a[0]);
+            break;
+        case RtLogEvent::InlineFallback:
+            std::snprintf(text, sizeof(text),
+                          "Inline analysis over budget (worst %.2f ms, budget %.2f ms); moved to worker",
+                          a[0] * 1000.0, a[1] * 1000.0);
+            break;
+        case RtLogEvent::WindowResized:
+            if (a[2] > 0.0) {
+                std::snprintf(text, sizeof(text), "Analysis window %.0f -> %.0f samples at %.1f Hz", a[0], a[1], a[2]);
+            } else {
+                std::snprintf(text, sizeof(text), "Analysis window %.0f -> %.0f samples (pitch lost)", a[0], a[1]);
+            }
+            break;
+        case RtLogEvent::ThresholdApplied:
+            std::snprintf(text, sizeof(text), "Threshold %.3f applied", a[0]);
+            break;
+        default:
+            std::snprintf(text, sizeof(text), "Event %u (%g, %g, %g, %g)", static_cast<unsigned>(record.event), a[0],
+                          a[1], a[2], a[3]);
+            break;
+    }
+    return text;
+}
+
+}  // namespace tine::dsp
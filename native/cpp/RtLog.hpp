@@ -0,0 +1,105 @@
+#ifndef TINE_NATIVE_UTIL_RTLOG_HPP
+#define TINE_NATIVE_UTIL_RTLOG_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+namespace tine::dsp {
+
+enum class RtLogLevel : std::uint8_t { Info, Warn, Error };
+
+enum class RtLogEvent : std::uint16_t {
+    /** args: frames skipped, total overruns. */
+    CaptureOverrun,
+    /** args: frames refused by a full ring. */
+    CaptureDropped,
+    /** args: worst inline analysis seconds, budget seconds. */
+    InlineFallback,
+    /** args: previous window, new window, tracked frequency. */
+    WindowResized,
+    /** args: threshold now applied. */
+    ThresholdApplied,
+};
+
+/**
+ * Fixed-size binary record: no strings, so logging never allocates or formats.
+ */
+struct RtLogRecord {
+    static constexpr std::size_t kMaxArgs = 4;
+
+    std::uint64_t timestampNanos{0};
+    RtLogEvent event{RtLogEvent::CaptureOverrun};
+    double args[kMaxArgs]{};
+};
+
+/**
+ * Lock-free bounded multi-producer/single-consumer log ring for real-time code.
+ *
+ * log() is wait-free apart from a CAS retry when producers race for the same
+ * slot; it never allocates, locks or formats, and drops the record (counting it)
+ * when the ring is full. drain() and format() belong on a non-real-time thread.
+ */
+class RtLog {
+public:
+    explicit RtLog(std::size_t capacity = 256);
+
+    RtLog(const RtLog&) = delete;
+    RtLog& operator=(const RtLog&) = delete;
+
+    /**
+     * Record @p event with up to four numeric arguments. Safe from any thread.
+     * @return false if the ring was full and the record was dropped.
+     */
+    bool log(RtLogEvent event, double a0 = 0.0, double a1 = 0.0, double a2 = 0.0, double a3 = 0.0) noexcept;
+
+    /**
+     * Pop one record. Single consumer only.
+     * @return false when empty.
+     */
+    bool pop(RtLogRecord& record) noexcept;
+
+    /**
+     * Pop every available record into @p handler(const RtLogRecord&).
+     * @return Records delivered.
+     */
+    template <typename Handler>
+    std::size_t drain(Handler&& handler) {
+        std::size_t count = 0;
+        RtLogRecord record;
+        while (pop(record)) {
+            handler(record);
+            ++count;
+        }
+        return count;
+    }
+
+    /** Records lost to a full ring since construction. */
+    [[nodiscard]] std::uint64_t dropped() const noexcept { return m_dropped.load(std::memory_order_relaxed); }
+
+    [[nodiscard]] std::size_t capacity() const noexcept { return m_mask + 1; }
+
+    [[nodiscard]] static const char* eventName(RtLogEvent event) noexcept;
+    [[nodiscard]] static RtLogLevel level(RtLogEvent event) noexcept;
+
+    /** Human-readable message for @p record (without timestamp or level). */
+    [[nodiscard]] static std::string format(const RtLogRecord& record);
+
+private:
+    struct Cell {
+        std::atomic<std::size_t> sequence{0};
+        RtLogRecord record;
+    };
+
+    const std::size_t m_mask;
+    std::unique_ptr<Cell[]> m_cells;
+    alignas(64) std::atomic<std::size_t> m_enqueue{0};
+    alignas(64) std::size_t m_dequeue{0};
+    std::atomic<std::uint64_t> m_dropped{0};
+};
+
+}  // namespace tine::dsp
+
+#endif  // TINE_NATIVE_UTIL_RTLOG_HPP
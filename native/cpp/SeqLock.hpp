@@ -0,0 +1,87 @@
+#ifndef TINE_NATIVE_UTIL_SEQLOCK_HPP
+#define TINE_NATIVE_UTIL_SEQLOCK_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+namespace tine::dsp {
+
+/**
+ * Single-writer sequence lock publishing a small trivially copyable value.
+ *
+ * store() is wait-free, so a real-time thread can publish without ever waiting
+ * on a reader; load() retries while a store is in flight. The payload lives in
+ * relaxed atomic words, so concurrent access is race-free without locks.
+ */
+template <typename T>
+class SeqLock {
+    static_assert(std::is_trivially_copyable_v<T>, "SeqLock payloads are copied word by word");
+
+public:
+    SeqLock() noexcept { store(T{}); }
+
+    explicit SeqLock(const T& value) noexcept { store(value); }
+
+    SeqLock(const SeqLock&) = delete;
+    SeqLock& operator=(const SeqLock&) = delete;
+
+    /** Publish @p value. One writer thread at a time. */
+    void store(const T& value) noexcept {
+        std::uint64_t words[WORDS]{};
+        std::memcpy(words, &value, sizeof(T));
+
+        const std::uint64_t sequence = m_sequence.load(std::memory_order_relaxed);
+        // Odd while writing; the fence keeps the payload stores after it.
+        m_sequence.store(sequence + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        for (std::size_t i = 0; i < WORDS; ++i) {
+            m_words[i].store(words[i], std::memory_order_relaxed);
+        }
+        m_sequence.store(sequence + 2, std::memory_order_release);
+    }
+
+    /** Latest complete value. Any number of reader threads. */
+    [[nodiscard]] T load() const noexcept {
+        T value;
+        while (!tryLoad(value)) {
+        }
+        return value;
+    }
+
+    /**
+     * One read attempt.
+     * @return false when it overlapped a store; @p value is then unspecified.
+     */
+    bool tryLoad(T& value) const noexcept {
+        const std::uint64_t before = m_sequence.load(std::memory_order_acquire);
+        if (before & 1) {
+            return false;
+        }
+        std::uint64_t words[WORDS];
+        for (std::size_t i = 0; i < WORDS; ++i) {
+            words[i] = m_words[i].load(std::memory_order_relaxed);
+        }
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (m_sequence.load(std::memory_order_relaxed) != before) {
+            return false;
+        }
+        std::memcpy(&value, words, sizeof(T));
+        return true;
+    }
+
+    /** Incremented by two per store; readers can compare it to skip unchanged values. */
+    [[nodiscard]] std::uint64_t version() const noexcept { return m_sequence.load(std::memory_order_acquire); }
+
+private:
+    static constexpr std::size_t WORDS = (sizeof(T) + sizeof(std::uint64_t) - 1) / sizeof(std::uint64_t);
+
+    std::atomic<std::uint64_t> m_sequence{0};
+    std::atomic<std::uint64_t> m_words[WORDS]{};
+};
+
+}  // namespace tine::dsp
+
+#endif  // TINE_NATIVE_UTIL_SEQLOCK_HPP
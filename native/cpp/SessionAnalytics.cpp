@@ -0,0 +1,364 @@
+#include "SessionAnalytics.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace tine::dsp {
+
+namespace {
+
+// Session-wide cells ahead of the per-summary slots.
+constexpr std::size_t SESSION_SECONDS = 0;
+constexpr std::size_t DRIFT_BIN_SECONDS = 1;
+// Weighted least-squares sums of cents against time (minutes).
+constexpr std::size_t REGRESSION_W = 2;
+constexpr std::size_t REGRESSION_WT = 3;
+constexpr std::size_t REGRESSION_WC = 4;
+constexpr std::size_t REGRESSION_WTT = 5;
+constexpr std::size_t REGRESSION_WTC = 6;
+constexpr std::size_t GLOBAL_CELLS = 7;
+
+// Fields of one summary slot.
+constexpr std::size_t VOICED = 0;
+constexpr std::size_t IN_TUNE = 1;
+constexpr std::size_t SUM_CENTS = 2;
+constexpr std::size_t SUM_SQUARES = 3;
+constexpr std::size_t VIBRATO_SECONDS = 4;
+constexpr std::size_t VIBRATO_RATE = 5;
+constexpr std::size_t VIBRATO_DEPTH = 6;
+constexpr std::size_t HISTOGRAM = 7;
+constexpr std::size_t SLOT_CELLS = HISTOGRAM + IntonationSummary::HISTOGRAM_BINS;
+
+constexpr std::size_t OVERALL_SLOT = 0;
+constexpr std::size_t FIRST_NOTE_SLOT = 1;
+constexpr std::size_t FIRST_STRING_SLOT = FIRST_NOTE_SLOT + SessionAnalytics::NOTE_COUNT;
+
+// A held note keeps its vibrato segment until the pitch is this far (semitones)
+// from it, so a wide vibrato crossing the half-semitone boundary is not cut.
+constexpr double SEGMENT_HOLD_SEMITONES = 0.75;
+// Results further apart than this many hops are not one contour.
+constexpr double GAP_HOPS = 1.5;
+// Resonators assess a segment once it is this many time constants old.
+constexpr double SETTLE_TIME_CONSTANTS = 2.0;
+// The contour's moving mean follows slower than the slowest vibrato by this factor.
+constexpr double CONTOUR_MEAN_RATIO = 3.0;
+
+constexpr std::size_t slotCell(std::size_t slot, std::size_t field) {
+    return GLOBAL_CELLS + slot * SLOT_CELLS + field;
+}
+
+}  // namespace
+
+SessionAnalytics::SessionAnalytics(const SessionAnalyticsConfig& config) : m_config(config) {
+    const SessionAnalyticsConfig defaults;
+    if (!(m_config.sampleRate > 0.0)) {
+        m_config.sampleRate = defaults.sampleRate;
+    }
+    m_config.hopSize = std::max<std::size_t>(m_config.hopSize, 1);
+    m_config.driftBins = std::max<std::size_t>(m_config.driftBins, 2);
+    if (!(m_config.driftBinSeconds > 0.0)) {
+        m_config.driftBinSeconds = defaults.driftBinSeconds;
+    }
+    if (!(m_config.vibratoTimeConstantSeconds > 0.0)) {
+        m_config.vibratoTimeConstantSeconds = defaults.vibratoTimeConstantSeconds;
+    }
+    m_resultSeconds = static_cast<double>(m_config.hopSize) / m_config.sampleRate;
+
+    m_slotCount = FIRST_STRING_SLOT + m_config.stringMidi.size();
+    m_driftOffset = GLOBAL_CELLS + m_slotCount * SLOT_CELLS;
+    m_cellCount = m_driftOffset + 2 * m_config.driftBins;
+    m_cells = std::make_unique<std::atomic<double>[]>(m_cellCount);
+
+    // Bands stay below the contour's Nyquist rate (one sample per result).
+    const double contourRate = 1.0 / m_resultSeconds;
+    const double maxHz = std::min(m_config.vibratoMaxHz, 0.4 * contourRate);
+    const double minHz = std::clamp(m_config.vibratoMinHz, 0.1, maxHz);
+    const std::size_t bands = std::max<std::size_t>(m_config.vibratoBands, 1);
+    m_resonators.resize(bands);
+    for (std::size_t k = 0; k < bands; ++k) {
+        const double hz = bands > 1 ? minHz + (maxHz - minHz) * static_cast<double>(k) / (bands - 1) : minHz;
+        m_resonators[k].cosw = std::cos(2.0 * M_PI * hz * m_resultSeconds);
+        m_resonators[k].sinw = std::sin(2.0 * M_PI * hz * m_resultSeconds);
+    }
+    m_config.vibratoMinHz = minHz;
+    m_config.vibratoMaxHz = maxHz;
+    m_config.vibratoBands = bands;
+    m_decay = std::exp(-m_resultSeconds / m_config.vibratoTimeConstantSeconds);
+    m_contourAlpha = 1.0 - std::exp(-2.0 * M_PI * (minHz / CONTOUR_MEAN_RATIO) * m_resultSeconds);
+
+    reset();
+}
+
+void SessionAnalytics::reset() noexcept {
+    for (std::size_t i = 0; i < m_cellCount; ++i) {
+        m_cells[i].store(0.0, std::memory_order_relaxed);
+    }
+    m_cells[DRIFT_BIN_SECONDS].store(m_config.driftBinSeconds, std::memory_order_relaxed);
+    for (Resonator& resonator : m_resonators) {
+        resonator.re = 0.0;
+        resonator.im = 0.0;
+    }
+    m_segmentNote = -1;
+    m_segmentSeconds = 0.0;
+    m_started = false;
+}
+
+void SessionAnalytics::add(std::size_t cell, double value) noexcept {
+    // Single writer: load and store need no read-modify-write.
+    m_cells[cell].store(m_cells[cell].load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+}
+
+void SessionAnalytics::process(const PitchResult& result, std::uint64_t sampleTime) noexcept {
+    if (!m_started) {
+        m_started = true;
+        m_firstSampleTime = sampleTime;
+        m_lastSampleTime = sampleTime;
+    }
+    const bool contiguous =
+        sampleTime >= m_lastSampleTime &&
+        static_cast<double>(sampleTime - m_lastSampleTime) <= GAP_HOPS * static_cast<double>(m_config.hopSize);
+    m_lastSampleTime = sampleTime;
+
+    const bool voiced = result.isValid && result.frequency > 0.0 && std::isfinite(result.midi) &&
+                        result.midi >= 0.0 && result.midi < static_cast<double>(NOTE_COUNT) - 0.5;
+    const double elapsed =
+        static_cast<double>(sampleTime - m_firstSampleTime) / m_config.sampleRate + m_resultSeconds;
+
+    // Odd while the totals are inconsistent; snapshot() retries across it.
+    const std::uint64_t sequence = m_sequence.load(std::memory_order_relaxed);
+    m_sequence.store(sequence + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    m_cells[SESSION_SECONDS].store(elapsed, std::memory_order_relaxed);
+    extendDrift(elapsed - m_resultSeconds);
+    if (voiced) {
+        const int note = static_cast<int>(std::lround(result.midi));
+        const double cents = (result.midi - note) * 100.0;
+        const double seconds = m_resultSeconds;
+        accumulate(OVERALL_SLOT, seconds, cents);
+        accumulate(FIRST_NOTE_SLOT + static_cast<std::size_t>(note), seconds, cents);
+
+        std::size_t stringSlot = 0;
+        double stringDistance = 1.0;
+        for (std::size_t i = 0; i < m_config.stringMidi.size(); ++i) {
+            const double distance = std::fabs(result.midi - m_config.stringMidi[i]);
+            if (distance < stringDistance) {
+                stringDistance = distance;
+                stringSlot = FIRST_STRING_SLOT + i;
+            }
+        }
+        if (stringSlot != 0) {
+            const int string = m_config.stringMidi[stringSlot - FIRST_STRING_SLOT];
+            accumulate(stringSlot, seconds, (result.midi - string) * 100.0);
+        }
+
+        accumulateDrift(elapsed - seconds, seconds, cents);
+
+        double rateHz = 0.0;
+        double depthCents = 0.0;
+        trackVibrato(note, result.midi, contiguous, rateHz, depthCents);
+        if (depthCents > 0.0) {
+            accumulateVibrato(OVERALL_SLOT, seconds, rateHz, depthCents);
+            accumulateVibrato(FIRST_NOTE_SLOT + static_cast<std::size_t>(m_segmentNote), seconds, rateHz,
+                              depthCents);
+            if (stringSlot != 0) {
+                accumulateVibrato(stringSlot, seconds, rateHz, depthCents);
+            }
+        }
+    } else {
+        m_segmentNote = -1;
+    }
+
+    m_sequence.store(sequence + 2, std::memory_order_release);
+}
+
+void SessionAnalytics::accumulate(std::size_t slot, double seconds, double cents) noexcept {
+    add(slotCell(slot, VOICED), seconds);
+    if (std::fabs(cents) <= m_config.inTuneCents) {
+        add(slotCell(slot, IN_TUNE), seconds);
+    }
+    add(slotCell(slot, SUM_CENTS), seconds * cents);
+    add(slotCell(slot, SUM_SQUARES), seconds * cents * cents);
+
+    constexpr double binCents = 2.0 * IntonationSummary::HISTOGRAM_CENTS / IntonationSummary::HISTOGRAM_BINS;
+    const double position = std::floor((cents + IntonationSummary::HISTOGRAM_CENTS) / binCents);
+    const auto bin = static_cast<std::size_t>(
+        std::clamp(position, 0.0, static_cast<double>(IntonationSummary::HISTOGRAM_BINS - 1)));
+    add(slotCell(slot, HISTOGRAM + bin), seconds);
+}
+
+void SessionAnalytics::accumulateVibrato(std::size_t slot, double seconds, double rateHz,
+                                         double depthCents) noexcept {
+    add(slotCell(slot, VIBRATO_SECONDS), seconds);
+    add(slotCell(slot, VIBRATO_RATE), seconds * rateHz);
+    add(slotCell(slot, VIBRATO_DEPTH), seconds * depthCents);
+}
+
+void SessionAnalytics::accumulateDrift(double timeSeconds, double seconds, double cents) noexcept {
+    const double minutes = timeSeconds / 60.0;
+    add(REGRESSION_W, seconds);
+    add(REGRESSION_WT, seconds * minutes);
+    add(REGRESSION_WC, seconds * cents);
+    add(REGRESSION_WTT, seconds * minutes * minutes);
+    add(REGRESSION_WTC, seconds * minutes * cents);
+
+    const double width = m_cells[DRIFT_BIN_SECONDS].load(std::memory_order_relaxed);
+    const std::size_t bins = m_config.driftBins;
+    const auto bin = std::min(static_cast<std::size_t>(timeSeconds / width), bins - 1);
+    add(m_driftOffset + 2 * bin, seconds);
+    add(m_driftOffset + 2 * bin + 1, seconds * cents);
+}
+
+void SessionAnalytics::extendDrift(double timeSeconds) noexcept {
+    const std::size_t bins = m_config.driftBins;
+    double width = m_cells[DRIFT_BIN_SECONDS].load(std::memory_order_relaxed);
+    while (timeSeconds >= width * static_cast<double>(bins)) {
+        // Full: halve the resolution in place so memory stays fixed for any session length.
+        for (std::size_t i = 0; i < bins; ++i) {
+            double voiced = 0.0;
+            double sum = 0.0;
+            for (std::size_t j = 2 * i; j < std::min(2 * i + 2, bins); ++j) {
+                voiced += m_cells[m_driftOffset + 2 * j].load(std::memory_order_relaxed);
+                sum += m_cells[m_driftOffset + 2 * j + 1].load(std::memory_order_relaxed);
+            }
+            m_cells[m_driftOffset + 2 * i].store(voiced, std::memory_order_relaxed);
+            m_cells[m_driftOffset + 2 * i + 1].store(sum, std::memory_order_relaxed);
+        }
+        width *= 2.0;
+        m_cells[DRIFT_BIN_SECONDS].store(width, std::memory_order_relaxed);
+    }
+}
+
+void SessionAnalytics::trackVibrato(int note, double midi, bool contiguous, double& rateHz,
+                                    double& depthCents) noexcept {
+    if (!contiguous || m_segmentNote < 0 ||
+        std::fabs(midi - static_cast<double>(m_segmentNote)) >= SEGMENT_HOLD_SEMITONES) {
+        for (Resonator& resonator : m_resonators) {
+            resonator.re = 0.0;
+            resonator.im = 0.0;
+        }
+        m_segmentNote = note;
+        m_segmentSeconds = 0.0;
+        m_contourMean = (midi - note) * 100.0;
+    }
+
+    // The contour around its slow moving mean: intonation drift and scoops are
+    // removed, the periodic part excites the resonators.
+    const double contour = (midi - static_cast<double>(m_segmentNote)) * 100.0;
+    m_contourMean += m_contourAlpha * (contour - m_contourMean);
+    const double input = contour - m_contourMean;
+
+    std::size_t best = 0;
+    double bestPower = -1.0;
+    for (std::size_t k = 0; k < m_resonators.size(); ++k) {
+        Resonator& r = m_resonators[k];
+        const double re = m_decay * (r.re * r.cosw - r.im * r.sinw) + input;
+        const double im = m_decay * (r.re * r.sinw + r.im * r.cosw);
+        r.re = re;
+        r.im = im;
+        const double power = re * re + im * im;
+        if (power > bestPower) {
+            bestPower = power;
+            best = k;
+        }
+    }
+    m_segmentSeconds += m_resultSeconds;
+    if (m_segmentSeconds < SETTLE_TIME_CONSTANTS * m_config.vibratoTimeConstantSeconds) {
+        return;
+    }
+
+    const std::size_t bands = m_resonators.size();
+    const double spacing = bands > 1 ? (m_config.vibratoMaxHz - m_config.vibratoMinHz) / (bands - 1) : 0.0;
+    double offset = 0.0;
+    if (best > 0 && best + 1 < bands) {
+        const auto magnitude = [this](std::size_t k) {
+            return std::hypot(m_resonators[k].re, m_resonators[k].im);
+        };
+        const double a = magnitude(best - 1);
+        const double b = magnitude(best);
+        const double c = magnitude(best + 1);
+        const double denominator = a - 2.0 * b + c;
+        offset = denominator < 0.0 ? std::clamp(0.5 * (a - c) / denominator, -0.5, 0.5) : 0.0;
+    }
+    // A sinusoid of amplitude A at a band's centre settles to |z| = A / (2 (1 - decay));
+    // off centre the band's Lorentzian response is divided back out.
+    const double detuneHz = offset * spacing;
+    const double response =
+        1.0 / std::sqrt(1.0 + std::pow(2.0 * M_PI * detuneHz * m_config.vibratoTimeConstantSeconds, 2.0));
+    const double depth = 2.0 * (1.0 - m_decay) * std::sqrt(bestPower) / response;
+    if (depth < m_config.vibratoMinDepthCents) {
+        return;
+    }
+    rateHz = m_config.vibratoMinHz + (static_cast<double>(best) + offset) * spacing;
+    depthCents = depth;
+}
+
+SessionAnalyticsSnapshot SessionAnalytics::snapshot() const {
+    std::vector<double> cells(m_cellCount);
+    for (;;) {
+        const std::uint64_t before = m_sequence.load(std::memory_order_acquire);
+        if (before & 1) {
+            continue;
+        }
+        for (std::size_t i = 0; i < m_cellCount; ++i) {
+            cells[i] = m_cells[i].load(std::memory_order_relaxed);
+        }
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (m_sequence.load(std::memory_order_relaxed) == before) {
+            break;
+        }
+    }
+
+    SessionAnalyticsSnapshot snapshot;
+    snapshot.sessionSeconds = cells[SESSION_SECONDS];
+    snapshot.overall = summarize(cells, OVERALL_SLOT);
+    for (std::size_t note = 0; note < NOTE_COUNT; ++note) {
+        if (cells[slotCell(FIRST_NOTE_SLOT + note, VOICED)] > 0.0) {
+            snapshot.notes.push_back({static_cast<int>(note), summarize(cells, FIRST_NOTE_SLOT + note)});
+        }
+    }
+    for (std::size_t i = 0; i < m_config.stringMidi.size(); ++i) {
+        snapshot.strings.push_back({m_config.stringMidi[i], summarize(cells, FIRST_STRING_SLOT + i)});
+    }
+
+    snapshot.driftBinSeconds = cells[DRIFT_BIN_SECONDS];
+    const auto used = std::min<std::size_t>(
+        m_config.driftBins, static_cast<std::size_t>(std::ceil(snapshot.sessionSeconds / snapshot.driftBinSeconds)));
+    for (std::size_t i = 0; i < used; ++i) {
+        DriftPoint point;
+        point.startSeconds = static_cast<double>(i) * snapshot.driftBinSeconds;
+        point.voicedSeconds = cells[m_driftOffset + 2 * i];
+        point.meanCents = point.voicedSeconds > 0.0 ? cells[m_driftOffset + 2 * i + 1] / point.voicedSeconds : 0.0;
+        snapshot.drift.push_back(point);
+    }
+
+    const double w = cells[REGRESSION_W];
+    const double spread = w * cells[REGRESSION_WTT] - cells[REGRESSION_WT] * cells[REGRESSION_WT];
+    if (w > 0.0 && spread > 1e-12) {
+        snapshot.driftCentsPerMinute =
+            (w * cells[REGRESSION_WTC] - cells[REGRESSION_WT] * cells[REGRESSION_WC]) / spread;
+    }
+    return snapshot;
+}
+
+IntonationSummary SessionAnalytics::summarize(const std::vector<double>& cells, std::size_t slot) const {
+    IntonationSummary summary;
+    summary.voicedSeconds = cells[slotCell(slot, VOICED)];
+    summary.inTuneSeconds = cells[slotCell(slot, IN_TUNE)];
+    if (summary.voicedSeconds > 0.0) {
+        summary.meanCents = cells[slotCell(slot, SUM_CENTS)] / summary.voicedSeconds;
+        const double meanSquare = cells[slotCell(slot, SUM_SQUARES)] / summary.voicedSeconds;
+        summary.stdDevCents = std::sqrt(std::max(0.0, meanSquare - summary.meanCents * summary.meanCents));
+    }
+    for (std::size_t bin = 0; bin < IntonationSummary::HISTOGRAM_BINS; ++bin) {
+        summary.centsHistogram[bin] = cells[slotCell(slot, HISTOGRAM + bin)];
+    }
+    summary.vibratoSeconds = cells[slotCell(slot, VIBRATO_SECONDS)];
+    if (summary.vibratoSeconds > 0.0) {
+        summary.vibratoRateHz = cells[slotCell(slot, VIBRATO_RATE)] / summary.vibratoSeconds;
+        summary.vibratoDepthCents = cells[slotCell(slot, VIBRATO_DEPTH)] / summary.vibratoSeconds;
+    }
+    return summary;
+}
+
+}  // namespace tine::dsp
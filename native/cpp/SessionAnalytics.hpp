@@ -0,0 +1,163 @@
+#ifndef TINE_NATIVE_DSP_SESSIONANALYTICS_HPP
+#define TINE_NATIVE_DSP_SESSIONANALYTICS_HPP
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "YinPitchDetector.hpp"
+
+namespace tine::dsp {
+
+struct SessionAnalyticsConfig {
+    double sampleRate{48000.0};
+    /** Frames of new audio behind each result; its duration is the weight of one result. */
+    std::size_t hopSize{512};
+    /** |cents| at or below which a voiced result counts as in tune. */
+    double inTuneCents{10.0};
+    /** Reference notes (e.g. open strings) as MIDI numbers; each gets its own statistics. */
+    std::vector<int> stringMidi;
+    /** Drift series resolution; bins double in width whenever driftBins fill up. */
+    double driftBinSeconds{10.0};
+    std::size_t driftBins{360};
+    /** Vibrato resonator bank: rates covered and number of bands. */
+    double vibratoMinHz{3.0};
+    double vibratoMaxHz{9.0};
+    std::size_t vibratoBands{13};
+    /** Resonator memory; also the settling time before a held note is assessed. */
+    double vibratoTimeConstantSeconds{0.5};
+    /** Modulation below this depth (cents, peak) is not vibrato. */
+    double vibratoMinDepthCents{5.0};
+};
+
+/**
+ * Time-weighted intonation statistics for one note, string or the whole session.
+ */
+struct IntonationSummary {
+    static constexpr std::size_t HISTOGRAM_BINS = 20;
+    /** The histogram covers +/-HISTOGRAM_CENTS in 5-cent bins; outliers land in the end bins. */
+    static constexpr double HISTOGRAM_CENTS = 50.0;
+
+    double voicedSeconds{0.0};
+    double inTuneSeconds{0.0};
+    double meanCents{0.0};
+    double stdDevCents{0.0};
+    /** Voiced seconds per cents bin, lowest (flattest) first. */
+    std::array<double, HISTOGRAM_BINS> centsHistogram{};
+    /** Seconds with vibrato, and its time-weighted mean rate and peak depth. */
+    double vibratoSeconds{0.0};
+    double vibratoRateHz{0.0};
+    double vibratoDepthCents{0.0};
+
+    [[nodiscard]] double inTuneFraction() const noexcept {
+        return voicedSeconds > 0.0 ? inTuneSeconds / voicedSeconds : 0.0;
+    }
+};
+
+struct NoteIntonation {
+    /** MIDI note (per-note statistics) or reference note (per-string statistics). */
+    int midi{0};
+    IntonationSummary summary;
+};
+
+struct DriftPoint {
+    double startSeconds{0.0};
+    double voicedSeconds{0.0};
+    /** Mean offset from the nearest note over the bin's voiced time. */
+    double meanCents{0.0};
+};
+
+struct SessionAnalyticsSnapshot {
+    /** Stream time covered from the first result, voiced or not. */
+    double sessionSeconds{0.0};
+    IntonationSummary overall;
+    /** Only notes that sounded, in MIDI order. */
+    std::vector<NoteIntonation> notes;
+    /** One entry per configured string, in configuration order. */
+    std::vector<NoteIntonation> strings;
+    double driftBinSeconds{0.0};
+    std::vector<DriftPoint> drift;
+    /** Least-squares slope of cents offset against time over the whole session. */
+    double driftCentsPerMinute{0.0};
+};
+
+/**
+ * Per-session intonation analytics fed by every detector result.
+ *
+ * process() runs on the thread that produces results (capture or engine thread),
+ * costs O(1) per result and never allocates: per-note and per-string moments,
+ * cents histograms, a drift series and a regression for drift rate. Vibrato is
+ * measured on the cents contour of each held note by a bank of decaying complex
+ * resonators; the strongest band gives rate and depth.
+ *
+ * All totals live in relaxed atomics behind a sequence counter, so snapshot() may
+ * run on any thread at any time and still sees the totals of a whole result.
+ */
+class SessionAnalytics {
+public:
+    static constexpr std::size_t NOTE_COUNT = 128;
+
+    explicit SessionAnalytics(const SessionAnalyticsConfig& config = {});
+
+    SessionAnalytics(const SessionAnalytics&) = delete;
+    SessionAnalytics& operator=(const SessionAnalytics&) = delete;
+
+    /**
+     * Producer thread: account one result.
+     * @param sampleTime Stream frame index of the newest sample behind it; gaps
+     *        (skipped frames) count as session time and break vibrato tracking.
+     */
+    void process(const PitchResult& result, std::uint64_t sampleTime) noexcept;
+
+    /** Any thread. Allocates the returned vectors. */
+    [[nodiscard]] SessionAnalyticsSnapshot snapshot() const;
+
+    /** Start a new session. Only while no results are being processed. */
+    void reset() noexcept;
+
+    [[nodiscard]] const SessionAnalyticsConfig& config() const noexcept { return m_config; }
+
+private:
+    struct Resonator {
+        double cosw{1.0};
+        double sinw{0.0};
+        double re{0.0};
+        double im{0.0};
+    };
+
+    void accumulate(std::size_t slot, double seconds, double cents) noexcept;
+    void accumulateVibrato(std::size_t slot, double seconds, double rateHz, double depthCents) noexcept;
+    void accumulateDrift(double timeSeconds, double seconds, double cents) noexcept;
+    void extendDrift(double timeSeconds) noexcept;
+    void trackVibrato(int note, double midi, bool contiguous, double& rateHz, double& depthCents) noexcept;
+    void add(std::size_t cell, double value) noexcept;
+    [[nodiscard]] IntonationSummary summarize(const std::vector<double>& cells, std::size_t slot) const;
+
+    SessionAnalyticsConfig m_config;
+    double m_resultSeconds;
+
+    // Flat cell layout: globals, then one slot per summary, then drift bins.
+    std::size_t m_slotCount;
+    std::size_t m_driftOffset;
+    std::size_t m_cellCount;
+    std::unique_ptr<std::atomic<double>[]> m_cells;
+    std::atomic<std::uint64_t> m_sequence{0};
+
+    // Producer-only state.
+    std::vector<Resonator> m_resonators;
+    double m_decay{0.0};
+    double m_contourAlpha{0.0};
+    double m_contourMean{0.0};
+    double m_segmentSeconds{0.0};
+    int m_segmentNote{-1};
+    std::uint64_t m_firstSampleTime{0};
+    std::uint64_t m_lastSampleTime{0};
+    bool m_started{false};
+};
+
+}  // namespace tine::dsp
+
+#endif  // TINE_NATIVE_DSP_SESSIONANALYTICS_HPP
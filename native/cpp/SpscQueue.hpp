@@ -0,0 +1,79 @@
+#ifndef TINE_NATIVE_UTIL_SPSC_QUEUE_HPP
+#define TINE_NATIVE_UTIL_SPSC_QUEUE_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <type_traits>
+
+namespace tine::dsp {
+
+/**
+ * Bounded single-producer/single-consumer queue of small trivially copyable
+ * records. push() and pop() are wait-free and never allocate; a full queue
+ * rejects the record and counts it instead of blocking the producer.
+ */
+template <typename T>
+class SpscQueue {
+    static_assert(std::is_trivially_copyable_v<T>, "SpscQueue records are copied, never constructed in place");
+
+public:
+    /** Capacity rounds up to a power of two. */
+    explicit SpscQueue(std::size_t capacity) : m_mask(roundUp(capacity) - 1), m_slots(new T[m_mask + 1]) {}
+
+    SpscQueue(const SpscQueue&) = delete;
+    SpscQueue& operator=(const SpscQueue&) = delete;
+
+    /** Producer thread. @return false (and counts a drop) when full. */
+    bool push(const T& value) noexcept {
+        const std::uint64_t tail = m_tail.load(std::memory_order_relaxed);
+        if (tail - m_head.load(std::memory_order_acquire) > m_mask) {
+            m_dropped.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        m_slots[tail & m_mask] = value;
+        m_tail.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    /** Consumer thread. @return false when empty. */
+    bool pop(T& value) noexcept {
+        const std::uint64_t head = m_head.load(std::memory_order_relaxed);
+        if (head == m_tail.load(std::memory_order_acquire)) {
+            return false;
+        }
+        value = m_slots[head & m_mask];
+        m_head.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    [[nodiscard]] std::size_t size() const noexcept {
+        return static_cast<std::size_t>(m_tail.load(std::memory_order_acquire) -
+                                        m_head.load(std::memory_order_acquire));
+    }
+
+    [[nodiscard]] std::size_t capacity() const noexcept { return m_mask + 1; }
+
+    /** Records rejected because the queue was full. */
+    [[nodiscard]] std::uint64_t dropped() const noexcept { return m_dropped.load(std::memory_order_relaxed); }
+
+private:
+    static std::size_t roundUp(std::size_t value) {
+        std::size_t v = 2;
+        while (v < value) {
+            v <<= 1;
+        }
+        return v;
+    }
+
+    const std::size_t m_mask;
+    std::unique_ptr<T[]> m_slots;
+    alignas(64) std::atomic<std::uint64_t> m_head{0};
+    alignas(64) std::atomic<std::uint64_t> m_tail{0};
+    std::atomic<std::uint64_t> m_dropped{0};
+};
+
+}  // namespace tine::dsp
+
+#endif  // TINE_NATIVE_UTIL_SPSC_QUEUE_HPP
@@ -0,0 +1,311 @@
+#include "StreamScheduler.hpp"
+
+#include <algorithm>
+#include <string>
+#include <utility>
+
+namespace tine::dsp {
+
+namespace {
+
+constexpr double MIN_QUANTUM_SECONDS = 1e-3;
+constexpr double NANOSECONDS = 1e-9;
+
+std::uint64_t nanosecondsBetween(std::chrono::steady_clock::time_point from,
+                                 std::chrono::steady_clock::time_point to) noexcept {
+    const auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(to - from).count();
+    return elapsed > 0 ? static_cast<std::uint64_t>(elapsed) : 0;
+}
+
+double smooth(double current, double sample, double weight) noexcept {
+    return current + weight * (sample - current);
+}
+
+// The scheduler whose refused handles this thread is resuming, if any.
+thread_local StreamScheduler* t_resumingRefused = nullptr;
+
+}  // namespace
+
+const char* streamClassName(StreamClass streamClass) noexcept {
+    return streamClass == StreamClass::Live ? "live" : "batch";
+}
+
+ScheduledStream::~ScheduledStream() {
+    m_scheduler.close(*this);
+}
+
+void ScheduledStream::wait(std::coroutine_handle<> handle) {
+    m_scheduler.enqueue(*this, handle);
+}
+
+void ScheduledStream::started() noexcept {
+    // Stamped on resumption, so the pool's FIFO counts as waiting, not as compute.
+    m_startedAt = Clock::now();
+    m_scheduler.state(m_class).wait->record(nanosecondsBetween(m_readyAt, m_startedAt));
+}
+
+void ScheduledStream::done(double audioSeconds) {
+    m_scheduler.finish(*this, audioSeconds);
+}
+
+StreamScheduler::StreamScheduler(AsyncScheduler& scheduler, const StreamSchedulerConfig& config)
+    : m_scheduler(scheduler), m_config(config) {
+    if (m_config.concurrency == 0) {
+        m_config.concurrency = std::max<std::size_t>(1, m_scheduler.workerCount());
+    }
+    m_config.quantumSeconds = std::max(m_config.quantumSeconds, MIN_QUANTUM_SECONDS);
+    m_config.degradeFactor = std::max(m_config.degradeFactor, 1.0);
+    m_config.costSmoothing = std::clamp(m_config.costSmoothing, 0.0, 1.0);
+
+    for (StreamClass streamClass : {StreamClass::Live, StreamClass::Batch}) {
+        ClassState& entry = state(streamClass);
+        const std::string name = streamClassName(streamClass);
+        entry.stats.cost = m_config.initialCost;
+        entry.latency = &m_metrics.histogram("tine_stream_step_latency_seconds_" + name,
+                                             "Detection step latency, ready to finished, " + name + " streams",
+                                             NANOSECONDS);
+        entry.wait = &m_metrics.histogram("tine_stream_step_wait_seconds_" + name,
+                                          "Time a ready detection step waited for a slot, " + name + " streams",
+                                          NANOSECONDS);
+        entry.rejected = &m_metrics.counter("tine_stream_rejected_total_" + name,
+                                            "Streams refused by admission control, " + name);
+    }
+    m_liveLoadGauge = &m_metrics.gauge("tine_stream_live_load", "Projected live demand as a share of concurrency");
+}
+
+StreamScheduler::~StreamScheduler() {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_idle.wait(lock, [this] { return m_dispatching == 0; });
+}
+
+StreamAdmission StreamScheduler::admit(StreamClass streamClass, double audioRate) {
+    StreamAdmission admission;
+    std::lock_guard<std::mutex> lock(m_mutex);
+    ClassState& entry = state(streamClass);
+    const auto concurrency = static_cast<double>(m_config.concurrency);
+
+    if (streamClass == StreamClass::Batch) {
+        admission.projectedLoad = liveDemand() / concurrency;
+        if (m_config.maxBatchStreams > 0 && entry.stats.openStreams >= m_config.maxBatchStreams) {
+            ++entry.stats.rejected;
+            entry.rejected->add();
+            return admission;
+        }
+        admission.verdict = AdmissionVerdict::Accepted;
+        admission.stream.reset(new ScheduledStream(*this, streamClass, 0.0, 1.0));
+        ++entry.stats.accepted;
+        ++entry.stats.openStreams;
+        return admission;
+    }
+
+    // A newcomer is charged the class's measured cost, scaled down if degraded.
+    const double rate = std::max(audioRate, 0.0);
+    const double current = liveDemand();
+    const double demand = rate * entry.stats.cost;
+    const double budget = m_config.liveCapacity * concurrency;
+    admission.projectedLoad = (current + demand) / concurrency;
+
+    double hopScale = 1.0;
+    if (current + demand <= budget) {
+        admission.verdict = AdmissionVerdict::Accepted;
+        ++entry.stats.accepted;
+    } else if (current + demand / m_config.degradeFactor <= budget) {
+        admission.verdict = AdmissionVerdict::Degraded;
+        hopScale = m_config.degradeFactor;
+        ++entry.stats.degraded;
+    } else {
+        ++entry.stats.rejected;
+        entry.rejected->add();
+        return admission;
+    }
+    admission.stream.reset(new ScheduledStream(*this, streamClass, rate, hopScale));
+    m_liveStreams.push_back(admission.stream.get());
+    ++entry.stats.openStreams;
+    m_liveLoadGauge->set(liveDemand() / concurrency);
+    return admission;
+}
+
+void StreamScheduler::enqueue(ScheduledStream& stream, std::coroutine_handle<> handle) {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        stream.m_handle = handle;
+        stream.m_readyAt = ScheduledStream::Clock::now();
+        // A stream idle for a while does not bank more than one quantum.
+        stream.m_deficit = std::min(stream.m_deficit, m_config.quantumSeconds);
+        Queue& queue = state(stream.m_class).waiting;
+        stream.m_next = nullptr;
+        if (!queue.head) {
+            queue.head = queue.tail = &stream;
+        } else if (stream.m_deficit > 0.0) {
+            // Still inside its quantum: continue before the others in its class.
+            stream.m_next = queue.head;
+            queue.head = &stream;
+        } else {
+            queue.tail->m_next = &stream;
+            queue.tail = &stream;
+        }
+    }
+    dispatch();
+}
+
+ScheduledStream* StreamScheduler::pick() noexcept {
+    for (ClassState* entry : {&m_live, &m_batch}) {
+        Queue& queue = entry->waiting;
+        // Deficit round robin: a stream whose deficit is spent gets a new quantum
+        // and goes to the back; every pass adds a quantum, so this terminates.
+        while (queue.head) {
+            ScheduledStream* stream = queue.head;
+            if (stream->m_deficit > 0.0) {
+                queue.head = stream->m_next;
+                if (!queue.head) {
+                    queue.tail = nullptr;
+                }
+                stream->m_next = nullptr;
+                return stream;
+            }
+            stream->m_deficit += m_config.quantumSeconds;
+            if (stream->m_next) {
+                queue.head = stream->m_next;
+                queue.tail->m_next = stream;
+                queue.tail = stream;
+                stream->m_next = nullptr;
+            }
+        }
+    }
+    return nullptr;
+}
+
+void StreamScheduler::dispatch() {
+    // Once a posted step runs, its stream may end and the owner destroy the
+    // scheduler while this call still walks the queues; hold the destructor off.
+    struct Pin {
+        StreamScheduler& scheduler;
+        explicit Pin(StreamScheduler& owner) : scheduler(owner) {
+            std::lock_guard<std::mutex> lock(scheduler.m_mutex);
+            ++scheduler.m_dispatching;
+        }
+        ~Pin() {
+            std::lock_guard<std::mutex> lock(scheduler.m_mutex);
+            if (--scheduler.m_dispatching == 0) {
+                scheduler.m_idle.notify_all();
+            }
+        }
+    } pin(*this);
+
+    for (;;) {
+        std::coroutine_handle<> handle;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (m_running >= m_config.concurrency) {
+                break;
+            }
+            ScheduledStream* stream = pick();
+            if (!stream) {
+                break;
+            }
+            ++m_running;
+            handle = std::exchange(stream->m_handle, nullptr);
+        }
+        // FIFO behind wake-ups from capture and I/O threads, so a live stream
+        // that just became ready reaches its turn() before the next batch step.
+        if (!m_scheduler.post(handle)) {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_refused.push_back(handle);
+        }
+    }
+
+    // The pool is shutting down. Run the refused steps here so they see their
+    // closed inputs and finish; a dispatch() from inside one only queues more.
+    if (t_resumingRefused == this) {
+        return;
+    }
+    StreamScheduler* const outer = std::exchange(t_resumingRefused, this);
+    for (;;) {
+        std::coroutine_handle<> handle;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (m_refused.empty()) {
+                break;
+            }
+            handle = m_refused.back();
+            m_refused.pop_back();
+        }
+        handle.resume();
+    }
+    t_resumingRefused = outer;
+}
+
+void StreamScheduler::finish(ScheduledStream& stream, double audioSeconds) {
+    const auto now = ScheduledStream::Clock::now();
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_running -= m_running > 0 ? 1 : 0;
+        ClassState& entry = state(stream.m_class);
+        entry.latency->record(nanosecondsBetween(stream.m_readyAt, now));
+
+        const double compute = std::chrono::duration<double>(now - stream.m_startedAt).count();
+        audioSeconds = std::max(audioSeconds, 0.0);
+        stream.m_deficit -= audioSeconds;
+        ++entry.stats.steps;
+        entry.stats.audioSeconds += audioSeconds;
+        entry.stats.computeSeconds += compute;
+        if (audioSeconds > 0.0) {
+            const double cost = compute / audioSeconds;
+            stream.m_cost = stream.m_cost < 0.0 ? cost : smooth(stream.m_cost, cost, m_config.costSmoothing);
+            entry.stats.cost = entry.measured ? smooth(entry.stats.cost, cost, m_config.costSmoothing) : cost;
+            entry.measured = true;
+        }
+        if (stream.m_class == StreamClass::Live) {
+            m_liveLoadGauge->set(liveDemand() / static_cast<double>(m_config.concurrency));
+        }
+    }
+    dispatch();
+}
+
+void StreamScheduler::close(ScheduledStream& stream) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    ClassState& entry = state(stream.m_class);
+    entry.stats.openStreams -= entry.stats.openStreams > 0 ? 1 : 0;
+    if (stream.m_class == StreamClass::Live) {
+        m_liveStreams.erase(std::remove(m_liveStreams.begin(), m_liveStreams.end(), &stream), m_liveStreams.end());
+        m_liveLoadGauge->set(liveDemand() / static_cast<double>(m_config.concurrency));
+    }
+}
+
+double StreamScheduler::demandOf(const ScheduledStream& stream) const noexcept {
+    // Until its own steps are measured, a degraded stream is assumed to achieve
+    // the reduction it was admitted under.
+    const double cost = stream.m_cost >= 0.0 ? stream.m_cost : m_live.stats.cost / stream.m_hopScale;
+    return stream.m_audioRate * cost;
+}
+
+double StreamScheduler::liveDemand() const noexcept {
+    double total = 0.0;
+    for (const ScheduledStream* stream : m_liveStreams) {
+        total += demandOf(*stream);
+    }
+    return total;
+}
+
+StreamSchedulerStats StreamScheduler::stats() const {
+    StreamSchedulerStats result;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        result.live = m_live.stats;
+        result.batch = m_batch.stats;
+        result.concurrency = m_config.concurrency;
+        result.liveLoad = liveDemand() / static_cast<double>(m_config.concurrency);
+    }
+    const std::vector<double> quantiles{0.5, 0.99};
+    for (auto [entry, out] : {std::pair{&m_live, &result.live}, std::pair{&m_batch, &result.batch}}) {
+        const MetricHistogram::Summary latency = entry->latency->summarize(quantiles);
+        const MetricHistogram::Summary wait = entry->wait->summarize(quantiles);
+        out->latencyP50 = static_cast<double>(latency.quantiles[0].second) * NANOSECONDS;
+        out->latencyP99 = static_cast<double>(latency.quantiles[1].second) * NANOSECONDS;
+        out->latencyMax = static_cast<double>(latency.max) * NANOSECONDS;
+        out->waitP99 = static_cast<double>(wait.quantiles[1].second) * NANOSECONDS;
+    }
+    return result;
+}
+
+}  // namespace tine::dsp
@@ -0,0 +1,309 @@
+#ifndef TINE_NATIVE_ASYNC_STREAMSCHEDULER_HPP
+#define TINE_NATIVE_ASYNC_STREAMSCHEDULER_HPP
+
+#include <chrono>
+#include <condition_variable>
+#include <coroutine>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "AsyncScheduler.hpp"
+#include "Metrics.hpp"
+
+namespace tine::dsp {
+
+enum class StreamClass : std::uint8_t {
+    /** Fed in real time (capture, sockets); has a latency target. */
+    Live,
+    /** Files and uploads; wants throughput and takes what live streams leave. */
+    Batch,
+};
+
+[[nodiscard]] const char* streamClassName(StreamClass streamClass) noexcept;
+
+enum class AdmissionVerdict : std::uint8_t {
+    Accepted,
+    /** Admitted at a cost cut by hopScale: the analysis runs with a hop that many times longer. */
+    Degraded,
+    Rejected,
+};
+
+struct StreamSchedulerConfig {
+    /** Detection steps running at once; 0 means the scheduler's worker count. */
+    std::size_t concurrency{0};
+    /**
+     * Deficit-round-robin quantum: audio seconds a stream analyzes per turn
+     * before the next waiting stream of its class goes.
+     */
+    double quantumSeconds{0.25};
+    /** Share of concurrency live streams are projected to use at most; admission keeps them under it. */
+    double liveCapacity{0.75};
+    /** Cost reduction offered to a live stream that does not fit as requested. */
+    double degradeFactor{2.0};
+    /** Open batch streams; further ones are rejected until one closes. 0 means no limit. */
+    std::size_t maxBatchStreams{64};
+    /** Compute seconds per audio second assumed until a step of the class has been measured. */
+    double initialCost{0.02};
+    /** Weight of each new step in the smoothed cost estimates. */
+    double costSmoothing{0.1};
+};
+
+/** Counters for one class. Latencies are per detection step, in seconds. */
+struct StreamClassStats {
+    std::uint64_t openStreams{0};
+    std::uint64_t accepted{0};
+    std::uint64_t degraded{0};
+    std::uint64_t rejected{0};
+    std::uint64_t steps{0};
+    double audioSeconds{0.0};
+    double computeSeconds{0.0};
+    /** Smoothed compute seconds per audio second. */
+    double cost{0.0};
+    /** From the step being ready to it finishing: queue wait plus detection. */
+    double latencyP50{0.0};
+    double latencyP99{0.0};
+    double latencyMax{0.0};
+    double waitP99{0.0};
+};
+
+struct StreamSchedulerStats {
+    StreamClassStats live;
+    StreamClassStats batch;
+    /** Projected live demand as a share of concurrency. */
+    double liveLoad{0.0};
+    std::size_t concurrency{0};
+};
+
+class StreamScheduler;
+
+/**
+ * A stream's place in a StreamScheduler. Analysis loops bracket each detection
+ * step with co_await turn() and done(), normally through a ScheduledStep;
+ * everything else (reads, ring waits) happens outside the bracket and holds no
+ * slot. Closing (destroying) the handle releases the stream's share of
+ * admitted load; it must not be waiting.
+ */
+class ScheduledStream {
+public:
+    ~ScheduledStream();
+
+    ScheduledStream(const ScheduledStream&) = delete;
+    ScheduledStream& operator=(const ScheduledStream&) = delete;
+
+    /** Awaitable that resumes the caller on a pool worker once the stream is granted a slot. */
+    [[nodiscard]] auto turn() noexcept {
+        struct Awaiter {
+            ScheduledStream& stream;
+            bool await_ready() const noexcept { return false; }
+            void await_suspend(std::coroutine_handle<> handle) { stream.wait(handle); }
+            void await_resume() const noexcept { stream.started(); }
+        };
+        return Awaiter{*this};
+    }
+
+    /** End the step begun by turn(): release the slot and charge @p audioSeconds analyzed. */
+    void done(double audioSeconds);
+
+    [[nodiscard]] StreamClass streamClass() const noexcept { return m_class; }
+    /**
+     * 1, or the degradeFactor the stream was admitted under. analyzeStream(),
+     * analyzeRing() and analyzeStreamCached() run at a hop this many times longer.
+     */
+    [[nodiscard]] double hopScale() const noexcept { return m_hopScale; }
+
+private:
+    friend class StreamScheduler;
+    friend class ScheduledStep;
+    using Clock = std::chrono::steady_clock;
+
+    ScheduledStream(StreamScheduler& scheduler, StreamClass streamClass, double audioRate, double hopScale) noexcept
+        : m_scheduler(scheduler), m_class(streamClass), m_audioRate(audioRate), m_hopScale(hopScale) {}
+
+    void wait(std::coroutine_handle<> handle);
+    /** On the worker that resumed the step: the slot is in use from here, not from dispatch. */
+    void started() noexcept;
+
+    StreamScheduler& m_scheduler;
+    const StreamClass m_class;
+    const double m_audioRate;
+    const double m_hopScale;
+
+    // Guarded by the scheduler's mutex.
+    double m_deficit{0.0};
+    /** Smoothed compute seconds per audio second; negative until measured. */
+    double m_cost{-1.0};
+    std::coroutine_handle<> m_handle;
+    ScheduledStream* m_next{nullptr};
+    Clock::time_point m_readyAt;
+    /** Written by the running step itself, read back by its done(). */
+    Clock::time_point m_startedAt;
+};
+
+/**
+ * One detection step of an analysis loop. co_await begin() waits for the
+ * stream's turn, or yields to the scheduler when there is no stream. The
+ * destructor ends the step with the audio charged so far, so a step that
+ * throws (a sink, say) still hands its slot on.
+ */
+class ScheduledStep {
+public:
+    /** @param stream May be null: begin() is then a plain yield and nothing is charged. */
+    ScheduledStep(AsyncScheduler& scheduler, ScheduledStream* stream) noexcept
+        : m_scheduler(scheduler), m_stream(stream) {}
+
+    ~ScheduledStep() {
+        if (m_stream && m_started) {
+            m_stream->done(m_audioSeconds);
+        }
+    }
+
+    ScheduledStep(const ScheduledStep&) = delete;
+    ScheduledStep& operator=(const ScheduledStep&) = delete;
+
+    [[nodiscard]] auto begin() noexcept {
+        struct Awaiter {
+            ScheduledStep& step;
+            bool await_ready() const noexcept { return false; }
+            bool await_suspend(std::coroutine_handle<> handle) {
+                if (!step.m_stream) {
+                    return step.m_scheduler.trySchedule(handle);
+                }
+                step.m_stream->wait(handle);
+                return true;
+            }
+            void await_resume() const noexcept {
+                if (step.m_stream) {
+                    step.m_stream->started();
+                }
+                step.m_started = true;
+            }
+        };
+        return Awaiter{*this};
+    }
+
+    /** Add @p audioSeconds to what the step is charged when it ends. */
+    void charge(double audioSeconds) noexcept { m_audioSeconds += audioSeconds; }
+
+private:
+    AsyncScheduler& m_scheduler;
+    ScheduledStream* m_stream;
+    double m_audioSeconds{0.0};
+    bool m_started{false};
+};
+
+struct StreamAdmission {
+    AdmissionVerdict verdict{AdmissionVerdict::Rejected};
+    /** Null when rejected. */
+    std::unique_ptr<ScheduledStream> stream;
+    /** Live demand as a share of concurrency had the stream been admitted as requested. */
+    double projectedLoad{0.0};
+};
+
+/**
+ * Fair scheduling and admission control for the multi-stream analyzer.
+ *
+ * Detection steps of admitted streams run at most `concurrency` at a time on
+ * the AsyncScheduler's pool. When a slot frees, live streams go before batch
+ * streams; within a class, waiting streams take turns by deficit round robin
+ * over audio seconds analyzed, so a stream with long steps (large batches,
+ * long windows) gets no more audio through per round than one with short
+ * steps.
+ *
+ * Each step is timed. The smoothed compute cost per audio second, times the
+ * rate a live stream delivers audio (1 for real time), is its projected share
+ * of a worker; admit() accepts a live stream while the total stays under
+ * liveCapacity of concurrency, offers it a cheaper configuration when only
+ * that would fit, and rejects it otherwise. What live streams leave is batch
+ * capacity, so batch streams are only limited in number. Per-class step
+ * latency and queue wait are recorded in histograms exported through
+ * metrics().
+ *
+ * Thread-safe. Picking the next stream takes a mutex held for a few pointer
+ * moves; steps are resumed outside it.
+ */
+class StreamScheduler {
+public:
+    explicit StreamScheduler(AsyncScheduler& scheduler, const StreamSchedulerConfig& config = {});
+    /** Waits for dispatch() calls still running on workers; every stream must be closed. */
+    ~StreamScheduler();
+
+    StreamScheduler(const StreamScheduler&) = delete;
+    StreamScheduler& operator=(const StreamScheduler&) = delete;
+
+    /**
+     * Register a stream.
+     * @param audioRate Audio seconds a live stream delivers per wall second (1 in
+     *        real time, 0 to skip its load accounting). Ignored for batch streams.
+     */
+    [[nodiscard]] StreamAdmission admit(StreamClass streamClass, double audioRate = 1.0);
+
+    [[nodiscard]] StreamSchedulerStats stats() const;
+
+    /** Latency and wait histograms plus admission counters, for Prometheus export. */
+    [[nodiscard]] const MetricsRegistry& metrics() const noexcept { return m_metrics; }
+
+    [[nodiscard]] const StreamSchedulerConfig& config() const noexcept { return m_config; }
+
+private:
+    friend class ScheduledStream;
+
+    struct Queue {
+        ScheduledStream* head{nullptr};
+        ScheduledStream* tail{nullptr};
+    };
+
+    struct ClassState {
+        Queue waiting;
+        /** Counters and smoothed cost; the latency fields are filled in by stats(). */
+        StreamClassStats stats;
+        bool measured{false};
+        MetricHistogram* latency{nullptr};
+        MetricHistogram* wait{nullptr};
+        MetricCounter* rejected{nullptr};
+    };
+
+    void enqueue(ScheduledStream& stream, std::coroutine_handle<> handle);
+    void finish(ScheduledStream& stream, double audioSeconds);
+    void close(ScheduledStream& stream);
+    /**
+     * Post waiting streams to the pool while slots are free. Handles the pool
+     * refuses (shutdown) are resumed here, one at a time by the outermost call on
+     * the thread, so steps that end and begin inside them never nest.
+     */
+    void dispatch();
+    /** Under the lock: the next stream to run, or null. */
+    ScheduledStream* pick() noexcept;
+    /** Under the lock: projected workers a live stream keeps busy. */
+    [[nodiscard]] double demandOf(const ScheduledStream& stream) const noexcept;
+    [[nodiscard]] double liveDemand() const noexcept;
+
+    ClassState& state(StreamClass streamClass) noexcept {
+        return streamClass == StreamClass::Live ? m_live : m_batch;
+    }
+
+    AsyncScheduler& m_scheduler;
+    StreamSchedulerConfig m_config;
+    MetricsRegistry m_metrics;
+    MetricGauge* m_liveLoadGauge{nullptr};
+
+    mutable std::mutex m_mutex;
+    ClassState m_live;
+    ClassState m_batch;
+    std::size_t m_running{0};
+    std::vector<ScheduledStream*> m_liveStreams;
+    /** Picked steps the pool refused, waiting for the outermost dispatch() to resume them. */
+    std::vector<std::coroutine_handle<>> m_refused;
+    /**
+     * dispatch() calls in progress. A step posted by one can finish its stream
+     * before the call returns, so the destructor waits for this to drain.
+     */
+    std::size_t m_dispatching{0};
+    std::condition_variable m_idle;
+};
+
+}  // namespace tine::dsp
+
+#endif  // TINE_NATIVE_ASYNC_STREAMSCHEDULER_HPP
@@ -0,0 +1,223 @@
+#include "ThreadConfig.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <cmath>
+#include <cstdio>
+
+#include <pthread.h>
+#include <sched.h>
+
+#if defined(__APPLE__)
+#include <mach/mach.h>
+#include <mach/mach_time.h>
+#include <mach/thread_policy.h>
+#endif
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64)
+#include <xmmintrin.h>
+#define TINE_FP_SSE 1
+#elif defined(__aarch64__)
+#define TINE_FP_AARCH64 1
+#elif defined(__arm__)
+#define TINE_FP_ARM32 1
+#endif
+
+namespace tine::dsp {
+
+namespace {
+
+#if defined(TINE_FP_SSE)
+constexpr std::uint64_t kFlushBits = 0x8040;  // MXCSR FTZ (bit 15) | DAZ (bit 6)
+#elif defined(TINE_FP_AARCH64) || defined(TINE_FP_ARM32)
+constexpr std::uint64_t kFlushBits = 1ULL << 24;  // FPCR / FPSCR FZ
+#else
+constexpr std::uint64_t kFlushBits = 0;
+#endif
+
+std::uint64_t readFpControl() noexcept {
+#if defined(TINE_FP_SSE)
+    return _mm_getcsr();
+#elif defined(TINE_FP_AARCH64)
+    std::uint64_t value = 0;
+    asm volatile("mrs %0, fpcr" : "=r"(value));
+    return value;
+#elif defined(TINE_FP_ARM32)
+    std::uint32_t value = 0;
+    asm volatile("vmrs %0, fpscr" : "=r"(value));
+    return value;
+#else
+    return 0;
+#endif
+}
+
+void writeFpControl(std::uint64_t value) noexcept {
+#if defined(TINE_FP_SSE)
+    _mm_setcsr(static_cast<unsigned int>(value));
+#elif defined(TINE_FP_AARCH64)
+    asm volatile("msr fpcr, %0" : : "r"(value));
+#elif defined(TINE_FP_ARM32)
+    const auto narrow = static_cast<std::uint32_t>(value);
+    asm volatile("vmsr fpscr, %0" : : "r"(narrow));
+#else
+    (void)value;
+#endif
+}
+
+bool flushDenormals() noexcept {
+    if (kFlushBits == 0) {
+        return false;
+    }
+    writeFpControl(readFpControl() | kFlushBits);
+    return denormalsFlushedOnCurrentThread();
+}
+
+int applyPosixPolicy(int policy, double relativePriority, int& appliedPriority) {
+    const int minPriority = sched_get_priority_min(policy);
+    const int maxPriority = sched_get_priority_max(policy);
+    const double clamped = std::min(std::max(relativePriority, 0.0), 1.0);
+
+    sched_param param{};
+    param.sched_priority = minPriority + static_cast<int>(std::lround(clamped * (maxPriority - minPriority)));
+    const int result = pthread_setschedparam(pthread_self(), policy, &param);
+    if (result == 0) {
+        appliedPriority = param.sched_priority;
+    }
+    return result;
+}
+
+#if defined(__APPLE__)
+int applyTimeConstraint(const ThreadConfigRequest& request) {
+    mach_timebase_info_data_t timebase{};
+    mach_timebase_info(&timebase);
+    const double ticksPerSecond = 1e9 * static_cast<double>(timebase.denom) / static_cast<double>(timebase.numer);
+
+    const double period = request.periodSeconds > 0.0 ? request.periodSeconds : 0.005;
+    const double computation = request.computationSeconds > 0.0 ? request.computationSeconds : period * 0.5;
+    const double constraint = request.constraintSeconds > 0.0 ? request.constraintSeconds : period;
+
+    thread_time_constraint_policy_data_t policy{};
+    policy.period = static_cast<uint32_t>(period * ticksPerSecond);
+    policy.computation = static_cast<uint32_t>(computation * ticksPerSecond);
+    policy.constraint = static_cast<uint32_t>(constraint * ticksPerSecond);
+    policy.preemptible = TRUE;
+
+    // pthread_mach_thread_np() borrows the thread's port; mach_thread_self() would
+    // add a send right on every call that nothing releases.
+    return thread_policy_set(pthread_mach_thread_np(pthread_self()), THREAD_TIME_CONSTRAINT_POLICY,
+                             reinterpret_cast<thread_policy_t>(&policy), THREAD_TIME_CONSTRAINT_POLICY_COUNT);
+}
+#endif
+
+int applyAffinity(int cpu) {
+#if defined(__linux__)
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    return pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+#elif defined(__APPLE__)
+    // Apple exposes only affinity tags: threads sharing a tag are kept on a shared L2.
+    thread_affinity_policy_data_t policy{cpu + 1};
+    return thread_policy_set(pthread_mach_thread_np(pthread_self()), THREAD_AFFINITY_POLICY,
+                             reinterpret_cast<thread_policy_t>(&policy), THREAD_AFFINITY_POLICY_COUNT);
+#else
+    (void)cpu;
+    return ENOTSUP;
+#endif
+}
+
+}  // namespace
+
+AppliedThreadConfig configureCurrentThread(const ThreadConfigRequest& request) {
+    AppliedThreadConfig applied;
+
+    auto noteError = [&applied](int code) {
+        if (code != 0 && applied.error == 0) {
+            applied.error = code;
+        }
+    };
+
+    switch (request.policy) {
+        case ThreadPolicy::Default:
+            break;
+        case ThreadPolicy::RoundRobin:
+        case ThreadPolicy::Fifo: {
+            const int policy = request.policy == ThreadPolicy::Fifo ? SCHED_FIFO : SCHED_RR;
+            const int result = applyPosixPolicy(policy, request.priority, applied.priority);
+            noteError(result);
+            if (result == 0) {
+                applied.policy = request.policy;
+            }
+            break;
+        }
+        case ThreadPolicy::TimeConstraint: {
+#if defined(__APPLE__)
+            const int result = applyTimeConstraint(request);
+            noteError(result);
+            if (result == 0) {
+                applied.policy = ThreadPolicy::TimeConstraint;
+            }
+#else
+            const int result = applyPosixPolicy(SCHED_FIFO, request.priority, applied.priority);
+            noteError(result);
+            if (result == 0) {
+                applied.policy = ThreadPolicy::Fifo;
+            }
+#endif
+            break;
+        }
+    }
+
+    if (request.cpu >= 0) {
+        const int result = applyAffinity(request.cpu);
+        noteError(result);
+        if (result == 0) {
+            applied.cpu = request.cpu;
+        }
+    }
+
+    if (request.flushDenormals) {
+        applied.denormalsFlushed = flushDenormals();
+    }
+
+    return applied;
+}
+
+bool denormalsFlushedOnCurrentThread() noexcept {
+    return kFlushBits != 0 && (readFpControl() & kFlushBits) == kFlushBits;
+}
+
+ScopedDenormalFlush::ScopedDenormalFlush() noexcept : m_saved(readFpControl()) {
+    if (kFlushBits != 0) {
+        writeFpControl(m_saved | kFlushBits);
+    }
+}
+
+ScopedDenormalFlush::~ScopedDenormalFlush() {
+    if (kFlushBits != 0) {
+        writeFpControl(m_saved);
+    }
+}
+
+std::string AppliedThreadConfig::describe() const {
+    char line[128];
+    std::snprintf(line, sizeof(line), "policy=%s priority=%d cpu=%d ftz=%s error=%d", threadPolicyName(policy),
+                  priority, cpu, denormalsFlushed ? "on" : "off", error);
+    return line;
+}
+
+const char* threadPolicyName(ThreadPolicy policy) noexcept {
+    switch (policy) {
+        case ThreadPolicy::Default:
+            return "default";
+        case ThreadPolicy::RoundRobin:
+            return "rr";
+        case ThreadPolicy::Fifo:
+            return "fifo";
+        case ThreadPolicy::TimeConstraint:
+            return "time-constraint";
+    }
+    return "unknown";
+}
+
+}  // namespace tine::dsp
@@ -0,0 +1,84 @@
+#ifndef TINE_NATIVE_UTIL_THREADCONFIG_HPP
+#define TINE_NATIVE_UTIL_THREADCONFIG_HPP
+
+#include <cstdint>
+#include <string>
+
+namespace tine::dsp {
+
+enum class ThreadPolicy {
+    /** Leave the scheduler policy untouched. */
+    Default,
+    /** POSIX SCHED_RR. */
+    RoundRobin,
+    /** POSIX SCHED_FIFO. */
+    Fifo,
+    /** Mach THREAD_TIME_CONSTRAINT_POLICY on Apple platforms; SCHED_FIFO elsewhere. */
+    TimeConstraint,
+};
+
+/**
+ * Requested scheduling setup for an engine worker thread. Every field is a request;
+ * the platform may refuse any part of it (e.g. unprivileged Linux processes).
+ */
+struct ThreadConfigRequest {
+    ThreadPolicy policy{ThreadPolicy::Default};
+    /** Relative priority in [0, 1] mapped onto the policy's priority range. */
+    double priority{0.5};
+    /** Time-constraint parameters (seconds). Ignored by the POSIX policies. */
+    double periodSeconds{0.0};
+    double computationSeconds{0.0};
+    double constraintSeconds{0.0};
+    /** Core index to pin to, or -1 for no affinity. Apple treats this as an affinity tag hint. */
+    int cpu{-1};
+    /** Enable flush-to-zero / denormals-are-zero in this thread's FP environment. */
+    bool flushDenormals{true};
+};
+
+/**
+ * What actually took effect after configureCurrentThread().
+ */
+struct AppliedThreadConfig {
+    ThreadPolicy policy{ThreadPolicy::Default};
+    int priority{0};
+    int cpu{-1};
+    bool denormalsFlushed{false};
+    /** errno / kern_return_t from the first refused request, 0 when everything applied. */
+    int error{0};
+
+    /** Compact single-line description for logs and telemetry. */
+    [[nodiscard]] std::string describe() const;
+};
+
+/**
+ * Apply @p request to the calling thread. Never fails hard: refused parts are
+ * reported in the returned AppliedThreadConfig.
+ */
+AppliedThreadConfig configureCurrentThread(const ThreadConfigRequest& request);
+
+/**
+ * @return True when FTZ/DAZ (or the platform equivalent) is enabled on this thread.
+ */
+bool denormalsFlushedOnCurrentThread() noexcept;
+
+/**
+ * Enables FTZ/DAZ for the current scope and restores the previous FP control state
+ * on exit. Intended for work borrowed from shared threads such as dispatch queues.
+ */
+class ScopedDenormalFlush {
+public:
+    ScopedDenormalFlush() noexcept;
+    ~ScopedDenormalFlush();
+
+    ScopedDenormalFlush(const ScopedDenormalFlush&) = delete;
+    ScopedDenormalFlush& operator=(const ScopedDenormalFlush&) = delete;
+
+private:
+    std::uint64_t m_saved;
+};
+
+const char* threadPolicyName(ThreadPolicy policy) noexcept;
+
+}  // namespace tine::dsp
+
+#endif  // TINE_NATIVE_UTIL_THREADCONFIG_HPP
@@ -0,0 +1,284 @@
+#include "ThreadPool.hpp"
+
+namespace tine::dsp {
+
+namespace {
+
+// Coroutine frames are at least pointer aligned, so the low bit tags a handle
+// address apart from a PoolTask pointer inside a single deque word.
+constexpr std::uintptr_t kCoroutineTag = 1;
+// Every this many takes a worker serves the shared queue before its own deque.
+constexpr std::uint32_t kInjectedPollInterval = 16;
+
+thread_local const void* tPool = nullptr;
+thread_local TaskPriority tPriority = TaskPriority::Normal;
+thread_local std::size_t tWorkerIndex = 0;
+
+std::size_t roundUpPowerOfTwo(std::size_t value) {
+    std::size_t v = 1;
+    while (v < value) {
+        v <<= 1;
+    }
+    return v;
+}
+
+}  // namespace
+
+WorkStealingDeque::WorkStealingDeque(std::size_t capacity)
+    : m_mask(static_cast<std::int64_t>(roundUpPowerOfTwo(capacity < 2 ? 2 : capacity)) - 1),
+      m_slots(new std::atomic<std::uintptr_t>[static_cast<std::size_t>(m_mask + 1)]) {
+    for (std::int64_t i = 0; i <= m_mask; ++i) {
+        m_slots[static_cast<std::size_t>(i)].store(0, std::memory_order_relaxed);
+    }
+}
+
+bool WorkStealingDeque::push(std::uintptr_t item) noexcept {
+    const std::int64_t bottom = m_bottom.load(std::memory_order_relaxed);
+    const std::int64_t top = m_top.load(std::memory_order_acquire);
+    if (bottom - top > m_mask) {
+        return false;
+    }
+    m_slots[static_cast<std::size_t>(bottom & m_mask)].store(item, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    m_bottom.store(bottom + 1, std::memory_order_relaxed);
+    return true;
+}
+
+std::uintptr_t WorkStealingDeque::pop() noexcept {
+    const std::int64_t bottom = m_bottom.load(std::memory_order_relaxed) - 1;
+    m_bottom.store(bottom, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    std::int64_t top = m_top.load(std::memory_order_relaxed);
+
+    if (top > bottom) {
+        m_bottom.store(bottom + 1, std::memory_order_relaxed);
+        return 0;
+    }
+
+    std::uintptr_t item = m_slots[static_cast<std::size_t>(bottom & m_mask)].load(std::memory_order_relaxed);
+    if (top == bottom) {
+        // Last element: race against thieves for it.
+        if (!m_top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+            item = 0;
+        }
+        m_bottom.store(bottom + 1, std::memory_order_relaxed);
+    }
+    return item;
+}
+
+std::uintptr_t WorkStealingDeque::steal() noexcept {
+    std::int64_t top = m_top.load(std::memory_order_acquire);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    const std::int64_t bottom = m_bottom.load(std::memory_order_acquire);
+    if (top >= bottom) {
+        return 0;
+    }
+
+    const std::uintptr_t item = m_slots[static_cast<std::size_t>(top & m_mask)].load(std::memory_order_relaxed);
+    if (!m_top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+        return 0;
+    }
+    return item;
+}
+
+ThreadPool::ThreadPool(const ThreadPoolConfig& config) : m_config(config) {
+    std::size_t normalWorkers = config.normalWorkers;
+    if (normalWorkers == 0) {
+        const std::size_t cores = std::thread::hardware_concurrency();
+        normalWorkers = cores > config.realtimeWorkers ? cores - config.realtimeWorkers : 1;
+    }
+
+    for (std::size_t i = 0; i < normalWorkers; ++i) {
+        m_normal.workers.push_back(std::make_unique<Worker>(config.dequeCapacity));
+    }
+    for (std::size_t i = 0; i < config.realtimeWorkers; ++i) {
+        m_realtime.workers.push_back(std::make_unique<Worker>(config.dequeCapacity));
+    }
+
+    // Realtime workers take the lowest core indices so pinning keeps them apart
+    // from the bulk of the normal group.
+    std::size_t globalIndex = 0;
+    for (std::size_t i = 0; i < m_realtime.workers.size(); ++i, ++globalIndex) {
+        m_realtime.workers[i]->thread =
+            std::thread([this, i, globalIndex] { run(TaskPriority::Realtime, i, globalIndex); });
+    }
+    for (std::size_t i = 0; i < m_normal.workers.size(); ++i, ++globalIndex) {
+        m_normal.workers[i]->thread =
+            std::thread([this, i, globalIndex] { run(TaskPriority::Normal, i, globalIndex); });
+    }
+
+    // Wait for every worker to apply its thread configuration so appliedConfig()
+    // is stable as soon as the pool is constructed.
+    const std::size_t total = m_normal.workers.size() + m_realtime.workers.size();
+    std::unique_lock<std::mutex> lock(m_startupMutex);
+    m_startupCondition.wait(lock, [this, total] { return m_configuredWorkers == total; });
+}
+
+ThreadPool::~ThreadPool() {
+    shutdown();
+}
+
+ThreadPool& ThreadPool::shared() {
+    static ThreadPool pool;
+    return pool;
+}
+
+bool ThreadPool::submit(PoolTask* task, TaskPriority priority) {
+    if (!task || !task->invoke) {
+        return false;
+    }
+    return enqueue(reinterpret_cast<std::uintptr_t>(task), priority);
+}
+
+bool ThreadPool::submit(std::coroutine_handle<> handle, TaskPriority priority) {
+    if (!handle) {
+        return false;
+    }
+    return enqueue(reinterpret_cast<std::uintptr_t>(handle.address()) | kCoroutineTag, priority);
+}
+
+bool ThreadPool::post(std::coroutine_handle<> handle, TaskPriority priority) {
+    if (!handle) {
+        return false;
+    }
+    return enqueue(reinterpret_cast<std::uintptr_t>(handle.address()) | kCoroutineTag, priority, true);
+}
+
+bool ThreadPool::enqueue(std::uintptr_t item, TaskPriority priority, bool shared) {
+    const bool onOwnWorker = tPool == this;
+    // During shutdown, work spawned by tasks that were already accepted is still run,
+    // but only within the spawning worker's group: the groups are joined one after
+    // the other, so an item pushed across into a group already joined would leak.
+    if (m_stopping.load(std::memory_order_acquire) && !(onOwnWorker && tPriority == priority)) {
+        return false;
+    }
+
+    Group& target = group(priority);
+    if (target.workers.empty()) {
+        return false;
+    }
+
+    // Count before publishing so a thief can never decrement below zero.
+    target.pending.fetch_add(1, std::memory_order_seq_cst);
+
+    bool queued = false;
+    if (onOwnWorker && tPriority == priority && !shared) {
+        queued = target.workers[tWorkerIndex]->deque.push(item);
+    }
+    if (!queued) {
+        std::lock_guard<std::mutex> lock(target.injectMutex);
+        target.injected.push_back(item);
+    }
+
+    if (target.sleepers.load(std::memory_order_seq_cst) > 0) {
+        std::lock_guard<std::mutex> lock(target.sleepMutex);
+        target.sleepCondition.notify_one();
+    }
+    return true;
+}
+
+bool ThreadPool::take(Group& source, std::size_t index, std::uintptr_t& item) {
+    Worker& own = *source.workers[index];
+    // A coroutine that keeps yielding lands on top of its own worker's deque
+    // again; polling the shared queue first now and then keeps it from starving
+    // work submitted from other threads.
+    const bool sharedFirst = ++own.takes % kInjectedPollInterval == 0;
+    item = sharedFirst ? 0 : own.deque.pop();
+
+    if (item == 0) {
+        std::lock_guard<std::mutex> lock(source.injectMutex);
+        if (!source.injected.empty()) {
+            item = source.injected.front();
+            source.injected.pop_front();
+        }
+    }
+    if (item == 0 && sharedFirst) {
+        item = own.deque.pop();
+    }
+
+    const std::size_t count = source.workers.size();
+    for (std::size_t offset = 1; item == 0 && offset < count; ++offset) {
+        item = source.workers[(index + offset) % count]->deque.steal();
+    }
+
+    if (item == 0) {
+        return false;
+    }
+    source.pending.fetch_sub(1, std::memory_order_acq_rel);
+    return true;
+}
+
+void ThreadPool::execute(std::uintptr_t item) {
+    if (item & kCoroutineTag) {
+        std::coroutine_handle<>::from_address(reinterpret_cast<void*>(item & ~kCoroutineTag)).resume();
+        return;
+    }
+    auto* task = reinterpret_cast<PoolTask*>(item);
+    task->invoke(task);
+}
+
+void ThreadPool::run(TaskPriority priority, std::size_t index, std::size_t globalIndex) {
+    tPool = this;
+    tPriority = priority;
+    tWorkerIndex = index;
+
+    Group& own = group(priority);
+    ThreadConfigRequest request =
+        priority == TaskPriority::Realtime ? m_config.realtimeThread : m_config.normalThread;
+    if (m_config.pinWorkers) {
+        const unsigned cores = std::thread::hardware_concurrency();
+        request.cpu = cores > 0 ? static_cast<int>(globalIndex % cores) : -1;
+    }
+    const AppliedThreadConfig applied = configureCurrentThread(request);
+    {
+        std::lock_guard<std::mutex> lock(m_startupMutex);
+        own.workers[index]->applied = applied;
+        ++m_configuredWorkers;
+    }
+    m_startupCondition.notify_all();
+
+    for (;;) {
+        std::uintptr_t item = 0;
+        if (take(own, index, item)) {
+            execute(item);
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(own.sleepMutex);
+        own.sleepers.fetch_add(1, std::memory_order_seq_cst);
+        own.sleepCondition.wait(lock, [this, &own] {
+            return own.pending.load(std::memory_order_seq_cst) > 0 ||
+                   m_stopping.load(std::memory_order_acquire);
+        });
+        own.sleepers.fetch_sub(1, std::memory_order_relaxed);
+
+        if (m_stopping.load(std::memory_order_acquire) && own.pending.load(std::memory_order_acquire) == 0) {
+            break;
+        }
+    }
+
+    tPool = nullptr;
+}
+
+void ThreadPool::shutdown() {
+    if (m_stopping.exchange(true)) {
+        return;
+    }
+
+    for (Group* g : {&m_normal, &m_realtime}) {
+        {
+            std::lock_guard<std::mutex> lock(g->sleepMutex);
+        }
+        g->sleepCondition.notify_all();
+    }
+
+    for (Group* g : {&m_realtime, &m_normal}) {
+        for (auto& worker : g->workers) {
+            if (worker->thread.joinable()) {
+                worker->thread.join();
+            }
+        }
+    }
+}
+
+}  // namespace tine::dsp
@@ -0,0 +1,168 @@
+#ifndef TINE_NATIVE_UTIL_THREADPOOL_HPP
+#define TINE_NATIVE_UTIL_THREADPOOL_HPP
+
+#include <atomic>
+#include <condition_variable>
+#include <coroutine>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "ThreadConfig.hpp"
+
+namespace tine::dsp {
+
+/**
+ * Intrusive unit of work. The submitter owns the node and must keep it alive
+ * until @p invoke has been called, which keeps submission allocation-free.
+ */
+struct PoolTask {
+    void (*invoke)(PoolTask* self){nullptr};
+};
+
+enum class TaskPriority {
+    Normal,
+    Realtime,
+};
+
+struct ThreadPoolConfig {
+    /** Workers serving Normal tasks. Zero selects hardware concurrency minus the realtime workers. */
+    std::size_t normalWorkers{0};
+    /** Workers serving Realtime tasks; they run at elevated scheduling priority where permitted. */
+    std::size_t realtimeWorkers{0};
+    /** Pin worker i to core i (modulo core count) where the platform allows it. */
+    bool pinWorkers{false};
+    /** Thread setup for Normal workers (FTZ/DAZ on by default). */
+    ThreadConfigRequest normalThread{};
+    /** Thread setup for Realtime workers. */
+    ThreadConfigRequest realtimeThread{ThreadPolicy::Fifo, 0.5};
+    /** Per-worker deque capacity (rounded up to a power of two). Overflow spills to the shared queue. */
+    std::size_t dequeCapacity{1024};
+};
+
+/**
+ * Chase-Lev work-stealing deque of task words. The owning worker pushes and pops at
+ * the bottom; any thread may steal from the top.
+ */
+class WorkStealingDeque {
+public:
+    explicit WorkStealingDeque(std::size_t capacity);
+
+    WorkStealingDeque(const WorkStealingDeque&) = delete;
+    WorkStealingDeque& operator=(const WorkStealingDeque&) = delete;
+
+    /** Owner only. Returns false when full. */
+    bool push(std::uintptr_t item) noexcept;
+    /** Owner only. Returns 0 when empty. */
+    std::uintptr_t pop() noexcept;
+    /** Any thread. Returns 0 when empty or when the race for the last item was lost. */
+    std::uintptr_t steal() noexcept;
+
+private:
+    const std::int64_t m_mask;
+    std::unique_ptr<std::atomic<std::uintptr_t>[]> m_slots;
+    alignas(64) std::atomic<std::int64_t> m_top{0};
+    alignas(64) std::atomic<std::int64_t> m_bottom{0};
+};
+
+/**
+ * Process-wide work-stealing pool shared by every parallel feature of the core
+ * (coroutine scheduling, batch file analysis) so they never oversubscribe the
+ * cores. Workers are split into a Normal and a Realtime group;
+ * each group steals only among its own workers.
+ */
+class ThreadPool {
+public:
+    explicit ThreadPool(const ThreadPoolConfig& config = {});
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    /**
+     * Lazily constructed pool with the default configuration.
+     */
+    static ThreadPool& shared();
+
+    /**
+     * Queue @p task. Returns false after shutdown() has begun, unless called from
+     * one of this pool's workers of the same @p priority.
+     */
+    bool submit(PoolTask* task, TaskPriority priority = TaskPriority::Normal);
+
+    /**
+     * Queue a coroutine resumption. Returns false after shutdown() has begun.
+     */
+    bool submit(std::coroutine_handle<> handle, TaskPriority priority = TaskPriority::Normal);
+
+    /**
+     * Queue a coroutine resumption on the group's shared FIFO queue even when
+     * called from a worker, behind work other threads have submitted. For
+     * callers that decide the order themselves; submit() favours cache locality.
+     */
+    bool post(std::coroutine_handle<> handle, TaskPriority priority = TaskPriority::Normal);
+
+    /**
+     * Stop accepting work, run everything already queued, then join the workers.
+     */
+    void shutdown();
+
+    [[nodiscard]] std::size_t workerCount(TaskPriority priority) const noexcept {
+        return group(priority).workers.size();
+    }
+
+    /**
+     * Settings that actually took effect on worker @p index of the @p priority group.
+     */
+    [[nodiscard]] const AppliedThreadConfig& appliedConfig(TaskPriority priority, std::size_t index) const {
+        return group(priority).workers[index]->applied;
+    }
+
+private:
+    struct Worker {
+        explicit Worker(std::size_t capacity) : deque(capacity) {}
+        WorkStealingDeque deque;
+        std::thread thread;
+        AppliedThreadConfig applied;
+        /** Owner only: takes so far, for the periodic shared-queue poll. */
+        std::uint32_t takes{0};
+    };
+
+    struct Group {
+        std::vector<std::unique_ptr<Worker>> workers;
+        std::mutex injectMutex;
+        std::deque<std::uintptr_t> injected;
+        std::atomic<std::size_t> pending{0};
+        std::atomic<std::size_t> sleepers{0};
+        std::mutex sleepMutex;
+        std::condition_variable sleepCondition;
+    };
+
+    Group& group(TaskPriority priority) noexcept {
+        return priority == TaskPriority::Realtime ? m_realtime : m_normal;
+    }
+    const Group& group(TaskPriority priority) const noexcept {
+        return priority == TaskPriority::Realtime ? m_realtime : m_normal;
+    }
+
+    bool enqueue(std::uintptr_t item, TaskPriority priority, bool shared = false);
+    bool take(Group& group, std::size_t index, std::uintptr_t& item);
+    void run(TaskPriority priority, std::size_t index, std::size_t globalIndex);
+    static void execute(std::uintptr_t item);
+
+    Group m_normal;
+    Group m_realtime;
+    ThreadPoolConfig m_config;
+    std::atomic<bool> m_stopping{false};
+    std::mutex m_startupMutex;
+    std::condition_variable m_startupCondition;
+    std::size_t m_configuredWorkers{0};
+};
+
+}  // namespace tine::dsp
+
+#endif  // TINE_NATIVE_UTIL_THREADPOOL_HPP
@@ -0,0 +1,188 @@
+#include "ToneGenerator.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace tine::dsp {
+
+namespace {
+
+constexpr std::size_t WAVEFORMS = 4;
+constexpr std::size_t TABLE_MASK = ToneGenerator::TABLE_SIZE - 1;
+// Time constant for duck gain changes, long enough not to click.
+constexpr double DUCK_SECONDS = 0.01;
+
+static_assert((ToneGenerator::TABLE_SIZE & TABLE_MASK) == 0, "table size must be a power of two");
+
+// Amplitude of harmonic @p n in the Fourier sine series of @p waveform.
+double harmonicAmplitude(ToneWaveform waveform, std::size_t n) {
+    const auto h = static_cast<double>(n);
+    switch (waveform) {
+        case ToneWaveform::Sine:
+            return n == 1 ? 1.0 : 0.0;
+        case ToneWaveform::Sawtooth:
+            return 1.0 / h;
+        case ToneWaveform::Square:
+            return n % 2 == 1 ? 1.0 / h : 0.0;
+        case ToneWaveform::Triangle:
+            return n % 2 == 1 ? ((n / 2) % 2 == 0 ? 1.0 : -1.0) / (h * h) : 0.0;
+    }
+    return 0.0;
+}
+
+// One linear segment per control block: value at sample i is start + slope * (i + 1).
+double rampSlope(double start, double end, std::size_t frames) {
+    return (end - start) / static_cast<double>(frames);
+}
+
+}  // namespace
+
+ToneGenerator::ToneGenerator(double sampleRate)
+    : m_sampleRate(sampleRate > 0.0 ? sampleRate : 48000.0),
+      m_tables(WAVEFORMS * OCTAVES * (TABLE_SIZE + 1), 0.0F) {
+    std::vector<double> sine(TABLE_SIZE);
+    for (std::size_t i = 0; i < TABLE_SIZE; ++i) {
+        sine[i] = std::sin(2.0 * M_PI * static_cast<double>(i) / TABLE_SIZE);
+    }
+
+    std::vector<double> sum(TABLE_SIZE);
+    for (std::size_t w = 0; w < WAVEFORMS; ++w) {
+        const auto waveform = static_cast<ToneWaveform>(w);
+        for (std::size_t octave = 0; octave < OCTAVES; ++octave) {
+            const double top = LOWEST_FREQUENCY * std::ldexp(1.0, static_cast<int>(octave) + 1);
+            const auto harmonics = std::clamp<std::size_t>(
+                static_cast<std::size_t>(HARMONIC_CEILING * m_sampleRate / top), 1, TABLE_SIZE / 2 - 1);
+
+            std::fill(sum.begin(), sum.end(), 0.0);
+            for (std::size_t n = 1; n <= harmonics; ++n) {
+                const double amplitude = harmonicAmplitude(waveform, n);
+                if (amplitude == 0.0) {
+                    continue;
+                }
+                // sin(2 pi n i / N) is an exact lookup at index n * i mod N.
+                for (std::size_t i = 0; i < TABLE_SIZE; ++i) {
+                    sum[i] += amplitude * sine[(n * i) & TABLE_MASK];
+                }
+            }
+
+            double peak = 0.0;
+            for (double v : sum) {
+                peak = std::max(peak, std::fabs(v));
+            }
+            const double scale = peak > 0.0 ? 1.0 / peak : 0.0;
+            float* table = m_tables.data() + (w * OCTAVES + octave) * (TABLE_SIZE + 1);
+            for (std::size_t i = 0; i < TABLE_SIZE; ++i) {
+                table[i] = static_cast<float>(sum[i] * scale);
+            }
+            table[TABLE_SIZE] = table[0];
+        }
+    }
+}
+
+void ToneGenerator::noteOn(double frequency) noexcept {
+    ToneParameters next = m_parameters.load();
+    next.frequency = frequency;
+    next.gate = true;
+    m_parameters.store(next);
+}
+
+void ToneGenerator::noteOff() noexcept {
+    ToneParameters next = m_parameters.load();
+    next.gate = false;
+    m_parameters.store(next);
+}
+
+bool ToneGenerator::containsHarmonic(ToneWaveform waveform, std::size_t n) noexcept {
+    return n > 0 && harmonicAmplitude(waveform, n) != 0.0;
+}
+
+const float* ToneGenerator::tableFor(ToneWaveform waveform, double frequency) const noexcept {
+    const double octaves = std::log2(std::max(frequency, LOWEST_FREQUENCY) / LOWEST_FREQUENCY);
+    const auto octave = std::min<std::size_t>(static_cast<std::size_t>(octaves), OCTAVES - 1);
+    const auto w = std::min<std::size_t>(static_cast<std::size_t>(waveform), WAVEFORMS - 1);
+    return m_tables.data() + (w * OCTAVES + octave) * (TABLE_SIZE + 1);
+}
+
+void ToneGenerator::render(float* out, std::size_t frames, bool accumulate) noexcept {
+    const ToneParameters p = m_parameters.load();
+    const double sr = m_sampleRate;
+    const double targetLog =
+        std::log(std::clamp(std::isfinite(p.frequency) ? p.frequency : 440.0, 1.0, HARMONIC_CEILING * sr));
+    const double envelopeTarget = p.gate ? 1.0 : 0.0;
+    const double duckTarget = m_ducked.load(std::memory_order_relaxed) ? std::clamp(p.duckGain, 0.0, 1.0) : 1.0;
+
+    if (!m_started || (m_envelope == 0.0 && !p.gate)) {
+        // Silent: a note starting from silence begins on pitch rather than gliding in.
+        m_logFrequency = targetLog;
+        m_started = true;
+        m_duck = duckTarget;
+        m_audibleFrequency.store(0.0, std::memory_order_relaxed);
+        if (!p.gate) {
+            if (!accumulate) {
+                std::memset(out, 0, frames * sizeof(float));
+            }
+            return;
+        }
+    }
+
+    const auto block = static_cast<double>(CONTROL_BLOCK);
+    const double glideCoefficient = p.glideSeconds > 0.0 ? std::exp(-block / (p.glideSeconds * sr)) : 0.0;
+    const double duckCoefficient = std::exp(-block / (DUCK_SECONDS * sr));
+    const double rampSeconds = p.gate ? p.attackSeconds : p.releaseSeconds;
+    const double envelopeStep = rampSeconds > 0.0 ? 1.0 / (rampSeconds * sr) : 1.0;
+    const double gain = std::isfinite(p.gain) ? p.gain : 0.0;
+    const double tableScale = TABLE_SIZE / sr;
+
+    for (std::size_t offset = 0; offset < frames; offset += CONTROL_BLOCK) {
+        const std::size_t n = std::min(CONTROL_BLOCK, frames - offset);
+        const auto length = static_cast<double>(n);
+
+        // Control rate: exponential glide in log frequency, linear envelope, smoothed duck.
+        const double startFrequency = std::exp(m_logFrequency);
+        m_logFrequency = targetLog + (m_logFrequency - targetLog) * glideCoefficient;
+        const double endFrequency = std::exp(m_logFrequency);
+
+        const double envelopeStart = m_envelope;
+        if (m_envelope < envelopeTarget) {
+            m_envelope = std::min(envelopeTarget, m_envelope + envelopeStep * length);
+        } else if (m_envelope > envelopeTarget) {
+            m_envelope = std::max(envelopeTarget, m_envelope - envelopeStep * length);
+        }
+        const double duckStart = m_duck;
+        m_duck = duckTarget + (m_duck - duckTarget) * duckCoefficient;
+
+        const float* table = tableFor(p.waveform, std::max(startFrequency, endFrequency));
+        const double increment = startFrequency * tableScale;
+        const double incrementSlope = rampSlope(startFrequency, endFrequency, n) * tableScale;
+        const double amplitudeStart = gain * envelopeStart * duckStart;
+        const double amplitudeSlope = rampSlope(amplitudeStart, gain * m_envelope * m_duck, n);
+
+        // Per-sample phase in closed form (no loop-carried accumulator), then
+        // interpolated lookup and gain: independent lanes the compiler can vectorise.
+        const double phase = m_phase;
+        for (std::size_t i = 0; i < n; ++i) {
+            const auto k = static_cast<double>(i);
+            const double position = phase + k * increment + incrementSlope * k * (k - 1.0) * 0.5;
+            const auto whole = static_cast<std::size_t>(position);
+            const auto frac = static_cast<float>(position - static_cast<double>(whole));
+            const std::size_t index = whole & TABLE_MASK;
+            const float sample = table[index] + frac * (table[index + 1] - table[index]);
+            m_block[i] = sample * static_cast<float>(amplitudeStart + amplitudeSlope * (k + 1.0));
+        }
+        if (accumulate) {
+            for (std::size_t i = 0; i < n; ++i) {
+                out[offset + i] += m_block[i];
+            }
+        } else {
+            std::memcpy(out + offset, m_block, n * sizeof(float));
+        }
+
+        m_phase = std::fmod(phase + length * increment + incrementSlope * length * (length - 1.0) * 0.5,
+                            static_cast<double>(TABLE_SIZE));
+    }
+
+    m_audibleFrequency.store(m_envelope > 0.0 ? std::exp(m_logFrequency) : 0.0, std::memory_order_relaxed);
+}
+
+}  // namespace tine::dsp
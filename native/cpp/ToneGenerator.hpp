@@ -0,0 +1,123 @@
+#ifndef TINE_NATIVE_DSP_TONEGENERATOR_HPP
+#define TINE_NATIVE_DSP_TONEGENERATOR_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "SeqLock.hpp"
+
+namespace tine::dsp {
+
+enum class ToneWaveform : std::uint8_t { Sine, Triangle, Sawtooth, Square };
+
+/**
+ * Everything the control side may change; published to the render thread as
+ * one consistent snapshot.
+ */
+struct ToneParameters {
+    double frequency{440.0};
+    /** Linear peak amplitude. */
+    double gain{0.25};
+    /** Time constant of the exponential pitch glide between notes (seconds); 0 jumps. */
+    double glideSeconds{0.05};
+    /** Linear envelope ramps (seconds). */
+    double attackSeconds{0.02};
+    double releaseSeconds{0.2};
+    /** Gain applied while setDucked(true), e.g. while the player's own note sounds. */
+    double duckGain{0.3};
+    ToneWaveform waveform{ToneWaveform::Sine};
+    /** Note held: the envelope rises toward 1, otherwise it releases to silence. */
+    bool gate{false};
+};
+
+/**
+ * Reference tone / drone for the output path: band-limited wavetable
+ * oscillator with glide and an attack/release envelope.
+ *
+ * Wavetables are built once per octave in the constructor with only the
+ * harmonics that stay below Nyquist in that octave, so the render callback
+ * does table lookups and never allocates. Parameters travel through a SeqLock:
+ * setParameters() from any one control thread, render() from the audio thread.
+ * Pitch and envelope update at a control rate of CONTROL_BLOCK samples and are
+ * ramped within each block; the inner loops are plain array arithmetic the
+ * compiler vectorises.
+ */
+class ToneGenerator {
+public:
+    static constexpr std::size_t TABLE_SIZE = 1024;
+    static constexpr std::size_t CONTROL_BLOCK = 32;
+    /** Lowest frequency of the first wavetable octave (Hz). */
+    static constexpr double LOWEST_FREQUENCY = 16.0;
+    static constexpr std::size_t OCTAVES = 11;
+    /**
+     * Harmonics stop below this fraction of the sample rate at the top of each
+     * octave, leaving the remaining band for the interpolator's images.
+     */
+    static constexpr double HARMONIC_CEILING = 0.45;
+
+    explicit ToneGenerator(double sampleRate);
+
+    ToneGenerator(const ToneGenerator&) = delete;
+    ToneGenerator& operator=(const ToneGenerator&) = delete;
+
+    /** Control thread (one at a time). Takes effect at the next render(). */
+    void setParameters(const ToneParameters& parameters) noexcept { m_parameters.store(parameters); }
+
+    [[nodiscard]] ToneParameters parameters() const noexcept { return m_parameters.load(); }
+
+    /** Control thread: glide to @p frequency and open the gate. */
+    void noteOn(double frequency) noexcept;
+
+    /** Control thread: release the current note. */
+    void noteOff() noexcept;
+
+    /**
+     * Lower the tone to duckGain (smoothed over ~10 ms). Any thread, e.g. the
+     * result handler while the detector reports a voiced note.
+     */
+    void setDucked(bool ducked) noexcept { m_ducked.store(ducked, std::memory_order_relaxed); }
+
+    /**
+     * Audio thread: render @p frames mono samples into @p out, replacing its
+     * contents, or adding to them with @p accumulate.
+     */
+    void render(float* out, std::size_t frames, bool accumulate = false) noexcept;
+
+    /**
+     * Frequency the detector should notch out: the sounding pitch (glide included,
+     * updated once per render) while the tone is audible, 0 when silent. Any thread.
+     */
+    [[nodiscard]] double audibleFrequency() const noexcept {
+        return m_audibleFrequency.load(std::memory_order_relaxed);
+    }
+
+    [[nodiscard]] double sampleRate() const noexcept { return m_sampleRate; }
+
+    /** Whether harmonic @p n (1 = fundamental) of @p waveform is nonzero. */
+    [[nodiscard]] static bool containsHarmonic(ToneWaveform waveform, std::size_t n) noexcept;
+
+private:
+    [[nodiscard]] const float* tableFor(ToneWaveform waveform, double frequency) const noexcept;
+
+    double m_sampleRate;
+    /** [waveform][octave] tables of TABLE_SIZE + 1 samples (guard point for interpolation). */
+    std::vector<float> m_tables;
+    SeqLock<ToneParameters> m_parameters;
+
+    // Render-thread state.
+    double m_phase{0.0};
+    double m_logFrequency{0.0};
+    double m_envelope{0.0};
+    double m_duck{1.0};
+    bool m_started{false};
+    float m_block[CONTROL_BLOCK]{};
+
+    std::atomic<bool> m_ducked{false};
+    std::atomic<double> m_audibleFrequency{0.0};
+};
+
+}  // namespace tine::dsp
+
+#endif  // TINE_NATIVE_DSP_TONEGENERATOR_HPP
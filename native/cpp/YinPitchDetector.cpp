@@ -1,6 +1,9 @@
 #include "YinPitchDetector.hpp"
 
+#include "KernelAutotuner.hpp"
+
 #include <algorithm>
+#include <array>
 #include <cmath>
 #include <limits>
 
@@ -10,6 +13,34 @@ namespace {
 constexpr double MIN_THRESHOLD = 0.001;
 constexpr double MAX_THRESHOLD = 0.999;
 
+// Frames per internal processFrames() batch; bounds the per-frame scratch rows.
+constexpr std::size_t MAX_BATCH_FRAMES = 64;
+// The sliding per-lag sum is re-added from its chunks once it falls below this
+// fraction of its peak since the last exact sum: past that, the residue left by
+// subtracting the loud chunks outweighs the frame's own difference.
+constexpr double BATCH_RESUM_FRACTION = 1e-3;
+// FFT-kernel cost per point and radix-2 stage, in shared-pass squared
+// differences. Measured at windows 1024-4096, where it puts the break-even hop
+// near window / 7, / 12 and / 23.
+constexpr double FFT_COST_PER_POINT_STAGE = 3.4;
+
+// Windowed-sinc half-width (taps each side) and Kaiser window shape. The
+// difference function is dominated by a large, slowly varying mean, so the
+// kernel needs far more passband accuracy than audio resampling does: Lanczos-4
+// still left a cent of bias at 2 kHz, this pair keeps it under 0.1 cent.
+constexpr int SINC_HALF_WIDTH = 8;
+constexpr double SINC_KAISER_BETA = 10.0;
+// Kernel table resolution (entries per lag).
+constexpr int SINC_PHASES = 256;
+// Lags either side of the CMND pick that refinement reads: Newton stays within
+// one lag and the finite-difference step can cross into the next tap.
+constexpr std::size_t REFINE_RADIUS = SINC_HALF_WIDTH + 2;
+// Newton iterations on the interpolated difference; each at least squares the error.
+constexpr int NEWTON_ITERATIONS = 4;
+constexpr double NEWTON_TOLERANCE = 1e-7;
+// Finite-difference step (lags) for the sinc curve's derivatives.
+constexpr double SINC_DERIVATIVE_STEP = 1e-3;
+
 constexpr const char* NOTE_NAMES[] = {
     "C",  "C#", "D",  "D#", "E",  "F",
     "F#", "G",  "G#", "A",  "A#", "B",
@@ -20,10 +51,103 @@ double clamp(double value, double min, double max) {
     return std::min(std::max(value, min), max);
 }
 
+// Modified Bessel function I0 by its power series sum(((x/2)^k / k!)^2). The
+// C++17 special math functions are missing from libc++, so this stands in for
+// std::cyl_bessel_i; 25 terms leave the residual below 1e-15 relative at x = 10.
+double besselI0(double x) {
+    const double half = 0.5 * x;
+    double term = 1.0;
+    double sum = 1.0;
+    for (int k = 1; k <= 25; ++k) {
+        const double factor = half / k;
+        term *= factor * factor;
+        sum += term;
+    }
+    return sum;
+}
+
+// Kaiser-windowed sinc tap at offset @p t (lags) from the evaluation point.
+double kaiserSinc(double t) {
+    const double r = t / SINC_HALF_WIDTH;
+    if (r * r >= 1.0) {
+        return 0.0;
+    }
+    const double window =
+        besselI0(SINC_KAISER_BETA * std::sqrt(1.0 - r * r)) / besselI0(SINC_KAISER_BETA);
+    if (std::fabs(t) < 1e-12) {
+        return window;
+    }
+    const double a = M_PI * t;
+    return std::sin(a) / a * window;
+}
+
+// The kernel sampled every 1/SINC_PHASES lag over [0, SINC_HALF_WIDTH], with a
+// knot either side for the Catmull-Rom lookup. Built once per process.
+struct SincTable {
+    std::array<double, SINC_HALF_WIDTH * SINC_PHASES + 3> taps{};
+
+    SincTable() {
+        for (std::size_t i = 0; i < taps.size(); ++i) {
+            taps[i] = kaiserSinc((static_cast<double>(i) - 1.0) / SINC_PHASES);
+        }
+    }
+};
+
+const SincTable& sincTable() {
+    static const SincTable table;
+    return table;
+}
+
+// Kernel value at @p t, interpolated from the table; relative error near 1e-8.
+double sincTap(const SincTable& table, double t) {
+    const double position = std::fabs(t) * SINC_PHASES;
+    const auto knot = static_cast<std::size_t>(position);
+    if (knot >= static_cast<std::size_t>(SINC_HALF_WIDTH * SINC_PHASES)) {
+        return 0.0;
+    }
+    const double u = position - static_cast<double>(knot);
+    const double* p = table.taps.data() + knot;
+    // Knot k of the kernel lives at taps[k + 1]; p[0..3] are knots k-1..k+2.
+    return p[1] + 0.5 * u * (p[2] - p[0] + u * (2.0 * p[0] - 5.0 * p[1] + 4.0 * p[2] - p[3] +
+                                                 u * (3.0 * (p[1] - p[2]) + p[3] - p[0])));
+}
+
+// Windowed-sinc reconstruction of @p values at fractional lag @p x.
+double sincAt(const double* values, double x) {
+    const SincTable& table = sincTable();
+    const auto base = static_cast<std::ptrdiff_t>(std::floor(x));
+    double sum = 0.0;
+    double weights = 0.0;
+    for (std::ptrdiff_t k = base - SINC_HALF_WIDTH + 1; k <= base + SINC_HALF_WIDTH; ++k) {
+        const double weight = sincTap(table, x - static_cast<double>(k));
+        sum += values[k] * weight;
+        weights += weight;
+    }
+    // Truncated kernels do not quite sum to one between samples; the difference
+    // function's large mean would turn that ripple into a bias in the minimum.
+    return sum / weights;
+}
+
+// First and second derivative of the Lagrange cubic through values[t0 - 1 .. t0 + 2] at x.
+void cubicSlopes(const double* values, double x, double& slope, double& curvature) {
+    const auto t0 = static_cast<std::ptrdiff_t>(std::floor(x));
+    const double p0 = values[t0 - 1];
+    const double p1 = values[t0];
+    const double p2 = values[t0 + 1];
+    const double p3 = values[t0 + 2];
+    const double a = (-p0 + 3.0 * p1 - 3.0 * p2 + p3) / 6.0;
+    const double b = (p0 - 2.0 * p1 + p2) / 2.0;
+    const double c = (-2.0 * p0 - 3.0 * p1 + 6.0 * p2 - p3) / 6.0;
+    const double u = x - static_cast<double>(t0);
+    slope = (3.0 * a * u + 2.0 * b) * u + c;
+    curvature = 6.0 * a * u + 2.0 * b;
+}
+
 }  // namespace
 
 YinPitchDetector::YinPitchDetector(double sampleRate, std::size_t bufferSize, double threshold)
     : m_sampleRate(sampleRate),
+      m_capacity(bufferSize),
       m_bufferSize(bufferSize),
       m_maxLag(bufferSize / 2),
       m_threshold(clamp(threshold, MIN_THRESHOLD, MAX_THRESHOLD)),
@@ -31,38 +155,81 @@ YinPitchDetector::YinPitchDetector(double sampleRate, std::size_t bufferSize, do
       m_cumulative(m_maxLag + 1, 0.0) {}
 
 PitchResult YinPitchDetector::processBuffer(const float* samples, std::size_t numSamples) {
-    PitchResult empty{};
-    empty.isValid = false;
-
     if (!samples || numSamples < m_bufferSize || m_maxLag < 2 || m_sampleRate <= 0) {
-        m_lastResult = empty;
+        if (m_candidateLog) {
+            m_candidateLog->frameEnds.push_back(static_cast<std::uint32_t>(m_candidateLog->candidates.size()));
+        }
+        m_lastResult = PitchResult{};
         return m_lastResult;
     }
 
     computeDifference(samples);
-    computeCumulativeMeanNormalized();
+    return resultFromDifference(m_difference.data());
+}
+
+std::size_t YinPitchDetector::processFrames(const float* samples, std::size_t numSamples, std::size_t hop,
+                                            PitchResult* results, std::size_t maxResults) {
+    if (!samples || !results || maxResults == 0 || hop == 0 || numSamples < m_bufferSize || m_maxLag < 2 ||
+        m_sampleRate <= 0) {
+        return 0;
+    }
+
+    // A hop longer than the window leaves nothing to share.
+    if (hop >= m_bufferSize || fftBeatsBatch(hop)) {
+        const std::size_t frames = std::min(maxResults, (numSamples - m_bufferSize) / hop + 1);
+        for (std::size_t k = 0; k < frames; ++k) {
+            results[k] = processBuffer(samples + k * hop, m_bufferSize);
+        }
+        return frames;
+    }
+
+    const std::size_t total = std::min(maxResults, (numSamples - m_bufferSize) / hop + 1);
+    const std::size_t row = m_maxLag + 1;
+    std::size_t done = 0;
+    while (done < total) {
+        const std::size_t frames = std::min(MAX_BATCH_FRAMES, total - done);
+        computeBatchDifference(samples + done * hop, frames, hop);
+        for (std::size_t k = 0; k < frames; ++k) {
+            results[done + k] = resultFromDifference(m_batchDifference.data() + k * row);
+        }
+        done += frames;
+    }
+    return total;
+}
+
+PitchResult YinPitchDetector::resultFromDifference(const double* difference) {
+    computeCumulativeMeanNormalized(difference);
+    if (m_candidateLog) {
+        recordCandidates(difference);
+    }
 
     double probability = 0.0;
     std::size_t tau = absoluteThreshold(probability);
     if (tau == 0) {
-        m_lastResult = empty;
+        m_lastResult = PitchResult{};
         return m_lastResult;
     }
 
     double refinedTau = static_cast<double>(tau);
     if (tau > 1 && tau < m_maxLag) {
-        refinedTau = parabolicInterpolation(tau, m_cumulative);
+        refinedTau = refineLag(tau, difference);
     }
 
-    if (refinedTau <= 0.0) {
-        m_lastResult = empty;
-        return m_lastResult;
+    m_lastResult = resultFromPeriod(m_sampleRate, refinedTau, probability);
+    return m_lastResult;
+}
+
+PitchResult YinPitchDetector::resultFromPeriod(double sampleRate, double period, double probability) {
+    PitchResult empty{};
+    empty.isValid = false;
+
+    if (period <= 0.0) {
+        return empty;
     }
 
-    const double frequency = m_sampleRate / refinedTau;
+    const double frequency = sampleRate / period;
     if (!std::isfinite(frequency) || frequency <= 0.0) {
-        m_lastResult = empty;
-        return m_lastResult;
+        return empty;
     }
 
     const double midi = midiFromFrequency(frequency);
@@ -76,48 +243,179 @@ PitchResult YinPitchDetector::processBuffer(const float* samples, std::size_t nu
     result.cents = cents;
     result.probability = clamp(probability, 0.0, 1.0);
     result.noteName = noteNameFromMidi(nearestMidi);
+    return result;
+}
 
-    m_lastResult = result;
-    return m_lastResult;
+PitchResult YinPitchDetector::decodeCandidates(const LagCandidate* candidates, std::size_t count, double threshold,
+                                               double sampleRate) {
+    if (!candidates || count == 0) {
+        return PitchResult{};
+    }
+    // absoluteThreshold(): the first candidate under the threshold, else the global minimum.
+    const double limit = clampThreshold(threshold);
+    const LagCandidate* chosen = candidates + count - 1;
+    for (std::size_t i = 0; i < count; ++i) {
+        if (candidates[i].cmnd < limit) {
+            chosen = candidates + i;
+            break;
+        }
+    }
+    return resultFromPeriod(sampleRate, chosen->period, 1.0 - chosen->cmnd);
+}
+
+std::size_t YinPitchDetector::setActiveSize(std::size_t windowSize) noexcept {
+    // Keep the window even so the lag range is exactly half of it.
+    windowSize = std::min(std::max<std::size_t>(windowSize, 4), m_capacity) & ~static_cast<std::size_t>(1);
+    m_bufferSize = windowSize;
+    m_maxLag = windowSize / 2;
+    selectKernel();
+    return m_bufferSize;
+}
+
+void YinPitchDetector::setKernelWisdom(const KernelWisdom& wisdom) {
+    m_kernelTable.clear();
+    std::size_t largestFft = 0;
+    for (const KernelWisdomEntry& entry : wisdom.entries()) {
+        if (entry.windowSize > m_capacity) {
+            continue;
+        }
+        m_kernelTable.push_back({entry.windowSize, entry.choice});
+        if (entry.choice.kind == DifferenceKernelKind::Fft) {
+            const std::size_t needed = DifferenceKernel::minimumFftSize(entry.windowSize, entry.windowSize / 2);
+            largestFft = std::max({largestFft, needed, entry.choice.fftSize});
+        }
+    }
+    m_kernel.reserve(m_capacity, largestFft);
+    selectKernel();
+}
+
+void YinPitchDetector::selectKernel() noexcept {
+    m_kernelChoice = DifferenceKernelChoice{};
+    for (const KernelSlot& slot : m_kernelTable) {
+        if (slot.windowSize == m_bufferSize) {
+            m_kernelChoice = slot.choice;
+            return;
+        }
+    }
+}
+
+bool YinPitchDetector::fftBeatsBatch(std::size_t hop) const noexcept {
+    if (m_kernelChoice.kind != DifferenceKernelKind::Fft) {
+        return false;
+    }
+    // The shared pass does about maxLag * hop squared differences per frame; the
+    // FFT's cost does not depend on the hop.
+    const std::size_t fftSize =
+        std::max(m_kernelChoice.fftSize, DifferenceKernel::minimumFftSize(m_bufferSize, m_maxLag));
+    const auto points = static_cast<double>(fftSize);
+    const double fftCost = FFT_COST_PER_POINT_STAGE * points * std::log2(points);
+    return fftCost < static_cast<double>(m_maxLag) * static_cast<double>(hop);
 }
 
 void YinPitchDetector::setThreshold(double threshold) noexcept {
-    m_threshold = clamp(threshold, MIN_THRESHOLD, MAX_THRESHOLD);
+    m_threshold = clampThreshold(threshold);
+}
+
+double YinPitchDetector::clampThreshold(double threshold) noexcept {
+    return clamp(threshold, MIN_THRESHOLD, MAX_THRESHOLD);
+}
+
+void YinPitchDetector::setLagRefinement(LagRefinement refinement) noexcept {
+    if (refinement == LagRefinement::Sinc) {
+        static_cast<void>(sincTable());
+    }
+    m_refinement = refinement;
 }
 
 void YinPitchDetector::computeDifference(const float* samples) {
-    std::fill(m_difference.begin(), m_difference.end(), 0.0);
+    m_kernel.compute(m_kernelChoice, samples, m_bufferSize, m_maxLag, m_difference.data());
+}
+
+void YinPitchDetector::computeBatchDifference(const float* samples, std::size_t frames, std::size_t hop) {
+    const std::size_t row = m_maxLag + 1;
+    m_batchDifference.assign(frames * row, 0.0);
 
     for (std::size_t tau = 1; tau <= m_maxLag; ++tau) {
-        double sum = 0.0;
-        for (std::size_t i = 0; i < m_bufferSize - tau; ++i) {
-            const double delta = static_cast<double>(samples[i]) - static_cast<double>(samples[i + tau]);
-            sum += delta * delta;
+        // Frame k sums e(i) = (x[i] - x[i + tau])^2 over [k * hop, k * hop + length).
+        // With length = chunksPerFrame * hop + tail that is chunks k .. k + chunksPerFrame - 1
+        // plus the first `tail` terms of chunk k + chunksPerFrame.
+        const std::size_t length = m_bufferSize - tau;
+        const std::size_t chunksPerFrame = length / hop;
+        const std::size_t tail = length % hop;
+        const std::size_t fullChunks = frames - 1 + chunksPerFrame;
+
+        m_chunkSums.resize(fullChunks);
+        m_chunkHeads.resize(fullChunks + 1);
+
+        for (std::size_t chunk = 0; chunk <= fullChunks; ++chunk) {
+            const float* x = samples + chunk * hop;
+            const float* y = x + tau;
+
+            double head = 0.0;
+            for (std::size_t i = 0; i < tail; ++i) {
+                const double delta = static_cast<double>(x[i]) - static_cast<double>(y[i]);
+                head += delta * delta;
+            }
+            m_chunkHeads[chunk] = head;
+            if (chunk == fullChunks) {
+                break;
+            }
+
+            double rest = 0.0;
+            for (std::size_t i = tail; i < hop; ++i) {
+                const double delta = static_cast<double>(x[i]) - static_cast<double>(y[i]);
+                rest += delta * delta;
+            }
+            m_chunkSums[chunk] = head + rest;
         }
-        m_difference[tau] = sum;
-    }
 
-    m_difference[0] = 0.0;
+        // Slide a chunksPerFrame-wide sum across the chunk sums. Add/subtract
+        // keeps rounding relative to the largest value the sum has held, so when
+        // the signal decays (a note ending in silence) the sum is rebuilt exactly;
+        // otherwise a silent frame would keep a residue YIN reads as a period.
+        const auto exactSum = [this, chunksPerFrame](std::size_t first) {
+            double sum = 0.0;
+            for (std::size_t chunk = first; chunk < first + chunksPerFrame; ++chunk) {
+                sum += m_chunkSums[chunk];
+            }
+            return sum;
+        };
+        double running = exactSum(0);
+        double peak = running;
+        for (std::size_t k = 0; k < frames; ++k) {
+            if (k > 0) {
+                running += m_chunkSums[k - 1 + chunksPerFrame] - m_chunkSums[k - 1];
+                if (running < peak * BATCH_RESUM_FRACTION) {
+                    running = exactSum(k);
+                    peak = running;
+                } else if (running > peak) {
+                    peak = running;
+                }
+            }
+            m_batchDifference[k * row + tau] = running + m_chunkHeads[k + chunksPerFrame];
+        }
+    }
 }
 
-void YinPitchDetector::computeCumulativeMeanNormalized() {
+void YinPitchDetector::computeCumulativeMeanNormalized(const double* difference) {
     m_cumulative[0] = 1.0;
     double runningSum = 0.0;
 
     for (std::size_t tau = 1; tau <= m_maxLag; ++tau) {
-        runningSum += m_difference[tau];
+        runningSum += difference[tau];
         if (runningSum == 0.0) {
             m_cumulative[tau] = 1.0;
         } else {
-            m_cumulative[tau] = (m_difference[tau] * static_cast<double>(tau)) / runningSum;
+            m_cumulative[tau] = (difference[tau] * static_cast<double>(tau)) / runningSum;
         }
     }
 }
 
 std::size_t YinPitchDetector::absoluteThreshold(double& probability) const {
-    for (std::size_t tau = 2; tau < m_cumulative.size(); ++tau) {
+    const std::size_t lags = m_maxLag + 1;
+    for (std::size_t tau = m_minLag; tau < lags; ++tau) {
         if (m_cumulative[tau] < m_threshold) {
-            while (tau + 1 < m_cumulative.size() && m_cumulative[tau + 1] < m_cumulative[tau]) {
+            while (tau + 1 < lags && m_cumulative[tau + 1] < m_cumulative[tau]) {
                 ++tau;
             }
             probability = 1.0 - m_cumulative[tau];
@@ -128,7 +426,7 @@ std::size_t YinPitchDetector::absoluteThreshold(double& probability) const {
     double minValue = std::numeric_limits<double>::infinity();
     std::size_t candidate = 0;
 
-    for (std::size_t tau = 2; tau < m_cumulative.size(); ++tau) {
+    for (std::size_t tau = m_minLag; tau < lags; ++tau) {
         if (m_cumulative[tau] < minValue) {
             minValue = m_cumulative[tau];
             candidate = tau;
@@ -145,6 +443,88 @@ std::size_t YinPitchDetector::absoluteThreshold(double& probability) const {
     return candidate;
 }
 
+void YinPitchDetector::recordCandidates(const double* difference) {
+    // absoluteThreshold() walks downhill from the first lag under the threshold,
+    // so it can only stop where a falling run ends. Of those, only a new running
+    // minimum can be the first under some threshold; the last is the fallback.
+    const std::size_t lags = m_maxLag + 1;
+    double lowest = std::numeric_limits<double>::infinity();
+    for (std::size_t tau = m_minLag; tau < lags; ++tau) {
+        const double value = m_cumulative[tau];
+        const bool runEnd = (tau == m_minLag || m_cumulative[tau - 1] > value) &&
+                            (tau + 1 == lags || m_cumulative[tau + 1] >= value);
+        if (!runEnd || !(value < lowest)) {
+            continue;
+        }
+        lowest = value;
+        LagCandidate candidate;
+        candidate.lag = static_cast<std::uint32_t>(tau);
+        candidate.cmnd = value;
+        candidate.period = tau > 1 && tau < m_maxLag ? refineLag(tau, difference) : static_cast<double>(tau);
+        m_candidateLog->candidates.push_back(candidate);
+    }
+    m_candidateLog->frameEnds.push_back(static_cast<std::uint32_t>(m_candidateLog->candidates.size()));
+}
+
+double YinPitchDetector::refineLag(std::size_t tau, const double* difference) const {
+    // Every sample the fits below touch must exist; short lag ranges fall back.
+    const bool sinc = m_refinement == LagRefinement::Sinc && tau >= REFINE_RADIUS &&
+                      tau + REFINE_RADIUS <= m_maxLag;
+    const bool cubic = (m_refinement == LagRefinement::Cubic || m_refinement == LagRefinement::Sinc) &&
+                       tau >= 3 && tau + 3 <= m_maxLag;
+    if (!sinc && !cubic) {
+        return parabolicInterpolation(tau, m_cumulative);
+    }
+
+    // Fit the mean squared difference per term rather than the sum. The sum
+    // covers bufferSize - tau terms, a ramp the short kernels cannot follow and
+    // one that drags the minimum toward longer lags whenever noise lifts the floor.
+    double local[2 * REFINE_RADIUS + 1];
+    const std::size_t first = tau > REFINE_RADIUS ? tau - REFINE_RADIUS : 0;
+    const std::size_t last = std::min(tau + REFINE_RADIUS, m_maxLag);
+    for (std::size_t lag = first; lag <= last; ++lag) {
+        local[lag - first] = difference[lag] / static_cast<double>(m_bufferSize - lag);
+    }
+    const double* values = local - static_cast<std::ptrdiff_t>(first);
+
+    // Start from the parabola through those values, then let Newton walk to the
+    // minimum of the smoother curve, never leaving tau's neighbourhood.
+    const double lower = static_cast<double>(tau) - 1.0;
+    const double upper = static_cast<double>(tau) + 1.0;
+    const double y0 = values[tau - 1];
+    const double y1 = values[tau];
+    const double y2 = values[tau + 1];
+    const double denominator = y0 - 2.0 * y1 + y2;
+    double x = static_cast<double>(tau);
+    if (denominator > 0.0) {
+        x += clamp((y0 - y2) / (2.0 * denominator), -0.5, 0.5);
+    }
+
+    for (int iteration = 0; iteration < NEWTON_ITERATIONS; ++iteration) {
+        double slope;
+        double curvature;
+        if (sinc) {
+            const double h = SINC_DERIVATIVE_STEP;
+            const double below = sincAt(values, x - h);
+            const double centre = sincAt(values, x);
+            const double above = sincAt(values, x + h);
+            slope = (above - below) / (2.0 * h);
+            curvature = (above - 2.0 * centre + below) / (h * h);
+        } else {
+            cubicSlopes(values, x, slope, curvature);
+        }
+        if (!(curvature > 0.0)) {
+            break;
+        }
+        const double step = clamp(-slope / curvature, -0.5, 0.5);
+        x = clamp(x + step, lower, upper);
+        if (std::fabs(step) < NEWTON_TOLERANCE) {
+            break;
+        }
+    }
+    return x;
+}
+
 double YinPitchDetector::parabolicInterpolation(std::size_t tau, const std::vector<double>& values) {
     if (tau == 0 || tau + 1 >= values.size()) {
         return static_cast<double>(tau);
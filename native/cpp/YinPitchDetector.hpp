@@ -2,11 +2,16 @@
 #define TINE_NATIVE_DSP_YINPITCHDETECTOR_HPP
 
 #include <cstddef>
+#include <cstdint>
 #include <string>
 #include <vector>
 
+#include "DifferenceKernel.hpp"
+
 namespace tine::dsp {
 
+class KernelWisdom;
+
 struct PitchResult {
     bool isValid{false};
     double frequency{0.0};
@@ -16,32 +21,180 @@ struct PitchResult {
     double probability{0.0};
 };
 
+/**
+ * How the integer lag picked from the CMND is refined to a fractional period.
+ */
+enum class LagRefinement : std::uint8_t {
+    /** Parabola through three CMND points. Cheapest; biases high pitches by up to ~2 cents. */
+    Parabolic,
+    /**
+     * Cubic through four points of the raw difference, minimised with Newton
+     * steps. Exact for pure tones, but harmonics bend it more than the parabola.
+     */
+    Cubic,
+    /**
+     * Windowed-sinc (Kaiser, 16 taps) reconstruction of the raw difference,
+     * minimised with Newton steps. The difference of a band-limited signal is
+     * band-limited in the lag too, so this tracks the true minimum: under 0.1
+     * cent of bias at any window, at a few microseconds per result. Needs lags
+     * of 10 or more (below 4.8 kHz at 48 kHz); shorter ones fall back to Cubic.
+     */
+    Sinc,
+};
+
+/**
+ * A lag the threshold search can settle on, whatever the threshold. A frame's
+ * candidates run in lag order with strictly falling CMND: for any threshold the
+ * detector picks the first one below it, or the last (the global minimum) when
+ * none is. Typically a handful per frame.
+ */
+struct LagCandidate {
+    std::uint32_t lag{0};
+    double cmnd{1.0};
+    /** Fractional period (samples) as the configured LagRefinement refined it. */
+    double period{0.0};
+};
+
+/**
+ * Candidates of consecutive frames: frame k owns
+ * candidates[k == 0 ? 0 : frameEnds[k - 1], frameEnds[k]).
+ */
+struct CandidateLog {
+    std::vector<LagCandidate> candidates;
+    std::vector<std::uint32_t> frameEnds;
+
+    [[nodiscard]] std::size_t frameCount() const noexcept { return frameEnds.size(); }
+    [[nodiscard]] std::size_t frameBegin(std::size_t frame) const noexcept {
+        return frame == 0 ? 0 : frameEnds[frame - 1];
+    }
+    void clear() noexcept {
+        candidates.clear();
+        frameEnds.clear();
+    }
+};
+
 class YinPitchDetector {
 public:
     YinPitchDetector(double sampleRate, std::size_t bufferSize, double threshold = 0.1);
 
     PitchResult processBuffer(const float* samples, std::size_t numSamples);
 
+    /**
+     * Analyze consecutive windows starting every @p hop samples in one pass.
+     *
+     * Frame k covers samples [k * hop, k * hop + bufferSize). Each lag's squared
+     * differences are streamed once over the whole span and summed per hop-sized
+     * chunk, so overlapping frames share both the sample loads and the partial
+     * sums instead of recomputing them. Results match processBuffer() up to
+     * floating-point summation order. When kernel wisdom picked the FFT for the
+     * active window and the hop is long enough that one FFT per frame is cheaper
+     * than the shared pass, frames go through the FFT one at a time instead.
+     *
+     * @return Number of results written to @p results (at most @p maxResults);
+     *         getLastResult() holds the final one.
+     */
+    std::size_t processFrames(const float* samples, std::size_t numSamples, std::size_t hop,
+                              PitchResult* results, std::size_t maxResults);
+
     [[nodiscard]] const PitchResult& getLastResult() const noexcept { return m_lastResult; }
 
+    /**
+     * Analyze only the first @p windowSize samples (lag range windowSize / 2) of
+     * each buffer from now on. Clamped to [4, constructor bufferSize] and rounded
+     * down to even; no allocation, so it is safe on the audio thread.
+     * @return The active window size.
+     */
+    std::size_t setActiveSize(std::size_t windowSize) noexcept;
+
+    [[nodiscard]] std::size_t getActiveSize() const noexcept { return m_bufferSize; }
+
+    /**
+     * Ignore lags below @p minLag (frequencies above sampleRate / minLag) when
+     * picking the period. The difference function still covers every lag because
+     * the cumulative normalisation needs them.
+     */
+    void setMinLag(std::size_t minLag) noexcept { m_minLag = minLag < 2 ? 2 : minLag; }
+
+    /**
+     * Dispatch processBuffer() to the measured-fastest difference kernel for each
+     * window size @p wisdom covers; other sizes keep the direct kernel.
+     * processFrames() consults it too. Allocates the FFT scratch up front, so
+     * call it before audio starts.
+     */
+    void setKernelWisdom(const KernelWisdom& wisdom);
+
+    /** Kernel processBuffer() uses at the active window size. */
+    [[nodiscard]] DifferenceKernelKind getKernel() const noexcept { return m_kernelChoice.kind; }
+
     void setThreshold(double threshold) noexcept;
 
+    /**
+     * Takes effect from the next analysis. Parabolic by default. The first switch
+     * to Sinc in a process builds its kernel table, so make it off the audio thread.
+     */
+    void setLagRefinement(LagRefinement refinement) noexcept;
+
+    [[nodiscard]] LagRefinement getLagRefinement() const noexcept { return m_refinement; }
+
     [[nodiscard]] double getThreshold() const noexcept { return m_threshold; }
 
+    /**
+     * Append the candidates of every frame analyzed from now on to @p log
+     * (nullptr stops). Appending allocates, so this is for offline analysis; a
+     * log can later be re-decoded at any threshold without the audio.
+     */
+    void setCandidateLog(CandidateLog* log) noexcept { m_candidateLog = log; }
+
+    /**
+     * The result the detector would have produced at @p threshold for a frame
+     * with these candidates. Matches processBuffer() exactly.
+     */
+    [[nodiscard]] static PitchResult decodeCandidates(const LagCandidate* candidates, std::size_t count,
+                                                      double threshold, double sampleRate);
+
+    /** Threshold as setThreshold() clamps it. */
+    [[nodiscard]] static double clampThreshold(double threshold) noexcept;
+
 private:
     double m_sampleRate;
+    // Allocation size; m_bufferSize / m_maxLag are the active window and lag range.
+    std::size_t m_capacity;
     std::size_t m_bufferSize;
     std::size_t m_maxLag;
+    std::size_t m_minLag{2};
     double m_threshold;
+    LagRefinement m_refinement{LagRefinement::Parabolic};
 
     std::vector<double> m_difference;
     std::vector<double> m_cumulative;
 
+    // processFrames() scratch: per-frame difference rows and per-chunk lag sums.
+    std::vector<double> m_batchDifference;
+    std::vector<double> m_chunkSums;
+    std::vector<double> m_chunkHeads;
+
+    struct KernelSlot {
+        std::size_t windowSize;
+        DifferenceKernelChoice choice;
+    };
+
+    DifferenceKernel m_kernel;
+    std::vector<KernelSlot> m_kernelTable;
+    DifferenceKernelChoice m_kernelChoice;
+
     PitchResult m_lastResult;
+    CandidateLog* m_candidateLog{nullptr};
 
+    void selectKernel() noexcept;
     void computeDifference(const float* samples);
-    void computeCumulativeMeanNormalized();
+    void computeBatchDifference(const float* samples, std::size_t frames, std::size_t hop);
+    [[nodiscard]] bool fftBeatsBatch(std::size_t hop) const noexcept;
+    PitchResult resultFromDifference(const double* difference);
+    void computeCumulativeMeanNormalized(const double* difference);
     std::size_t absoluteThreshold(double& probability) const;
+    void recordCandidates(const double* difference);
+    static PitchResult resultFromPeriod(double sampleRate, double period, double probability);
+    [[nodiscard]] double refineLag(std::size_t tau, const double* difference) const;
     static double parabolicInterpolation(std::size_t tau, const std::vector<double>& values);
     static double midiFromFrequency(double frequency);
     static std::string noteNameFromMidi(double midi);
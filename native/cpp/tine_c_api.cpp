@@ -0,0 +1,443 @@
+#include "tine_c_api.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <new>
+#include <string>
+
+#include "BroadcastRingBuffer.hpp"
+#include "PitchEngine.hpp"
+#include "YinPitchDetector.hpp"
+
+using tine::dsp::BroadcastRingBuffer;
+using tine::dsp::ConsumerMode;
+using tine::dsp::EngineMode;
+using tine::dsp::OverflowPolicy;
+using tine::dsp::PitchEngine;
+using tine::dsp::PitchEngineConfig;
+using tine::dsp::PitchResult;
+using tine::dsp::YinPitchDetector;
+
+struct tine_detector {
+    YinPitchDetector detector;
+    // processFrames() needs C++ results; kept here so the hot path never allocates
+    // once a batch of this size has been seen.
+    std::unique_ptr<PitchResult[]> batch;
+    std::size_t batchCapacity{0};
+
+    tine_detector(double sampleRate, std::size_t window, double threshold) : detector(sampleRate, window, threshold) {}
+};
+
+struct tine_ring {
+    BroadcastRingBuffer* ring;
+    std::unique_ptr<BroadcastRingBuffer> owned;
+};
+
+struct tine_engine {
+    std::unique_ptr<PitchEngine> engine;
+    tine_ring captureRing{};
+    tine_result_callback callback{nullptr};
+    void* userData{nullptr};
+    tine_pitch_result* sink{nullptr};
+    std::size_t sinkCapacity{0};
+    std::size_t produced{0};
+};
+
+namespace {
+
+// Set only while tine_engine_process_pending() runs, so results the capture
+// thread produces in inline mode never touch the caller's array.
+thread_local tine_engine* t_draining = nullptr;
+
+// Layouts shipped in 1.0; anything shorter predates the API and is rejected.
+constexpr std::size_t DETECTOR_CONFIG_V1_SIZE = offsetof(tine_detector_config, threshold) + sizeof(double);
+constexpr std::size_t ENGINE_CONFIG_V1_SIZE = offsetof(tine_engine_config, threshold) + sizeof(double);
+
+bool aligned(const void* pointer, std::uintptr_t alignment) {
+    return reinterpret_cast<std::uintptr_t>(pointer) % alignment == 0;
+}
+
+/**
+ * Copy the prefix of @p config the caller knows about over @p defaults, so a
+ * caller built against an older minor version gets defaults for appended fields
+ * and a newer one's extra fields are ignored.
+ * @return False when struct_size is below @p minimumSize.
+ */
+template <typename Config>
+bool readConfig(const Config& config, std::size_t minimumSize, Config& defaults) {
+    if (config.struct_size < minimumSize) {
+        return false;
+    }
+    std::memcpy(&defaults, &config, std::min<std::size_t>(config.struct_size, sizeof(Config)));
+    return true;
+}
+
+void toCResult(const PitchResult& result, tine_pitch_result& out) {
+    out.frequency = result.frequency;
+    out.midi = result.midi;
+    out.cents = result.cents;
+    out.probability = result.probability;
+    out.is_valid = result.isValid ? 1 : 0;
+    out.reserved = 0;
+    if (result.isValid && result.frequency > 0.0) {
+        const auto nearest = static_cast<int32_t>(std::lround(result.midi));
+        out.note_index = ((nearest % 12) + 12) % 12;
+        out.octave = static_cast<int32_t>(std::floor(nearest / 12.0)) - 1;
+    } else {
+        out.note_index = -1;
+        out.octave = 0;
+    }
+}
+
+void deliver(tine_engine* wrapper, const PitchResult& result) {
+    tine_pitch_result converted;
+    toCResult(result, converted);
+    if (wrapper->callback) {
+        wrapper->callback(wrapper->userData, &converted);
+        return;
+    }
+    if (t_draining != wrapper) {
+        return;
+    }
+    if (wrapper->produced < wrapper->sinkCapacity) {
+        wrapper->sink[wrapper->produced] = converted;
+    }
+    ++wrapper->produced;
+}
+
+}  // namespace
+
+extern "C" {
+
+uint32_t tine_api_version(void) {
+    return TINE_C_API_VERSION;
+}
+
+const char* tine_status_string(tine_status status) {
+    switch (status) {
+        case TINE_OK:
+            return "ok";
+        case TINE_ERR_INVALID_ARGUMENT:
+            return "invalid argument";
+        case TINE_ERR_OUT_OF_MEMORY:
+            return "out of memory";
+        case TINE_ERR_MISALIGNED:
+            return "misaligned buffer";
+        case TINE_ERR_BUFFER_TOO_SMALL:
+            return "result buffer too small";
+        case TINE_ERR_VERSION:
+            return "unsupported config version";
+    }
+    return "unknown status";
+}
+
+void tine_detector_config_init(tine_detector_config* config) {
+    if (!config) {
+        return;
+    }
+    *config = tine_detector_config{};
+    config->struct_size = sizeof(tine_detector_config);
+    config->window_size = 2048;
+    config->sample_rate = 48000.0;
+    config->threshold = 0.1;
+}
+
+tine_status tine_detector_create(const tine_detector_config* config, tine_detector** out_detector) {
+    if (!config || !out_detector) {
+        return TINE_ERR_INVALID_ARGUMENT;
+    }
+    *out_detector = nullptr;
+    tine_detector_config settings;
+    tine_detector_config_init(&settings);
+    if (!readConfig(*config, DETECTOR_CONFIG_V1_SIZE, settings)) {
+        return TINE_ERR_VERSION;
+    }
+    if (settings.window_size < 4 || !(settings.sample_rate > 0.0)) {
+        return TINE_ERR_INVALID_ARGUMENT;
+    }
+    try {
+        *out_detector = new tine_detector(settings.sample_rate, settings.window_size, settings.threshold);
+    } catch (const std::bad_alloc&) {
+        return TINE_ERR_OUT_OF_MEMORY;
+    }
+    return TINE_OK;
+}
+
+void tine_detector_destroy(tine_detector* detector) {
+    delete detector;
+}
+
+tine_status tine_detector_process(tine_detector* detector, const float* samples, size_t frames,
+                                  tine_pitch_result* out_result) {
+    if (!detector || !samples || !out_result || frames < detector->detector.getActiveSize()) {
+        return TINE_ERR_INVALID_ARGUMENT;
+    }
+    if (!aligned(samples, TINE_SAMPLE_ALIGNMENT) || !aligned(out_result, TINE_RESULT_ALIGNMENT)) {
+        return TINE_ERR_MISALIGNED;
+    }
+    toCResult(detector->detector.processBuffer(samples, frames), *out_result);
+    return TINE_OK;
+}
+
+tine_status tine_detector_process_frames(tine_detector* detector, const float* samples, size_t frames, size_t hop,
+                                         tine_pitch_result* out_results, size_t capacity, size_t* out_written) {
+    if (out_written) {
+        *out_written = 0;
+    }
+    if (!detector || !samples || !out_results || capacity == 0 || hop == 0) {
+        return TINE_ERR_INVALID_ARGUMENT;
+    }
+    if (!aligned(samples, TINE_SAMPLE_ALIGNMENT) || !aligned(out_results, TINE_RESULT_ALIGNMENT)) {
+        return TINE_ERR_MISALIGNED;
+    }
+    if (capacity > detector->batchCapacity) {
+        PitchResult* batch = new (std::nothrow) PitchResult[capacity];
+        if (!batch) {
+            return TINE_ERR_OUT_OF_MEMORY;
+        }
+        detector->batch.reset(batch);
+        detector->batchCapacity = capacity;
+    }
+
+    const std::size_t written =
+        detector->detector.processFrames(samples, frames, hop, detector->batch.get(), capacity);
+    for (std::size_t i = 0; i < written; ++i) {
+        toCResult(detector->batch[i], out_results[i]);
+    }
+    if (out_written) {
+        *out_written = written;
+    }
+    return TINE_OK;
+}
+
+tine_status tine_detector_set_threshold(tine_detector* detector, double threshold) {
+    if (!detector) {
+        return TINE_ERR_INVALID_ARGUMENT;
+    }
+    detector->detector.setThreshold(threshold);
+    return TINE_OK;
+}
+
+tine_status tine_ring_create(size_t capacity_frames, size_t max_consumers, tine_ring** out_ring) {
+    if (!out_ring) {
+        return TINE_ERR_INVALID_ARGUMENT;
+    }
+    *out_ring = nullptr;
+    if (capacity_frames == 0) {
+        return TINE_ERR_INVALID_ARGUMENT;
+    }
+    try {
+        auto ring = std::make_unique<BroadcastRingBuffer>(capacity_frames, max_consumers);
+        BroadcastRingBuffer* raw = ring.get();
+        *out_ring = new tine_ring{raw, std::move(ring)};
+    } catch (const std::bad_alloc&) {
+        return TINE_ERR_OUT_OF_MEMORY;
+    }
+    return TINE_OK;
+}
+
+void tine_ring_destroy(tine_ring* ring) {
+    if (ring && ring->owned) {
+        delete ring;
+    }
+}
+
+int32_t tine_ring_add_consumer(tine_ring* ring, tine_consumer_mode mode, size_t resync_frames) {
+    if (!ring) {
+        return BroadcastRingBuffer::kInvalidConsumer;
+    }
+    return ring->ring->addConsumer(mode == TINE_CONSUMER_BLOCKING ? ConsumerMode::Blocking : ConsumerMode::Lagging,
+                                   resync_frames);
+}
+
+void tine_ring_remove_consumer(tine_ring* ring, int32_t consumer) {
+    if (ring) {
+        ring->ring->removeConsumer(consumer);
+    }
+}
+
+size_t tine_ring_write(tine_ring* ring, const float* samples, size_t frames) {
+    if (!ring || (!samples && frames > 0) || !aligned(samples, TINE_SAMPLE_ALIGNMENT)) {
+        return 0;
+    }
+    return ring->ring->write(samples, frames);
+}
+
+size_t tine_ring_read(tine_ring* ring, int32_t consumer, float* dst, size_t frames, size_t* out_lost) {
+    if (out_lost) {
+        *out_lost = 0;
+    }
+    if (!ring || (!dst && frames > 0) || !aligned(dst, TINE_SAMPLE_ALIGNMENT)) {
+        return 0;
+    }
+    return ring->ring->read(consumer, dst, frames, out_lost);
+}
+
+size_t tine_ring_available(const tine_ring* ring, int32_t consumer) {
+    return ring ? ring->ring->available(consumer) : 0;
+}
+
+size_t tine_ring_capacity(const tine_ring* ring) {
+    return ring ? ring->ring->capacity() : 0;
+}
+
+void tine_engine_config_init(tine_engine_config* config) {
+    if (!config) {
+        return;
+    }
+    const PitchEngineConfig defaults;
+    *config = tine_engine_config{};
+    config->struct_size = sizeof(tine_engine_config);
+    config->window_size = static_cast<uint32_t>(defaults.windowSize);
+    config->hop_size = static_cast<uint32_t>(defaults.hopSize);
+    config->ring_capacity = static_cast<uint32_t>(defaults.ringCapacity);
+    config->capture_block_frames = static_cast<uint32_t>(defaults.captureBlockFrames);
+    config->mode = TINE_ENGINE_WORKER;
+    config->overwrite_oldest = defaults.overflow == OverflowPolicy::OverwriteOldest ? 1 : 0;
+    config->adaptive_window = defaults.adaptiveWindow ? 1 : 0;
+    config->sample_rate = defaults.sampleRate;
+    config->threshold = defaults.threshold;
+}
+
+tine_status tine_engine_create(const tine_engine_config* config, tine_engine** out_engine) {
+    if (!config || !out_engine) {
+        return TINE_ERR_INVALID_ARGUMENT;
+    }
+    *out_engine = nullptr;
+    tine_engine_config settings;
+    tine_engine_config_init(&settings);
+    if (!readConfig(*config, ENGINE_CONFIG_V1_SIZE, settings)) {
+        return TINE_ERR_VERSION;
+    }
+    if (settings.window_size < 4 || settings.hop_size == 0 || !(settings.sample_rate > 0.0)) {
+        return TINE_ERR_INVALID_ARGUMENT;
+    }
+
+    PitchEngineConfig engineConfig;
+    engineConfig.sampleRate = settings.sample_rate;
+    engineConfig.windowSize = settings.window_size;
+    engineConfig.hopSize = settings.hop_size;
+    engineConfig.ringCapacity = settings.ring_capacity;
+    engineConfig.captureBlockFrames = settings.capture_block_frames;
+    engineConfig.mode = settings.mode == TINE_ENGINE_INLINE ? EngineMode::Inline : EngineMode::Worker;
+    engineConfig.overflow = settings.overwrite_oldest ? OverflowPolicy::OverwriteOldest : OverflowPolicy::DropNewest;
+    engineConfig.adaptiveWindow = settings.adaptive_window != 0;
+    engineConfig.threshold = settings.threshold;
+
+    try {
+        auto wrapper = std::make_unique<tine_engine>();
+        wrapper->engine = std::make_unique<PitchEngine>(engineConfig);
+        wrapper->captureRing.ring = &wrapper->engine->captureRing();
+        tine_engine* raw = wrapper.get();
+        wrapper->engine->setResultHandler([raw](const PitchResult& result) { deliver(raw, result); });
+        *out_engine = wrapper.release();
+    } catch (const std::bad_alloc&) {
+        return TINE_ERR_OUT_OF_MEMORY;
+    }
+    return TINE_OK;
+}
+
+void tine_engine_destroy(tine_engine* engine) {
+    delete engine;
+}
+
+size_t tine_engine_push(tine_engine* engine, const float* samples, size_t frames) {
+    if (!engine || !samples || !aligned(samples, TINE_SAMPLE_ALIGNMENT)) {
+        return 0;
+    }
+    return engine->engine->pushAudio(samples, frames);
+}
+
+tine_status tine_engine_process_pending(tine_engine* engine, tine_pitch_result* out_results, size_t capacity,
+                                        size_t* out_written) {
+    if (out_written) {
+        *out_written = 0;
+    }
+    if (!engine || (!out_results && capacity > 0)) {
+        return TINE_ERR_INVALID_ARGUMENT;
+    }
+    if (out_results && !aligned(out_results, TINE_RESULT_ALIGNMENT)) {
+        return TINE_ERR_MISALIGNED;
+    }
+
+    engine->sink = out_results;
+    engine->sinkCapacity = capacity;
+    engine->produced = 0;
+    t_draining = engine;
+    const std::size_t emitted = engine->engine->processPending();
+    t_draining = nullptr;
+
+    if (engine->callback) {
+        if (out_written) {
+            *out_written = emitted;
+        }
+        return TINE_OK;
+    }
+    if (out_written) {
+        *out_written = engine->produced < capacity ? engine->produced : capacity;
+    }
+    return engine->produced > capacity ? TINE_ERR_BUFFER_TOO_SMALL : TINE_OK;
+}
+
+tine_status tine_engine_set_result_callback(tine_engine* engine, tine_result_callback callback, void* user_data) {
+    if (!engine) {
+        return TINE_ERR_INVALID_ARGUMENT;
+    }
+    engine->callback = callback;
+    engine->userData = user_data;
+    return TINE_OK;
+}
+
+tine_status tine_engine_set_threshold(tine_engine* engine, double threshold) {
+    if (!engine) {
+        return TINE_ERR_INVALID_ARGUMENT;
+    }
+    engine->engine->setThreshold(threshold);
+    return TINE_OK;
+}
+
+uint64_t tine_engine_lost_frames(const tine_engine* engine) {
+    return engine ? engine->engine->lostFrames() : 0;
+}
+
+uint64_t tine_engine_overruns(const tine_engine* engine) {
+    return engine ? engine->engine->overruns() : 0;
+}
+
+size_t tine_engine_active_window(const tine_engine* engine) {
+    return engine ? engine->engine->activeWindow() : 0;
+}
+
+int32_t tine_engine_inline_active(const tine_engine* engine) {
+    return engine && engine->engine->inlineActive() ? 1 : 0;
+}
+
+tine_ring* tine_engine_capture_ring(tine_engine* engine) {
+    return engine ? &engine->captureRing : nullptr;
+}
+
+tine_status tine_engine_metrics_text(const tine_engine* engine, char* buffer, size_t capacity, size_t* out_length) {
+    if (!engine || (!buffer && capacity > 0)) {
+        return TINE_ERR_INVALID_ARGUMENT;
+    }
+    std::string text;
+    try {
+        text = engine->engine->metrics().snapshot().toText();
+    } catch (const std::bad_alloc&) {
+        return TINE_ERR_OUT_OF_MEMORY;
+    }
+    if (out_length) {
+        *out_length = text.size();
+    }
+    if (text.size() >= capacity) {
+        return TINE_ERR_BUFFER_TOO_SMALL;
+    }
+    std::memcpy(buffer, text.c_str(), text.size() + 1);
+    return TINE_OK;
+}
+
+}  // extern "C"
@@ -0,0 +1,213 @@
+/*
+ * Stable C interface to the native pitch core for hosts that cannot consume C++
+ * types: JNI, WASM glue, Python ctypes/cffi, daemons.
+ *
+ * Conventions:
+ *  - Every object is an opaque handle created by tine_*_create() and released
+ *    by the matching tine_*_destroy(). Destroy accepts NULL.
+ *  - Audio is passed as caller-owned spans (pointer + frame count) and is never
+ *    retained after the call returns; nothing is copied beyond what the engine
+ *    itself buffers.
+ *  - Results are written into caller-provided arrays.
+ *  - Config structs start with struct_size so fields can be appended without
+ *    breaking older callers; always fill them with the *_config_init() function.
+ *    Fields beyond a caller's struct_size take their defaults.
+ *  - Functions never throw or abort; failures are reported as tine_status.
+ *
+ * Alignment: sample spans must be aligned to TINE_SAMPLE_ALIGNMENT and result
+ * arrays to TINE_RESULT_ALIGNMENT, otherwise TINE_ERR_MISALIGNED is returned.
+ * TINE_PREFERRED_ALIGNMENT avoids split loads but is not required.
+ *
+ * Threading matches the C++ classes: a detector is single-threaded; an engine
+ * takes tine_engine_push() from one capture thread and
+ * tine_engine_process_pending() from one worker thread.
+ */
+#ifndef TINE_NATIVE_C_API_H
+#define TINE_NATIVE_C_API_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define TINE_C_API_VERSION_MAJOR 1
+#define TINE_C_API_VERSION_MINOR 1
+#define TINE_C_API_VERSION ((TINE_C_API_VERSION_MAJOR << 16) | TINE_C_API_VERSION_MINOR)
+
+#define TINE_SAMPLE_ALIGNMENT 4
+#define TINE_RESULT_ALIGNMENT 8
+#define TINE_PREFERRED_ALIGNMENT 16
+
+typedef enum tine_status {
+    TINE_OK = 0,
+    TINE_ERR_INVALID_ARGUMENT = -1,
+    TINE_ERR_OUT_OF_MEMORY = -2,
+    TINE_ERR_MISALIGNED = -3,
+    /** More results were produced than the caller's array holds; the rest were discarded. */
+    TINE_ERR_BUFFER_TOO_SMALL = -4,
+    /** The config's struct_size is smaller than the first released layout. */
+    TINE_ERR_VERSION = -5
+} tine_status;
+
+typedef struct tine_pitch_result {
+    double frequency;
+    double midi;
+    double cents;
+    double probability;
+    int32_t is_valid;
+    /** Pitch class of the nearest note, 0 = C ... 11 = B; -1 when invalid. */
+    int32_t note_index;
+    /** Scientific-pitch octave of the nearest note (A4 = 440 Hz). */
+    int32_t octave;
+    int32_t reserved;
+} tine_pitch_result;
+
+/** Runtime version; compare the major part with TINE_C_API_VERSION_MAJOR. */
+uint32_t tine_api_version(void);
+
+/** Static, human-readable name for a status code. */
+const char* tine_status_string(tine_status status);
+
+/* ---------------------------------------------------------------- detector */
+
+typedef struct tine_detector tine_detector;
+
+typedef struct tine_detector_config {
+    uint32_t struct_size;
+    uint32_t window_size;
+    double sample_rate;
+    double threshold;
+} tine_detector_config;
+
+void tine_detector_config_init(tine_detector_config* config);
+
+tine_status tine_detector_create(const tine_detector_config* config, tine_detector** out_detector);
+void tine_detector_destroy(tine_detector* detector);
+
+/** Analyze the first window_size samples of a span of at least that many frames. */
+tine_status tine_detector_process(tine_detector* detector, const float* samples, size_t frames,
+                                  tine_pitch_result* out_result);
+
+/**
+ * Analyze consecutive windows every @p hop frames in one batched pass; writes up
+ * to @p capacity results and the count to @p out_written.
+ */
+tine_status tine_detector_process_frames(tine_detector* detector, const float* samples, size_t frames, size_t hop,
+                                         tine_pitch_result* out_results, size_t capacity, size_t* out_written);
+
+tine_status tine_detector_set_threshold(tine_detector* detector, double threshold);
+
+/* -------------------------------------------------------------------- ring */
+
+typedef struct tine_ring tine_ring;
+
+typedef enum tine_consumer_mode {
+    /** Holds the producer back rather than being overwritten. */
+    TINE_CONSUMER_BLOCKING = 0,
+    /** Never holds the producer back; overwritten frames are skipped and counted. */
+    TINE_CONSUMER_LAGGING = 1
+} tine_consumer_mode;
+
+/** Single-producer, multi-consumer float ring; capacity rounds up to a power of two. */
+tine_status tine_ring_create(size_t capacity_frames, size_t max_consumers, tine_ring** out_ring);
+
+/** Releases an owned ring; a borrowed ring from tine_engine_capture_ring() is ignored. */
+void tine_ring_destroy(tine_ring* ring);
+
+/** @return Consumer id >= 0, or -1 when every slot is taken. */
+int32_t tine_ring_add_consumer(tine_ring* ring, tine_consumer_mode mode, size_t resync_frames);
+void tine_ring_remove_consumer(tine_ring* ring, int32_t consumer);
+
+/**
+ * @return Frames written; fewer than @p frames when a blocking consumer is
+ *         behind, and 0 for a NULL or misaligned span.
+ */
+size_t tine_ring_write(tine_ring* ring, const float* samples, size_t frames);
+
+/**
+ * @return Frames copied into @p dst, 0 for a NULL or misaligned one; @p out_lost
+ *         (may be NULL) receives frames skipped first.
+ */
+size_t tine_ring_read(tine_ring* ring, int32_t consumer, float* dst, size_t frames, size_t* out_lost);
+
+size_t tine_ring_available(const tine_ring* ring, int32_t consumer);
+size_t tine_ring_capacity(const tine_ring* ring);
+
+/* ------------------------------------------------------------------ engine */
+
+typedef struct tine_engine tine_engine;
+
+typedef enum tine_engine_mode {
+    TINE_ENGINE_WORKER = 0,
+    /** Analyze on the pushing thread while the detector fits the capture budget. */
+    TINE_ENGINE_INLINE = 1
+} tine_engine_mode;
+
+typedef struct tine_engine_config {
+    uint32_t struct_size;
+    uint32_t window_size;
+    uint32_t hop_size;
+    uint32_t ring_capacity;
+    uint32_t capture_block_frames;
+    int32_t mode;
+    /** Nonzero: overwrite the oldest unread audio under load instead of dropping new audio. */
+    int32_t overwrite_oldest;
+    int32_t adaptive_window;
+    double sample_rate;
+    double threshold;
+} tine_engine_config;
+
+/**
+ * Receives each result as it is produced, on the thread that produced it (the
+ * pushing thread in inline mode). Must not call back into the engine.
+ */
+typedef void (*tine_result_callback)(void* user_data, const tine_pitch_result* result);
+
+void tine_engine_config_init(tine_engine_config* config);
+
+tine_status tine_engine_create(const tine_engine_config* config, tine_engine** out_engine);
+void tine_engine_destroy(tine_engine* engine);
+
+/** Capture thread: hand over a span of mono samples. @return Frames accepted. */
+size_t tine_engine_push(tine_engine* engine, const float* samples, size_t frames);
+
+/**
+ * Worker thread: analyze every complete hop. Results go to the callback when one
+ * is set, otherwise into @p out_results (up to @p capacity; may be NULL with 0).
+ * @p out_written (may be NULL) receives the number of results produced. In
+ * inline mode, results produced inside tine_engine_push() reach only the callback.
+ */
+tine_status tine_engine_process_pending(tine_engine* engine, tine_pitch_result* out_results, size_t capacity,
+                                        size_t* out_written);
+
+/** Set before audio flows; NULL restores array delivery. */
+tine_status tine_engine_set_result_callback(tine_engine* engine, tine_result_callback callback, void* user_data);
+
+tine_status tine_engine_set_threshold(tine_engine* engine, double threshold);
+
+uint64_t tine_engine_lost_frames(const tine_engine* engine);
+uint64_t tine_engine_overruns(const tine_engine* engine);
+size_t tine_engine_active_window(const tine_engine* engine);
+int32_t tine_engine_inline_active(const tine_engine* engine);
+
+/**
+ * The engine's capture ring, for registering extra consumers (meters,
+ * recorders). Borrowed: valid until the engine is destroyed.
+ */
+tine_ring* tine_engine_capture_ring(tine_engine* engine);
+
+/**
+ * Snapshot the engine's metrics in Prometheus text exposition format, NUL
+ * terminated. @p out_length (may be NULL) receives the length excluding the
+ * terminator; when it does not fit, TINE_ERR_BUFFER_TOO_SMALL is returned and
+ * @p out_length says how much to allocate. Safe from any thread. Since 1.1.
+ */
+tine_status tine_engine_metrics_text(const tine_engine* engine, char* buffer, size_t capacity, size_t* out_length);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* TINE_NATIVE_C_API_H */
@@ -0,0 +1,40 @@
+#ifndef TINE_NATIVE_TESTS_ALLOCATIONCOUNTER_HPP
+#define TINE_NATIVE_TESTS_ALLOCATIONCOUNTER_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+
+/**
+ * Replaces the global operator new so a test can assert that a real-time path
+ * never allocates. Replacement functions may not be inline, so include this
+ * from the test program's one translation unit only.
+ */
+
+namespace tine::test {
+
+inline std::atomic<std::size_t>& allocations() {
+    static std::atomic<std::size_t> count{0};
+    return count;
+}
+
+}  // namespace tine::test
+
+void* operator new(std::size_t size) {
+    tine::test::allocations().fetch_add(1, std::memory_order_relaxed);
+    if (void* p = std::malloc(size > 0 ? size : 1)) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept {
+    std::free(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept {
+    std::free(p);
+}
+
+#endif  // TINE_NATIVE_TESTS_ALLOCATIONCOUNTER_HPP
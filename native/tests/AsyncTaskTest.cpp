@@ -0,0 +1,83 @@
+// spawn() with a WaitGroup: tasks that throw are counted as failed and keep
+// their first exception, and neither the process nor the tasks spawned next to
+// them are taken down.
+//
+// Build (from the repository root):
+//   c++ -std=c++20 -O2 -pthread -Inative/cpp -Inative/tests native/tests/AsyncTaskTest.cpp
+//       native/cpp/AsyncScheduler.cpp native/cpp/ThreadPool.cpp native/cpp/ThreadConfig.cpp
+//       -o async_task_test
+//   ./async_task_test
+
+#include <atomic>
+#include <cstddef>
+#include <stdexcept>
+#include <string>
+
+#include "AsyncScheduler.hpp"
+#include "AsyncTask.hpp"
+#include "TestSupport.hpp"
+
+using namespace tine::dsp;
+
+namespace {
+
+Task<int> step(AsyncScheduler& scheduler, int value) {
+    co_await scheduler.yield();
+    if (value < 0) {
+        throw std::runtime_error("stream " + std::to_string(-value) + " failed");
+    }
+    co_return value;
+}
+
+Task<void> stream(AsyncScheduler& scheduler, int value, std::atomic<int>& total) {
+    for (int i = 0; i < 4; ++i) {
+        total.fetch_add(co_await step(scheduler, i == 2 ? value : 1), std::memory_order_relaxed);
+    }
+}
+
+void testFailedStreams(AsyncScheduler& scheduler) {
+    std::atomic<int> total{0};
+    WaitGroup group;
+    for (int i = 0; i < 8; ++i) {
+        // Streams 3 and 5 throw at their third step.
+        spawn(scheduler, stream(scheduler, i == 3 || i == 5 ? -i : 1, total), &group);
+    }
+    group.wait();
+
+    TINE_CHECK(group.failed() == 2);
+    // Six streams add 4 each, the failed two 2 each before throwing.
+    TINE_CHECK(total.load() == 6 * 4 + 2 * 2);
+    const std::exception_ptr error = group.firstError();
+    TINE_CHECK(error != nullptr);
+    try {
+        std::rethrow_exception(error);
+    } catch (const std::runtime_error& thrown) {
+        const std::string message = thrown.what();
+        TINE_CHECK(message == "stream 3 failed" || message == "stream 5 failed");
+    }
+}
+
+void testCleanGroup(AsyncScheduler& scheduler) {
+    std::atomic<int> total{0};
+    WaitGroup group;
+    for (int i = 0; i < 4; ++i) {
+        spawn(scheduler, stream(scheduler, 1, total), &group);
+    }
+    group.wait();
+    TINE_CHECK(group.failed() == 0);
+    TINE_CHECK(group.firstError() == nullptr);
+    TINE_CHECK(total.load() == 16);
+}
+
+}  // namespace
+
+int main() {
+    ThreadPoolConfig poolConfig;
+    poolConfig.normalWorkers = 2;
+    ThreadPool pool(poolConfig);
+    AsyncScheduler scheduler(pool);
+
+    testFailedStreams(scheduler);
+    testCleanGroup(scheduler);
+    return tine::test::finish("AsyncTaskTest");
+}
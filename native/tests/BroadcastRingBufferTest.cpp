@@ -0,0 +1,177 @@
+// BroadcastRingBuffer loss accounting: Blocking consumers hold the producer back
+// and never lose frames; Lagging ones are lapped, resume resyncFrames behind
+// the producer, and report exactly the frames they skipped, also while the
+// producer keeps writing on another thread.
+//
+// Build (from the repository root):
+//   c++ -std=c++20 -O2 -pthread -Inative/cpp -Inative/tests native/tests/BroadcastRingBufferTest.cpp
+//       native/cpp/BroadcastRingBuffer.cpp -o broadcast_ring_buffer_test
+//   ./broadcast_ring_buffer_test
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+#include "BroadcastRingBuffer.hpp"
+#include "TestSupport.hpp"
+
+using namespace tine::dsp;
+
+namespace {
+
+// Samples carry their stream index, so a reader can tell exactly which frames
+// it received. Indices stay below 2^24, where floats hold integers exactly.
+class Counter {
+public:
+    const float* next(std::size_t frames) {
+        m_block.resize(frames);
+        for (float& sample : m_block) {
+            sample = static_cast<float>(m_index++);
+        }
+        return m_block.data();
+    }
+    void rewind(std::size_t frames) { m_index -= frames; }
+    [[nodiscard]] std::uint64_t index() const { return m_index; }
+
+private:
+    std::vector<float> m_block;
+    std::uint64_t m_index{0};
+};
+
+void testBlocking() {
+    BroadcastRingBuffer ring(256, 2);
+    TINE_CHECK(ring.capacity() == 256);
+    const auto consumer = ring.addConsumer(ConsumerMode::Blocking);
+    Counter counter;
+
+    // The producer writes only what the consumer has room for; the rest is its loss, not the consumer's.
+    TINE_CHECK(ring.write(counter.next(300), 300) == 256);
+    counter.rewind(44);
+    TINE_CHECK(ring.write(counter.next(1), 1) == 0);
+    counter.rewind(1);
+
+    std::vector<float> out(128);
+    std::size_t lost = 99;
+    TINE_CHECK(ring.read(consumer, out.data(), out.size(), &lost) == 128);
+    TINE_CHECK(lost == 0);
+    TINE_CHECK(out[0] == 0.0F && out[127] == 127.0F);
+    TINE_CHECK(ring.write(counter.next(200), 200) == 128);
+    counter.rewind(72);
+    TINE_CHECK(ring.available(consumer) == 256);
+    TINE_CHECK(ring.read(consumer, out.data(), out.size(), &lost) == 128);
+    TINE_CHECK(out[0] == 128.0F);
+    TINE_CHECK(ring.lostFrames(consumer) == 0 && ring.overruns(consumer) == 0);
+}
+
+void testLappedLagging() {
+    BroadcastRingBuffer ring(256, 2);
+    const auto lagging = ring.addConsumer(ConsumerMode::Lagging, 64);
+    Counter counter;
+    for (int i = 0; i < 10; ++i) {
+        TINE_CHECK(ring.write(counter.next(100), 100) == 100);
+    }
+    TINE_CHECK(ring.available(lagging) == 256);
+
+    // Lapped: resume 64 frames behind the producer and count everything before.
+    std::vector<float> out(256);
+    std::size_t lost = 0;
+    TINE_CHECK(ring.read(lagging, out.data(), out.size(), &lost) == 64);
+    TINE_CHECK(lost == 1000 - 64);
+    TINE_CHECK(out[0] == 936.0F && out[63] == 999.0F);
+    TINE_CHECK(ring.lostFrames(lagging) == 936 && ring.overruns(lagging) == 1);
+
+    // Within capacity again: no further loss.
+    TINE_CHECK(ring.write(counter.next(200), 200) == 200);
+    TINE_CHECK(ring.read(lagging, out.data(), out.size(), &lost) == 200);
+    TINE_CHECK(lost == 0 && out[0] == 1000.0F);
+    TINE_CHECK(ring.lostFrames(lagging) == 936 && ring.overruns(lagging) == 1);
+
+    // Default resync keeps half the ring.
+    const auto halfway = ring.addConsumer(ConsumerMode::Lagging);
+    TINE_CHECK(ring.write(counter.next(200), 200) == 200);
+    TINE_CHECK(ring.write(counter.next(200), 200) == 200);
+    TINE_CHECK(ring.read(halfway, out.data(), out.size(), &lost) == 128);
+    TINE_CHECK(lost == 400 - 128);
+}
+
+void testMixedConsumers() {
+    // A Blocking consumer bounds the producer, so a Lagging one reading no slower is never lapped.
+    BroadcastRingBuffer ring(128, 3);
+    const auto blocking = ring.addConsumer(ConsumerMode::Blocking);
+    const auto lagging = ring.addConsumer(ConsumerMode::Lagging);
+    Counter counter;
+    std::vector<float> out(48);
+    std::uint64_t written = 0;
+    for (int round = 0; round < 50; ++round) {
+        const std::size_t accepted = ring.write(counter.next(80), 80);
+        counter.rewind(80 - accepted);
+        written += accepted;
+        static_cast<void>(ring.read(blocking, out.data(), out.size()));
+        static_cast<void>(ring.read(lagging, out.data(), out.size()));
+    }
+    TINE_CHECK(written < 50 * 80);
+    TINE_CHECK(ring.lostFrames(blocking) == 0 && ring.lostFrames(lagging) == 0);
+
+    // Slots: a third consumer fits, a fourth does not until one is removed.
+    const auto third = ring.addConsumer(ConsumerMode::Lagging);
+    TINE_CHECK(third != BroadcastRingBuffer::kInvalidConsumer);
+    TINE_CHECK(ring.addConsumer(ConsumerMode::Lagging) == BroadcastRingBuffer::kInvalidConsumer);
+    ring.removeConsumer(third);
+    TINE_CHECK(ring.consumerCount() == 2);
+    TINE_CHECK(ring.addConsumer(ConsumerMode::Blocking) != BroadcastRingBuffer::kInvalidConsumer);
+}
+
+void testConcurrentAccounting() {
+    constexpr std::size_t kBlock = 96;
+    constexpr std::uint64_t kTotal = kBlock * 40'000;
+    BroadcastRingBuffer ring(1024, 1);
+    const auto lagging = ring.addConsumer(ConsumerMode::Lagging, 256);
+
+    std::atomic<bool> done{false};
+    std::thread producer([&] {
+        Counter counter;
+        while (counter.index() < kTotal) {
+            const std::size_t accepted = ring.write(counter.next(kBlock), kBlock);
+            counter.rewind(kBlock - accepted);
+        }
+        done.store(true, std::memory_order_release);
+    });
+
+    // Every frame is either delivered in order or counted lost, never both and never reordered.
+    std::vector<float> out(200);
+    std::uint64_t expected = 0;
+    std::uint64_t lostTotal = 0;
+    std::size_t violations = 0;
+    for (;;) {
+        const bool finished = done.load(std::memory_order_acquire);
+        std::size_t lost = 0;
+        const std::size_t count = ring.read(lagging, out.data(), out.size(), &lost);
+        expected += lost;
+        lostTotal += lost;
+        for (std::size_t i = 0; i < count; ++i) {
+            violations += out[i] == static_cast<float>(expected) ? 0 : 1;
+            ++expected;
+        }
+        if (finished && count == 0) {
+            break;
+        }
+    }
+    producer.join();
+
+    TINE_CHECK(violations == 0);
+    TINE_CHECK(expected == kTotal);
+    TINE_CHECK(ring.lostFrames(lagging) == lostTotal);
+    TINE_CHECK(ring.overruns(lagging) <= lostTotal);
+}
+
+}  // namespace
+
+int main() {
+    testBlocking();
+    testLappedLagging();
+    testMixedConsumers();
+    testConcurrentAccounting();
+    return tine::test::finish("broadcast_ring_buffer_test");
+}
@@ -0,0 +1,179 @@
+// C ABI contract: struct_size versioning of the config structs, alignment
+// errors on caller spans, and the buffer-too-small paths of
+// tine_engine_process_pending and tine_engine_metrics_text.
+//
+// Build (from the repository root):
+//   c++ -std=c++20 -O2 -pthread -Inative/cpp -Inative/tests native/tests/CApiTest.cpp native/cpp/tine_c_api.cpp
+//       native/cpp/PitchEngine.cpp native/cpp/YinPitchDetector.cpp native/cpp/DifferenceKernel.cpp
+//       native/cpp/KernelAutotuner.cpp native/cpp/BroadcastRingBuffer.cpp native/cpp/Metrics.cpp
+//       native/cpp/RtLog.cpp native/cpp/DialAnimator.cpp native/cpp/MidiGenerator.cpp
+//       native/cpp/ToneGenerator.cpp native/cpp/SessionAnalytics.cpp native/cpp/PitchTrackStore.cpp
+//       native/cpp/MelodyAligner.cpp -o c_api_test
+//   ./c_api_test
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#include "TestSupport.hpp"
+#include "tine_c_api.h"
+
+namespace {
+
+constexpr double kSampleRate = 48000.0;
+
+void testDetectorConfigVersions() {
+    tine_detector_config config;
+    tine_detector_config_init(&config);
+    TINE_CHECK(config.struct_size == sizeof(tine_detector_config));
+
+    tine_detector* detector = nullptr;
+    config.struct_size = 0;
+    TINE_CHECK(tine_detector_create(&config, &detector) == TINE_ERR_VERSION);
+    TINE_CHECK(detector == nullptr);
+
+    // One byte short of the 1.0 layout is older than any released caller.
+    config.struct_size = offsetof(tine_detector_config, threshold) + sizeof(double) - 1;
+    TINE_CHECK(tine_detector_create(&config, &detector) == TINE_ERR_VERSION);
+
+    // A caller built against a newer minor version passes a longer struct; the
+    // fields this library does not know are ignored.
+    struct NewerConfig {
+        tine_detector_config base;
+        std::uint64_t appended;
+    } newer{};
+    tine_detector_config_init(&newer.base);
+    newer.base.struct_size = sizeof(NewerConfig);
+    newer.base.window_size = 1024;
+    newer.appended = ~std::uint64_t{0};
+    TINE_CHECK(tine_detector_create(&newer.base, &detector) == TINE_OK);
+    TINE_CHECK(detector != nullptr);
+    tine_detector_destroy(detector);
+
+    tine_detector_config_init(&config);
+    config.window_size = 2;
+    TINE_CHECK(tine_detector_create(&config, &detector) == TINE_ERR_INVALID_ARGUMENT);
+    TINE_CHECK(tine_detector_create(nullptr, &detector) == TINE_ERR_INVALID_ARGUMENT);
+}
+
+void testEngineConfigVersions() {
+    tine_engine_config config;
+    tine_engine_config_init(&config);
+    TINE_CHECK(config.struct_size == sizeof(tine_engine_config));
+
+    tine_engine* engine = nullptr;
+    config.struct_size = offsetof(tine_engine_config, sample_rate);
+    TINE_CHECK(tine_engine_create(&config, &engine) == TINE_ERR_VERSION);
+    TINE_CHECK(engine == nullptr);
+
+    config.struct_size = sizeof(tine_engine_config);
+    config.hop_size = 0;
+    TINE_CHECK(tine_engine_create(&config, &engine) == TINE_ERR_INVALID_ARGUMENT);
+}
+
+void testAlignment() {
+    tine_detector_config config;
+    tine_detector_config_init(&config);
+    config.window_size = 1024;
+    tine_detector* detector = nullptr;
+    if (!TINE_CHECK(tine_detector_create(&config, &detector) == TINE_OK)) {
+        return;
+    }
+
+    const std::vector<float> tone = tine::test::makeGlide(kSampleRate, 4096, 220.0, 220.0);
+    // Byte buffers so the offsets below land at known misalignments.
+    alignas(16) unsigned char sampleBytes[4096 * sizeof(float) + 16];
+    std::memcpy(sampleBytes, tone.data(), tone.size() * sizeof(float));
+    alignas(16) unsigned char resultBytes[8 * sizeof(tine_pitch_result) + 16];
+    auto* samples = reinterpret_cast<const float*>(sampleBytes);
+    auto* results = reinterpret_cast<tine_pitch_result*>(resultBytes);
+    auto* oddSamples = reinterpret_cast<const float*>(sampleBytes + 2);
+    auto* oddResults = reinterpret_cast<tine_pitch_result*>(resultBytes + 4);
+
+    TINE_CHECK(tine_detector_process(detector, samples, 1024, results) == TINE_OK);
+    TINE_CHECK(results->is_valid == 1);
+    TINE_CHECK(tine_detector_process(detector, oddSamples, 1024, results) == TINE_ERR_MISALIGNED);
+    TINE_CHECK(tine_detector_process(detector, samples, 1024, oddResults) == TINE_ERR_MISALIGNED);
+    TINE_CHECK(tine_detector_process(detector, samples, 1023, results) == TINE_ERR_INVALID_ARGUMENT);
+
+    std::size_t written = 99;
+    TINE_CHECK(tine_detector_process_frames(detector, oddSamples, 4096, 512, results, 8, &written) ==
+               TINE_ERR_MISALIGNED);
+    TINE_CHECK(written == 0);
+    TINE_CHECK(tine_detector_process_frames(detector, samples, 4096, 512, oddResults, 8, &written) ==
+               TINE_ERR_MISALIGNED);
+    TINE_CHECK(tine_detector_process_frames(detector, samples, 4096, 512, results, 8, &written) == TINE_OK);
+    TINE_CHECK(written == 7);
+    tine_detector_destroy(detector);
+
+    // Ring spans report misalignment as zero frames moved.
+    tine_ring* ring = nullptr;
+    if (!TINE_CHECK(tine_ring_create(256, 2, &ring) == TINE_OK)) {
+        return;
+    }
+    const int32_t consumer = tine_ring_add_consumer(ring, TINE_CONSUMER_BLOCKING, 0);
+    TINE_CHECK(consumer >= 0);
+    TINE_CHECK(tine_ring_write(ring, oddSamples, 64) == 0);
+    TINE_CHECK(tine_ring_write(ring, samples, 64) == 64);
+    alignas(16) unsigned char readBytes[64 * sizeof(float) + 16];
+    TINE_CHECK(tine_ring_read(ring, consumer, reinterpret_cast<float*>(readBytes + 1), 64, nullptr) == 0);
+    TINE_CHECK(tine_ring_available(ring, consumer) == 64);
+    TINE_CHECK(tine_ring_read(ring, consumer, reinterpret_cast<float*>(readBytes), 64, nullptr) == 64);
+    TINE_CHECK(std::memcmp(readBytes, samples, 64 * sizeof(float)) == 0);
+    TINE_CHECK(tine_ring_write(ring, nullptr, 16) == 0);
+    tine_ring_destroy(ring);
+}
+
+void testMetricsText() {
+    tine_engine_config config;
+    tine_engine_config_init(&config);
+    config.window_size = 1024;
+    config.hop_size = 512;
+    tine_engine* engine = nullptr;
+    if (!TINE_CHECK(tine_engine_create(&config, &engine) == TINE_OK)) {
+        return;
+    }
+    const std::vector<float> tone = tine::test::makeGlide(kSampleRate, 8192, 196.0, 196.0);
+    TINE_CHECK(tine_engine_push(engine, tone.data(), tone.size()) == tone.size());
+    // Results beyond the caller's array are discarded and reported.
+    alignas(16) tine_pitch_result results[2];
+    std::size_t produced = 0;
+    TINE_CHECK(tine_engine_process_pending(engine, results, 2, &produced) == TINE_ERR_BUFFER_TOO_SMALL);
+    TINE_CHECK(produced == 2);
+    TINE_CHECK(results[1].is_valid == 1);
+    TINE_CHECK(tine_engine_process_pending(engine, results, 2, &produced) == TINE_OK);
+    TINE_CHECK(produced == 0);
+
+    // Probe with no buffer: the call reports the length to allocate.
+    std::size_t length = 0;
+    TINE_CHECK(tine_engine_metrics_text(engine, nullptr, 0, &length) == TINE_ERR_BUFFER_TOO_SMALL);
+    TINE_CHECK(length > 0);
+    TINE_CHECK(tine_engine_metrics_text(engine, nullptr, 16, &length) == TINE_ERR_INVALID_ARGUMENT);
+
+    // Exactly the length leaves no room for the terminator.
+    std::vector<char> text(length + 1, '#');
+    std::size_t needed = 0;
+    TINE_CHECK(tine_engine_metrics_text(engine, text.data(), length, &needed) == TINE_ERR_BUFFER_TOO_SMALL);
+    TINE_CHECK(needed == length);
+    TINE_CHECK(text[0] == '#');
+
+    // The snapshot may grow between calls only if new series appear; none do here.
+    TINE_CHECK(tine_engine_metrics_text(engine, text.data(), text.size(), &needed) == TINE_OK);
+    TINE_CHECK(needed == length);
+    TINE_CHECK(std::strlen(text.data()) == length);
+    TINE_CHECK(std::strstr(text.data(), "# TYPE") != nullptr);
+    TINE_CHECK(tine_engine_metrics_text(engine, text.data(), text.size(), nullptr) == TINE_OK);
+    tine_engine_destroy(engine);
+}
+
+}  // namespace
+
+int main() {
+    TINE_CHECK(tine_api_version() >> 16 == TINE_C_API_VERSION_MAJOR);
+    testDetectorConfigVersions();
+    testEngineConfigVersions();
+    testAlignment();
+    testMetricsText();
+    return tine::test::finish("c_api_test");
+}
@@ -0,0 +1,158 @@
+// CandidateTrack decoding against the live detector: a track recorded once must
+// reproduce, frame for frame, what a detector running at another threshold
+// reports, including when that threshold changes mid-stream, and must survive
+// a serialize/parse round trip.
+//
+// Build (from the repository root):
+//   c++ -std=c++20 -O2 -pthread -Inative/cpp -Inative/tests native/tests/CandidateTrackTest.cpp
+//       native/cpp/CandidateTrack.cpp native/cpp/AsyncStream.cpp native/cpp/AsyncScheduler.cpp
+//       native/cpp/ThreadPool.cpp native/cpp/ThreadConfig.cpp native/cpp/StreamScheduler.cpp
+//       native/cpp/Metrics.cpp native/cpp/YinPitchDetector.cpp native/cpp/DifferenceKernel.cpp
+//       native/cpp/KernelAutotuner.cpp -o candidate_track_test
+//   ./candidate_track_test
+
+#include <cstddef>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "CandidateTrack.hpp"
+#include "TestSupport.hpp"
+#include "YinPitchDetector.hpp"
+
+using namespace tine::dsp;
+
+namespace {
+
+constexpr double kSampleRate = 48000.0;
+constexpr std::size_t kWindow = 2048;
+constexpr std::size_t kHop = 512;
+constexpr double kRecordThreshold = 0.12;
+
+bool sameResult(const PitchResult& a, const PitchResult& b) {
+    return a.isValid == b.isValid && a.frequency == b.frequency && a.probability == b.probability &&
+           a.midi == b.midi && a.cents == b.cents && a.noteName == b.noteName;
+}
+
+std::vector<float> makeSignal() {
+    // Noise over the glide puts minima on both sides of every tested threshold.
+    std::vector<float> samples = tine::test::makeGlide(kSampleRate, static_cast<std::size_t>(kSampleRate), 70.0, 900.0);
+    std::mt19937 random(11);
+    std::normal_distribution<float> noise(0.0F, 0.08F);
+    for (float& sample : samples) {
+        sample += noise(random);
+    }
+    return samples;
+}
+
+CandidateTrack record(const std::vector<float>& samples, bool batched) {
+    CandidateTrack track;
+    track.info.sampleRate = kSampleRate;
+    track.info.windowSize = kWindow;
+    track.info.hopSize = kHop;
+
+    YinPitchDetector recorder(kSampleRate, kWindow, kRecordThreshold);
+    recorder.setCandidateLog(&track.log);
+    const std::size_t frames = (samples.size() - kWindow) / kHop + 1;
+    if (batched) {
+        std::vector<PitchResult> results(frames);
+        static_cast<void>(recorder.processFrames(samples.data(), samples.size(), kHop, results.data(), frames));
+    } else {
+        for (std::size_t k = 0; k < frames; ++k) {
+            static_cast<void>(recorder.processBuffer(samples.data() + k * kHop, kWindow));
+        }
+    }
+    TINE_CHECK(track.frameCount() == frames);
+    return track;
+}
+
+void testFixedThresholds(const std::vector<float>& samples) {
+    const CandidateTrack track = record(samples, false);
+    for (const double threshold : {0.02, 0.08, 0.12, 0.2, 0.35, 0.6}) {
+        YinPitchDetector live(kSampleRate, kWindow, threshold);
+        const std::vector<PitchResult> decoded = track.decode(threshold);
+        if (!TINE_CHECK(decoded.size() == track.frameCount())) {
+            continue;
+        }
+        std::size_t mismatches = 0;
+        std::size_t voiced = 0;
+        for (std::size_t k = 0; k < decoded.size(); ++k) {
+            const PitchResult expected = live.processBuffer(samples.data() + track.frameStart(k), kWindow);
+            mismatches += sameResult(decoded[k], expected) ? 0 : 1;
+            voiced += expected.isValid ? 1 : 0;
+        }
+        TINE_CHECK(mismatches == 0);
+        TINE_CHECK(voiced > 0);
+    }
+}
+
+void testBatchedRecording(const std::vector<float>& samples) {
+    // Candidates recorded by processFrames() decode to what processFrames() reports.
+    const CandidateTrack track = record(samples, true);
+    for (const double threshold : {0.05, 0.25}) {
+        YinPitchDetector live(kSampleRate, kWindow, threshold);
+        std::vector<PitchResult> expected(track.frameCount());
+        static_cast<void>(live.processFrames(samples.data(), samples.size(), kHop, expected.data(), expected.size()));
+        const std::vector<PitchResult> decoded = track.decode(threshold);
+        std::size_t mismatches = 0;
+        for (std::size_t k = 0; k < decoded.size(); ++k) {
+            mismatches += sameResult(decoded[k], expected[k]) ? 0 : 1;
+        }
+        TINE_CHECK(mismatches == 0);
+    }
+}
+
+void testLiveThresholdChanges(const std::vector<float>& samples) {
+    // A live session moves the threshold as the user drags the sensitivity slider.
+    const CandidateTrack track = record(samples, false);
+    YinPitchDetector live(kSampleRate, kWindow, kRecordThreshold);
+    std::size_t mismatches = 0;
+    for (std::size_t k = 0; k < track.frameCount(); ++k) {
+        const double threshold = 0.04 + 0.5 * static_cast<double>(k % 13) / 13.0;
+        live.setThreshold(threshold);
+        const PitchResult expected = live.processBuffer(samples.data() + track.frameStart(k), kWindow);
+        mismatches += sameResult(track.decodeFrame(k, threshold), expected) ? 0 : 1;
+    }
+    TINE_CHECK(mismatches == 0);
+
+    // Out-of-range thresholds clamp the same way setThreshold() does.
+    live.setThreshold(5.0);
+    const PitchResult clamped = live.processBuffer(samples.data(), kWindow);
+    TINE_CHECK(sameResult(track.decodeFrame(0, 5.0), clamped));
+}
+
+void testRoundTrip(const std::vector<float>& samples) {
+    const CandidateTrack track = record(samples, false);
+    const std::string bytes = track.serialize();
+
+    CandidateTrack parsed;
+    if (TINE_CHECK(CandidateTrack::parse(bytes, parsed))) {
+        TINE_CHECK(parsed.frameCount() == track.frameCount());
+        TINE_CHECK(parsed.info.hopSize == kHop && parsed.info.windowSize == kWindow);
+        const std::vector<PitchResult> before = track.decode(0.15);
+        const std::vector<PitchResult> after = parsed.decode(0.15);
+        std::size_t mismatches = 0;
+        for (std::size_t k = 0; k < before.size(); ++k) {
+            mismatches += sameResult(before[k], after[k]) ? 0 : 1;
+        }
+        TINE_CHECK(mismatches == 0);
+    }
+
+    // A truncated sidecar is rejected and leaves the target untouched.
+    CandidateTrack untouched;
+    untouched.info.hopSize = 7;
+    TINE_CHECK(!CandidateTrack::parse(std::string_view(bytes).substr(0, bytes.size() - 1), untouched));
+    TINE_CHECK(untouched.info.hopSize == 7 && untouched.frameCount() == 0);
+    TINE_CHECK(!CandidateTrack::parse(std::string_view(bytes).substr(0, 8), untouched));
+}
+
+}  // namespace
+
+int main() {
+    const std::vector<float> samples = makeSignal();
+    testFixedThresholds(samples);
+    testBatchedRecording(samples);
+    testLiveThresholdChanges(samples);
+    testRoundTrip(samples);
+    return tine::test::finish("candidate_track_test");
+}
@@ -0,0 +1,152 @@
+// DialAnimator springs: a step in pitch moves the needle and note ring
+// monotonically onto their targets without overshooting and then reports them
+// settled; the trajectory is the same at 60 Hz, 240 Hz or with jittery frame
+// intervals; the needle is clamped to +/-150 degrees past +/-50 cents; and the
+// ring takes the short way round while an unvoiced result only recentres the
+// needle.
+//
+// Build (from the repository root):
+//   c++ -std=c++20 -O2 -Inative/cpp -Inative/tests native/tests/DialAnimatorTest.cpp
+//       native/cpp/DialAnimator.cpp -o dial_animator_test
+//   ./dial_animator_test
+
+#include <cmath>
+#include <cstddef>
+
+#include "DialAnimator.hpp"
+#include "TestSupport.hpp"
+
+using namespace tine::dsp;
+
+namespace {
+
+constexpr double kFrame = 1.0 / 60.0;
+
+PitchResult voiced(double midi, double cents) {
+    PitchResult result;
+    result.isValid = true;
+    result.midi = midi;
+    result.cents = cents;
+    result.frequency = 440.0 * std::pow(2.0, (midi + cents / 100.0 - 69.0) / 12.0);
+    result.probability = 0.95;
+    return result;
+}
+
+void testNoOvershoot() {
+    DialAnimator dial;
+    dial.pushResult(voiced(60.0, 0.0));
+    dial.advance(1.0);
+    TINE_CHECK(dial.state().settled == 1 && dial.state().ringDegrees == 0.0);
+
+    // 40 cents sharp and a semitone up: needle to +120, ring to -30.
+    dial.pushResult(voiced(61.0, 40.0));
+    DialState previous = dial.state();
+    bool monotone = true;
+    bool bounded = true;
+    std::size_t settledAt = 0;
+    for (std::size_t frame = 1; frame <= 120; ++frame) {
+        const DialState state = dial.advance(kFrame);
+        monotone = monotone && state.needleDegrees >= previous.needleDegrees &&
+                   state.ringDegrees <= previous.ringDegrees;
+        bounded = bounded && state.needleDegrees <= 120.0 + 1e-9 && state.ringDegrees >= -30.0 - 1e-9;
+        if (state.settled && settledAt == 0) {
+            settledAt = frame;
+        }
+        previous = state;
+    }
+    TINE_CHECK(monotone);
+    TINE_CHECK(bounded);
+    // Critically damped at 12 rad/s: moving for a while, at rest within two seconds.
+    TINE_CHECK(settledAt > 30 && settledAt <= 120);
+    TINE_CHECK(std::fabs(previous.needleDegrees - 120.0) < 0.01 && std::fabs(previous.ringDegrees + 30.0) < 0.01);
+    TINE_CHECK(previous.voiced == 1 && previous.cents == 40.0 && previous.midi == 61.0);
+
+    // Reversed mid-flight, still moving away from the new target: it turns back
+    // and approaches without passing it.
+    dial.pushResult(voiced(61.0, -40.0));
+    dial.advance(0.05);
+    TINE_CHECK(dial.state().needleVelocity < 0.0);
+    TINE_CHECK(dial.state().needleDegrees < 120.0);
+    dial.pushResult(voiced(61.0, 40.0));
+    bool below = true;
+    for (std::size_t frame = 0; frame < 120; ++frame) {
+        below = below && dial.advance(kFrame).needleDegrees <= 120.0 + 1e-9;
+    }
+    TINE_CHECK(below);
+    TINE_CHECK(std::fabs(dial.state().needleDegrees - 120.0) < 0.01);
+}
+
+void testFrameRateIndependence() {
+    DialAnimator coarse;
+    DialAnimator fine;
+    DialAnimator jittery;
+    for (DialAnimator* dial : {&coarse, &fine, &jittery}) {
+        dial->pushResult(voiced(64.0, -25.0));
+    }
+
+    // Jittery frames alternate short and long but meet the 60 Hz grid every two.
+    const double shortFrame = 0.3 * kFrame;
+    const double longFrame = 2.0 * kFrame - shortFrame;
+    bool same = true;
+    for (std::size_t frame = 0; frame < 60; ++frame) {
+        const DialState a = coarse.advance(kFrame);
+        DialState b;
+        for (int i = 0; i < 4; ++i) {
+            b = fine.advance(kFrame / 4.0);
+        }
+        same = same && std::fabs(a.needleDegrees - b.needleDegrees) < 1e-9 &&
+               std::fabs(a.ringDegrees - b.ringDegrees) < 1e-9;
+        if (frame % 2 == 1) {
+            jittery.advance(shortFrame);
+            const DialState c = jittery.advance(longFrame);
+            same = same && std::fabs(a.needleDegrees - c.needleDegrees) < 1e-9 &&
+                   std::fabs(a.ringDegrees - c.ringDegrees) < 1e-9;
+        }
+    }
+    TINE_CHECK(same);
+
+    // A stall longer than MAX_STEP_SECONDS lands exactly on the target.
+    DialAnimator stalled;
+    stalled.pushResult(voiced(64.0, -25.0));
+    const DialState snapped = stalled.advance(1.0);
+    TINE_CHECK(snapped.needleDegrees == -75.0 && snapped.needleVelocity == 0.0 && snapped.settled == 1);
+}
+
+void testClampAndRing() {
+    DialAnimator dial;
+    dial.pushResult(voiced(69.0, 200.0));
+    TINE_CHECK(dial.advance(1.0).needleDegrees == 150.0);
+    dial.pushResult(voiced(69.0, -80.0));
+    TINE_CHECK(dial.advance(1.0).needleDegrees == -150.0);
+    // The reported cents stay unclamped; only the needle stops at full scale.
+    TINE_CHECK(dial.state().cents == -80.0);
+
+    // From C to the B below turns +30, not -330.
+    DialAnimator ring;
+    ring.pushResult(voiced(60.0, 0.0));
+    TINE_CHECK(ring.advance(1.0).ringDegrees == 0.0);
+    ring.pushResult(voiced(59.0, 0.0));
+    TINE_CHECK(std::fabs(ring.advance(1.0).ringDegrees - 30.0) < 1e-9);
+    // Twelve semitones up lands on the same note a full turn round, the short way: no motion.
+    ring.pushResult(voiced(71.0, 0.0));
+    TINE_CHECK(std::fabs(ring.advance(1.0).ringDegrees - 30.0) < 1e-9);
+
+    // Unvoiced: the needle recentres, the ring stays on the last note.
+    ring.pushResult(voiced(59.0, 30.0));
+    ring.advance(1.0);
+    ring.pushResult(PitchResult{});
+    const DialState rest = ring.advance(1.0);
+    TINE_CHECK(rest.needleDegrees == 0.0 && std::fabs(rest.ringDegrees - 30.0) < 1e-9 && rest.voiced == 0);
+
+    ring.reset();
+    TINE_CHECK(ring.state().needleDegrees == 0.0 && ring.state().ringDegrees == 0.0 && ring.state().settled == 1);
+}
+
+}  // namespace
+
+int main() {
+    testNoOvershoot();
+    testFrameRateIndependence();
+    testClampAndRing();
+    return tine::test::finish("DialAnimatorTest");
+}
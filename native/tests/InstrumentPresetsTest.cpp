@@ -0,0 +1,117 @@
+// compilePreset(): the lag floor sits a semitone above the band's top, the
+// window the planner derives from applyTo() covers a semitone below its bottom,
+// the pre-filters are a high-pass then a low-pass with unusable corners dropped,
+// and the reference notes follow the requested A4.
+//
+// Build (from the repository root):
+//   c++ -std=c++20 -O2 -Inative/cpp -Inative/tests native/tests/InstrumentPresetsTest.cpp
+//       native/cpp/InstrumentPresets.cpp native/cpp/LatencyPlanner.cpp -o instrument_presets_test
+//   ./instrument_presets_test
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <string>
+
+#include "InstrumentPresets.hpp"
+#include "TestSupport.hpp"
+
+using namespace tine::dsp;
+
+namespace {
+
+constexpr double kSemitone = 1.0594630943592953;
+
+bool near(double a, double b, double tolerance = 1e-9) {
+    return std::fabs(a - b) <= tolerance * std::fmax(1.0, std::fabs(b));
+}
+
+// DC gain of a normalised section: 0 for a high-pass, 1 for a low-pass.
+double dcGain(const BiquadCoefficients& c) {
+    return (c.b0 + c.b1 + c.b2) / (1.0 + c.a1 + c.a2);
+}
+
+void testBuiltIns() {
+    TINE_CHECK(builtInPresets().size() == 9);
+    for (const char* name : {"guitar", "bass", "violin", "viola", "cello", "ukulele", "voice", "piano", "chromatic"}) {
+        const InstrumentPreset* preset = builtInPreset(name);
+        TINE_CHECK(preset != nullptr && preset->name == name);
+    }
+    TINE_CHECK(builtInPreset("theremin") == nullptr);
+    // Lookups hand out the same stable definition every time.
+    TINE_CHECK(builtInPreset("cello") == builtInPreset("cello"));
+}
+
+void testLagBounds() {
+    for (double rate : {44100.0, 48000.0}) {
+        for (const InstrumentPreset& preset : builtInPresets()) {
+            const CompiledPreset compiled = compilePreset(preset, rate);
+            TINE_CHECK(compiled.sampleRate == rate);
+            const auto floor = static_cast<std::size_t>(std::floor(rate / (preset.maxFrequencyHz * kSemitone)));
+            TINE_CHECK(compiled.minLag == std::max<std::size_t>(2, floor));
+            // The top note a semitone sharp still has a period at or above the floor.
+            TINE_CHECK(rate / (preset.maxFrequencyHz * kSemitone) >= static_cast<double>(compiled.minLag));
+
+            LatencyPlanRequest request;
+            compiled.applyTo(request);
+            TINE_CHECK(request.sampleRate == rate);
+            TINE_CHECK(near(request.minFrequencyHz, preset.minFrequencyHz / kSemitone));
+            TINE_CHECK(request.targetLatencySeconds == preset.targetLatencySeconds);
+            // The bottom note a semitone flat fits the planned window's lag range.
+            const LatencyPlan plan = planLatency(request);
+            TINE_CHECK(static_cast<double>(plan.windowFrames / 2) >= rate / (preset.minFrequencyHz / kSemitone));
+
+            PitchEngineConfig config;
+            compiled.applyTo(config);
+            TINE_CHECK(config.minLag == compiled.minLag);
+            TINE_CHECK(config.preFilters.size() == compiled.preFilters.size());
+            TINE_CHECK(config.adaptiveWindow == preset.adaptiveWindow);
+        }
+    }
+}
+
+void testPreFilters() {
+    const CompiledPreset guitar = compilePreset(*builtInPreset("guitar"), 48000.0);
+    TINE_CHECK(guitar.preFilters.size() == 2);
+    TINE_CHECK(near(dcGain(guitar.preFilters[0]), 0.0, 1e-12));
+    TINE_CHECK(near(dcGain(guitar.preFilters[1]), 1.0, 1e-12));
+
+    // Violin has no low-pass corner.
+    const CompiledPreset violin = compilePreset(*builtInPreset("violin"), 48000.0);
+    TINE_CHECK(violin.preFilters.size() == 1);
+    TINE_CHECK(near(dcGain(violin.preFilters[0]), 0.0, 1e-12));
+
+    InstrumentPreset custom;
+    custom.name = "custom";
+    TINE_CHECK(compilePreset(custom, 48000.0).preFilters.empty());
+    // A low-pass this close to Nyquist would do nothing and is dropped.
+    custom.lowPassHz = 22000.0;
+    TINE_CHECK(compilePreset(custom, 48000.0).preFilters.empty());
+    TINE_CHECK(compilePreset(custom, 96000.0).preFilters.size() == 1);
+}
+
+void testTargets() {
+    const CompiledPreset guitar = compilePreset(*builtInPreset("guitar"), 48000.0);
+    const double expected[] = {82.40688922821750, 110.0, 146.8323839587038,
+                               195.9977179908746, 246.9416506280621, 329.6275569128699};
+    TINE_CHECK(guitar.targetFrequencies.size() == 6);
+    for (std::size_t i = 0; i < guitar.targetFrequencies.size() && i < 6; ++i) {
+        TINE_CHECK(near(guitar.targetFrequencies[i], expected[i]));
+    }
+
+    const CompiledPreset baroque = compilePreset(*builtInPreset("violin"), 48000.0, 415.0);
+    TINE_CHECK(baroque.targetFrequencies.size() == 4);
+    TINE_CHECK(near(baroque.targetFrequencies[2], 415.0));
+
+    TINE_CHECK(compilePreset(*builtInPreset("chromatic"), 48000.0).targetFrequencies.empty());
+}
+
+}  // namespace
+
+int main() {
+    testBuiltIns();
+    testLagBounds();
+    testPreFilters();
+    testTargets();
+    return tine::test::finish("InstrumentPresetsTest");
+}
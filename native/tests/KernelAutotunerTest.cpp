@@ -0,0 +1,141 @@
+// KernelWisdom persistence: serialize() output parses back to the same entries;
+// a different magic or version, an unknown kernel, a zero window, trailing
+// garbage or a line cut short is rejected without touching the destination;
+// load() only accepts wisdom measured on the given CPU; and a short autotune
+// run records one entry per requested window.
+//
+// Build (from the repository root):
+//   c++ -std=c++20 -O2 -pthread -Inative/cpp -Inative/tests native/tests/KernelAutotunerTest.cpp
+//       native/cpp/KernelAutotuner.cpp native/cpp/DifferenceKernel.cpp -o kernel_autotuner_test
+//   ./kernel_autotuner_test
+
+#include <cmath>
+#include <cstddef>
+#include <cstdio>
+#include <filesystem>
+#include <string>
+
+#include "KernelAutotuner.hpp"
+#include "TestSupport.hpp"
+
+using namespace tine::dsp;
+
+namespace {
+
+KernelWisdom makeWisdom() {
+    KernelWisdom wisdom("Apple M2 Pro x12");
+    wisdom.set({4096, {DifferenceKernelKind::Fft, 16384}, 2.5e-5});
+    wisdom.set({1024, {DifferenceKernelKind::Blocked, 0}, 3.25e-6});
+    wisdom.set({2048, {DifferenceKernelKind::Direct, 0}, 1.5e-5});
+    return wisdom;
+}
+
+bool sameEntries(const KernelWisdom& a, const KernelWisdom& b) {
+    if (a.entries().size() != b.entries().size()) {
+        return false;
+    }
+    for (std::size_t i = 0; i < a.entries().size(); ++i) {
+        const KernelWisdomEntry& x = a.entries()[i];
+        const KernelWisdomEntry& y = b.entries()[i];
+        if (x.windowSize != y.windowSize || x.choice.kind != y.choice.kind || x.choice.fftSize != y.choice.fftSize ||
+            std::fabs(x.secondsPerCall - y.secondsPerCall) > 1e-5 * x.secondsPerCall) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void testRoundTrip() {
+    const KernelWisdom wisdom = makeWisdom();
+    // Entries are kept sorted by window, and set() replaces rather than appends.
+    TINE_CHECK(wisdom.entries().size() == 3 && wisdom.entries().front().windowSize == 1024);
+    KernelWisdom replaced = wisdom;
+    replaced.set({2048, {DifferenceKernelKind::Fft, 0}, 1e-5});
+    TINE_CHECK(replaced.entries().size() == 3 && replaced.find(2048)->choice.kind == DifferenceKernelKind::Fft);
+    TINE_CHECK(wisdom.find(512) == nullptr);
+
+    KernelWisdom parsed;
+    TINE_CHECK(KernelWisdom::parse(wisdom.serialize(), parsed));
+    TINE_CHECK(parsed.cpuModel() == wisdom.cpuModel());
+    TINE_CHECK(sameEntries(parsed, wisdom));
+
+    // Blank lines and a missing final newline are fine; so is a file with no entries yet.
+    const std::string text = "tine-kernel-wisdom 1\ncpu Pixel 8\n\n2048 fft 0 0.00002";
+    TINE_CHECK(KernelWisdom::parse(text, parsed));
+    TINE_CHECK(parsed.cpuModel() == "Pixel 8" && parsed.entries().size() == 1);
+    TINE_CHECK(parsed.find(2048) && parsed.find(2048)->choice.kind == DifferenceKernelKind::Fft);
+    TINE_CHECK(KernelWisdom::parse("tine-kernel-wisdom 1\ncpu Pixel 8\n", parsed));
+    TINE_CHECK(parsed.empty());
+}
+
+void testRejected() {
+    const char* const malformed[] = {
+        "",
+        "tine-kernel-wisdom\n",
+        "tine-kernel-wisdom 2\ncpu X\n2048 direct 0 1e-5\n",
+        "tine-kernel-wisdum 1\ncpu X\n2048 direct 0 1e-5\n",
+        "tine-kernel-wisdom 1\nmodel X\n2048 direct 0 1e-5\n",
+        "tine-kernel-wisdom 1\ncpu X\n2048 simd 0 1e-5\n",
+        "tine-kernel-wisdom 1\ncpu X\n0 direct 0 1e-5\n",
+        "tine-kernel-wisdom 1\ncpu X\n2048 direct 0 1e-5 extra\n",
+        // Cut short by a partial write: an entry missing its last fields.
+        "tine-kernel-wisdom 1\ncpu X\n1024 blocked 0 1e-6\n2048 fft\n",
+        "tine-kernel-wisdom 1\ncpu X\n1024 blocked 0 1e-6\n2048 fft 8192\n",
+        // Two entries run together on one line.
+        "tine-kernel-wisdom 1\ncpu X\n1024 blocked 0 1e-6 2048 fft 8192 1e-5\n",
+    };
+    for (const char* text : malformed) {
+        KernelWisdom wisdom = makeWisdom();
+        const bool parsed = KernelWisdom::parse(text, wisdom);
+        if (!TINE_CHECK(!parsed)) {
+            std::fprintf(stderr, "  accepted: \"%s\"\n", text);
+        }
+        // The destination is left as it was.
+        TINE_CHECK(wisdom.cpuModel() == "Apple M2 Pro x12" && sameEntries(wisdom, makeWisdom()));
+    }
+}
+
+void testLoadSave() {
+    const std::string path =
+        (std::filesystem::temp_directory_path() / "tine_kernel_autotuner_test.wisdom").string();
+    const KernelWisdom wisdom = makeWisdom();
+    TINE_CHECK(wisdom.save(path));
+    TINE_CHECK(!std::filesystem::exists(path + ".tmp"));
+
+    KernelWisdom loaded;
+    TINE_CHECK(KernelWisdom::load(path, "Apple M2 Pro x12", loaded));
+    TINE_CHECK(sameEntries(loaded, wisdom));
+
+    // Measured on another CPU: re-tune instead.
+    KernelWisdom other;
+    TINE_CHECK(!KernelWisdom::load(path, "Apple M3 x8", other));
+    TINE_CHECK(other.empty());
+
+    std::filesystem::remove(path);
+    TINE_CHECK(!KernelWisdom::load(path, "Apple M2 Pro x12", other));
+}
+
+void testAutotune() {
+    KernelAutotuneOptions options;
+    options.secondsPerCandidate = 0.002;
+    const KernelWisdom wisdom = autotuneDifferenceKernels({512, 256}, options);
+    TINE_CHECK(wisdom.cpuModel() == currentCpuModel());
+    TINE_CHECK(wisdom.entries().size() == 2);
+    for (std::size_t window : {256, 512}) {
+        const KernelWisdomEntry* entry = wisdom.find(window);
+        TINE_CHECK(entry && entry->secondsPerCall > 0.0);
+    }
+    // What the tuner writes, the parser reads.
+    KernelWisdom parsed;
+    TINE_CHECK(KernelWisdom::parse(wisdom.serialize(), parsed) && sameEntries(parsed, wisdom));
+}
+
+}  // namespace
+
+int main() {
+    testRoundTrip();
+    testRejected();
+    testLoadSave();
+    testAutotune();
+    return tine::test::finish("KernelAutotunerTest");
+}
@@ -0,0 +1,137 @@
+// YinPitchDetector lag refinement on tones with known fractional periods,
+// swept from 24 samples (2 kHz at 48 kHz) to 900, where rounding to the integer
+// lag alone would be off by up to tens of cents: Sinc stays within its stated
+// 0.1 cent on pure and harmonic tones, Parabolic within its ~2 cent bias and
+// Cubic within half a cent on pure tones; below 10 lags Sinc falls back to
+// Cubic; and processFrames() refines exactly as processBuffer() does.
+//
+// Build (from the repository root):
+//   c++ -std=c++20 -O2 -Inative/cpp -Inative/tests native/tests/LagRefinementTest.cpp
+//       native/cpp/YinPitchDetector.cpp native/cpp/DifferenceKernel.cpp -o lag_refinement_test
+//   ./lag_refinement_test
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdio>
+#include <vector>
+
+#include "TestSupport.hpp"
+#include "YinPitchDetector.hpp"
+
+using namespace tine::dsp;
+
+namespace {
+
+constexpr double kSampleRate = 48000.0;
+constexpr std::size_t kWindow = 2048;
+constexpr std::size_t kPeriods = 60;
+
+/** @p harmonics partials at 1/h amplitude, fixed phases, period @p period samples. */
+std::vector<float> makeTone(double period, int harmonics, std::size_t frames = kWindow) {
+    std::vector<float> samples(frames);
+    for (std::size_t i = 0; i < frames; ++i) {
+        double value = 0.0;
+        for (int h = 1; h <= harmonics; ++h) {
+            value += std::sin(2.0 * M_PI * h * static_cast<double>(i) / period + 0.7 * h * h) / h;
+        }
+        samples[i] = static_cast<float>(0.3 * value);
+    }
+    return samples;
+}
+
+/** Log-spaced periods with fractional parts that wander across the whole sample. */
+double sweptPeriod(std::size_t k) {
+    const double t = static_cast<double>(k) / static_cast<double>(kPeriods - 1);
+    return 24.0 * std::pow(900.0 / 24.0, t) + 0.013 * static_cast<double>(k);
+}
+
+double centsOff(double frequency, double period) {
+    return std::fabs(1200.0 * std::log2(frequency * period / kSampleRate));
+}
+
+/** Largest error over the sweep, in cents; infinite if any tone went unvoiced. */
+double worstError(LagRefinement refinement, int harmonics) {
+    YinPitchDetector detector(kSampleRate, kWindow, 0.15);
+    detector.setLagRefinement(refinement);
+    double worst = 0.0;
+    for (std::size_t k = 0; k < kPeriods; ++k) {
+        const double period = sweptPeriod(k);
+        const std::vector<float> tone = makeTone(period, harmonics);
+        const PitchResult result = detector.processBuffer(tone.data(), tone.size());
+        worst = std::max(worst, result.isValid ? centsOff(result.frequency, period) : INFINITY);
+    }
+    return worst;
+}
+
+void testSubSampleAccuracy() {
+    // Without refinement the integer lag would miss by this much somewhere in the sweep.
+    double rounding = 0.0;
+    for (std::size_t k = 0; k < kPeriods; ++k) {
+        const double period = sweptPeriod(k);
+        rounding = std::max(rounding, centsOff(kSampleRate / std::round(period), period));
+    }
+    TINE_CHECK(rounding > 10.0);
+
+    struct Bound {
+        LagRefinement refinement;
+        int harmonics;
+        double cents;
+    };
+    const Bound bounds[] = {
+        {LagRefinement::Sinc, 1, 0.1},      {LagRefinement::Sinc, 5, 0.1},
+        {LagRefinement::Parabolic, 1, 2.0}, {LagRefinement::Parabolic, 5, 2.0},
+        {LagRefinement::Cubic, 1, 0.5},
+    };
+    for (const Bound& bound : bounds) {
+        const double worst = worstError(bound.refinement, bound.harmonics);
+        if (!TINE_CHECK(worst < bound.cents)) {
+            std::fprintf(stderr, "  refinement %d, %d harmonics: %.4f cents\n", static_cast<int>(bound.refinement),
+                         bound.harmonics, worst);
+        }
+    }
+    // Sinc is the accurate one on harmonic tones, where Cubic bends most.
+    TINE_CHECK(worstError(LagRefinement::Sinc, 5) < worstError(LagRefinement::Cubic, 5));
+}
+
+void testShortLagFallback() {
+    // 7.6 kHz: a period under 10 lags, too short for the 16-tap sinc.
+    const std::vector<float> tone = makeTone(6.3, 1);
+    YinPitchDetector sinc(kSampleRate, kWindow, 0.15);
+    YinPitchDetector cubic(kSampleRate, kWindow, 0.15);
+    sinc.setLagRefinement(LagRefinement::Sinc);
+    cubic.setLagRefinement(LagRefinement::Cubic);
+    const PitchResult a = sinc.processBuffer(tone.data(), tone.size());
+    const PitchResult b = cubic.processBuffer(tone.data(), tone.size());
+    TINE_CHECK(a.isValid && a.frequency == b.frequency);
+}
+
+void testFramesRefineAlike() {
+    constexpr std::size_t kHop = 512;
+    const std::vector<float> tone = makeTone(37.77, 5, 8 * kWindow);
+    YinPitchDetector single(kSampleRate, kWindow, 0.15);
+    YinPitchDetector batched(kSampleRate, kWindow, 0.15);
+    single.setLagRefinement(LagRefinement::Sinc);
+    batched.setLagRefinement(LagRefinement::Sinc);
+
+    std::vector<PitchResult> results((tone.size() - kWindow) / kHop + 1);
+    const std::size_t written = batched.processFrames(tone.data(), tone.size(), kHop, results.data(), results.size());
+    TINE_CHECK(written == results.size());
+    bool same = true;
+    for (std::size_t k = 0; k < written; ++k) {
+        const PitchResult reference = single.processBuffer(tone.data() + k * kHop, kWindow);
+        // Up to the batched pass's summation order.
+        same = same && results[k].isValid && std::fabs(results[k].frequency / reference.frequency - 1.0) < 1e-6 &&
+               centsOff(results[k].frequency, 37.77) < 0.1;
+    }
+    TINE_CHECK(same);
+}
+
+}  // namespace
+
+int main() {
+    testSubSampleAccuracy();
+    testShortLagFallback();
+    testFramesRefineAlike();
+    return tine::test::finish("LagRefinementTest");
+}
@@ -0,0 +1,120 @@
+// planLatency drain batching and inline plans: the batch size is the most hops
+// that fit maxBatchLatencySeconds, the ring grows to hold a whole batch, the
+// wakeup rate falls by the same factor and the batching wait is added to the
+// latency figures; inline plans never batch and count no drain wait, which the
+// worker's worst case always includes.
+//
+// Build (from the repository root):
+//   c++ -std=c++20 -O2 -pthread -Inative/cpp -Inative/tests native/tests/LatencyPlannerTest.cpp
+//       native/cpp/LatencyPlanner.cpp -o latency_planner_test
+//   ./latency_planner_test
+
+#include <cmath>
+#include <cstddef>
+
+#include "LatencyPlanner.hpp"
+#include "TestSupport.hpp"
+
+using namespace tine::dsp;
+
+namespace {
+
+constexpr double kSampleRate = 48000.0;
+constexpr std::size_t kWindow = 2048;
+constexpr std::size_t kIoPeriod = 256;
+constexpr double kAnalysisSeconds = 1e-4;
+
+bool near(double a, double b) {
+    return std::fabs(a - b) <= 1e-9;
+}
+
+bool isPowerOfTwo(std::size_t value) {
+    return value != 0 && (value & (value - 1)) == 0;
+}
+
+LatencyPlanRequest baseRequest(EngineMode mode) {
+    LatencyPlanRequest request;
+    request.sampleRate = kSampleRate;
+    request.windowFrames = kWindow;
+    request.ioPeriodFrames = kIoPeriod;
+    request.analysisSeconds = kAnalysisSeconds;
+    request.mode = mode;
+    return request;
+}
+
+void testWorkerBatching() {
+    const LatencyPlan single = planLatency(baseRequest(EngineMode::Worker));
+    const double hopSeconds = static_cast<double>(single.hopFrames) / kSampleRate;
+    TINE_CHECK(single.batchHops == 1);
+    TINE_CHECK(single.batchLatencySeconds == 0.0);
+    TINE_CHECK(near(single.drainPeriodSeconds, hopSeconds));
+    TINE_CHECK(near(single.wakeupsPerSecond, 1.0 / hopSeconds));
+    // Two hops of drain slack plus the tap block in flight.
+    TINE_CHECK(isPowerOfTwo(single.ringCapacity));
+    TINE_CHECK(single.ringCapacity >= 3 * single.hopFrames + single.tapFrames);
+    TINE_CHECK(single.ringCapacity < 2 * (3 * single.hopFrames + single.tapFrames));
+
+    for (double maxBatch : {0.05, 0.15, 0.4}) {
+        LatencyPlanRequest request = baseRequest(EngineMode::Worker);
+        request.maxBatchLatencySeconds = maxBatch;
+        const LatencyPlan plan = planLatency(request);
+
+        // Batching only changes how often the engine thread wakes, not the pipeline.
+        TINE_CHECK(plan.tapFrames == single.tapFrames && plan.hopFrames == single.hopFrames);
+        TINE_CHECK(plan.windowFrames == single.windowFrames);
+        TINE_CHECK(plan.meetsLatencyTarget == single.meetsLatencyTarget);
+
+        // As many hops as fit the allowance: one more would exceed it.
+        const auto extra = static_cast<double>(plan.batchHops - 1);
+        TINE_CHECK(plan.batchHops > 1);
+        TINE_CHECK(extra * hopSeconds <= maxBatch && (extra + 1.0) * hopSeconds > maxBatch);
+        TINE_CHECK(near(plan.batchLatencySeconds, extra * hopSeconds));
+        TINE_CHECK(near(plan.drainPeriodSeconds, static_cast<double>(plan.batchHops) * hopSeconds));
+        TINE_CHECK(near(plan.wakeupsPerSecond, single.wakeupsPerSecond / static_cast<double>(plan.batchHops)));
+
+        // The ring holds a whole batch on top of the slack.
+        TINE_CHECK(isPowerOfTwo(plan.ringCapacity));
+        TINE_CHECK(plan.ringCapacity >= (2 + plan.batchHops) * plan.hopFrames + plan.tapFrames);
+        TINE_CHECK(plan.engineConfig(0.1).ringCapacity == plan.ringCapacity);
+
+        // A batch waits half its extra hops on average and all of them at worst.
+        TINE_CHECK(near(plan.expectedLatencySeconds, single.expectedLatencySeconds + plan.batchLatencySeconds / 2.0));
+        TINE_CHECK(near(plan.worstCaseLatencySeconds, single.worstCaseLatencySeconds + plan.batchLatencySeconds));
+    }
+
+    // An allowance shorter than a hop leaves one hop per wakeup.
+    LatencyPlanRequest request = baseRequest(EngineMode::Worker);
+    request.maxBatchLatencySeconds = 0.5 * hopSeconds;
+    TINE_CHECK(planLatency(request).batchHops == 1);
+}
+
+void testInlinePlan() {
+    LatencyPlanRequest request = baseRequest(EngineMode::Inline);
+    request.maxBatchLatencySeconds = 0.15;
+    const LatencyPlan plan = planLatency(request);
+
+    // Nothing to batch: the capture callback analyzes each hop itself.
+    TINE_CHECK(plan.mode == EngineMode::Inline && plan.engineConfig(0.1).mode == EngineMode::Inline);
+    TINE_CHECK(plan.batchHops == 1 && plan.batchLatencySeconds == 0.0);
+    TINE_CHECK(near(plan.drainPeriodSeconds, static_cast<double>(plan.hopFrames) / kSampleRate));
+
+    // No drain wait: an IO period, the rest of the hop, half a window and one analysis.
+    const double io = static_cast<double>(kIoPeriod) / kSampleRate;
+    const double hop = static_cast<double>(plan.hopFrames) / kSampleRate;
+    const double halfWindow = static_cast<double>(kWindow) / (2.0 * kSampleRate);
+    TINE_CHECK(near(plan.worstCaseLatencySeconds, hop + halfWindow + kAnalysisSeconds));
+    TINE_CHECK(near(plan.expectedLatencySeconds, io + (hop - io) / 2.0 + halfWindow + kAnalysisSeconds));
+
+    // The worker also waits up to a hop for its drain.
+    const LatencyPlan workerPlan = planLatency(baseRequest(EngineMode::Worker));
+    const double workerHop = static_cast<double>(workerPlan.hopFrames) / kSampleRate;
+    TINE_CHECK(near(workerPlan.worstCaseLatencySeconds, 2.0 * workerHop + halfWindow + kAnalysisSeconds));
+}
+
+}  // namespace
+
+int main() {
+    testWorkerBatching();
+    testInlinePlan();
+    return tine::test::finish("LatencyPlannerTest");
+}
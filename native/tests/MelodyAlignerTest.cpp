@@ -0,0 +1,212 @@
+// MelodyAligner against a synthetic singer whose position in the melody is
+// known: every committed frame must land on the note actually being sung at
+// tempo, at half speed and at one and a half times speed, across a dropout
+// longer than the band radius, and an octave down; the score must report the
+// singer's constant offset; and the input queue must count what it refuses.
+//
+// Build (from the repository root):
+//   c++ -std=c++20 -O2 -Inative/cpp -Inative/tests native/tests/MelodyAlignerTest.cpp
+//       native/cpp/MelodyAligner.cpp -o melody_aligner_test
+//   ./melody_aligner_test
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <vector>
+
+#include "MelodyAligner.hpp"
+#include "TestSupport.hpp"
+
+using namespace tine::dsp;
+
+namespace {
+
+constexpr double kSampleRate = 48000.0;
+constexpr std::size_t kHop = 480;
+// Frames this close (in hops) to a sung note change may fall on either note.
+constexpr std::uint64_t kBoundaryHops = 3;
+
+const std::vector<MelodyNote> kMelody = {
+    {60.0, 0.5}, {62.0, 0.5}, {64.0, 0.5}, {65.0, 0.5}, {67.0, 0.5},
+    {-1.0, 0.5}, {69.0, 0.5}, {67.0, 0.5}, {64.0, 0.75},
+};
+
+PitchResult voiced(double midi) {
+    PitchResult result;
+    result.isValid = true;
+    result.midi = midi;
+    result.frequency = 440.0 * std::pow(2.0, (midi - 69.0) / 12.0);
+    result.probability = 0.95;
+    return result;
+}
+
+MelodyAlignerConfig baseConfig() {
+    MelodyAlignerConfig config;
+    config.sampleRate = kSampleRate;
+    config.hopSize = kHop;
+    config.melody = kMelody;
+    return config;
+}
+
+struct Performance {
+    /** Note sung at each result's sample time. */
+    std::map<std::uint64_t, std::uint32_t> truth;
+    /** Sample times of sung note changes. */
+    std::vector<std::uint64_t> changes;
+};
+
+/**
+ * Sing the melody at @p tempo times its written speed, @p offsetCents off,
+ * skipping the results between @p gapFrom and @p gapTo (sample times).
+ */
+Performance sing(MelodyAligner& aligner, double tempo, double offsetCents, std::uint64_t gapFrom = 0,
+                 std::uint64_t gapTo = 0) {
+    Performance performance;
+    std::uint64_t time = 0;
+    for (std::uint32_t index = 0; index < kMelody.size(); ++index) {
+        const MelodyNote& note = kMelody[index];
+        const auto results = static_cast<std::size_t>(std::round(note.seconds / tempo * kSampleRate / kHop));
+        performance.changes.push_back(time);
+        for (std::size_t i = 0; i < results; ++i, time += kHop) {
+            if (time >= gapFrom && time < gapTo) {
+                continue;
+            }
+            performance.truth[time] = index;
+            aligner.process(note.midi >= 0.0 ? voiced(note.midi + offsetCents / 100.0) : PitchResult{}, time);
+        }
+    }
+    aligner.finish();
+    return performance;
+}
+
+bool nearChange(const Performance& performance, std::uint64_t time) {
+    for (std::uint64_t change : performance.changes) {
+        const std::uint64_t distance = time > change ? time - change : change - time;
+        if (distance <= kBoundaryHops * kHop) {
+            return true;
+        }
+    }
+    return false;
+}
+
+struct Agreement {
+    std::size_t frames{0};
+    std::size_t checked{0};
+    std::size_t matched{0};
+    /** Voiced frames committed to a note rather than a rest. */
+    std::size_t scored{0};
+    bool ordered{true};
+};
+
+Agreement compare(MelodyAligner& aligner, const Performance& performance) {
+    Agreement agreement;
+    AlignedFrame frame;
+    std::uint64_t lastTime = 0;
+    double lastReference = -1.0;
+    while (aligner.pop(frame)) {
+        // Committed frames come in stream order and never move back in the melody.
+        agreement.ordered = agreement.ordered && (agreement.frames == 0 || frame.sampleTime > lastTime) &&
+                            frame.referenceSeconds >= lastReference;
+        lastTime = frame.sampleTime;
+        lastReference = frame.referenceSeconds;
+        ++agreement.frames;
+        agreement.scored += frame.voiced && !frame.onRest ? 1 : 0;
+        const auto sung = performance.truth.find(frame.sampleTime);
+        if (sung == performance.truth.end() || nearChange(performance, frame.sampleTime)) {
+            continue;
+        }
+        ++agreement.checked;
+        agreement.matched += frame.noteIndex == sung->second ? 1 : 0;
+    }
+    return agreement;
+}
+
+void testInTime() {
+    MelodyAligner aligner(baseConfig());
+    TINE_CHECK(aligner.referenceFrames() == 475);
+    const Performance performance = sing(aligner, 1.0, 30.0);
+    const Agreement agreement = compare(aligner, performance);
+    TINE_CHECK(agreement.ordered);
+    TINE_CHECK(agreement.frames == performance.truth.size());
+    TINE_CHECK(agreement.checked > 400 && agreement.matched == agreement.checked);
+
+    const AlignmentScore score = aligner.score();
+    TINE_CHECK(score.finished);
+    TINE_CHECK(score.alignedFrames == performance.truth.size());
+    // Everything but the rest is voiced and scored, 30 cents sharp.
+    TINE_CHECK(score.scoredFrames == agreement.scored && score.scoredFrames == performance.truth.size() - 50);
+    TINE_CHECK(std::fabs(score.meanCents() - 30.0) < 0.05);
+    TINE_CHECK(std::fabs(score.meanAbsCents() - 30.0) < 0.05);
+    TINE_CHECK(score.inTuneFraction() == 0.0);
+    TINE_CHECK(score.noteIndex == kMelody.size() - 1);
+}
+
+void testTempo() {
+    for (double tempo : {0.5, 1.5}) {
+        MelodyAligner aligner(baseConfig());
+        const Performance performance = sing(aligner, tempo, 0.0);
+        const Agreement agreement = compare(aligner, performance);
+        TINE_CHECK(agreement.ordered);
+        TINE_CHECK(agreement.frames == performance.truth.size());
+        TINE_CHECK(agreement.checked > 0 && agreement.matched * 100 >= agreement.checked * 97);
+        const AlignmentScore score = aligner.score();
+        TINE_CHECK(score.meanAbsCents() < 1.0);
+        TINE_CHECK(score.inTuneFraction() == 1.0);
+    }
+}
+
+void testDropout() {
+    MelodyAlignerConfig config = baseConfig();
+    config.bandRadiusSeconds = 0.5;
+    MelodyAligner aligner(config);
+    // A second of missing results in the middle of the 65 and 67.
+    const auto from = static_cast<std::uint64_t>(1.75 * kSampleRate);
+    const auto to = static_cast<std::uint64_t>(2.75 * kSampleRate);
+    const Performance performance = sing(aligner, 1.0, 0.0, from, to);
+    const Agreement agreement = compare(aligner, performance);
+    TINE_CHECK(agreement.ordered);
+    // Only the results actually sung are committed, and they still land on their notes.
+    TINE_CHECK(agreement.frames == performance.truth.size());
+    TINE_CHECK(agreement.checked > 0 && agreement.matched * 100 >= agreement.checked * 97);
+}
+
+void testOctaveFold() {
+    MelodyAligner aligner(baseConfig());
+    const Performance performance = sing(aligner, 1.0, -1200.0);
+    const Agreement agreement = compare(aligner, performance);
+    TINE_CHECK(agreement.matched == agreement.checked);
+    TINE_CHECK(aligner.score().meanAbsCents() < 1e-3);
+}
+
+void testInputQueue() {
+    MelodyAlignerConfig config = baseConfig();
+    config.inputCapacity = 4;
+    MelodyAligner aligner(config);
+
+    // Silence before the first note is not aligned.
+    TINE_CHECK(aligner.submit(PitchResult{}, 0));
+    for (std::uint64_t i = 1; i < 6; ++i) {
+        aligner.submit(voiced(60.0), i * kHop);
+    }
+    TINE_CHECK(aligner.droppedResults() == 2);
+    TINE_CHECK(aligner.drain() == 4);
+    TINE_CHECK(aligner.drain() == 0);
+    aligner.finish();
+    TINE_CHECK(aligner.score().alignedFrames == 3);
+
+    // reset() starts over and clears the finished state.
+    aligner.reset();
+    TINE_CHECK(!aligner.score().finished && aligner.score().alignedFrames == 0);
+}
+
+}  // namespace
+
+int main() {
+    testInTime();
+    testTempo();
+    testDropout();
+    testOctaveFold();
+    testInputQueue();
+    return tine::test::finish("MelodyAlignerTest");
+}
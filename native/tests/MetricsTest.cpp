@@ -0,0 +1,189 @@
+// MetricHistogram against exact order statistics: every reported quantile is at
+// or above the true one and within 1/SUB_BUCKETS of it (exact below
+// 2 * SUB_BUCKETS), while count, sum and the extremes stay exact, also with
+// writers on several threads; merging histograms matches recording everything
+// into one; and reset() forgets every sample, extremes included.
+//
+// Build (from the repository root):
+//   c++ -std=c++20 -O2 -pthread -Inative/cpp -Inative/tests native/tests/MetricsTest.cpp
+//       native/cpp/Metrics.cpp -o metrics_test
+//   ./metrics_test
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <numeric>
+#include <thread>
+#include <vector>
+
+#include "Metrics.hpp"
+#include "TestSupport.hpp"
+
+using namespace tine::dsp;
+
+namespace {
+
+const std::vector<double> kQuantiles{0.0, 0.1, 0.5, 0.9, 0.99, 0.999, 1.0};
+constexpr double kRelativeError = 1.0 / static_cast<double>(MetricHistogram::SUB_BUCKETS);
+
+/** Log-uniform values from 1 to about 2^34 (tens of seconds in nanoseconds). */
+std::vector<std::uint64_t> makeSamples(std::size_t count, std::uint64_t seed) {
+    std::vector<std::uint64_t> samples(count);
+    std::uint64_t state = seed;
+    for (std::uint64_t& sample : samples) {
+        state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+        const double unit = static_cast<double>(state >> 11) / 9007199254740992.0;
+        sample = static_cast<std::uint64_t>(std::exp2(34.0 * unit));
+    }
+    return samples;
+}
+
+bool sameSummary(const MetricHistogram::Summary& a, const MetricHistogram::Summary& b) {
+    return a.count == b.count && a.sum == b.sum && a.min == b.min && a.max == b.max && a.quantiles == b.quantiles;
+}
+
+void testBuckets() {
+    // Every value lands in the bucket whose upper edge is the first at or above it.
+    bool bounded = true;
+    for (std::uint64_t value : makeSamples(100000, 7)) {
+        const std::size_t index = MetricHistogram::bucketIndex(value);
+        bounded = bounded && MetricHistogram::bucketUpperBound(index) >= value &&
+                  (index == 0 || MetricHistogram::bucketUpperBound(index - 1) < value);
+    }
+    TINE_CHECK(bounded);
+    for (std::uint64_t value = 0; value < 2 * MetricHistogram::SUB_BUCKETS; ++value) {
+        bounded = bounded && MetricHistogram::bucketUpperBound(MetricHistogram::bucketIndex(value)) == value;
+    }
+    TINE_CHECK(bounded);
+    TINE_CHECK(MetricHistogram::bucketIndex(MetricHistogram::MAX_VALUE) == MetricHistogram::BUCKET_COUNT - 1);
+    TINE_CHECK(MetricHistogram::bucketUpperBound(MetricHistogram::BUCKET_COUNT - 1) == MetricHistogram::MAX_VALUE);
+}
+
+void testQuantileError() {
+    std::vector<std::uint64_t> samples = makeSamples(200000, 42);
+    // A few small values, which must come out exact.
+    for (std::uint64_t value = 0; value < 2 * MetricHistogram::SUB_BUCKETS; ++value) {
+        samples.push_back(value);
+    }
+    MetricHistogram histogram;
+    for (std::uint64_t value : samples) {
+        histogram.record(value);
+    }
+    const MetricHistogram::Summary summary = histogram.summarize(kQuantiles);
+
+    std::sort(samples.begin(), samples.end());
+    TINE_CHECK(summary.count == samples.size());
+    TINE_CHECK(summary.sum == std::accumulate(samples.begin(), samples.end(), std::uint64_t{0}));
+    TINE_CHECK(summary.min == samples.front() && summary.max == samples.back());
+
+    for (const auto& [q, value] : summary.quantiles) {
+        const auto rank = static_cast<std::size_t>(std::max(1.0, std::ceil(q * static_cast<double>(samples.size()))));
+        const std::uint64_t exact = samples[rank - 1];
+        const double error = exact > 0 ? static_cast<double>(value - exact) / static_cast<double>(exact) : 0.0;
+        const bool within = value >= exact && value <= summary.max && error < kRelativeError &&
+                            (exact >= 2 * MetricHistogram::SUB_BUCKETS || value == exact);
+        if (!TINE_CHECK(within)) {
+            std::fprintf(stderr, "  q=%g: reported %llu, exact %llu\n", q, static_cast<unsigned long long>(value),
+                         static_cast<unsigned long long>(exact));
+        }
+    }
+
+    // Past MAX_VALUE the bucket saturates but the maximum stays exact.
+    MetricHistogram saturated;
+    saturated.record(MetricHistogram::MAX_VALUE * 4);
+    const MetricHistogram::Summary top = saturated.summarize({1.0});
+    TINE_CHECK(top.max == MetricHistogram::MAX_VALUE * 4 && top.quantiles[0].second == top.max);
+}
+
+void testConcurrentRecording() {
+    constexpr std::size_t kWriters = 4;
+    MetricHistogram shared;
+    MetricHistogram reference;
+    std::vector<std::vector<std::uint64_t>> perWriter;
+    for (std::size_t w = 0; w < kWriters; ++w) {
+        perWriter.push_back(makeSamples(50000, 100 + w));
+        for (std::uint64_t value : perWriter.back()) {
+            reference.record(value);
+        }
+    }
+    std::vector<std::thread> writers;
+    for (std::size_t w = 0; w < kWriters; ++w) {
+        writers.emplace_back([&shared, &samples = perWriter[w]] {
+            for (std::uint64_t value : samples) {
+                shared.record(value);
+            }
+        });
+    }
+    for (std::thread& writer : writers) {
+        writer.join();
+    }
+    TINE_CHECK(sameSummary(shared.summarize(kQuantiles), reference.summarize(kQuantiles)));
+}
+
+void testMerge() {
+    const std::vector<std::uint64_t> low = makeSamples(30000, 1);
+    std::vector<std::uint64_t> high = makeSamples(30000, 2);
+    for (std::uint64_t& value : high) {
+        value += 1000000;
+    }
+
+    MetricHistogram a;
+    MetricHistogram b;
+    MetricHistogram all;
+    for (std::uint64_t value : low) {
+        a.record(value);
+        all.record(value);
+    }
+    for (std::uint64_t value : high) {
+        b.record(value);
+        all.record(value);
+    }
+
+    // Either way round, and into an empty histogram, which takes the other's extremes.
+    MetricHistogram empty;
+    empty.merge(b);
+    empty.merge(a);
+    a.merge(b);
+    TINE_CHECK(sameSummary(a.summarize(kQuantiles), all.summarize(kQuantiles)));
+    TINE_CHECK(sameSummary(empty.summarize(kQuantiles), all.summarize(kQuantiles)));
+    // The source is left as it was, and merging an empty histogram changes nothing.
+    TINE_CHECK(b.summarize({}).count == high.size());
+    a.merge(MetricHistogram{});
+    TINE_CHECK(sameSummary(a.summarize(kQuantiles), all.summarize(kQuantiles)));
+}
+
+void testReset() {
+    MetricHistogram histogram;
+    for (std::uint64_t value : makeSamples(10000, 9)) {
+        histogram.record(value);
+    }
+    histogram.record(0);
+    histogram.reset();
+
+    const MetricHistogram::Summary cleared = histogram.summarize(kQuantiles);
+    TINE_CHECK(cleared.count == 0 && cleared.sum == 0 && cleared.min == 0 && cleared.max == 0);
+    bool zero = true;
+    for (const auto& [q, value] : cleared.quantiles) {
+        zero = zero && value == 0;
+    }
+    TINE_CHECK(zero);
+
+    // Old extremes are gone: a fresh sample is its own minimum and maximum.
+    histogram.record(5000);
+    const MetricHistogram::Summary fresh = histogram.summarize({0.5});
+    TINE_CHECK(fresh.count == 1 && fresh.sum == 5000 && fresh.min == 5000 && fresh.max == 5000);
+    TINE_CHECK(fresh.quantiles[0].second == 5000);
+}
+
+}  // namespace
+
+int main() {
+    testBuckets();
+    testQuantileError();
+    testConcurrentRecording();
+    testMerge();
+    testReset();
+    return tine::test::finish("MetricsTest");
+}
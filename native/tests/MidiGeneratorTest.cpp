@@ -0,0 +1,235 @@
+// MidiGenerator decisions and encoding: a note starts at onProbability and is
+// held down to offProbability, a single stray hop bends while the same new note
+// twice running replaces the held one, a level rise re-articulates, and the
+// wire bytes and Standard MIDI File layout match the MIDI 1.0 spec byte for byte.
+//
+// Build (from the repository root):
+//   c++ -std=c++20 -O2 -Inative/cpp -Inative/tests native/tests/MidiGeneratorTest.cpp
+//       native/cpp/MidiGenerator.cpp -o midi_generator_test
+//   ./midi_generator_test
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "MidiGenerator.hpp"
+#include "TestSupport.hpp"
+
+using namespace tine::dsp;
+
+namespace {
+
+PitchResult voiced(double midi, double probability) {
+    PitchResult result;
+    result.isValid = true;
+    result.midi = midi;
+    result.frequency = 440.0 * std::pow(2.0, (midi - 69.0) / 12.0);
+    result.probability = probability;
+    return result;
+}
+
+std::vector<MidiEvent> drain(MidiGenerator& generator) {
+    std::vector<MidiEvent> events;
+    MidiEvent event;
+    while (generator.pop(event)) {
+        events.push_back(event);
+    }
+    return events;
+}
+
+std::size_t count(const std::vector<MidiEvent>& events, MidiEventType type) {
+    std::size_t n = 0;
+    for (const MidiEvent& event : events) {
+        n += event.type == type ? 1 : 0;
+    }
+    return n;
+}
+
+void testProbabilityHysteresis() {
+    MidiGenerator generator;
+
+    // Below onProbability nothing starts.
+    generator.process(voiced(60.0, 0.85), 512);
+    TINE_CHECK(generator.heldNote() == -1);
+    TINE_CHECK(drain(generator).empty());
+
+    // A confident result starts the note in tune: bend first, then the note-on, same frame.
+    generator.process(voiced(60.0, 0.95), 1024);
+    TINE_CHECK(generator.heldNote() == 60);
+    std::vector<MidiEvent> events = drain(generator);
+    TINE_CHECK(events.size() == 2);
+    if (events.size() == 2) {
+        TINE_CHECK(events[0].type == MidiEventType::PitchBend && events[0].bend == 8192);
+        TINE_CHECK(events[1].type == MidiEventType::NoteOn && events[1].note == 60);
+        TINE_CHECK(events[0].sampleTime == 1024 && events[1].sampleTime == 1024);
+        TINE_CHECK(events[1].velocity >= 64);
+    }
+
+    // Between the two thresholds the note is held.
+    generator.process(voiced(60.0, 0.8), 1536);
+    TINE_CHECK(generator.heldNote() == 60);
+    TINE_CHECK(count(drain(generator), MidiEventType::NoteOff) == 0);
+
+    // Under offProbability it is released on the same hop.
+    generator.process(voiced(60.0, 0.7), 2048);
+    TINE_CHECK(generator.heldNote() == -1);
+    events = drain(generator);
+    TINE_CHECK(events.size() == 1 && events[0].type == MidiEventType::NoteOff && events[0].note == 60 &&
+               events[0].sampleTime == 2048);
+
+    // An unvoiced result releases too.
+    generator.process(voiced(64.0, 0.95), 2560);
+    generator.process(PitchResult{}, 3072);
+    TINE_CHECK(generator.heldNote() == -1);
+    TINE_CHECK(count(drain(generator), MidiEventType::NoteOff) == 1);
+}
+
+void testRetriggerLock() {
+    MidiGenerator generator;
+    generator.process(voiced(60.0, 0.95), 0);
+    drain(generator);
+
+    // A nearby excursion only bends: 30 cents on a 2-semitone range.
+    generator.process(voiced(60.3, 0.95), 512);
+    std::vector<MidiEvent> events = drain(generator);
+    TINE_CHECK(events.size() == 1 && events[0].type == MidiEventType::PitchBend);
+    if (!events.empty()) {
+        TINE_CHECK(events[0].bend == 8192 + std::lround(0.3 / 2.0 * 8192.0));
+    }
+    // Under bendResolutionCents nothing is sent.
+    generator.process(voiced(60.3049, 0.95), 1024);
+    TINE_CHECK(drain(generator).empty());
+
+    // One stray hop at a new note bends and keeps the held note.
+    generator.process(voiced(62.0, 0.95), 1536);
+    TINE_CHECK(generator.heldNote() == 60);
+    events = drain(generator);
+    TINE_CHECK(count(events, MidiEventType::NoteOn) == 0 && count(events, MidiEventType::PitchBend) == 1);
+
+    // Back near the held note clears the pending change, so the next stray bends again.
+    generator.process(voiced(60.0, 0.95), 2048);
+    generator.process(voiced(62.0, 0.95), 2560);
+    TINE_CHECK(generator.heldNote() == 60);
+    TINE_CHECK(count(drain(generator), MidiEventType::NoteOn) == 0);
+
+    // The same new note on the following hop replaces it: off, bend, on.
+    generator.process(voiced(62.0, 0.95), 3072);
+    TINE_CHECK(generator.heldNote() == 62);
+    events = drain(generator);
+    TINE_CHECK(events.size() == 3);
+    if (events.size() == 3) {
+        TINE_CHECK(events[0].type == MidiEventType::NoteOff && events[0].note == 60);
+        TINE_CHECK(events[1].type == MidiEventType::PitchBend && events[1].bend == 8192);
+        TINE_CHECK(events[2].type == MidiEventType::NoteOn && events[2].note == 62);
+        TINE_CHECK(events[2].sampleTime == 3072);
+    }
+
+    // With retriggerHops = 1 the first hop away already changes the note.
+    MidiGeneratorConfig eager;
+    eager.retriggerHops = 1;
+    MidiGenerator fast(eager);
+    fast.process(voiced(60.0, 0.95), 0);
+    fast.process(voiced(64.0, 0.95), 512);
+    TINE_CHECK(fast.heldNote() == 64);
+}
+
+void testOnsetAndVelocity() {
+    MidiGenerator generator;
+    generator.process(voiced(57.0, 0.95), 0, -60.0);
+    std::vector<MidiEvent> events = drain(generator);
+    TINE_CHECK(events.size() == 2 && events[1].velocity == 1);
+
+    // A steady level holds; a 9 dB rise re-picks the same note at the new level.
+    generator.process(voiced(57.0, 0.95), 512, -58.0);
+    TINE_CHECK(count(drain(generator), MidiEventType::NoteOn) == 0);
+    generator.process(voiced(57.0, 0.95), 1024, -6.0);
+    events = drain(generator);
+    TINE_CHECK(events.size() == 3);
+    if (events.size() == 3) {
+        TINE_CHECK(events[0].type == MidiEventType::NoteOff && events[0].note == 57);
+        TINE_CHECK(events[2].type == MidiEventType::NoteOn && events[2].note == 57 && events[2].velocity == 127);
+    }
+
+    generator.allNotesOff(1536);
+    TINE_CHECK(generator.heldNote() == -1);
+    events = drain(generator);
+    TINE_CHECK(events.size() == 1 && events[0].type == MidiEventType::NoteOff && events[0].sampleTime == 1536);
+}
+
+void testWireBytes() {
+    std::uint8_t bytes[3];
+    MidiEvent on;
+    on.type = MidiEventType::NoteOn;
+    on.channel = 9;
+    on.note = 60;
+    on.velocity = 100;
+    TINE_CHECK(on.toBytes(bytes) == 3);
+    TINE_CHECK(bytes[0] == 0x99 && bytes[1] == 60 && bytes[2] == 100);
+
+    MidiEvent off = on;
+    off.type = MidiEventType::NoteOff;
+    off.velocity = 0;
+    off.toBytes(bytes);
+    TINE_CHECK(bytes[0] == 0x89 && bytes[1] == 60 && bytes[2] == 0);
+
+    // 14-bit bend, LSB first.
+    MidiEvent bend;
+    bend.type = MidiEventType::PitchBend;
+    bend.bend = 0x2345;
+    bend.toBytes(bytes);
+    TINE_CHECK(bytes[0] == 0xE0 && bytes[1] == (0x2345 & 0x7F) && bytes[2] == (0x2345 >> 7));
+
+    // The generator stamps its configured channel.
+    MidiGeneratorConfig config;
+    config.channel = 3;
+    MidiGenerator generator(config);
+    generator.process(voiced(60.0, 0.95), 0);
+    for (const MidiEvent& event : drain(generator)) {
+        TINE_CHECK(event.channel == 3);
+    }
+}
+
+void testStandardMidiFile() {
+    // One second apart at 48 kHz, rebased so the first event is tick 0.
+    MidiEvent on;
+    on.sampleTime = 48000;
+    on.type = MidiEventType::NoteOn;
+    on.note = 60;
+    on.velocity = 100;
+    MidiEvent off = on;
+    off.sampleTime = 96000;
+    off.type = MidiEventType::NoteOff;
+    off.velocity = 0;
+
+    const std::vector<std::uint8_t> file = encodeStandardMidiFile({on, off}, 48000.0, 960);
+    // 960 ticks per quarter at 120 bpm is 1920 ticks a second: VLQ 0x8F 0x00.
+    const std::vector<std::uint8_t> expected = {
+        'M', 'T', 'h', 'd', 0, 0, 0, 6, 0, 0, 0, 1, 0x03, 0xC0,
+        'M', 'T', 'r', 'k', 0, 0, 0, 20,
+        0x00, 0xFF, 0x51, 0x03, 0x07, 0xA1, 0x20,
+        0x00, 0x90, 60, 100,
+        0x8F, 0x00, 0x80, 60, 0,
+        0x00, 0xFF, 0x2F, 0x00,
+    };
+    TINE_CHECK(file == expected);
+
+    // Out-of-order times never produce a negative delta.
+    const std::vector<std::uint8_t> reordered = encodeStandardMidiFile({off, on}, 48000.0, 960);
+    TINE_CHECK(reordered.size() == expected.size() - 1);
+    TINE_CHECK(reordered[reordered.size() - 8] == 0x00 && reordered[reordered.size() - 7] == 0x90);
+
+    // An empty list is still a valid file with just the tempo and end of track.
+    TINE_CHECK(encodeStandardMidiFile({}, 48000.0).size() == 14 + 8 + 11);
+}
+
+}  // namespace
+
+int main() {
+    testProbabilityHysteresis();
+    testRetriggerLock();
+    testOnsetAndVelocity();
+    testWireBytes();
+    testStandardMidiFile();
+    return tine::test::finish("MidiGeneratorTest");
+}
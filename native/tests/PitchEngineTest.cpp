@@ -0,0 +1,265 @@
+// PitchEngine adaptive window: a high tone shrinks the analyzed window down the
+// halving ladder and a low tone grows it back to the full window, while a pitch
+// wandering back and forth across a ladder step settles on one size instead of
+// resizing every few hops. Draining the ring once per planned batch of hops
+// yields exactly the results draining after every hop does. When consumers
+// push inline hops over budget the engine falls back to the worker once, and
+// the worker carries on from the ring without losing or repeating a hop.
+//
+// Build (from the repository root):
+//   c++ -std=c++20 -O2 -pthread -Inative/cpp -Inative/tests native/tests/PitchEngineTest.cpp
+//       native/cpp/PitchEngine.cpp native/cpp/YinPitchDetector.cpp native/cpp/DifferenceKernel.cpp
+//       native/cpp/KernelAutotuner.cpp native/cpp/BroadcastRingBuffer.cpp native/cpp/Metrics.cpp
+//       native/cpp/RtLog.cpp native/cpp/DialAnimator.cpp native/cpp/MidiGenerator.cpp
+//       native/cpp/ToneGenerator.cpp native/cpp/SessionAnalytics.cpp native/cpp/PitchTrackStore.cpp
+//       native/cpp/MelodyAligner.cpp native/cpp/LatencyPlanner.cpp -o pitch_engine_test
+//   ./pitch_engine_test
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "LatencyPlanner.hpp"
+#include "PitchEngine.hpp"
+#include "TestSupport.hpp"
+
+using namespace tine::dsp;
+
+namespace {
+
+constexpr double kSampleRate = 48000.0;
+constexpr std::size_t kWindow = 2048;
+constexpr std::size_t kHop = 256;
+constexpr std::size_t kBlock = 128;
+
+double metric(const PitchEngine& engine, const std::string& name) {
+    for (const MetricsSnapshot::Value& value : engine.metrics().snapshot().values) {
+        if (value.name == name) {
+            return value.value;
+        }
+    }
+    return -1.0;
+}
+
+/** Five-harmonic tone whose frequency follows @p hz (called per frame), phase-continuous. */
+template <typename Frequency>
+std::vector<float> makeTone(std::size_t frames, Frequency hz) {
+    std::vector<float> samples(frames);
+    double phase = 0.0;
+    for (std::size_t i = 0; i < frames; ++i) {
+        phase += 2.0 * M_PI * hz(i) / kSampleRate;
+        double value = 0.0;
+        for (int h = 1; h <= 5; ++h) {
+            value += std::sin(h * phase) / h;
+        }
+        samples[i] = static_cast<float>(0.3 * value);
+    }
+    return samples;
+}
+
+/** Push @p signal in capture-sized blocks, draining after each one. */
+void feed(PitchEngine& engine, const std::vector<float>& signal) {
+    for (std::size_t offset = 0; offset < signal.size(); offset += kBlock) {
+        engine.pushAudio(signal.data() + offset, std::min(kBlock, signal.size() - offset));
+        engine.processPending();
+    }
+}
+
+PitchEngineConfig adaptiveConfig() {
+    PitchEngineConfig config;
+    config.sampleRate = kSampleRate;
+    config.windowSize = kWindow;
+    config.hopSize = kHop;
+    config.captureBlockFrames = kBlock;
+    config.adaptiveWindow = true;
+    config.minAdaptiveWindow = 256;
+    return config;
+}
+
+void testAdaptiveWindow() {
+    PitchEngine engine(adaptiveConfig());
+    TINE_CHECK(engine.windowLadder() == std::vector<std::size_t>({2048, 1024, 512, 256}));
+    TINE_CHECK(engine.activeWindow() == kWindow);
+
+    // 1 kHz needs under a hundred lags: the window steps all the way down,
+    // one halving per adaptiveShrinkAfter agreeing results.
+    const std::size_t second = static_cast<std::size_t>(kSampleRate);
+    feed(engine, makeTone(second, [](std::size_t) { return 1000.0; }));
+    TINE_CHECK(engine.activeWindow() == 256);
+    TINE_CHECK(metric(engine, "tine_window_resizes_total") == 3.0);
+    TINE_CHECK(metric(engine, "tine_active_window_frames") == 256.0);
+
+    // 60 Hz is far below the 256-frame lag range: back to the full window.
+    std::vector<double> low;
+    engine.setResultHandler([&low](const PitchResult& result) {
+        if (result.isValid) {
+            low.push_back(result.frequency);
+        }
+    });
+    feed(engine, makeTone(second, [](std::size_t) { return 60.0; }));
+    TINE_CHECK(engine.activeWindow() == kWindow);
+    // And the full window then tracks it.
+    TINE_CHECK(!low.empty() && std::fabs(low.back() - 60.0) < 0.5);
+}
+
+std::vector<float> vibrato(double centreHz, std::size_t frames) {
+    return makeTone(frames, [centreHz](std::size_t i) {
+        return centreHz * (1.0 + 0.06 * std::sin(2.0 * M_PI * 5.0 * static_cast<double>(i) / kSampleRate));
+    });
+}
+
+void testNoThrash() {
+    const std::size_t second = static_cast<std::size_t>(kSampleRate);
+
+    // The 512 -> 256 step shrinks from about 762 Hz up. Vibrato across that edge
+    // steps down the ladder once and stays there.
+    PitchEngine shrinking(adaptiveConfig());
+    feed(shrinking, vibrato(762.0, 3 * second));
+    TINE_CHECK(shrinking.activeWindow() == 256);
+    TINE_CHECK(metric(shrinking, "tine_window_resizes_total") == 3.0);
+
+    // From 256 it grows back below about 476 Hz, but only shrinks again from
+    // 762 Hz. Vibrato across the grow edge settles on 512 and stays.
+    PitchEngine growing(adaptiveConfig());
+    feed(growing, makeTone(second, [](std::size_t) { return 1000.0; }));
+    TINE_CHECK(growing.activeWindow() == 256);
+    const std::vector<float> wobble = vibrato(476.0, 3 * second);
+    feed(growing, std::vector<float>(wobble.begin(), wobble.begin() + second));
+    TINE_CHECK(growing.activeWindow() == 512);
+    const double settled = metric(growing, "tine_window_resizes_total");
+    feed(growing, std::vector<float>(wobble.begin() + second, wobble.end()));
+    TINE_CHECK(growing.activeWindow() == 512);
+    TINE_CHECK(metric(growing, "tine_window_resizes_total") == settled);
+}
+
+struct Recorded {
+    bool isValid;
+    double frequency;
+    double probability;
+
+    bool operator==(const Recorded&) const = default;
+};
+
+/**
+ * Run @p signal through @p config, delivering in @p tap blocks and draining after
+ * every @p batchHops hops' worth of capture.
+ */
+std::vector<Recorded> drainInBatches(const PitchEngineConfig& config, const std::vector<float>& signal,
+                                     std::size_t tap, std::size_t batchHops) {
+    PitchEngine engine(config);
+    std::vector<Recorded> results;
+    engine.setResultHandler([&results](const PitchResult& result) {
+        results.push_back({result.isValid, result.frequency, result.probability});
+    });
+    const std::size_t drainFrames = batchHops * config.hopSize;
+    std::size_t sinceDrain = 0;
+    for (std::size_t offset = 0; offset + tap <= signal.size(); offset += tap) {
+        engine.pushAudio(signal.data() + offset, tap);
+        sinceDrain += tap;
+        if (sinceDrain >= drainFrames) {
+            engine.processPending();
+            sinceDrain = 0;
+        }
+    }
+    engine.processPending();
+    TINE_CHECK(engine.overruns() == 0 && engine.lostFrames() == 0);
+    return results;
+}
+
+void testBatchedDrain() {
+    LatencyPlanRequest request;
+    request.sampleRate = kSampleRate;
+    request.windowFrames = kWindow;
+    request.ioPeriodFrames = kBlock;
+    const LatencyPlan single = planLatency(request);
+    request.maxBatchLatencySeconds = 0.15;
+    const LatencyPlan batched = planLatency(request);
+    TINE_CHECK(batched.batchHops > 1);
+    TINE_CHECK(batched.hopFrames == single.hopFrames && batched.tapFrames == single.tapFrames);
+
+    // A glide so every hop's result differs from its neighbours'.
+    const std::vector<float> signal = tine::test::makeGlide(kSampleRate, 2 * static_cast<std::size_t>(kSampleRate),
+                                                            110.0, 440.0);
+    const std::vector<Recorded> perHop =
+        drainInBatches(single.engineConfig(0.1), signal, single.tapFrames, single.batchHops);
+    const std::vector<Recorded> perBatch =
+        drainInBatches(batched.engineConfig(0.1), signal, batched.tapFrames, batched.batchHops);
+    TINE_CHECK(perHop.size() == (signal.size() - kWindow) / single.hopFrames + 1);
+    TINE_CHECK(perBatch == perHop);
+}
+
+void testInlineFallback() {
+    PitchEngineConfig config;
+    config.sampleRate = kSampleRate;
+    config.windowSize = 1024;
+    config.hopSize = kHop;
+    config.captureBlockFrames = 64;
+    const std::vector<float> signal =
+        tine::test::makeGlide(kSampleRate, static_cast<std::size_t>(kSampleRate), 150.0, 600.0);
+
+    std::vector<Recorded> reference;
+    {
+        PitchEngine worker(config);
+        worker.setResultHandler([&reference](const PitchResult& result) {
+            reference.push_back({result.isValid, result.frequency, result.probability});
+        });
+        for (std::size_t offset = 0; offset < signal.size(); offset += config.captureBlockFrames) {
+            worker.pushAudio(signal.data() + offset, config.captureBlockFrames);
+            worker.processPending();
+        }
+    }
+
+    // A generous budget that calibration easily meets; the consumer then blows it.
+    config.mode = EngineMode::Inline;
+    config.inlineBudgetFraction = 20.0;
+    PitchEngine engine(config);
+    TINE_CHECK(engine.inlineActive());
+    const auto slowConsumer = std::chrono::duration<double>(1.2 * engine.inlineBudgetSeconds());
+
+    std::vector<Recorded> results;
+    std::size_t slowHops = 0;
+    engine.setResultHandler([&](const PitchResult& result) {
+        results.push_back({result.isValid, result.frequency, result.probability});
+        if (results.size() > 20 && engine.inlineActive()) {
+            ++slowHops;
+            std::this_thread::sleep_for(slowConsumer);
+        }
+    });
+    std::size_t inlineResults = 0;
+    for (std::size_t offset = 0; offset < signal.size(); offset += config.captureBlockFrames) {
+        const bool wasInline = engine.inlineActive();
+        engine.pushAudio(signal.data() + offset, config.captureBlockFrames);
+        if (wasInline) {
+            inlineResults = results.size();
+        }
+        // The engine thread's tick; a no-op while inline.
+        engine.processPending();
+    }
+
+    // Fell back after inlineStrikeLimit slow hops, once, and stayed in worker mode.
+    TINE_CHECK(!engine.inlineActive());
+    TINE_CHECK(slowHops == config.inlineStrikeLimit);
+    TINE_CHECK(inlineResults == 20 + config.inlineStrikeLimit);
+    TINE_CHECK(metric(engine, "tine_inline_fallbacks_total") == 1.0);
+    TINE_CHECK(metric(engine, "tine_inline_active") == 0.0);
+    TINE_CHECK(engine.inlineWorstCaseSeconds() > engine.inlineBudgetSeconds());
+    // Every hop analyzed exactly once, in order, as if the worker had run throughout.
+    TINE_CHECK(engine.lostFrames() == 0);
+    TINE_CHECK(results.size() == reference.size() && results.size() > inlineResults);
+    TINE_CHECK(results == reference);
+}
+
+}  // namespace
+
+int main() {
+    testAdaptiveWindow();
+    testNoThrash();
+    testBatchedDrain();
+    testInlineFallback();
+    return tine::test::finish("PitchEngineTest");
+}
@@ -0,0 +1,282 @@
+// PitchTrackCache bookkeeping: chunk keys follow the audio and the analysis
+// settings but not the threshold; the least recently used entry is evicted
+// first, also for entries adopted from disk by a new instance; a corrupt entry
+// or one of the wrong length is dropped and counted as a miss; and a second
+// cached pass over a file reports exactly what the first, uncached pass did.
+//
+// Build (from the repository root):
+//   c++ -std=c++20 -O2 -pthread -Inative/cpp -Inative/tests native/tests/PitchTrackCacheTest.cpp
+//       native/cpp/PitchTrackCache.cpp native/cpp/CandidateTrack.cpp native/cpp/AsyncStream.cpp
+//       native/cpp/AsyncScheduler.cpp native/cpp/ThreadPool.cpp native/cpp/ThreadConfig.cpp
+//       native/cpp/StreamScheduler.cpp native/cpp/Metrics.cpp native/cpp/YinPitchDetector.cpp
+//       native/cpp/DifferenceKernel.cpp native/cpp/KernelAutotuner.cpp -o pitch_track_cache_test
+//   ./pitch_track_cache_test
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/stat.h>
+
+#include "AsyncScheduler.hpp"
+#include "PitchTrackCache.hpp"
+#include "TestSupport.hpp"
+
+using namespace tine::dsp;
+
+namespace {
+
+constexpr double kSampleRate = 48000.0;
+constexpr std::size_t kWindow = 2048;
+constexpr std::size_t kHop = 512;
+constexpr std::size_t kFrames = 8;
+
+CandidateTrackInfo trackInfo() {
+    CandidateTrackInfo info;
+    info.sampleRate = kSampleRate;
+    info.windowSize = kWindow;
+    info.hopSize = kHop;
+    return info;
+}
+
+std::vector<float> makeChunk(double hz) {
+    return tine::test::makeGlide(kSampleRate, kWindow + (kFrames - 1) * kHop, hz, hz * 1.1);
+}
+
+CandidateTrack record(const std::vector<float>& samples) {
+    CandidateTrack track;
+    track.info = trackInfo();
+    YinPitchDetector detector(kSampleRate, kWindow, 0.12);
+    detector.setCandidateLog(&track.log);
+    std::vector<PitchResult> results(kFrames);
+    static_cast<void>(detector.processFrames(samples.data(), samples.size(), kHop, results.data(), kFrames));
+    return track;
+}
+
+struct Entry {
+    TrackChunkKey key;
+    CandidateTrack track;
+    std::uint64_t bytes{0};
+};
+
+Entry makeEntry(double hz) {
+    const std::vector<float> samples = makeChunk(hz);
+    Entry entry;
+    entry.key = hashTrackChunk(samples.data(), samples.size(), trackInfo());
+    entry.track = record(samples);
+    entry.bytes = entry.track.serialize().size();
+    return entry;
+}
+
+std::string entryPath(const std::string& directory, const TrackChunkKey& key) {
+    return directory + "/" + key.hex() + ".tpc";
+}
+
+void setModified(const std::string& path, std::int64_t seconds) {
+    const struct timespec times[2] = {{seconds, 0}, {seconds, 0}};
+    ::utimensat(AT_FDCWD, path.c_str(), times, 0);
+}
+
+void testKeys() {
+    const std::vector<float> samples = makeChunk(220.0);
+    const TrackChunkKey key = hashTrackChunk(samples.data(), samples.size(), trackInfo());
+    TINE_CHECK(key == hashTrackChunk(samples.data(), samples.size(), trackInfo()));
+    TINE_CHECK(key.hex().size() == 32);
+
+    std::vector<float> nudged = samples;
+    nudged[nudged.size() / 2] += 1e-6F;
+    TINE_CHECK(!(key == hashTrackChunk(nudged.data(), nudged.size(), trackInfo())));
+    TINE_CHECK(!(key == hashTrackChunk(samples.data(), samples.size() - 1, trackInfo())));
+
+    CandidateTrackInfo other = trackInfo();
+    other.hopSize = kHop * 2;
+    TINE_CHECK(!(key == hashTrackChunk(samples.data(), samples.size(), other)));
+    other = trackInfo();
+    other.refinement = LagRefinement::Cubic;
+    TINE_CHECK(!(key == hashTrackChunk(samples.data(), samples.size(), other)));
+}
+
+void testLruEviction(const std::string& directory) {
+    const Entry a = makeEntry(110.0);
+    const Entry b = makeEntry(165.0);
+    const Entry c = makeEntry(247.0);
+
+    PitchTrackCacheConfig config;
+    config.directory = directory;
+    // Room for any two of the three, not all of them.
+    config.maxBytes = a.bytes + b.bytes + c.bytes - 1;
+    PitchTrackCache cache(config);
+
+    TINE_CHECK(cache.store(a.key, a.track));
+    TINE_CHECK(cache.store(b.key, b.track));
+    CandidateTrack loaded;
+    // Touching a makes b the least recently used.
+    TINE_CHECK(cache.lookup(a.key, kFrames, loaded) && loaded.frameCount() == kFrames);
+    TINE_CHECK(cache.store(c.key, c.track));
+
+    PitchTrackCacheStats stats = cache.stats();
+    TINE_CHECK(stats.evictions == 1 && stats.entries == 2 && stats.stores == 3);
+    TINE_CHECK(stats.bytes == a.bytes + c.bytes);
+    TINE_CHECK(!std::filesystem::exists(entryPath(directory, b.key)));
+    TINE_CHECK(!cache.lookup(b.key, kFrames, loaded));
+    TINE_CHECK(cache.lookup(c.key, kFrames, loaded));
+    TINE_CHECK(cache.lookup(a.key, kFrames, loaded));
+
+    // Replacing an entry is not a second entry.
+    TINE_CHECK(cache.store(a.key, a.track));
+    stats = cache.stats();
+    TINE_CHECK(stats.entries == 2 && stats.bytes == a.bytes + c.bytes);
+    TINE_CHECK(stats.hits == 3 && stats.misses == 1);
+
+    // The newest entry stays even when it alone is over budget.
+    PitchTrackCacheConfig tiny = config;
+    tiny.directory = directory + "/tiny";
+    tiny.maxBytes = 1;
+    PitchTrackCache small(tiny);
+    TINE_CHECK(small.store(a.key, a.track) && small.store(b.key, b.track));
+    TINE_CHECK(small.stats().entries == 1);
+    TINE_CHECK(small.lookup(b.key, kFrames, loaded) && !small.lookup(a.key, kFrames, loaded));
+    small.clear();
+    TINE_CHECK(small.stats().entries == 0 && small.stats().bytes == 0);
+    TINE_CHECK(!std::filesystem::exists(entryPath(tiny.directory, b.key)));
+}
+
+void testAdoption(const std::string& directory) {
+    const Entry a = makeEntry(110.0);
+    const Entry b = makeEntry(165.0);
+    const Entry c = makeEntry(247.0);
+    PitchTrackCacheConfig config;
+    config.directory = directory;
+    {
+        PitchTrackCache cache(config);
+        TINE_CHECK(cache.store(a.key, a.track) && cache.store(b.key, b.track) && cache.store(c.key, c.track));
+    }
+    // Recency survives a restart through modification times: b oldest, then c, then a.
+    setModified(entryPath(directory, b.key), 1000000000);
+    setModified(entryPath(directory, c.key), 1000000100);
+    setModified(entryPath(directory, a.key), 1000000200);
+    // A stray temporary from an interrupted store is not an entry.
+    std::FILE* stray = std::fopen((entryPath(directory, a.key) + ".tmp.abcdef").c_str(), "wb");
+    if (stray) {
+        std::fclose(stray);
+    }
+
+    config.maxBytes = a.bytes + c.bytes;
+    PitchTrackCache adopted(config);
+    const PitchTrackCacheStats stats = adopted.stats();
+    TINE_CHECK(stats.entries == 2 && stats.evictions == 1 && stats.bytes == a.bytes + c.bytes);
+    TINE_CHECK(!std::filesystem::exists(entryPath(directory, b.key)));
+    CandidateTrack loaded;
+    TINE_CHECK(adopted.lookup(a.key, kFrames, loaded) && adopted.lookup(c.key, kFrames, loaded));
+}
+
+void testCorruptEntries(const std::string& directory) {
+    const Entry a = makeEntry(110.0);
+    const Entry b = makeEntry(165.0);
+    PitchTrackCacheConfig config;
+    config.directory = directory;
+    PitchTrackCache cache(config);
+    TINE_CHECK(cache.store(a.key, a.track) && cache.store(b.key, b.track));
+
+    // Truncate a behind the cache's back.
+    std::filesystem::resize_file(entryPath(directory, a.key), a.bytes / 2);
+    CandidateTrack loaded;
+    loaded.info.hopSize = 7;
+    TINE_CHECK(!cache.lookup(a.key, kFrames, loaded));
+    // A failed lookup leaves the caller's track alone.
+    TINE_CHECK(loaded.info.hopSize == 7);
+    PitchTrackCacheStats stats = cache.stats();
+    TINE_CHECK(stats.misses == 1 && stats.entries == 1 && stats.bytes == b.bytes);
+    TINE_CHECK(!std::filesystem::exists(entryPath(directory, a.key)));
+
+    // An entry that parses but covers a different number of windows is dropped too.
+    TINE_CHECK(!cache.lookup(b.key, kFrames + 1, loaded));
+    stats = cache.stats();
+    TINE_CHECK(stats.misses == 2 && stats.entries == 0 && stats.bytes == 0);
+    TINE_CHECK(!std::filesystem::exists(entryPath(directory, b.key)));
+
+    // The key can be stored again afterwards.
+    TINE_CHECK(cache.store(a.key, a.track) && cache.lookup(a.key, kFrames, loaded));
+}
+
+Task<void> analyze(AsyncContext& context, const std::vector<float>& audio, const StreamAnalysisConfig& config,
+                   PitchTrackCache* cache, std::vector<PitchResult>& results, StreamSummary& summary) {
+    MemoryStreamSource source(audio.data(), audio.size());
+    const StreamResultSink sink = [&results](std::size_t, const PitchResult& result) {
+        results.push_back(result);
+    };
+    if (cache) {
+        summary = co_await analyzeStreamCached(context, source, config, *cache, sink);
+    } else {
+        summary = co_await analyzeStream(context, source, config, sink);
+    }
+}
+
+void testCachedStream(const std::string& directory) {
+    ThreadPoolConfig poolConfig;
+    poolConfig.normalWorkers = 1;
+    ThreadPool pool(poolConfig);
+    AsyncScheduler scheduler(pool);
+    AsyncContext context{scheduler, nullptr};
+
+    StreamAnalysisConfig config;
+    config.sampleRate = kSampleRate;
+    config.windowSize = kWindow;
+    config.hopSize = kHop;
+    config.threshold = 0.15;
+    // processFrames() results differ in the last bits between batch sizes, so the
+    // uncached pass batches windows the way the cache cuts chunks.
+    config.batchFrames = 64;
+    const std::vector<float> audio = tine::test::makeGlide(kSampleRate, 3 * 48000 + 123, 80.0, 700.0);
+
+    PitchTrackCacheConfig cacheConfig;
+    cacheConfig.directory = directory;
+    cacheConfig.chunkWindows = 64;
+    PitchTrackCache cache(cacheConfig);
+
+    std::vector<std::vector<PitchResult>> results(3);
+    std::vector<StreamSummary> summaries(3);
+    for (std::size_t pass = 0; pass < 3; ++pass) {
+        WaitGroup group;
+        spawn(scheduler, analyze(context, audio, config, pass == 0 ? nullptr : &cache, results[pass], summaries[pass]),
+              &group);
+        group.wait();
+    }
+
+    // Pass 1 fills the cache, pass 2 decodes every chunk from it.
+    TINE_CHECK(summaries[1].cachedWindows == 0);
+    TINE_CHECK(summaries[2].cachedWindows == summaries[2].windowsAnalyzed);
+    TINE_CHECK(cache.stats().hits == cache.stats().stores);
+    for (std::size_t pass = 1; pass < 3; ++pass) {
+        TINE_CHECK(summaries[pass].windowsAnalyzed == summaries[0].windowsAnalyzed);
+        TINE_CHECK(summaries[pass].validWindows == summaries[0].validWindows);
+        std::size_t mismatches = results[pass].size() == results[0].size() ? 0 : 1;
+        for (std::size_t k = 0; k < results[pass].size() && k < results[0].size(); ++k) {
+            const PitchResult& a = results[0][k];
+            const PitchResult& b = results[pass][k];
+            mismatches += a.isValid == b.isValid && a.frequency == b.frequency && a.probability == b.probability ? 0 : 1;
+        }
+        TINE_CHECK(mismatches == 0);
+    }
+}
+
+}  // namespace
+
+int main() {
+    const std::filesystem::path root = std::filesystem::temp_directory_path() / "tine_pitch_track_cache_test";
+    std::filesystem::remove_all(root);
+    std::filesystem::create_directories(root);
+
+    testKeys();
+    testLruEviction((root / "lru").string());
+    testAdoption((root / "adopt").string());
+    testCorruptEntries((root / "corrupt").string());
+    testCachedStream((root / "stream").string());
+
+    std::filesystem::remove_all(root);
+    return tine::test::finish("PitchTrackCacheTest");
+}
@@ -0,0 +1,196 @@
+// PitchTrackStore range queries against a brute-force scan of the same frames:
+// random and block-aligned ranges, time-based queries, the hop-grid gap fill,
+// the capacity limit, and the same answers from a saved, mapped file.
+//
+// Build (from the repository root):
+//   c++ -std=c++20 -O2 -Inative/cpp -Inative/tests native/tests/PitchTrackStoreTest.cpp
+//       native/cpp/PitchTrackStore.cpp -o pitch_track_store_test
+//   ./pitch_track_store_test [trackFile]
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <unistd.h>
+
+#include "PitchTrackStore.hpp"
+#include "TestSupport.hpp"
+
+using namespace tine::dsp;
+
+namespace {
+
+constexpr double kSampleRate = 48000.0;
+constexpr std::size_t kHop = 512;
+// Small blocks so a few hundred frames already build several index levels.
+constexpr std::size_t kBlock = 8;
+
+TrackAggregate scan(const std::vector<TrackFrame>& frames, std::size_t begin, std::size_t end) {
+    TrackAggregate total;
+    for (std::size_t i = begin; i < std::min(end, frames.size()); ++i) {
+        total.add(frames[i]);
+    }
+    return total;
+}
+
+bool agrees(const TrackAggregate& a, const TrackAggregate& b) {
+    const auto close = [](double x, double y) { return std::fabs(x - y) <= 1e-9 * std::max(1.0, std::fabs(x)); };
+    return a.frames == b.frames && a.validFrames == b.validFrames && close(a.sumCents, b.sumCents) &&
+           close(a.sumSquaredCents, b.sumSquaredCents) && a.minCents == b.minCents && a.maxCents == b.maxCents &&
+           a.minFrequency == b.minFrequency && a.maxFrequency == b.maxFrequency;
+}
+
+/**
+ * Appends a random session and mirrors what the store should hold. @p slots, when
+ * given, receives the frame index of each result (gap frames excluded).
+ */
+std::vector<TrackFrame> fill(PitchTrackStore& store, std::size_t results, std::mt19937& random,
+                             std::vector<std::size_t>* slots = nullptr) {
+    std::vector<TrackFrame> expected;
+    std::uniform_real_distribution<double> cents(-50.0, 50.0);
+    std::uniform_real_distribution<double> unit(0.0, 1.0);
+    std::uint64_t sampleTime = 1'000'000;
+    for (std::size_t i = 0; i < results; ++i) {
+        // Now and then the engine skips hops; the store fills them with invalid frames.
+        if (i > 0 && unit(random) < 0.05) {
+            const auto skipped = static_cast<std::size_t>(1 + unit(random) * 4);
+            sampleTime += skipped * kHop;
+            expected.insert(expected.end(), skipped, TrackFrame{});
+        }
+        PitchResult result;
+        result.isValid = unit(random) < 0.8;
+        result.cents = cents(random);
+        result.frequency = 110.0 * std::pow(2.0, unit(random) * 3.0);
+        // Small jitter: the store snaps results to the nearest hop.
+        store.append(result, sampleTime + static_cast<std::uint64_t>(unit(random) * 100.0));
+        TrackFrame frame;
+        if (result.isValid) {
+            frame.frequency = static_cast<float>(result.frequency);
+            frame.cents = static_cast<float>(result.cents);
+            frame.valid = 1;
+        }
+        if (slots) {
+            slots->push_back(expected.size());
+        }
+        expected.push_back(frame);
+        sampleTime += kHop;
+    }
+    return expected;
+}
+
+std::size_t checkQueries(const PitchTrackView& view, const std::vector<TrackFrame>& expected, std::mt19937& random) {
+    std::size_t mismatches = 0;
+    const std::size_t n = expected.size();
+    std::uniform_int_distribution<std::size_t> position(0, n + kBlock);
+    for (int i = 0; i < 4000; ++i) {
+        std::size_t begin = position(random);
+        std::size_t end = position(random);
+        if (begin > end) {
+            std::swap(begin, end);
+        }
+        mismatches += agrees(view.queryFrames(begin, end), scan(expected, begin, end)) ? 0 : 1;
+    }
+    // Every range whose ends sit within one frame of a block or level boundary.
+    for (std::size_t a = 0; a <= n; a += kBlock) {
+        for (std::size_t b = a; b <= n + 1; b += kBlock) {
+            for (const std::size_t begin : {a, a + 1, a > 0 ? a - 1 : a}) {
+                for (const std::size_t end : {b, b + 1, b > 0 ? b - 1 : b}) {
+                    if (begin <= end) {
+                        mismatches += agrees(view.queryFrames(begin, end), scan(expected, begin, end)) ? 0 : 1;
+                    }
+                }
+            }
+        }
+    }
+    mismatches += agrees(view.queryFrames(0, n), scan(expected, 0, n)) ? 0 : 1;
+    mismatches += view.queryFrames(n, n + 10).frames == 0 ? 0 : 1;
+    mismatches += view.queryFrames(5, 5).frames == 0 ? 0 : 1;
+    return mismatches;
+}
+
+void testQueries(const std::string& trackFile) {
+    std::mt19937 random(3);
+    PitchTrackStoreConfig config;
+    config.sampleRate = kSampleRate;
+    config.hopSize = kHop;
+    config.blockFrames = kBlock;
+    config.capacityFrames = 4096;
+    PitchTrackStore store(config);
+    const std::vector<TrackFrame> expected = fill(store, 1500, random);
+
+    const PitchTrackView view = store.view();
+    TINE_CHECK(view.frameCount == expected.size());
+    TINE_CHECK(view.levelCount > 3);
+    TINE_CHECK(store.firstSampleTime() >= 1'000'000);
+    TINE_CHECK(checkQueries(view, expected, random) == 0);
+
+    // Time queries cover the frames starting inside [start, end).
+    const double frameSeconds = static_cast<double>(kHop) / kSampleRate;
+    TINE_CHECK(agrees(view.query(10.0 * frameSeconds, 250.0 * frameSeconds), scan(expected, 10, 250)));
+    TINE_CHECK(agrees(view.query(10.5 * frameSeconds, 250.5 * frameSeconds), scan(expected, 11, 251)));
+    TINE_CHECK(agrees(view.query(-1.0, 1e9), scan(expected, 0, expected.size())));
+    TINE_CHECK(view.query(2.0, 1.0).frames == 0);
+
+    if (!TINE_CHECK(store.save(trackFile))) {
+        return;
+    }
+    MappedPitchTrack mapped;
+    if (TINE_CHECK(mapped.open(trackFile))) {
+        TINE_CHECK(mapped.view().frameCount == expected.size());
+        TINE_CHECK(mapped.firstSampleTime() == store.firstSampleTime());
+        TINE_CHECK(checkQueries(mapped.view(), expected, random) == 0);
+        mapped.close();
+    }
+
+    // A truncated file is refused rather than queried past its end.
+    std::FILE* file = std::fopen(trackFile.c_str(), "r+b");
+    if (TINE_CHECK(file != nullptr)) {
+        std::fseek(file, 0, SEEK_END);
+        const long length = std::ftell(file);
+        std::fclose(file);
+        TINE_CHECK(::truncate(trackFile.c_str(), length / 2) == 0);
+        TINE_CHECK(!mapped.open(trackFile));
+    }
+    std::remove(trackFile.c_str());
+}
+
+void testCapacity() {
+    std::mt19937 random(5);
+    PitchTrackStoreConfig config;
+    config.sampleRate = kSampleRate;
+    config.hopSize = kHop;
+    config.blockFrames = kBlock;
+    config.capacityFrames = 100;
+    PitchTrackStore store(config);
+    std::vector<std::size_t> slots;
+    std::vector<TrackFrame> expected = fill(store, 150, random, &slots);
+
+    // Results past the end are counted; hops skipped past it are not results.
+    const PitchTrackView view = store.view();
+    TINE_CHECK(view.frameCount == 100);
+    const auto overflow = std::count_if(slots.begin(), slots.end(), [](std::size_t slot) { return slot >= 100; });
+    TINE_CHECK(store.droppedFrames() == static_cast<std::uint64_t>(overflow));
+    expected.resize(100);
+    TINE_CHECK(agrees(view.queryFrames(0, 100), scan(expected, 0, 100)));
+    TINE_CHECK(agrees(view.queryFrames(37, 95), scan(expected, 37, 95)));
+
+    store.reset();
+    TINE_CHECK(store.view().frameCount == 0);
+    TINE_CHECK(store.view().queryFrames(0, 10).frames == 0);
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    const std::string trackFile =
+        argc > 1 ? argv[1] : (std::filesystem::temp_directory_path() / "tine_pitch_track_store_test.bin").string();
+    testQueries(trackFile);
+    testCapacity();
+    return tine::test::finish("pitch_track_store_test");
+}
@@ -0,0 +1,196 @@
+// SessionAnalytics against synthetic result streams with known answers: time
+// weights, in-tune fraction, moments, histogram bins and per-string slots; a
+// linear drift recovered by the regression and by the drift series as its bins
+// widen; vibrato rate and depth from the resonator bank; and snapshots taken
+// while another thread is processing always seeing whole results.
+//
+// Build (from the repository root):
+//   c++ -std=c++20 -O2 -pthread -Inative/cpp -Inative/tests native/tests/SessionAnalyticsTest.cpp
+//       native/cpp/SessionAnalytics.cpp -o session_analytics_test
+//   ./session_analytics_test
+
+#include <atomic>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <thread>
+
+#include "SessionAnalytics.hpp"
+#include "TestSupport.hpp"
+
+using namespace tine::dsp;
+
+namespace {
+
+constexpr double kSampleRate = 48000.0;
+// 10 ms per result keeps the expected totals round.
+constexpr std::size_t kHop = 480;
+constexpr double kResultSeconds = 0.01;
+
+bool near(double a, double b, double tolerance) {
+    return std::fabs(a - b) <= tolerance;
+}
+
+PitchResult voiced(double midi) {
+    PitchResult result;
+    result.isValid = true;
+    result.midi = midi;
+    result.frequency = 440.0 * std::pow(2.0, (midi - 69.0) / 12.0);
+    result.probability = 0.95;
+    return result;
+}
+
+SessionAnalyticsConfig baseConfig() {
+    SessionAnalyticsConfig config;
+    config.sampleRate = kSampleRate;
+    config.hopSize = kHop;
+    return config;
+}
+
+void testIntonation() {
+    SessionAnalyticsConfig config = baseConfig();
+    config.stringMidi = {55, 60};
+    SessionAnalytics analytics(config);
+
+    std::uint64_t time = 0;
+    // One second 6 cents sharp, one second 21 cents sharp, half a second unvoiced.
+    for (int i = 0; i < 100; ++i, time += kHop) {
+        analytics.process(voiced(60.06), time);
+    }
+    for (int i = 0; i < 100; ++i, time += kHop) {
+        analytics.process(voiced(60.21), time);
+    }
+    for (int i = 0; i < 50; ++i, time += kHop) {
+        analytics.process(PitchResult{}, time);
+    }
+
+    const SessionAnalyticsSnapshot snapshot = analytics.snapshot();
+    TINE_CHECK(near(snapshot.sessionSeconds, 250 * kResultSeconds, 1e-9));
+    const IntonationSummary& overall = snapshot.overall;
+    TINE_CHECK(near(overall.voicedSeconds, 2.0, 1e-9));
+    TINE_CHECK(near(overall.inTuneSeconds, 1.0, 1e-9));
+    TINE_CHECK(near(overall.inTuneFraction(), 0.5, 1e-9));
+    TINE_CHECK(near(overall.meanCents, 13.5, 1e-6));
+    TINE_CHECK(near(overall.stdDevCents, 7.5, 1e-6));
+    // 5-cent bins from -50: +6 lands in bin 11, +21 in bin 14.
+    for (std::size_t bin = 0; bin < IntonationSummary::HISTOGRAM_BINS; ++bin) {
+        const double expected = bin == 11 || bin == 14 ? 1.0 : 0.0;
+        TINE_CHECK(near(overall.centsHistogram[bin], expected, 1e-9));
+    }
+
+    TINE_CHECK(snapshot.notes.size() == 1);
+    if (snapshot.notes.size() == 1) {
+        TINE_CHECK(snapshot.notes[0].midi == 60);
+        TINE_CHECK(near(snapshot.notes[0].summary.voicedSeconds, 2.0, 1e-9));
+    }
+    // Every voiced result is nearest the 60 string; the 55 string stays empty.
+    TINE_CHECK(snapshot.strings.size() == 2);
+    if (snapshot.strings.size() == 2) {
+        TINE_CHECK(snapshot.strings[0].midi == 55 && snapshot.strings[0].summary.voicedSeconds == 0.0);
+        TINE_CHECK(near(snapshot.strings[1].summary.meanCents, 13.5, 1e-6));
+    }
+
+    // Outliers land in the end bins.
+    SessionAnalytics outliers(baseConfig());
+    outliers.process(voiced(60.49), 0);
+    outliers.process(voiced(59.51), kHop);
+    const IntonationSummary wide = outliers.snapshot().overall;
+    TINE_CHECK(wide.centsHistogram.front() > 0.0 && wide.centsHistogram.back() > 0.0);
+
+    analytics.reset();
+    const SessionAnalyticsSnapshot cleared = analytics.snapshot();
+    TINE_CHECK(cleared.sessionSeconds == 0.0 && cleared.overall.voicedSeconds == 0.0 && cleared.notes.empty());
+}
+
+void testDrift() {
+    SessionAnalyticsConfig config = baseConfig();
+    config.driftBinSeconds = 10.0;
+    config.driftBins = 4;
+    SessionAnalytics analytics(config);
+
+    // Two minutes sagging from 10 cents flat to 2 cents sharp: 6 cents a minute.
+    const std::size_t results = 12000;
+    for (std::size_t i = 0; i < results; ++i) {
+        const double minutes = static_cast<double>(i) * kResultSeconds / 60.0;
+        analytics.process(voiced(60.0 + (-10.0 + 6.0 * minutes) / 100.0), i * kHop);
+    }
+
+    const SessionAnalyticsSnapshot snapshot = analytics.snapshot();
+    TINE_CHECK(near(snapshot.driftCentsPerMinute, 6.0, 1e-3));
+    // 120 s in four bins: the 10 s bins doubled twice.
+    TINE_CHECK(snapshot.driftBinSeconds == 40.0);
+    TINE_CHECK(snapshot.drift.size() == 3);
+    for (std::size_t i = 0; i < snapshot.drift.size(); ++i) {
+        const DriftPoint& point = snapshot.drift[i];
+        const double centreMinutes = (point.startSeconds + 20.0) / 60.0;
+        TINE_CHECK(point.startSeconds == 40.0 * static_cast<double>(i));
+        TINE_CHECK(near(point.voicedSeconds, 40.0, 1e-6));
+        TINE_CHECK(near(point.meanCents, -10.0 + 6.0 * centreMinutes, 0.01));
+    }
+}
+
+void testVibrato() {
+    SessionAnalytics analytics(baseConfig());
+    // Four seconds of 5.5 Hz, 20-cent vibrato around A3.
+    for (std::size_t i = 0; i < 400; ++i) {
+        const double t = static_cast<double>(i) * kResultSeconds;
+        analytics.process(voiced(57.0 + 0.2 * std::sin(2.0 * M_PI * 5.5 * t)), i * kHop);
+    }
+    const IntonationSummary vibrato = analytics.snapshot().overall;
+    // Nothing is assessed during the first two time constants (give or take a result).
+    TINE_CHECK(vibrato.vibratoSeconds > 2.5 && vibrato.vibratoSeconds <= 3.0 + 1.5 * kResultSeconds);
+    TINE_CHECK(near(vibrato.vibratoRateHz, 5.5, 0.25));
+    TINE_CHECK(near(vibrato.vibratoDepthCents, 20.0, 3.0));
+
+    // A steady note has none.
+    SessionAnalytics steady(baseConfig());
+    for (std::size_t i = 0; i < 400; ++i) {
+        steady.process(voiced(57.03), i * kHop);
+    }
+    TINE_CHECK(steady.snapshot().overall.vibratoSeconds == 0.0);
+}
+
+void testConcurrentSnapshots() {
+    SessionAnalyticsConfig config = baseConfig();
+    config.stringMidi = {57};
+    SessionAnalytics analytics(config);
+
+    std::atomic<bool> done{false};
+    std::thread producer([&] {
+        for (std::size_t i = 0; i < 200000; ++i) {
+            analytics.process(voiced(i % 2 == 0 ? 57.04 : 57.5 + 0.01 * static_cast<double>(i % 3)), i * kHop);
+        }
+        done.store(true);
+    });
+
+    // Each result updates the overall, note and string slots and the session clock together.
+    std::size_t torn = 0;
+    std::size_t snapshots = 0;
+    while (!done.load()) {
+        const SessionAnalyticsSnapshot snapshot = analytics.snapshot();
+        double notes = 0.0;
+        for (const NoteIntonation& note : snapshot.notes) {
+            notes += note.summary.voicedSeconds;
+        }
+        const double voiced = snapshot.overall.voicedSeconds;
+        if (!near(notes, voiced, 1e-6) || !near(snapshot.strings[0].summary.voicedSeconds, voiced, 1e-6) ||
+            !near(snapshot.sessionSeconds, voiced, 1e-6)) {
+            ++torn;
+        }
+        ++snapshots;
+    }
+    producer.join();
+    TINE_CHECK(torn == 0);
+    TINE_CHECK(snapshots > 0);
+    TINE_CHECK(near(analytics.snapshot().overall.voicedSeconds, 200000 * kResultSeconds, 1e-6));
+}
+
+}  // namespace
+
+int main() {
+    testIntonation();
+    testDrift();
+    testVibrato();
+    testConcurrentSnapshots();
+    return tine::test::finish("SessionAnalyticsTest");
+}
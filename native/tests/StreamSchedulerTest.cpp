@@ -0,0 +1,162 @@
+// StreamScheduler admission: live streams are accepted while the projected load
+// fits liveCapacity, degraded when only the cheaper hop fits and rejected
+// otherwise; closing a stream returns its share, and batch streams are limited
+// in number only. A degraded stream really runs at the scaled hop, so the
+// demand measured from its steps stays inside the live budget it was admitted
+// against.
+//
+// Build (from the repository root):
+//   c++ -std=c++20 -O2 -pthread -Inative/cpp -Inative/tests native/tests/StreamSchedulerTest.cpp
+//       native/cpp/StreamScheduler.cpp native/cpp/Metrics.cpp native/cpp/AsyncStream.cpp
+//       native/cpp/AsyncScheduler.cpp native/cpp/ThreadPool.cpp native/cpp/ThreadConfig.cpp
+//       native/cpp/YinPitchDetector.cpp native/cpp/DifferenceKernel.cpp native/cpp/KernelAutotuner.cpp
+//       -o stream_scheduler_test
+//   ./stream_scheduler_test
+
+#include <cmath>
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+#include "AsyncScheduler.hpp"
+#include "AsyncStream.hpp"
+#include "StreamScheduler.hpp"
+#include "TestSupport.hpp"
+
+using namespace tine::dsp;
+
+namespace {
+
+constexpr double kSampleRate = 48000.0;
+constexpr std::size_t kWindow = 2048;
+
+void testLiveAdmission(AsyncScheduler& scheduler) {
+    // Budget 0.75 * 2 = 1.5 workers at 0.4 per stream: three fit, a fourth only at half cost.
+    StreamSchedulerConfig config;
+    config.concurrency = 2;
+    config.initialCost = 0.4;
+    StreamScheduler streams(scheduler, config);
+
+    std::vector<std::unique_ptr<ScheduledStream>> open;
+    for (int i = 0; i < 3; ++i) {
+        StreamAdmission admission = streams.admit(StreamClass::Live);
+        TINE_CHECK(admission.verdict == AdmissionVerdict::Accepted);
+        TINE_CHECK(admission.stream && admission.stream->hopScale() == 1.0);
+        open.push_back(std::move(admission.stream));
+    }
+    StreamAdmission degraded = streams.admit(StreamClass::Live);
+    TINE_CHECK(degraded.verdict == AdmissionVerdict::Degraded);
+    TINE_CHECK(degraded.stream && degraded.stream->hopScale() == config.degradeFactor);
+    TINE_CHECK(std::fabs(degraded.projectedLoad - 0.8) < 1e-9);
+
+    StreamAdmission rejected = streams.admit(StreamClass::Live);
+    TINE_CHECK(rejected.verdict == AdmissionVerdict::Rejected);
+    TINE_CHECK(!rejected.stream);
+    TINE_CHECK(std::fabs(streams.stats().liveLoad - 0.7) < 1e-9);
+
+    // Closing an accepted stream returns its 0.4; a newcomer fits again.
+    open.pop_back();
+    StreamAdmission again = streams.admit(StreamClass::Live);
+    TINE_CHECK(again.verdict == AdmissionVerdict::Accepted);
+
+    const StreamSchedulerStats stats = streams.stats();
+    TINE_CHECK(stats.live.accepted == 4 && stats.live.degraded == 1 && stats.live.rejected == 1);
+    TINE_CHECK(stats.live.openStreams == 4);
+}
+
+void testBatchAdmission(AsyncScheduler& scheduler) {
+    StreamSchedulerConfig config;
+    config.concurrency = 1;
+    config.maxBatchStreams = 2;
+    StreamScheduler streams(scheduler, config);
+
+    StreamAdmission first = streams.admit(StreamClass::Batch);
+    StreamAdmission second = streams.admit(StreamClass::Batch);
+    TINE_CHECK(first.verdict == AdmissionVerdict::Accepted && second.verdict == AdmissionVerdict::Accepted);
+    TINE_CHECK(streams.admit(StreamClass::Batch).verdict == AdmissionVerdict::Rejected);
+    // Batch streams carry no live load.
+    TINE_CHECK(streams.stats().liveLoad == 0.0);
+    first.stream.reset();
+    TINE_CHECK(streams.admit(StreamClass::Batch).verdict == AdmissionVerdict::Accepted);
+}
+
+Task<void> analyze(AsyncContext& context, const std::vector<float>& audio, StreamAnalysisConfig config,
+                   StreamSummary& summary) {
+    MemoryStreamSource source(audio.data(), audio.size());
+    summary = co_await analyzeStream(context, source, config, {});
+}
+
+struct LiveRun {
+    AdmissionVerdict verdict{AdmissionVerdict::Rejected};
+    StreamSummary summary;
+    StreamSchedulerStats stats;
+};
+
+// Admit one live stream under @p config and analyze @p audio through it.
+LiveRun runLive(AsyncScheduler& scheduler, const StreamSchedulerConfig& config, const std::vector<float>& audio) {
+    StreamScheduler streams(scheduler, config);
+    StreamAdmission admission = streams.admit(StreamClass::Live);
+    LiveRun run;
+    run.verdict = admission.verdict;
+    if (!admission.stream) {
+        return run;
+    }
+
+    AsyncContext context{scheduler, nullptr};
+    StreamAnalysisConfig analysis;
+    analysis.sampleRate = kSampleRate;
+    analysis.windowSize = kWindow;
+    analysis.hopSize = kWindow;
+    analysis.batchFrames = 1;
+    analysis.stream = admission.stream.get();
+    TINE_CHECK(scheduledHopSize(analysis) ==
+               static_cast<std::size_t>(static_cast<double>(kWindow) * admission.stream->hopScale()));
+
+    WaitGroup group;
+    spawn(scheduler, analyze(context, audio, analysis, run.summary), &group);
+    group.wait();
+    run.stats = streams.stats();
+    return run;
+}
+
+void testDegradedDemand(AsyncScheduler& scheduler) {
+    const std::vector<float> audio = tine::test::makeGlide(kSampleRate, 30 * 48000, 110.0, 440.0);
+
+    // Measure the full-hop cost with room to spare; the first run warms the caches.
+    StreamSchedulerConfig roomy;
+    roomy.concurrency = 1;
+    roomy.liveCapacity = 1e6;
+    runLive(scheduler, roomy, audio);
+    const LiveRun full = runLive(scheduler, roomy, audio);
+    TINE_CHECK(full.verdict == AdmissionVerdict::Accepted);
+    TINE_CHECK(full.summary.windowsAnalyzed == audio.size() / kWindow);
+    const double cost = full.stats.live.cost;
+    TINE_CHECK(cost > 0.0);
+
+    // The full hop would take twice the budget; a quarter of it fits with room for noise.
+    StreamSchedulerConfig tight;
+    tight.concurrency = 1;
+    tight.initialCost = cost;
+    tight.liveCapacity = 0.5 * cost;
+    tight.degradeFactor = 4.0;
+    const LiveRun degraded = runLive(scheduler, tight, audio);
+    TINE_CHECK(degraded.verdict == AdmissionVerdict::Degraded);
+    TINE_CHECK(degraded.summary.framesRead == audio.size());
+    TINE_CHECK(degraded.summary.windowsAnalyzed == (audio.size() - kWindow) / (4 * kWindow) + 1);
+    TINE_CHECK(degraded.stats.liveLoad > 0.0);
+    TINE_CHECK(degraded.stats.liveLoad <= tight.liveCapacity);
+}
+
+}  // namespace
+
+int main() {
+    ThreadPoolConfig poolConfig;
+    poolConfig.normalWorkers = 2;
+    ThreadPool pool(poolConfig);
+    AsyncScheduler scheduler(pool);
+
+    testLiveAdmission(scheduler);
+    testBatchAdmission(scheduler);
+    testDegradedDemand(scheduler);
+    return tine::test::finish("StreamSchedulerTest");
+}
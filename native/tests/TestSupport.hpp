@@ -0,0 +1,59 @@
+#ifndef TINE_NATIVE_TESTS_TESTSUPPORT_HPP
+#define TINE_NATIVE_TESTS_TESTSUPPORT_HPP
+
+#include <cmath>
+#include <cstddef>
+#include <cstdio>
+#include <vector>
+
+namespace tine::test {
+
+/**
+ * Minimal check counter shared by the native test programs: each failed check
+ * prints its location, and finish() turns the tally into the exit status.
+ */
+struct Tally {
+    int checks{0};
+    int failures{0};
+};
+
+inline Tally& tally() {
+    static Tally counts;
+    return counts;
+}
+
+inline bool check(bool passed, const char* expression, const char* file, int line) {
+    ++tally().checks;
+    if (!passed) {
+        ++tally().failures;
+        std::fprintf(stderr, "%s:%d: check failed: %s\n", file, line, expression);
+    }
+    return passed;
+}
+
+inline int finish(const char* name) {
+    std::printf("%s: %d checks, %d failed\n", name, tally().checks, tally().failures);
+    return tally().failures == 0 ? 0 : 1;
+}
+
+/** Five-harmonic tone gliding exponentially from @p startHz to @p endHz. */
+inline std::vector<float> makeGlide(double sampleRate, std::size_t frames, double startHz, double endHz) {
+    std::vector<float> samples(frames);
+    double phase = 0.0;
+    for (std::size_t i = 0; i < frames; ++i) {
+        const double position = static_cast<double>(i) / static_cast<double>(frames);
+        phase += 2.0 * M_PI * startHz * std::pow(endHz / startHz, position) / sampleRate;
+        double value = 0.0;
+        for (int h = 1; h <= 5; ++h) {
+            value += std::sin(h * phase) / h;
+        }
+        samples[i] = static_cast<float>(0.3 * value);
+    }
+    return samples;
+}
+
+}  // namespace tine::test
+
+#define TINE_CHECK(expression) ::tine::test::check((expression), #expression, __FILE__, __LINE__)
+
+#endif  // TINE_NATIVE_TESTS_TESTSUPPORT_HPP
@@ -0,0 +1,278 @@
+// ThreadPool under contention and at shutdown: thieves racing the owner of a
+// WorkStealingDeque take every item exactly once; tasks a worker fans out to its
+// own deque are stolen and run by the others; once shutdown() has begun,
+// AsyncScheduler::trySchedule() refuses handles and hands them back, so a
+// yielding coroutine carries on in the caller; and shutdown() runs everything
+// already queued, plus same-group work spawned from it, before joining.
+//
+// Build (from the repository root):
+//   c++ -std=c++20 -O2 -pthread -Inative/cpp -Inative/tests native/tests/ThreadPoolTest.cpp
+//       native/cpp/AsyncScheduler.cpp native/cpp/ThreadPool.cpp native/cpp/ThreadConfig.cpp
+//       -o thread_pool_test
+//   ./thread_pool_test
+
+#include <atomic>
+#include <chrono>
+#include <coroutine>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <thread>
+#include <vector>
+
+#include "AsyncScheduler.hpp"
+#include "TestSupport.hpp"
+#include "ThreadPool.hpp"
+
+using namespace tine::dsp;
+
+namespace {
+
+constexpr std::size_t kThieves = 3;
+
+void spin(std::chrono::microseconds duration) {
+    const auto until = std::chrono::steady_clock::now() + duration;
+    while (std::chrono::steady_clock::now() < until) {
+    }
+}
+
+void testDequeContention() {
+    constexpr std::size_t kItems = 200000;
+    WorkStealingDeque deque(256);
+    const auto taken = std::make_unique<std::atomic<std::uint32_t>[]>(kItems + 1);
+    std::atomic<std::size_t> total{0};
+    std::atomic<bool> done{false};
+
+    std::vector<std::thread> thieves;
+    for (std::size_t t = 0; t < kThieves; ++t) {
+        thieves.emplace_back([&] {
+            while (!done.load(std::memory_order_acquire)) {
+                if (const std::uintptr_t item = deque.steal()) {
+                    taken[item].fetch_add(1, std::memory_order_relaxed);
+                    total.fetch_add(1, std::memory_order_relaxed);
+                }
+            }
+        });
+    }
+
+    // The owner pushes until full, then pops a few back, so both ends are contended
+    // and pop() keeps racing thieves for the last item.
+    std::size_t next = 1;
+    std::size_t owned = 0;
+    while (next <= kItems) {
+        while (next <= kItems && deque.push(next)) {
+            ++next;
+        }
+        for (int i = 0; i < 3; ++i) {
+            if (const std::uintptr_t item = deque.pop()) {
+                taken[item].fetch_add(1, std::memory_order_relaxed);
+                ++owned;
+            }
+        }
+    }
+    while (const std::uintptr_t item = deque.pop()) {
+        taken[item].fetch_add(1, std::memory_order_relaxed);
+        ++owned;
+    }
+    // Anything a thief is mid-way through stealing is accounted for once it finishes.
+    while (owned + total.load(std::memory_order_relaxed) < kItems) {
+        std::this_thread::yield();
+    }
+    done.store(true, std::memory_order_release);
+    for (std::thread& thief : thieves) {
+        thief.join();
+    }
+
+    bool once = true;
+    for (std::size_t item = 1; item <= kItems; ++item) {
+        once = once && taken[item].load() == 1;
+    }
+    TINE_CHECK(once);
+    TINE_CHECK(owned + total.load() == kItems);
+    // Both the owner and the thieves got a share.
+    TINE_CHECK(owned > 0 && total.load() > 0);
+}
+
+struct RecordingTask : PoolTask {
+    std::atomic<std::size_t>* ran{nullptr};
+    std::mutex* mutex{nullptr};
+    std::set<std::thread::id>* threads{nullptr};
+};
+
+void testWorkersSteal() {
+    constexpr std::size_t kChildren = 2000;
+    ThreadPoolConfig config;
+    config.normalWorkers = 4;
+    config.dequeCapacity = 4096;
+    ThreadPool pool(config);
+
+    std::atomic<std::size_t> ran{0};
+    std::mutex mutex;
+    std::set<std::thread::id> threads;
+    std::vector<RecordingTask> children(kChildren);
+    for (RecordingTask& child : children) {
+        child.ran = &ran;
+        child.mutex = &mutex;
+        child.threads = &threads;
+        child.invoke = [](PoolTask* self) {
+            auto* task = static_cast<RecordingTask*>(self);
+            spin(std::chrono::microseconds(20));
+            {
+                std::lock_guard<std::mutex> lock(*task->mutex);
+                task->threads->insert(std::this_thread::get_id());
+            }
+            task->ran->fetch_add(1, std::memory_order_release);
+        };
+    }
+
+    // Submitted from a worker, every child lands on that worker's own deque; the
+    // rest of the group only gets them by stealing.
+    struct FanOut : PoolTask {
+        ThreadPool* pool{nullptr};
+        std::vector<RecordingTask>* children{nullptr};
+        std::atomic<std::size_t> refused{0};
+    } root;
+    root.pool = &pool;
+    root.children = &children;
+    root.invoke = [](PoolTask* self) {
+        auto* fan = static_cast<FanOut*>(self);
+        for (RecordingTask& child : *fan->children) {
+            if (!fan->pool->submit(&child)) {
+                fan->refused.fetch_add(1, std::memory_order_relaxed);
+            }
+        }
+    };
+    TINE_CHECK(pool.submit(&root));
+    while (ran.load(std::memory_order_acquire) < kChildren) {
+        std::this_thread::yield();
+    }
+
+    TINE_CHECK(root.refused.load() == 0);
+    std::lock_guard<std::mutex> lock(mutex);
+    TINE_CHECK(threads.size() > 1);
+}
+
+/** Coroutine that starts suspended and finishes in whichever thread resumes it. */
+struct Stepper {
+    struct promise_type {
+        Stepper get_return_object() { return Stepper{std::coroutine_handle<promise_type>::from_promise(*this)}; }
+        std::suspend_always initial_suspend() noexcept { return {}; }
+        std::suspend_always final_suspend() noexcept { return {}; }
+        void return_void() noexcept {}
+        void unhandled_exception() noexcept {}
+    };
+    std::coroutine_handle<promise_type> handle;
+};
+
+Stepper yieldTwice(AsyncScheduler& scheduler, std::vector<std::thread::id>& threads) {
+    threads.push_back(std::this_thread::get_id());
+    co_await scheduler.yield();
+    threads.push_back(std::this_thread::get_id());
+    co_await scheduler.yield();
+    threads.push_back(std::this_thread::get_id());
+}
+
+void testRefusedAfterShutdown() {
+    ThreadPoolConfig config;
+    config.normalWorkers = 2;
+    ThreadPool pool(config);
+    AsyncScheduler scheduler(pool);
+    pool.shutdown();
+
+    std::vector<std::thread::id> threads;
+    Stepper stepper = yieldTwice(scheduler, threads);
+    // Refused: the handle is still the caller's, not resumed behind its back.
+    TINE_CHECK(!scheduler.trySchedule(stepper.handle));
+    TINE_CHECK(!scheduler.post(stepper.handle));
+    TINE_CHECK(threads.empty() && !stepper.handle.done());
+
+    // Resumed by hand, each refused yield carries straight on in this thread.
+    stepper.handle.resume();
+    TINE_CHECK(stepper.handle.done());
+    TINE_CHECK(threads == std::vector<std::thread::id>(3, std::this_thread::get_id()));
+    stepper.handle.destroy();
+
+    PoolTask task;
+    task.invoke = [](PoolTask*) {};
+    TINE_CHECK(!pool.submit(&task));
+}
+
+struct CountingTask : PoolTask {
+    std::atomic<std::size_t>* ran{nullptr};
+};
+
+void countInvoke(PoolTask* self) {
+    auto* task = static_cast<CountingTask*>(self);
+    spin(std::chrono::microseconds(5));
+    task->ran->fetch_add(1, std::memory_order_relaxed);
+}
+
+void testDrainOnShutdown() {
+    constexpr std::size_t kQueued = 2000;
+    ThreadPoolConfig config;
+    config.normalWorkers = 2;
+    config.realtimeWorkers = 1;
+    ThreadPool pool(config);
+
+    std::atomic<std::size_t> ran{0};
+    std::vector<CountingTask> queued(kQueued);
+    for (CountingTask& task : queued) {
+        task.ran = &ran;
+        task.invoke = countInvoke;
+    }
+
+    // One task waits until shutdown() has begun, then spawns more work: into its
+    // own group, which is still drained, and into the Realtime group, which may
+    // already have been joined and so refuses it.
+    struct Spawner : PoolTask {
+        ThreadPool* pool{nullptr};
+        std::atomic<bool>* stopping{nullptr};
+        CountingTask sameGroup;
+        CountingTask otherGroup;
+        bool sameAccepted{false};
+        bool otherAccepted{true};
+    } spawner;
+    std::atomic<bool> stopping{false};
+    spawner.pool = &pool;
+    spawner.stopping = &stopping;
+    spawner.sameGroup.ran = &ran;
+    spawner.sameGroup.invoke = countInvoke;
+    spawner.otherGroup.ran = &ran;
+    spawner.otherGroup.invoke = countInvoke;
+    spawner.invoke = [](PoolTask* self) {
+        auto* s = static_cast<Spawner*>(self);
+        while (!s->stopping->load(std::memory_order_acquire)) {
+            std::this_thread::yield();
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        s->sameAccepted = s->pool->submit(&s->sameGroup);
+        s->otherAccepted = s->pool->submit(&s->otherGroup, TaskPriority::Realtime);
+    };
+
+    bool accepted = pool.submit(&spawner);
+    for (CountingTask& task : queued) {
+        accepted = pool.submit(&task) && accepted;
+    }
+    TINE_CHECK(accepted);
+    stopping.store(true, std::memory_order_release);
+    pool.shutdown();
+
+    // Everything accepted ran before the workers were joined.
+    TINE_CHECK(spawner.sameAccepted);
+    TINE_CHECK(!spawner.otherAccepted);
+    TINE_CHECK(ran.load() == kQueued + 1);
+    // And shutdown() is idempotent.
+    pool.shutdown();
+}
+
+}  // namespace
+
+int main() {
+    testDequeContention();
+    testWorkersSteal();
+    testRefusedAfterShutdown();
+    testDrainOnShutdown();
+    return tine::test::finish("ThreadPoolTest");
+}
@@ -0,0 +1,226 @@
+// ToneGenerator against its promises: a sawtooth at the top of every wavetable
+// octave puts no partial above Nyquist (only interpolation images, under 1e-4
+// of the energy, fold back off the harmonic grid, where a naive sawtooth folds
+// back percents of it); a note starting from silence lands on pitch while the
+// next one glides exponentially at the control rate; ducking ramps the level
+// down and back with the 10 ms time constant and without a step; and render()
+// never allocates.
+//
+// Build (from the repository root):
+//   c++ -std=c++20 -O2 -Inative/cpp -Inative/tests native/tests/ToneGeneratorTest.cpp
+//       native/cpp/ToneGenerator.cpp -o tone_generator_test
+//   ./tone_generator_test
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdio>
+#include <vector>
+
+#include "AllocationCounter.hpp"
+#include "TestSupport.hpp"
+#include "ToneGenerator.hpp"
+
+using namespace tine::dsp;
+
+namespace {
+
+constexpr double kSampleRate = 48000.0;
+// Bins of the spectrum the band-limiting check analyzes.
+constexpr std::size_t kSpectrum = 16384;
+
+/** Energy of DFT bin @p bin of @p signal (Goertzel). */
+double binEnergy(const std::vector<float>& signal, std::size_t bin) {
+    const double coefficient = 2.0 * std::cos(2.0 * M_PI * static_cast<double>(bin) / kSpectrum);
+    double s1 = 0.0;
+    double s2 = 0.0;
+    for (float x : signal) {
+        const double s0 = x + coefficient * s1 - s2;
+        s2 = s1;
+        s1 = s0;
+    }
+    return s1 * s1 + s2 * s2 - coefficient * s1 * s2;
+}
+
+/**
+ * Share of @p signal's energy off the harmonic grid of bin @p fundamental. With
+ * an odd fundamental bin every partial that folds back from above Nyquist lands
+ * off the grid, and every bin frequency is exact, so nothing leaks.
+ */
+double aliasedShare(const std::vector<float>& signal, std::size_t fundamental) {
+    double total = 0.0;
+    for (float x : signal) {
+        total += static_cast<double>(x) * x;
+    }
+    // Parseval: the bins sum to N times the signal energy, each real partial twice.
+    double harmonic = 0.0;
+    for (std::size_t bin = fundamental; bin < kSpectrum / 2; bin += fundamental) {
+        harmonic += 2.0 * binEnergy(signal, bin);
+    }
+    return 1.0 - harmonic / (static_cast<double>(kSpectrum) * total);
+}
+
+ToneParameters steady(ToneWaveform waveform, double frequency) {
+    ToneParameters parameters;
+    parameters.frequency = frequency;
+    parameters.waveform = waveform;
+    parameters.glideSeconds = 0.0;
+    parameters.attackSeconds = 0.0;
+    parameters.gate = true;
+    return parameters;
+}
+
+void testBandLimited() {
+    const double binHz = kSampleRate / kSpectrum;
+    for (std::size_t octave = 0; octave < ToneGenerator::OCTAVES; ++octave) {
+        // The highest odd bin inside this octave's table: its most harmonics.
+        const double top = ToneGenerator::LOWEST_FREQUENCY * std::ldexp(1.0, static_cast<int>(octave) + 1);
+        auto bin = static_cast<std::size_t>(0.99 * top / binHz);
+        bin -= bin % 2 == 0 ? 1 : 0;
+        const double frequency = static_cast<double>(bin) * binHz;
+        if (frequency >= ToneGenerator::HARMONIC_CEILING * kSampleRate || frequency * 2.0 < top) {
+            continue;
+        }
+
+        ToneGenerator tone(kSampleRate);
+        tone.setParameters(steady(ToneWaveform::Sawtooth, frequency));
+        // Past the attack, so the level is constant over the analyzed block.
+        std::vector<float> signal(kSpectrum);
+        tone.render(signal.data(), ToneGenerator::CONTROL_BLOCK);
+        tone.render(signal.data(), signal.size());
+        const double share = aliasedShare(signal, bin);
+        if (!TINE_CHECK(share < 1e-4)) {
+            std::fprintf(stderr, "  octave %zu at %.1f Hz: %.2e of the energy aliased\n", octave, frequency, share);
+        }
+
+        // The same sawtooth summed naively up to the sample rate folds plenty back.
+        if (octave == 7) {
+            std::vector<float> naive(kSpectrum);
+            for (std::size_t i = 0; i < naive.size(); ++i) {
+                const double phase = static_cast<double>(i) * frequency / kSampleRate;
+                naive[i] = static_cast<float>(0.5 - (phase - std::floor(phase)));
+            }
+            TINE_CHECK(aliasedShare(naive, bin) > 1e-2);
+        }
+    }
+}
+
+void testGlide() {
+    ToneGenerator tone(kSampleRate);
+    ToneParameters parameters = steady(ToneWaveform::Sine, 220.0);
+    parameters.glideSeconds = 0.05;
+    tone.setParameters(parameters);
+
+    // From silence the note starts on pitch.
+    std::vector<float> block(ToneGenerator::CONTROL_BLOCK);
+    tone.render(block.data(), block.size());
+    TINE_CHECK(std::fabs(tone.audibleFrequency() / 220.0 - 1.0) < 1e-12);
+
+    // The next one glides in log frequency, one step per control block.
+    tone.noteOn(440.0);
+    const double coefficient =
+        std::exp(-static_cast<double>(ToneGenerator::CONTROL_BLOCK) / (parameters.glideSeconds * kSampleRate));
+    double previous = 220.0;
+    bool monotone = true;
+    bool onCurve = true;
+    for (std::size_t step = 1; step <= 750; ++step) {
+        tone.render(block.data(), block.size());
+        const double expected = 440.0 * std::pow(0.5, std::pow(coefficient, static_cast<double>(step)));
+        const double frequency = tone.audibleFrequency();
+        onCurve = onCurve && std::fabs(frequency / expected - 1.0) < 1e-9;
+        monotone = monotone && frequency >= previous && frequency <= 440.0;
+        previous = frequency;
+    }
+    TINE_CHECK(onCurve);
+    TINE_CHECK(monotone);
+    // Ten time constants on, it sounds at the target: count rising zero crossings.
+    std::vector<float> second(static_cast<std::size_t>(kSampleRate));
+    tone.render(second.data(), second.size());
+    std::size_t crossings = 0;
+    for (std::size_t i = 1; i < second.size(); ++i) {
+        crossings += second[i - 1] < 0.0F && second[i] >= 0.0F ? 1 : 0;
+    }
+    TINE_CHECK(crossings >= 439 && crossings <= 441);
+}
+
+/** Largest magnitude in @p samples. */
+double peak(const float* samples, std::size_t frames) {
+    double result = 0.0;
+    for (std::size_t i = 0; i < frames; ++i) {
+        result = std::max(result, static_cast<double>(std::fabs(samples[i])));
+    }
+    return result;
+}
+
+void testDucking() {
+    ToneGenerator tone(kSampleRate);
+    ToneParameters parameters = steady(ToneWaveform::Sine, 1000.0);
+    parameters.duckGain = 0.3;
+    tone.setParameters(parameters);
+    std::vector<float> settle(4800);
+    tone.render(settle.data(), settle.size());
+    TINE_CHECK(std::fabs(peak(settle.data() + 2400, 2400) - parameters.gain) < 1e-3);
+
+    // 100 ms ducked, then 100 ms released, rendered in one-period (48-frame) blocks.
+    constexpr std::size_t kPeriod = 48;
+    const double tau = 0.01 * kSampleRate;
+    std::vector<float> out(9600);
+    tone.setDucked(true);
+    tone.render(out.data(), 4800);
+    tone.setDucked(false);
+    tone.render(out.data() + 4800, 4800);
+
+    bool onRamp = true;
+    for (std::size_t start = 0; start < out.size(); start += kPeriod) {
+        // The level a period's peak should reach, taken at its end (the level ramps within it).
+        const std::size_t edge = (start % 4800) + kPeriod;
+        const double decay = std::exp(-static_cast<double>(edge) / tau);
+        const double duck = start < 4800 ? 0.3 + 0.7 * decay : 1.0 - 0.7 * (1.0 - std::exp(-4800.0 / tau)) * decay;
+        const double expected = parameters.gain * duck;
+        // Control-rate steps and the within-period ramp: a few percent.
+        onRamp = onRamp && std::fabs(peak(out.data() + start, kPeriod) - expected) < 0.05 * expected + 2e-3;
+    }
+    TINE_CHECK(onRamp);
+    // One time constant in, about two thirds of the way down; settled by the end.
+    TINE_CHECK(std::fabs(peak(out.data() + 432, kPeriod) / parameters.gain - (0.3 + 0.7 * std::exp(-1.0))) < 0.05);
+    TINE_CHECK(std::fabs(peak(out.data() + 4800 - kPeriod, kPeriod) / parameters.gain - 0.3) < 0.01);
+    TINE_CHECK(std::fabs(peak(out.data() + 9600 - kPeriod, kPeriod) / parameters.gain - 1.0) < 0.01);
+
+    // No step: sample-to-sample change never exceeds the steady sine's slope by much.
+    const double steadySlope = parameters.gain * 2.0 * M_PI * 1000.0 / kSampleRate;
+    double largest = 0.0;
+    for (std::size_t i = 1; i < out.size(); ++i) {
+        largest = std::max(largest, static_cast<double>(std::fabs(out[i] - out[i - 1])));
+    }
+    TINE_CHECK(largest < 1.05 * steadySlope);
+}
+
+void testRenderDoesNotAllocate() {
+    ToneGenerator tone(kSampleRate);
+    std::vector<float> out(4096, 0.0F);
+    const std::size_t before = tine::test::allocations().load();
+    for (ToneWaveform waveform :
+         {ToneWaveform::Sine, ToneWaveform::Triangle, ToneWaveform::Sawtooth, ToneWaveform::Square}) {
+        ToneParameters parameters = steady(waveform, 110.0);
+        parameters.glideSeconds = 0.05;
+        tone.setParameters(parameters);
+        tone.render(out.data(), out.size());
+        tone.noteOn(1760.0);
+        tone.setDucked(true);
+        tone.render(out.data(), out.size(), true);
+        tone.noteOff();
+        tone.setDucked(false);
+        tone.render(out.data(), out.size());
+    }
+    TINE_CHECK(tine::test::allocations().load() == before);
+}
+
+}  // namespace
+
+int main() {
+    testBandLimited();
+    testGlide();
+    testDucking();
+    testRenderDoesNotAllocate();
+    return tine::test::finish("ToneGeneratorTest");
+}
@@ -0,0 +1,100 @@
+// YinPitchDetector::processFrames() against one processBuffer() call per window:
+// same frames, same voicing and the same periods up to summation order, across
+// hops below, at and above the window and with a reduced active window.
+//
+// Build (from the repository root):
+//   c++ -std=c++20 -O2 -Inative/cpp -Inative/tests native/tests/YinPitchDetectorTest.cpp
+//       native/cpp/YinPitchDetector.cpp native/cpp/DifferenceKernel.cpp -o yin_pitch_detector_test
+//   ./yin_pitch_detector_test
+
+#include <cmath>
+#include <cstddef>
+#include <random>
+#include <vector>
+
+#include "TestSupport.hpp"
+#include "YinPitchDetector.hpp"
+
+using namespace tine::dsp;
+
+namespace {
+
+constexpr double kSampleRate = 48000.0;
+
+// Relative tolerance for a period the batched pass summed in another order.
+constexpr double kFrequencyTolerance = 1e-6;
+
+std::vector<float> makeSignal(std::size_t frames) {
+    std::vector<float> samples = tine::test::makeGlide(kSampleRate, frames, 82.0, 660.0);
+    // A silent gap and a noisy stretch give unvoiced frames and near-threshold minima.
+    std::mt19937 random(7);
+    std::normal_distribution<float> noise(0.0F, 0.2F);
+    for (std::size_t i = frames / 3; i < frames / 3 + 6000 && i < frames; ++i) {
+        samples[i] = 0.0F;
+    }
+    for (std::size_t i = 2 * frames / 3; i < 2 * frames / 3 + 9000 && i < frames; ++i) {
+        samples[i] += noise(random);
+    }
+    return samples;
+}
+
+void compareBatched(const std::vector<float>& samples, std::size_t window, std::size_t activeWindow,
+                    std::size_t hop) {
+    YinPitchDetector single(kSampleRate, window, 0.12);
+    YinPitchDetector batched(kSampleRate, window, 0.12);
+    single.setActiveSize(activeWindow);
+    batched.setActiveSize(activeWindow);
+
+    const std::size_t expected = (samples.size() - activeWindow) / hop + 1;
+    std::vector<PitchResult> results(expected + 4);
+    const std::size_t written = batched.processFrames(samples.data(), samples.size(), hop, results.data(),
+                                                      results.size());
+    TINE_CHECK(written == expected);
+
+    std::size_t mismatches = 0;
+    for (std::size_t k = 0; k < written; ++k) {
+        const PitchResult reference = single.processBuffer(samples.data() + k * hop, activeWindow);
+        const PitchResult& result = results[k];
+        const bool same = result.isValid == reference.isValid &&
+                          std::fabs(result.frequency - reference.frequency) <=
+                              kFrequencyTolerance * std::fmax(1.0, reference.frequency) &&
+                          std::fabs(result.probability - reference.probability) <= 1e-9 &&
+                          result.noteName == reference.noteName;
+        mismatches += same ? 0 : 1;
+    }
+    TINE_CHECK(mismatches == 0);
+    if (written > 0) {
+        TINE_CHECK(batched.getLastResult().frequency == results[written - 1].frequency);
+    }
+}
+
+void testEquivalence() {
+    const std::vector<float> samples = makeSignal(static_cast<std::size_t>(kSampleRate * 2));
+    for (const std::size_t hop : {64UL, 256UL, 1000UL, 2048UL, 3000UL}) {
+        compareBatched(samples, 2048, 2048, hop);
+    }
+    compareBatched(samples, 2048, 1024, 128);
+    compareBatched(samples, 1024, 1024, 96);
+}
+
+void testLimits() {
+    YinPitchDetector detector(kSampleRate, 1024, 0.12);
+    const std::vector<float> samples = tine::test::makeGlide(kSampleRate, 4096, 220.0, 220.0);
+    std::vector<PitchResult> results(8);
+
+    // Output capacity caps the frame count; the last result is the last one written.
+    TINE_CHECK(detector.processFrames(samples.data(), samples.size(), 256, results.data(), 3) == 3);
+    TINE_CHECK(detector.getLastResult().frequency == results[2].frequency);
+
+    // Shorter than one window: nothing to analyze.
+    TINE_CHECK(detector.processFrames(samples.data(), 1023, 256, results.data(), results.size()) == 0);
+    TINE_CHECK(detector.processFrames(samples.data(), samples.size(), 256, results.data(), 0) == 0);
+}
+
+}  // namespace
+
+int main() {
+    testEquivalence();
+    testLimits();
+    return tine::test::finish("yin_pitch_detector_test");
+}
@@ -1,6 +1,7 @@
 import { AdBanner } from '@components/AdBanner';
 import { MicPermissionScreen } from '@components/MicPermissionScreen';
 import { usePitchDetection } from '@hooks/usePitchDetection';
+import { addDialListener } from '@native/modules/PitchDetector';
 import { getMonotonicTime } from '@utils/clock';
 import { midiToNoteName } from '@utils/music';
 import {
@@ -28,6 +29,8 @@ const MIDI_END = 127;
 const CENTER_MIDI = 64;
 const STALE_SIGNAL_MS = 900;
 const AUDIO_ACTIVE_DB = -80;
+// The native needle spans +/-150 degrees at +/-50 cents; this dial spans +/-180.
+const NATIVE_NEEDLE_SCALE = 180 / 150;
 const clamp = (value: number, min: number, max: number): number =>
   Math.min(max, Math.max(min, value));
 
@@ -135,7 +138,7 @@ const resolveBoundaryFromFrequency = (
 };
 
 export const TunerScreen: React.FC = () => {
-  const { available, permission, requestPermission, openSettings, pitch, listening } =
+  const { available, permission, requestPermission, openSettings, pitch, listening, nativeDial } =
     usePitchDetection();
   const isWeb = Platform.OS === 'web';
   const { width, height } = useWindowDimensions();
@@ -628,8 +631,25 @@ export const TunerScreen: React.FC = () => {
     </View>
   );
 
+  // With the native dial, the needle and ring follow the native springs frame by
+  // frame and the timing animations below stand down.
   React.useEffect(() => {
-    if (!showTick) {
+    if (!nativeDial) {
+      return undefined;
+    }
+    const subscription = addDialListener((frame) => {
+      outerContinuousAngleRef.current = frame.ringDegrees;
+      innerContinuousAngleRef.current = frame.needleDegrees * NATIVE_NEEDLE_SCALE;
+      outerRotation.setValue(outerContinuousAngleRef.current);
+      innerCentsRotation.setValue(innerContinuousAngleRef.current);
+    });
+    return () => {
+      subscription.remove();
+    };
+  }, [innerCentsRotation, nativeDial, outerRotation]);
+
+  React.useEffect(() => {
+    if (!showTick || nativeDial) {
       return;
     }
     const computeContinuousTarget = () => {
@@ -655,10 +675,10 @@ export const TunerScreen: React.FC = () => {
       easing: Easing.out(Easing.cubic),
       useNativeDriver: !isWeb,
     }).start();
-  }, [allowMotion, isWeb, outerRotation, outerTargetAngleRaw, showTick]);
+  }, [allowMotion, isWeb, nativeDial, outerRotation, outerTargetAngleRaw, showTick]);
 
   React.useEffect(() => {
-    if (!showTick) {
+    if (!showTick || nativeDial) {
       return;
     }
     const target = allowMotion ? centsAngle : 0;
@@ -677,7 +697,7 @@ export const TunerScreen: React.FC = () => {
       easing: Easing.out(Easing.cubic),
       useNativeDriver: !isWeb,
     }).start();
-  }, [allowMotion, centsAngle, innerCentsRotation, isWeb, showTick]);
+  }, [allowMotion, centsAngle, innerCentsRotation, isWeb, nativeDial, showTick]);
 
   React.useEffect(() => {
     if (listening && permission === 'granted') {
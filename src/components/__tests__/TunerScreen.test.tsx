@@ -1,6 +1,9 @@
 import { render } from '@testing-library/react-native';
 import React from 'react';
 
+import { usePitchDetection } from '@hooks/usePitchDetection';
+import { addDialListener } from '@native/modules/PitchDetector';
+
 import TunerScreen from '../TunerScreen';
 
 jest.mock('@hooks/usePitchDetection', () => ({
@@ -14,6 +17,12 @@ jest.mock('@hooks/usePitchDetection', () => ({
   })),
 }));
 
+const mockRemoveDialListener = jest.fn();
+
+jest.mock('@native/modules/PitchDetector', () => ({
+  addDialListener: jest.fn(() => ({ remove: mockRemoveDialListener })),
+}));
+
 describe('TunerScreen', () => {
   it('shows a fallback when the native pitch detector is unavailable', () => {
     const { getByText } = render(<TunerScreen />);
@@ -25,4 +34,19 @@ describe('TunerScreen', () => {
       ),
     ).toBeOnTheScreen();
   });
+
+  it('follows the native dial frames when the detector animates the dial', () => {
+    const defaultStatus = (usePitchDetection as jest.Mock).getMockImplementation();
+    (usePitchDetection as jest.Mock).mockImplementation(() => ({
+      ...defaultStatus?.(),
+      nativeDial: true,
+    }));
+
+    const { unmount } = render(<TunerScreen />);
+    expect(addDialListener).toHaveBeenCalledTimes(1);
+
+    unmount();
+    expect(mockRemoveDialListener).toHaveBeenCalledTimes(1);
+    (usePitchDetection as jest.Mock).mockImplementation(defaultStatus);
+  });
 });
@@ -1,5 +1,5 @@
 /* eslint-disable import/order */
-import type { PitchEvent } from '@native/modules/specs/PitchDetectorNativeModule';
+import type { DialFrameEvent, PitchEvent } from '@native/modules/specs/PitchDetectorNativeModule';
 import { act, fireEvent, render, screen, waitFor } from '@testing-library/react-native';
 import TunerScreen from '@components/TunerScreen';
 import React from 'react';
@@ -39,6 +39,7 @@ jest.mock('@native/modules/specs/PitchDetectorNativeModule', () => ({
 }));
 
 const pitchListeners: ((event: PitchEvent) => void)[] = [];
+const dialListeners: ((event: DialFrameEvent) => void)[] = [];
 
 jest.mock('@native/modules/PitchDetector', () => ({
   start: jest.fn(() => Promise.resolve({ threshold: 0.12, bufferSize: 1024, sampleRate: 48000 })),
@@ -55,6 +56,17 @@ jest.mock('@native/modules/PitchDetector', () => ({
       },
     };
   }),
+  addDialListener: jest.fn((handler: (event: DialFrameEvent) => void) => {
+    dialListeners.push(handler);
+    return {
+      remove: () => {
+        const index = dialListeners.indexOf(handler);
+        if (index >= 0) {
+          dialListeners.splice(index, 1);
+        }
+      },
+    };
+  }),
   removeAllListeners: jest.fn(),
 }));
 
@@ -62,6 +74,7 @@ describe('usePitchDetection integration', () => {
   beforeEach(() => {
     jest.clearAllMocks();
     pitchListeners.splice(0, pitchListeners.length);
+    dialListeners.splice(0, dialListeners.length);
     const { __setPermissionState, __getPermissionsMock, __requestPermissionsMock } =
       jest.requireMock('expo-audio');
 
@@ -116,6 +129,19 @@ describe('usePitchDetection integration', () => {
     expect(__getPermissionsMock).toHaveBeenCalled();
   });
 
+  it('lets the native dial drive the needle on iOS', async () => {
+    const detector = jest.requireMock('@native/modules/PitchDetector');
+
+    render(<TunerScreen />);
+
+    await waitFor(() => {
+      expect(detector.start).toHaveBeenCalledWith(expect.objectContaining({ nativeDial: true }));
+    });
+    await waitFor(() => {
+      expect(dialListeners.length).toBe(1);
+    });
+  });
+
   it('updates the tuner display in response to pitch events', async () => {
     jest.useFakeTimers();
     const perfNow =
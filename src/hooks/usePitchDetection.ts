@@ -26,6 +26,11 @@ export interface PitchDetectionStatus {
   pitch: PitchState;
   permission: PermissionState;
   listening: boolean;
+  /**
+   * The detector animates the dial natively; subscribe with
+   * `PitchDetector.addDialListener` instead of animating from `pitch`.
+   */
+  nativeDial: boolean;
   requestPermission: () => Promise<boolean>;
   openSettings: () => Promise<void>;
 }
@@ -61,6 +66,7 @@ export function usePitchDetection(): PitchDetectionStatus {
   const [permission, setPermission] = React.useState<PermissionState>('unknown');
   const [pitch, setPitch] = React.useState<PitchState>(DEFAULT_PITCH);
   const [listening, setListening] = React.useState(false);
+  const [nativeDial, setNativeDial] = React.useState(false);
 
   const detectorRunningRef = React.useRef(false);
   const subscriptionRef = React.useRef<{ remove: () => void } | null>(null);
@@ -107,6 +113,7 @@ export function usePitchDetection(): PitchDetectionStatus {
     } finally {
       detectorRunningRef.current = false;
       setListening(false);
+      setNativeDial(false);
     }
   }, []);
 
@@ -259,16 +266,20 @@ export function usePitchDetection(): PitchDetectionStatus {
     const preferredSampleRate = Platform.OS === 'android' ? 48000 : 44100;
     const preferredBufferSize = 4096;
     const preferredThreshold = Platform.OS === 'web' ? 0.1 : 0.08;
+    // Only the iOS module animates the dial natively.
+    const preferredNativeDial = Platform.OS === 'ios';
     try {
       await PitchDetector.start({
         threshold: preferredThreshold,
         bufferSize: preferredBufferSize,
         sampleRate: preferredSampleRate,
         estimator: preferredEstimator,
+        nativeDial: preferredNativeDial,
       });
       subscriptionRef.current = PitchDetector.addPitchListener(handlePitch);
       detectorRunningRef.current = true;
       setListening(true);
+      setNativeDial(preferredNativeDial);
     } catch (error) {
       console.warn('Failed to start pitch detector', error);
       detectorRunningRef.current = false;
@@ -465,10 +476,11 @@ export function usePitchDetection(): PitchDetectionStatus {
       pitch,
       permission,
       listening,
+      nativeDial,
       requestPermission,
       openSettings,
     }),
-    [availability, listening, openSettings, permission, pitch, requestPermission],
+    [availability, listening, nativeDial, openSettings, permission, pitch, requestPermission],
   );
 }
 
@@ -1,10 +1,18 @@
+import { logger } from '@utils/logger';
 import { midiToNoteName } from '@utils/music';
 import { PitchSmoother } from '@utils/yinSmoothing';
 import { NativeEventEmitter, NativeModules, Platform } from 'react-native';
 
 import PitchDetectorModule, {
+  DIAL_FRAME_EVENT_NAME,
+  NATIVE_LOG_EVENT_NAME,
   PITCH_EVENT_NAME,
+  type DialFrameEvent,
+  type NativeLogEvent,
   type PitchEvent,
+  type PitchStats,
+  type ReferenceToneOptions,
+  type SessionAnalytics,
   type StartOptions,
   type StartResult,
 } from './specs/PitchDetectorNativeModule';
@@ -30,9 +38,9 @@ const nativeModuleForEvents = (() => {
 type Listener = (event: PitchEvent) => void;
 
 type InternalEmitter = {
-  addListener: (
+  addListener: <T>(
     eventName: string,
-    listener: Listener,
+    listener: (event: T) => void,
   ) => {
     remove: () => void;
   };
@@ -40,11 +48,11 @@ type InternalEmitter = {
 };
 
 const createFallbackEmitter = (): InternalEmitter => {
-  const listenerMap = new Map<string, Set<Listener>>();
+  const listenerMap = new Map<string, Set<unknown>>();
 
   return {
     addListener(eventName, listener) {
-      const listeners = listenerMap.get(eventName) ?? new Set<Listener>();
+      const listeners = listenerMap.get(eventName) ?? new Set<unknown>();
       listeners.add(listener);
       listenerMap.set(eventName, listeners);
 
@@ -116,8 +124,25 @@ type Subscription = {
   remove: () => void;
 };
 
+let nativeLogSubscription: Subscription | null = null;
+
+// Native diagnostics arrive in batches from the real-time log drain; route them
+// through the shared logger so they show up in DebugLogOverlay.
+const forwardNativeLogs = () => {
+  if (nativeLogSubscription) {
+    return;
+  }
+  nativeLogSubscription = eventEmitter.addListener<NativeLogEvent>(
+    NATIVE_LOG_EVENT_NAME,
+    (event) => {
+      logger[event.level](event.tag, event.message, { event: event.event });
+    },
+  );
+};
+
 export async function start(options: StartOptions = {}): Promise<StartResult> {
   if (Platform.OS !== 'web') {
+    forwardNativeLogs();
     return await PitchDetectorModule.start(options);
   }
 
@@ -232,6 +257,41 @@ export function setThreshold(threshold: number): void {
   webThreshold = threshold;
 }
 
+/**
+ * Native pipeline metrics (overruns, skipped frames, ring high-water mark, gate
+ * time, analysis time percentiles). Resolves null on web or while stopped.
+ */
+export async function getStats(): Promise<PitchStats | null> {
+  if (Platform.OS === 'web' || !PitchDetectorModule.getStats) {
+    return null;
+  }
+  return await PitchDetectorModule.getStats();
+}
+
+/**
+ * Per-note and per-string intonation, drift and vibrato for the session, computed
+ * natively from every result (start with `sessionAnalytics: true`). Remains
+ * readable after `stop()`; resolves null on web or when not enabled.
+ */
+export async function getSessionAnalytics(): Promise<SessionAnalytics | null> {
+  if (Platform.OS === 'web' || !PitchDetectorModule.getSessionAnalytics) {
+    return null;
+  }
+  return await PitchDetectorModule.getSessionAnalytics();
+}
+
+/**
+ * Play a reference tone or drone through the speaker while detecting; calling
+ * again glides to the new settings, null releases it. Takes effect from the next
+ * `start()` when called while stopped. No-op on web.
+ */
+export function setReferenceTone(options: ReferenceToneOptions | null): void {
+  if (Platform.OS === 'web' || !PitchDetectorModule.setReferenceTone) {
+    return;
+  }
+  PitchDetectorModule.setReferenceTone(options);
+}
+
 export function addPitchListener(listener: Listener): Subscription {
   if (Platform.OS !== 'web') {
     const subscription = eventEmitter.addListener(PITCH_EVENT_NAME, listener);
@@ -249,9 +309,26 @@ export function addPitchListener(listener: Listener): Subscription {
   };
 }
 
+/**
+ * Per-frame needle and ring angles from the native dial animator. Only fires
+ * when the detector was started with `nativeDial: true`; never on web.
+ */
+export function addDialListener(listener: (event: DialFrameEvent) => void): Subscription {
+  if (Platform.OS === 'web') {
+    return { remove: () => {} };
+  }
+  const subscription = eventEmitter.addListener<DialFrameEvent>(DIAL_FRAME_EVENT_NAME, listener);
+  return {
+    remove: () => {
+      subscription.remove();
+    },
+  };
+}
+
 export function removeAllListeners(): void {
   if (Platform.OS !== 'web') {
     eventEmitter.removeAllListeners(PITCH_EVENT_NAME);
+    eventEmitter.removeAllListeners(DIAL_FRAME_EVENT_NAME);
     return;
   }
   webListeners.clear();
@@ -261,6 +338,10 @@ export default {
   start,
   stop,
   setThreshold,
+  getStats,
+  getSessionAnalytics,
+  setReferenceTone,
   addPitchListener,
+  addDialListener,
   removeAllListeners,
 };
@@ -2,7 +2,15 @@ import { YinPitchDetector } from '@native/dsp/YinPitchDetector';
 import { midiToNoteName } from '@utils/music';
 import { PitchSmoother } from '@utils/yinSmoothing';
 
-import type { PitchEvent, StartOptions, StartResult } from './specs/pitchTypes';
+import type {
+  DialFrameEvent,
+  PitchEvent,
+  PitchStats,
+  ReferenceToneOptions,
+  SessionAnalytics,
+  StartOptions,
+  StartResult,
+} from './specs/pitchTypes';
 import { getWebWorkletDataUrl, getWebWorkletUrl } from './web/workletUrl';
 
 type Listener = (event: PitchEvent) => void;
@@ -333,6 +341,19 @@ export function setThreshold(threshold: number): void {
   }
 }
 
+/** The web worklet has no native metrics registry. */
+export async function getStats(): Promise<PitchStats | null> {
+  return null;
+}
+
+/** Session analytics are accumulated by the native engine only. */
+export async function getSessionAnalytics(): Promise<SessionAnalytics | null> {
+  return null;
+}
+
+/** The web detector does not render audio; reference tones are native only. */
+export function setReferenceTone(_options: ReferenceToneOptions | null): void {}
+
 export function addPitchListener(listener: Listener): Subscription {
   webListeners.add(listener);
   return {
@@ -342,6 +363,11 @@ export function addPitchListener(listener: Listener): Subscription {
   };
 }
 
+/** The native dial animator is not available on web; the subscription never fires. */
+export function addDialListener(_listener: (event: DialFrameEvent) => void): Subscription {
+  return { remove: () => {} };
+}
+
 export function removeAllListeners(): void {
   webListeners.clear();
 }
@@ -350,6 +376,10 @@ export default {
   start,
   stop,
   setThreshold,
+  getStats,
+  getSessionAnalytics,
+  setReferenceTone,
   addPitchListener,
+  addDialListener,
   removeAllListeners,
 };
@@ -0,0 +1,165 @@
+import type { NativeLogEvent, PitchStats } from '../specs/PitchDetectorNativeModule';
+
+type EventListener = (event: unknown) => void;
+
+describe('PitchDetector native bridge', () => {
+  const originalTurboProxy = (globalThis as any).__turboModuleProxy;
+  const emitterListeners = new Map<string, Set<EventListener>>();
+  const loggerMock = {
+    info: jest.fn(),
+    warn: jest.fn(),
+    error: jest.fn(),
+  };
+
+  const emit = (eventName: string, event: unknown) => {
+    emitterListeners.get(eventName)?.forEach((listener) => {
+      listener(event);
+    });
+  };
+
+  const loadDetector = (nativeModule: Record<string, unknown>, os: 'ios' | 'web' = 'ios') => {
+    jest.resetModules();
+    (globalThis as any).__turboModuleProxy = null;
+
+    class NativeEventEmitter {
+      addListener(eventName: string, listener: EventListener) {
+        const listeners = emitterListeners.get(eventName) ?? new Set<EventListener>();
+        listeners.add(listener);
+        emitterListeners.set(eventName, listeners);
+        return { remove: () => listeners.delete(listener) };
+      }
+
+      removeAllListeners(eventName: string) {
+        emitterListeners.delete(eventName);
+      }
+    }
+
+    jest.doMock('react-native', () => ({
+      NativeModules: { PitchDetector: nativeModule },
+      NativeEventEmitter,
+      Platform: { OS: os },
+      TurboModuleRegistry: { getEnforcing: jest.fn(() => undefined) },
+    }));
+    jest.doMock('@utils/logger', () => ({ logger: loggerMock }));
+
+    return require('../PitchDetector') as typeof import('../PitchDetector');
+  };
+
+  const baseModule = () => ({
+    start: jest.fn().mockResolvedValue({ sampleRate: 48000, bufferSize: 2048, threshold: 0.12 }),
+    stop: jest.fn().mockResolvedValue(true),
+    setThreshold: jest.fn(),
+    addListener: jest.fn(),
+    removeListeners: jest.fn(),
+  });
+
+  afterEach(() => {
+    emitterListeners.clear();
+    jest.clearAllMocks();
+    jest.restoreAllMocks();
+    (globalThis as any).__turboModuleProxy = originalTurboProxy;
+  });
+
+  it('routes onNativeLog events into the shared logger once started', async () => {
+    const detector = loadDetector(baseModule());
+    const event: NativeLogEvent = {
+      level: 'warn',
+      tag: 'PitchEngine',
+      event: 'capture-overrun',
+      message: '3 overruns, 1536 frames',
+      timestamp: 1700000000000,
+    };
+
+    emit('onNativeLog', event);
+    expect(loggerMock.warn).not.toHaveBeenCalled();
+
+    await detector.start();
+    await detector.start();
+    expect(emitterListeners.get('onNativeLog')?.size).toBe(1);
+
+    emit('onNativeLog', event);
+    emit('onNativeLog', { ...event, level: 'error', event: 'inline-fallback', message: 'fell back' });
+
+    expect(loggerMock.warn).toHaveBeenCalledTimes(1);
+    expect(loggerMock.warn).toHaveBeenCalledWith('PitchEngine', '3 overruns, 1536 frames', {
+      event: 'capture-overrun',
+    });
+    expect(loggerMock.error).toHaveBeenCalledWith('PitchEngine', 'fell back', {
+      event: 'inline-fallback',
+    });
+
+    // Pitch listeners come and go without dropping the diagnostics subscription.
+    detector.removeAllListeners();
+    emit('onNativeLog', event);
+    expect(loggerMock.warn).toHaveBeenCalledTimes(2);
+  });
+
+  it('returns the native stats snapshot', async () => {
+    const stats: PitchStats = {
+      counters: { tine_overruns_total: 2 },
+      gauges: { tine_ring_fill_high_water_frames: 4096 },
+      histograms: {},
+      sampleRate: 48000,
+      wakeupsPerSecond: 46.9,
+      timestamp: 1700000000000,
+    };
+    const nativeModule = { ...baseModule(), getStats: jest.fn().mockResolvedValue(stats) };
+    const detector = loadDetector(nativeModule);
+
+    await expect(detector.getStats()).resolves.toEqual(stats);
+    expect(nativeModule.getStats).toHaveBeenCalledTimes(1);
+  });
+
+  it('resolves null stats when the platform does not implement them', async () => {
+    await expect(loadDetector(baseModule()).getStats()).resolves.toBeNull();
+
+    const nativeModule = { ...baseModule(), getStats: jest.fn() };
+    await expect(loadDetector(nativeModule, 'web').getStats()).resolves.toBeNull();
+    expect(nativeModule.getStats).not.toHaveBeenCalled();
+  });
+
+  it('forwards reference tone settings and release', () => {
+    const nativeModule = { ...baseModule(), setReferenceTone: jest.fn() };
+    const detector = loadDetector(nativeModule);
+
+    detector.setReferenceTone({ frequency: 220, gain: 0.2, waveform: 'sawtooth', glideMs: 80 });
+    detector.setReferenceTone(null);
+
+    expect(nativeModule.setReferenceTone).toHaveBeenNthCalledWith(1, {
+      frequency: 220,
+      gain: 0.2,
+      waveform: 'sawtooth',
+      glideMs: 80,
+    });
+    expect(nativeModule.setReferenceTone).toHaveBeenNthCalledWith(2, null);
+  });
+
+  it('ignores the reference tone where the platform does not implement it', () => {
+    expect(() => loadDetector(baseModule()).setReferenceTone({ frequency: 440 })).not.toThrow();
+
+    const nativeModule = { ...baseModule(), setReferenceTone: jest.fn() };
+    loadDetector(nativeModule, 'web').setReferenceTone({ frequency: 440 });
+    expect(nativeModule.setReferenceTone).not.toHaveBeenCalled();
+  });
+
+  it('returns the session analytics, including after stop', async () => {
+    const analytics = { sessionSeconds: 30, inTuneCents: 10, notes: [], strings: [] };
+    const nativeModule = {
+      ...baseModule(),
+      getSessionAnalytics: jest.fn().mockResolvedValue(analytics),
+    };
+    const detector = loadDetector(nativeModule);
+
+    await detector.start({ sessionAnalytics: true });
+    await detector.stop();
+    await expect(detector.getSessionAnalytics()).resolves.toEqual(analytics);
+  });
+
+  it('resolves null analytics when the platform does not implement them', async () => {
+    await expect(loadDetector(baseModule()).getSessionAnalytics()).resolves.toBeNull();
+
+    const nativeModule = { ...baseModule(), getSessionAnalytics: jest.fn() };
+    await expect(loadDetector(nativeModule, 'web').getSessionAnalytics()).resolves.toBeNull();
+    expect(nativeModule.getSessionAnalytics).not.toHaveBeenCalled();
+  });
+});
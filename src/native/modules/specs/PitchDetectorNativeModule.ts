@@ -1,10 +1,30 @@
 import { NativeModules, Platform, TurboModuleRegistry } from 'react-native';
 import type { TurboModule } from 'react-native';
 
-import type { StartOptions, StartResult } from './pitchTypes';
-
-export type { PitchEvent, StartOptions, StartResult } from './pitchTypes';
-export { PITCH_EVENT_NAME } from './pitchTypes';
+import type {
+  PitchStats,
+  ReferenceToneOptions,
+  SessionAnalytics,
+  StartOptions,
+  StartResult,
+} from './pitchTypes';
+
+export type {
+  DialFrameEvent,
+  DriftPoint,
+  IntonationSummary,
+  NativeLogEvent,
+  NoteIntonation,
+  PitchEvent,
+  PitchStats,
+  PitchStatsHistogram,
+  ReferenceToneOptions,
+  ReferenceToneWaveform,
+  SessionAnalytics,
+  StartOptions,
+  StartResult,
+} from './pitchTypes';
+export { DIAL_FRAME_EVENT_NAME, NATIVE_LOG_EVENT_NAME, PITCH_EVENT_NAME } from './pitchTypes';
 
 /**
  * Shared TurboModule contract implemented by the Objective-C detector.
@@ -13,6 +33,12 @@ export interface Spec extends TurboModule {
   start(options?: StartOptions): Promise<StartResult>;
   stop(): Promise<boolean>;
   setThreshold(threshold: number): void;
+  /** Pipeline metrics for the running session; null when stopped. Not every platform implements it. */
+  getStats?(): Promise<PitchStats | null>;
+  /** Start, retune or (with null) release the reference tone. Not every platform implements it. */
+  setReferenceTone?(options: ReferenceToneOptions | null): void;
+  /** Intonation analytics of the current or last session; null when not enabled. */
+  getSessionAnalytics?(): Promise<SessionAnalytics | null>;
 }
 
 export let LINKING_ERROR =
@@ -74,6 +100,17 @@ const createUnavailableModule = (): Spec => {
     setThreshold() {
       warn();
     },
+    async getStats() {
+      warn();
+      return null;
+    },
+    setReferenceTone() {
+      warn();
+    },
+    async getSessionAnalytics() {
+      warn();
+      return null;
+    },
   };
 };
 
@@ -33,6 +33,10 @@ describe('PitchDetector native module resolution', () => {
     await expect(spec.start()).rejects.toThrow(LINKING_ERROR);
     await expect(spec.stop()).resolves.toBe(false);
     spec.setThreshold(0.5);
+    await expect(spec.getStats()).resolves.toBeNull();
+    expect(() => spec.setReferenceTone({ frequency: 440 })).not.toThrow();
+    expect(() => spec.setReferenceTone(null)).not.toThrow();
+    await expect(spec.getSessionAnalytics()).resolves.toBeNull();
 
     expect(warnSpy).toHaveBeenCalledWith(LINKING_ERROR);
   });
@@ -78,4 +82,103 @@ describe('PitchDetector native module resolution', () => {
     expect(stopMock).toHaveBeenCalledTimes(1);
     expect(setThresholdMock).toHaveBeenCalledWith(0.25);
   });
+
+  it('passes the native stats snapshot through', async () => {
+    jest.resetModules();
+    (globalThis as any).__turboModuleProxy = null;
+
+    const stats = {
+      counters: { tine_skipped_frames_total: 3 },
+      gauges: { tine_ring_fill_high_water_frames: 1024 },
+      histograms: {
+        tine_analysis_seconds: {
+          count: 10,
+          sum: 0.02,
+          min: 0.001,
+          max: 0.004,
+          quantiles: { '0.99': 0.004 },
+        },
+      },
+      sampleRate: 48000,
+      wakeupsPerSecond: 93.75,
+      timestamp: 1700000000000,
+    };
+    const getStatsMock = jest.fn().mockResolvedValue(stats);
+
+    jest.doMock('react-native', () => ({
+      NativeModules: {
+        PitchDetector: {
+          start: jest.fn(),
+          stop: jest.fn(),
+          setThreshold: jest.fn(),
+          getStats: getStatsMock,
+        },
+      },
+      Platform: { OS: 'ios' },
+      TurboModuleRegistry: { getEnforcing: jest.fn(() => undefined) },
+    }));
+
+    const { default: spec } = require('../PitchDetectorNativeModule');
+
+    await expect(spec.getStats()).resolves.toEqual(stats);
+    expect(getStatsMock).toHaveBeenCalledTimes(1);
+  });
+
+  it('passes reference tone settings and release through', () => {
+    jest.resetModules();
+    (globalThis as any).__turboModuleProxy = null;
+
+    const setReferenceToneMock = jest.fn();
+
+    jest.doMock('react-native', () => ({
+      NativeModules: {
+        PitchDetector: {
+          start: jest.fn(),
+          stop: jest.fn(),
+          setThreshold: jest.fn(),
+          setReferenceTone: setReferenceToneMock,
+        },
+      },
+      Platform: { OS: 'ios' },
+      TurboModuleRegistry: { getEnforcing: jest.fn(() => undefined) },
+    }));
+
+    const { default: spec } = require('../PitchDetectorNativeModule');
+
+    spec.setReferenceTone({ frequency: 440, waveform: 'triangle', duckWhileVoiced: true });
+    spec.setReferenceTone(null);
+
+    expect(setReferenceToneMock).toHaveBeenNthCalledWith(1, {
+      frequency: 440,
+      waveform: 'triangle',
+      duckWhileVoiced: true,
+    });
+    expect(setReferenceToneMock).toHaveBeenNthCalledWith(2, null);
+  });
+
+  it('passes the session analytics through', async () => {
+    jest.resetModules();
+    (globalThis as any).__turboModuleProxy = null;
+
+    const analytics = { sessionSeconds: 12.5, inTuneCents: 10, notes: [], strings: [], drift: [] };
+    const getSessionAnalyticsMock = jest.fn().mockResolvedValue(analytics);
+
+    jest.doMock('react-native', () => ({
+      NativeModules: {
+        PitchDetector: {
+          start: jest.fn(),
+          stop: jest.fn(),
+          setThreshold: jest.fn(),
+          getSessionAnalytics: getSessionAnalyticsMock,
+        },
+      },
+      Platform: { OS: 'ios' },
+      TurboModuleRegistry: { getEnforcing: jest.fn(() => undefined) },
+    }));
+
+    const { default: spec } = require('../PitchDetectorNativeModule');
+
+    await expect(spec.getSessionAnalytics()).resolves.toEqual(analytics);
+    expect(getSessionAnalyticsMock).toHaveBeenCalledTimes(1);
+  });
 });
@@ -13,11 +13,18 @@ export interface PitchEvent {
 
 export interface StartOptions {
   /**
-   * Number of frames analysed per window. Defaults to 2048 (~46 ms at 44.1 kHz).
-   * Lowering to 1024 or 512 can cut perceived latency for tuner UIs at the cost
-   * of frequency resolution and noise rejection.
+   * Number of frames analysed per window. When omitted, native layers derive the
+   * window from `minFrequency`. Lowering it can cut perceived latency for tuner UIs
+   * at the cost of frequency resolution and noise rejection.
    */
   bufferSize?: number;
+  /**
+   * Expected onset-to-result latency (ms) the native pipeline is planned for.
+   * Tap, hop, window and ring sizes are derived from it. Defaults to 80.
+   */
+  targetLatencyMs?: number;
+  /** Lowest fundamental (Hz) that must remain detectable. Defaults to 40. */
+  minFrequency?: number;
   /** YIN probability gate between 0 and 1. Defaults to 0.15. */
   threshold?: number;
   /**
@@ -32,14 +39,234 @@ export interface StartOptions {
   estimator?: 'yin' | 'fft-yin' | 'hps' | 'neural-hybrid';
   /** Optional URL or path to a neural model (e.g., ONNX/CoreML/TFLite) when using neural-hybrid. */
   neuralModelUrl?: string;
+  /**
+   * Where native analysis runs. `inline` analyzes on the capture thread while the
+   * measured detector cost fits the callback budget and falls back to `worker` otherwise.
+   */
+  analysisMode?: 'worker' | 'inline';
+  /**
+   * Let native layers shrink the analysis window and lag range while a high note
+   * is tracked and grow them again as pitch falls. Defaults to true.
+   */
+  adaptiveWindow?: boolean;
+  /**
+   * How the detected period is refined between samples. `sinc` keeps high
+   * notes within about a tenth of a cent, so a window half the usual size (set
+   * `bufferSize` or a shorter `targetLatencyMs`) reads as precisely as
+   * `parabolic` on a full one. `cubic` only suits pure tones. Defaults to `parabolic`.
+   */
+  lagRefinement?: 'parabolic' | 'cubic' | 'sinc';
+  /**
+   * Instrument profile supplying defaults for the band, latency target, threshold
+   * and pre-filtering. Explicit options above still take precedence.
+   */
+  preset?: InstrumentPresetName;
+  /**
+   * After `stop()`, time the native difference kernels for this session's window
+   * sizes on a background thread and remember the fastest per device. Later
+   * sessions dispatch to it with no warm-up. Defaults to false.
+   */
+  autotuneKernels?: boolean;
+  /**
+   * `energy` lets several hops queue and analyzes them in one wakeup of a
+   * non-real-time thread, trading up to `maxBatchLatencyMs` of extra latency for
+   * far fewer wakeups. Meant for background or monitor use; results are unchanged
+   * but arrive in bursts. Defaults to `latency`.
+   */
+  schedulingPolicy?: 'latency' | 'energy';
+  /** Extra latency (ms) the energy policy may add. Defaults to 150. */
+  maxBatchLatencyMs?: number;
+  /**
+   * Animate the needle and note ring natively: results drive critically damped
+   * springs that advance once per display frame, and each moving frame is
+   * delivered as a `DialFrameEvent`. Defaults to false.
+   */
+  nativeDial?: boolean;
+  /**
+   * While a reference tone sounds, notch its current frequency and harmonics
+   * out of the captured audio so the detector follows the player instead of the
+   * speaker. A player within about 43 cents of the tone is notched too, so
+   * leave this off to tune against a drone and rely on `duckWhileVoiced` or
+   * headphones instead. Defaults to false.
+   */
+  referenceToneNotch?: boolean;
+  /**
+   * Accumulate per-session intonation statistics natively from every result,
+   * readable with `getSessionAnalytics()`. Defaults to false.
+   */
+  sessionAnalytics?: boolean;
+  /** Offset (cents) within which a note counts as in tune for analytics. Defaults to 10. */
+  inTuneCents?: number;
 }
 
+export type InstrumentPresetName =
+  | 'guitar'
+  | 'bass'
+  | 'violin'
+  | 'viola'
+  | 'cello'
+  | 'ukulele'
+  | 'voice'
+  | 'piano'
+  | 'chromatic';
+
 export interface StartResult {
   sampleRate: number;
   bufferSize: number;
   threshold: number;
   estimator?: StartOptions['estimator'];
   neuralReady?: boolean;
+  /** Scheduling policy, affinity and FTZ state actually applied to the native analysis thread. */
+  threadConfig?: string;
+  /** Analysis mode in effect after start-up calibration. */
+  analysisMode?: StartOptions['analysisMode'];
+  /** Pipeline derived from `targetLatencyMs`, `minFrequency` and the granted IO period. */
+  latencyPlan?: LatencyPlan;
+  /** Preset in effect, when one was requested and recognised. */
+  preset?: InstrumentPresetInfo;
+  schedulingPolicy?: StartOptions['schedulingPolicy'];
+}
+
+export interface InstrumentPresetInfo {
+  name: InstrumentPresetName;
+  minFrequency: number;
+  maxFrequency: number;
+  /** Reference notes (open strings); empty for chromatic presets. */
+  targetFrequencies: number[];
+}
+
+export interface LatencyPlan {
+  ioPeriodFrames: number;
+  tapFrames: number;
+  hopFrames: number;
+  windowFrames: number;
+  ringCapacity: number;
+  minDetectableHz: number;
+  expectedLatencyMs: number;
+  worstCaseLatencyMs: number;
+  /** Average fraction of one core used by the detector. */
+  cpuLoad: number;
+  meetsLatencyTarget: boolean;
+  /** Hops analyzed per analysis-thread wakeup; above 1 only under the energy policy. */
+  batchHops?: number;
+  wakeupsPerSecond?: number;
 }
 
 export const PITCH_EVENT_NAME = 'onPitchData';
+
+/** Diagnostics drained from the native real-time log ring. */
+export interface NativeLogEvent {
+  level: 'info' | 'warn' | 'error';
+  tag: string;
+  /** Stable event id, e.g. `capture-overrun` or `inline-fallback`. */
+  event: string;
+  message: string;
+  /** Milliseconds since the epoch at which the native thread logged it. */
+  timestamp: number;
+}
+
+export const NATIVE_LOG_EVENT_NAME = 'onNativeLog';
+
+/** One display frame of the native dial animation (`nativeDial`). */
+export interface DialFrameEvent {
+  /** Needle deflection; +/-150 at +/-50 cents. */
+  needleDegrees: number;
+  /** Continuous note-ring rotation (-30 per semitone); never wraps the long way. */
+  ringDegrees: number;
+  /** Cents and fractional MIDI note the springs are heading for. */
+  cents: number;
+  midi: number;
+  voiced: boolean;
+  /** Both springs are at rest; no further frames arrive until the next move. */
+  settled: boolean;
+  /** Display-link timestamp in milliseconds (monotonic). */
+  timestamp: number;
+}
+
+export const DIAL_FRAME_EVENT_NAME = 'onDialFrame';
+
+export type ReferenceToneWaveform = 'sine' | 'triangle' | 'sawtooth' | 'square';
+
+/** Reference tone or drone rendered to the speaker alongside detection. */
+export interface ReferenceToneOptions {
+  frequency: number;
+  /** Linear peak amplitude, 0-1. Defaults to 0.25. */
+  gain?: number;
+  /** Band-limited waveform. Defaults to `sine`, the easiest to notch out. */
+  waveform?: ReferenceToneWaveform;
+  /** Time constant of the pitch glide from the previous tone. Defaults to 50. */
+  glideMs?: number;
+  attackMs?: number;
+  releaseMs?: number;
+  /** Drop to `duckGain` while the detector hears a voiced note. Defaults to false. */
+  duckWhileVoiced?: boolean;
+  /** Defaults to 0.3. */
+  duckGain?: number;
+}
+
+/** Summary of one native latency histogram, in the metric's unit (seconds for `*_seconds`). */
+export interface PitchStatsHistogram {
+  count: number;
+  sum: number;
+  min: number;
+  max: number;
+  /** Keyed by quantile, e.g. `"0.5"`, `"0.99"`. */
+  quantiles: Record<string, number>;
+}
+
+/**
+ * Snapshot of the native pipeline metrics. Names match the Prometheus exposition
+ * of the C API, e.g. `tine_skipped_frames_total` or `tine_ring_fill_high_water_frames`.
+ * Frame counts convert to time with `sampleRate`.
+ */
+export interface PitchStats {
+  counters: Record<string, number>;
+  gauges: Record<string, number>;
+  histograms: Record<string, PitchStatsHistogram>;
+  sampleRate: number;
+  /** Measured analysis-thread wakeups per second since start. */
+  wakeupsPerSecond: number;
+  /** Milliseconds since the epoch when the snapshot was taken. */
+  timestamp: number;
+}
+
+/** Time-weighted intonation statistics for one note, string or the whole session. */
+export interface IntonationSummary {
+  voicedSeconds: number;
+  inTuneSeconds: number;
+  inTuneFraction: number;
+  meanCents: number;
+  stdDevCents: number;
+  /** Voiced seconds in 5-cent bins from -50 to +50; outliers land in the end bins. */
+  centsHistogram: number[];
+  vibratoSeconds: number;
+  vibratoRateHz: number;
+  /** Peak deviation from the note's centre, in cents. */
+  vibratoDepthCents: number;
+}
+
+export interface NoteIntonation extends IntonationSummary {
+  /** The sounding note, or the string's reference note. */
+  midi: number;
+}
+
+export interface DriftPoint {
+  startSeconds: number;
+  voicedSeconds: number;
+  meanCents: number;
+}
+
+/** Native session analytics (`sessionAnalytics: true`), covering every result since `start()`. */
+export interface SessionAnalytics {
+  sessionSeconds: number;
+  inTuneCents: number;
+  overall: IntonationSummary;
+  /** Notes that sounded, in MIDI order. */
+  notes: NoteIntonation[];
+  /** One entry per open string of the active preset. */
+  strings: NoteIntonation[];
+  /** Bin width doubles as the session grows, so the series stays a fixed size. */
+  driftBinSeconds: number;
+  drift: DriftPoint[];
+  driftCentsPerMinute: number;
+}